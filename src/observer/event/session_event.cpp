@@ -57,6 +57,55 @@ int SessionEvent::get_response_len() const
   return response_.size();
 }
 
+std::ostream &SessionEvent::result_stream()
+{
+  if (result_stream_ == nullptr) {
+    result_stream_.reset(new ResultStream(client_));
+  }
+  return *result_stream_;
+}
+
+int SessionEvent::flush_result()
+{
+  if (result_stream_ == nullptr) {
+    return 0;
+  }
+  return result_stream_->buf().flush();
+}
+
+void SessionEvent::discard_result()
+{
+  if (result_stream_ != nullptr) {
+    result_stream_->buf().discard();
+  }
+}
+
+bool SessionEvent::result_sent() const
+{
+  return result_stream_ != nullptr && result_stream_->buf().sent();
+}
+
+void SessionEvent::start_capture_result(size_t max_size)
+{
+  result_stream();
+  result_stream_->buf().start_capture(max_size);
+}
+
+void SessionEvent::stop_capture_result()
+{
+  if (result_stream_ != nullptr) {
+    result_stream_->buf().stop_capture();
+  }
+}
+
+bool SessionEvent::finish_capture_result(std::string &output)
+{
+  if (result_stream_ == nullptr) {
+    return false;
+  }
+  return result_stream_->buf().finish_capture(output);
+}
+
 char *SessionEvent::get_request_buf()
 {
   return client_->buf;
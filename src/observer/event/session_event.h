@@ -16,10 +16,13 @@ See the Mulan PSL v2 for more details. */
 #define __OBSERVER_SESSION_SESSIONEVENT_H__
 
 #include <string.h>
+#include <memory>
+#include <ostream>
 #include <string>
 
 #include "common/seda/stage_event.h"
 #include "net/connection_context.h"
+#include "net/result_stream.h"
 
 class Session;
 
@@ -36,6 +39,29 @@ public:
   void set_response(const char *response, int len);
   void set_response(std::string &&response);
   int get_response_len() const;
+
+  /**
+   * 查询结果写到这里，攒够一块就发送给客户端，不再整体放到response中
+   */
+  std::ostream &result_stream();
+  /**
+   * 发送结果流中剩余的数据
+   * @return 客户端已经断开等原因发送失败时返回非0
+   */
+  int flush_result();
+  /**
+   * 丢弃结果流中还没有发送的数据，用于查询中途出错时
+   */
+  void discard_result();
+  bool result_sent() const;
+
+  /**
+   * 复制这一次写到结果流中的数据，参考ResultStreamBuf::start_capture
+   */
+  void start_capture_result(size_t max_size);
+  void stop_capture_result();
+  bool finish_capture_result(std::string &output);
+
   char *get_request_buf();
   int get_request_buf_len();
 
@@ -43,6 +69,7 @@ private:
   ConnectionContext *client_;
 
   std::string response_;
+  std::unique_ptr<ResultStream> result_stream_;
 };
 
 #endif  //__OBSERVER_SESSION_SESSIONEVENT_H__
@@ -20,6 +20,7 @@ See the Mulan PSL v2 for more details. */
 
 class SessionEvent;
 class Stmt;
+class CachedPlan;
 struct Query;
 
 class SQLStageEvent : public common::StageEvent
@@ -36,16 +37,22 @@ public:
   const std::string &sql() const { return sql_; }
   Query *query() const { return query_; }
   Stmt *stmt() const { return stmt_; }
+  /**
+   * 从执行计划缓存中取出或者PREPARE的计划，没有经过计划缓存时为空
+   */
+  CachedPlan *plan() const { return plan_; }
 
   void set_sql(const char *sql) { sql_ = sql; }
   void set_query(Query *query) { query_ = query; }
   void set_stmt(Stmt *stmt) { stmt_ = stmt; }
+  void set_plan(CachedPlan *plan) { plan_ = plan; }
 
 private:
   SessionEvent *session_event_ = nullptr;
   std::string sql_;
   Query *query_ = nullptr;
   Stmt *stmt_ = nullptr;
+  CachedPlan *plan_ = nullptr;
 };
 
 #endif  //__SRC_OBSERVER_SQL_EVENT_SQLEVENT_H__
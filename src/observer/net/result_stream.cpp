@@ -0,0 +1,94 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+
+#include "net/result_stream.h"
+#include "net/server.h"
+
+ResultStreamBuf::ResultStreamBuf(ConnectionContext *client) : client_(client), buffer_(CHUNK_SIZE)
+{
+  setp(buffer_.data(), buffer_.data() + buffer_.size());
+}
+
+int ResultStreamBuf::flush()
+{
+  if (failed_) {
+    return -1;
+  }
+  const int len = pptr() - pbase();
+  if (len == 0) {
+    return 0;
+  }
+  setp(buffer_.data(), buffer_.data() + buffer_.size());
+  if (capturing_) {
+    if (capture_.size() + len > capture_max_size_) {
+      stop_capture();
+    } else {
+      capture_.append(buffer_.data(), len);
+    }
+  }
+  // 还在执行请求，session在使用中，失败时不能在这里关闭连接
+  if (Server::try_send(client_, buffer_.data(), len) != 0) {
+    failed_ = true;
+    return -1;
+  }
+  sent_ = true;
+  return 0;
+}
+
+void ResultStreamBuf::discard()
+{
+  setp(buffer_.data(), buffer_.data() + buffer_.size());
+  stop_capture();
+}
+
+void ResultStreamBuf::start_capture(size_t max_size)
+{
+  // 只复制完整的结果，已经写过数据时不复制
+  capturing_ = !sent_ && pptr() == pbase();
+  capture_max_size_ = max_size;
+  capture_.clear();
+}
+
+void ResultStreamBuf::stop_capture()
+{
+  capturing_ = false;
+  std::string().swap(capture_);
+}
+
+bool ResultStreamBuf::finish_capture(std::string &output)
+{
+  if (!capturing_ || failed_ || capture_.size() + (pptr() - pbase()) > capture_max_size_) {
+    stop_capture();
+    return false;
+  }
+  capture_.append(pbase(), pptr() - pbase());
+  output.swap(capture_);
+  stop_capture();
+  return true;
+}
+
+ResultStreamBuf::int_type ResultStreamBuf::overflow(int_type ch)
+{
+  if (flush() != 0) {
+    return traits_type::eof();
+  }
+  if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+int ResultStreamBuf::sync()
+{
+  // std::endl也会调用sync，这里不发送，攒够一块再发
+  return failed_ ? -1 : 0;
+}
@@ -0,0 +1,99 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+
+#pragma once
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "net/connection_context.h"
+
+/**
+ * 把查询结果分块发送给客户端的streambuf，缓冲区满时才写socket，
+ * 客户端接收慢时写socket会等待，执行查询的线程也就随之放慢
+ */
+class ResultStreamBuf : public std::streambuf
+{
+public:
+  static const int CHUNK_SIZE = 64 * 1024;
+
+  explicit ResultStreamBuf(ConnectionContext *client);
+
+  /**
+   * 发送缓冲区中的所有数据
+   * @return 之前和本次发送都成功时返回0
+   */
+  int flush();
+
+  /**
+   * 丢弃还没有发送的数据，已经发送的数据无法撤回
+   */
+  void discard();
+
+  /**
+   * 发送的同时把结果复制一份，用于缓存查询结果。超过max_size时放弃复制
+   */
+  void start_capture(size_t max_size);
+  /**
+   * 放弃复制，比如查询失败，结果不完整
+   */
+  void stop_capture();
+  /**
+   * 取出复制的结果，包括缓冲区中还没有发送的部分
+   * @return 中途放弃了复制或者发送失败时返回false
+   */
+  bool finish_capture(std::string &output);
+
+  /**
+   * @return 是否已经有数据发送给了客户端
+   */
+  bool sent() const
+  {
+    return sent_;
+  }
+  bool failed() const
+  {
+    return failed_;
+  }
+
+protected:
+  int_type overflow(int_type ch) override;
+  int sync() override;
+
+private:
+  ConnectionContext *client_;
+  std::vector<char> buffer_;
+  bool sent_ = false;
+  bool failed_ = false;
+
+  bool capturing_ = false;
+  size_t capture_max_size_ = 0;
+  std::string capture_;
+};
+
+class ResultStream : public std::ostream
+{
+public:
+  explicit ResultStream(ConnectionContext *client) : std::ostream(nullptr), buf_(client)
+  {
+    rdbuf(&buf_);
+  }
+
+  ResultStreamBuf &buf()
+  {
+    return buf_;
+  }
+
+private:
+  ResultStreamBuf buf_;
+};
@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 #include <arpa/inet.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <stdio.h>
@@ -174,12 +175,47 @@ void Server::recv(int fd, short ev, void *arg)
   }
 
   LOG_INFO("receive command(size=%d): %s", data_len, client->buf);
+  // 请求执行期间不再读取，客户端断开时也不会在这里释放还在使用的连接，发送完结果后再恢复
+  event_del(&client->read_event);
   SessionEvent *sev = new SessionEvent(client);
   session_stage_->add_event(sev);
 }
 
-// 这个函数仅负责发送数据，至于是否是一个完整的消息，由调用者控制
-int Server::send(ConnectionContext *client, const char *buf, int data_len)
+// 客户端一直不接收数据时最多等待的时间
+static const int SEND_TIMEOUT_MS = 60 * 1000;
+
+static int write_all(int fd, const char *buf, int data_len)
+{
+  int wlen = 0;
+  while (wlen < data_len) {
+    // 客户端已经断开时不能产生SIGPIPE
+    int len = ::send(fd, buf + wlen, data_len - wlen, MSG_NOSIGNAL);
+    if (len >= 0) {
+      wlen += len;
+      continue;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      return -1;
+    }
+
+    // socket是非阻塞的，发送缓冲区满时等到可写再继续
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+    int ret = poll(&pfd, 1, SEND_TIMEOUT_MS);
+    if (ret == 0 || (ret < 0 && errno != EINTR)) {
+      LOG_WARN("Failed to wait for socket to be writable. ret=%d, errno=%d", ret, errno);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int Server::try_send(ConnectionContext *client, const char *buf, int data_len)
 {
   if (buf == nullptr || data_len == 0) {
     return 0;
@@ -188,24 +224,33 @@ int Server::send(ConnectionContext *client, const char *buf, int data_len)
   TimerStat writeStat(*write_socket_metric_);
 
   MUTEX_LOCK(&client->mutex);
-  int wlen = 0;
-  for (int i = 0; i < 3 && wlen < data_len; i++) {
-    int len = write(client->fd, buf + wlen, data_len - wlen);
-    if (len < 0) {
-      LOG_ERROR("Failed to send data back to client\n");
-      MUTEX_UNLOCK(&client->mutex);
-
-      close_connection(client);
-      return -STATUS_FAILED_NETWORK;
-    }
-    wlen += len;
+  int ret = write_all(client->fd, buf, data_len);
+  MUTEX_UNLOCK(&client->mutex);
+  if (ret != 0) {
+    LOG_ERROR("Failed to send data back to client. errno=%d", errno);
+    return -STATUS_FAILED_NETWORK;
   }
-  if (wlen < data_len) {
-    LOG_WARN("Not all data has been send back to client");
+  return 0;
+}
+
+// 这个函数仅负责发送数据，至于是否是一个完整的消息，由调用者控制
+int Server::send(ConnectionContext *client, const char *buf, int data_len)
+{
+  int ret = try_send(client, buf, data_len);
+  if (ret != 0) {
+    close_connection(client);
   }
+  return ret;
+}
 
-  MUTEX_UNLOCK(&client->mutex);
-  return 0;
+int Server::resume_read(ConnectionContext *client)
+{
+  int ret = event_add(&client->read_event, nullptr);
+  if (ret < 0) {
+    LOG_ERROR("Failed to event_add for read event of %s into libevent, %s", client->addr, strerror(errno));
+    close_connection(client);
+  }
+  return ret;
 }
 
 void Server::accept(int fd, short ev, void *arg)
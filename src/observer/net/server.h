@@ -28,7 +28,21 @@ public:
 
 public:
   static void init();
+  /**
+   * 发送失败时关闭连接
+   */
   static int send(ConnectionContext *client, const char *buf, int data_len);
+  /**
+   * 发送全部数据，socket缓冲区满时等待客户端接收。失败时不关闭连接，
+   * 用于请求还在执行、session还在使用的时候
+   */
+  static int try_send(ConnectionContext *client, const char *buf, int data_len);
+  // close connection
+  static void close_connection(ConnectionContext *client_context);
+  /**
+   * 一个请求的结果发送完后，继续接收这个连接上的下一个请求
+   */
+  static int resume_read(ConnectionContext *client);
 
 public:
   int serve();
@@ -36,8 +50,6 @@ public:
 
 private:
   static void accept(int fd, short ev, void *arg);
-  // close connection
-  static void close_connection(ConnectionContext *client_context);
   static void recv(int fd, short ev, void *arg);
 
 private:
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/trx/trx.h"
 #include "storage/common/db.h"
 #include "storage/default/default_handler.h"
+#include "sql/plan_cache/plan_cache.h"
 
 Session &Session::default_session()
 {
@@ -30,6 +31,10 @@ Session::~Session()
 {
   delete trx_;
   trx_ = nullptr;
+  for (auto &iter : prepared_plans_) {
+    delete iter.second;
+  }
+  prepared_plans_.clear();
 }
 
 const char *Session::get_current_db_name() const
@@ -75,3 +80,26 @@ Trx *Session::current_trx()
   }
   return trx_;
 }
+
+CachedPlan *Session::find_prepared_plan(const std::string &name) const
+{
+  auto iter = prepared_plans_.find(name);
+  return iter == prepared_plans_.end() ? nullptr : iter->second;
+}
+
+void Session::add_prepared_plan(const std::string &name, CachedPlan *plan)
+{
+  remove_prepared_plan(name);
+  prepared_plans_[name] = plan;
+}
+
+bool Session::remove_prepared_plan(const std::string &name)
+{
+  auto iter = prepared_plans_.find(name);
+  if (iter == prepared_plans_.end()) {
+    return false;
+  }
+  delete iter->second;
+  prepared_plans_.erase(iter);
+  return true;
+}
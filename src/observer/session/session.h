@@ -15,9 +15,11 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <string>
+#include <unordered_map>
 
 class Trx;
 class Db;
+class CachedPlan;
 
 class Session {
 public:
@@ -41,8 +43,16 @@ public:
 
   Trx *current_trx();
 
+  /**
+   * PREPARE的语句只在当前会话中可见，同名的语句会被替换
+   */
+  CachedPlan *find_prepared_plan(const std::string &name) const;
+  void add_prepared_plan(const std::string &name, CachedPlan *plan);
+  bool remove_prepared_plan(const std::string &name);
+
 private:
   Db *db_ = nullptr;
   Trx *trx_ = nullptr;
   bool trx_multi_operation_mode_ = false;  // 当前事务的模式，是否多语句模式. 单语句模式自动提交
+  std::unordered_map<std::string, CachedPlan *> prepared_plans_;
 };
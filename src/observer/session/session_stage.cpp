@@ -118,18 +118,29 @@ void SessionStage::callback_event(StageEvent *event, CallbackContext *context)
     return;
   }
 
+  // 结果流中剩余的数据先发出去。已经发出去一部分结果时不能再补一个终结符
+  if (sev->flush_result() != 0) {
+    Server::close_connection(sev->get_client());
+    return;
+  }
+
   const char *response = sev->get_response();
   int len = sev->get_response_len();
-  if (len <= 0 || response == nullptr) {
+  if (!sev->result_sent() && (len <= 0 || response == nullptr)) {
     response = "No data\n";
     len = strlen(response) + 1;
   }
-  Server::send(sev->get_client(), response, len);
-  if ('\0' != response[len - 1]) {
+  if (len > 0 && Server::send(sev->get_client(), response, len) != 0) {
+    return;
+  }
+  if (len <= 0 || '\0' != response[len - 1]) {
     // 这里强制性的给发送一个消息终结符，如果需要发送多条消息，需要调整
     char end = 0;
-    Server::send(sev->get_client(), &end, 1);
+    if (Server::send(sev->get_client(), &end, 1) != 0) {
+      return;
+    }
   }
+  Server::resume_read(sev->get_client());
 
   // sev->done();
   LOG_TRACE("Exit\n");
@@ -147,12 +158,14 @@ void SessionStage::handle_request(StageEvent *event)
   TimerStat sql_stat(*sql_metric_);
   if (nullptr == sev->get_request_buf()) {
     LOG_ERROR("Invalid request buffer.");
+    Server::resume_read(sev->get_client());
     sev->done_immediate();
     return;
   }
 
   std::string sql = sev->get_request_buf();
   if (common::is_blank(sql.c_str())) {
+    Server::resume_read(sev->get_client());
     sev->done_immediate();
     return;
   }
@@ -161,6 +174,7 @@ void SessionStage::handle_request(StageEvent *event)
   if (cb == nullptr) {
     LOG_ERROR("Failed to new callback for SessionEvent");
 
+    Server::resume_read(sev->get_client());
     sev->done_immediate();
     return;
   }
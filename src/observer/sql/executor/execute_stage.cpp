@@ -15,9 +15,13 @@ See the Mulan PSL v2 for more details. */
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <memory>
+#include <cstring>
+#include <thread>
 
 #include "execute_stage.h"
 
+#include "common/conf/ini.h"
 #include "common/io/io.h"
 #include "common/log/log.h"
 #include "common/lang/defer.h"
@@ -34,14 +38,27 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/delete_operator.h"
 #include "sql/operator/project_operator.h"
 #include "sql/operator/update_operator.h"
-#include "sql/operator/multi_select_operator.h"
+#include "sql/operator/join_operator.h"
 #include "sql/operator/aggregation_operator.h"
+#include "sql/operator/aggre_result.h"
+#include "sql/operator/hash_aggregation_operator.h"
+#include "sql/operator/sort_operator.h"
+#include "sql/operator/limit_operator.h"
+#include "sql/operator/semi_join_operator.h"
+#include "sql/operator/temp_relation.h"
+#include "sql/operator/batch_table_scan_operator.h"
+#include "sql/operator/batch_predicate_operator.h"
+#include "sql/operator/batch_project_operator.h"
+#include "sql/operator/batch_aggregation_operator.h"
 #include "sql/stmt/stmt.h"
 #include "sql/stmt/select_stmt.h"
 #include "sql/stmt/update_stmt.h"
 #include "sql/stmt/delete_stmt.h"
 #include "sql/stmt/insert_stmt.h"
 #include "sql/stmt/filter_stmt.h"
+#include "sql/optimizer/join_planner.h"
+#include "sql/optimizer/cost_model.h"
+#include "sql/plan_cache/plan_cache.h"
 #include "storage/common/table.h"
 #include "storage/common/field.h"
 #include "storage/index/index.h"
@@ -53,6 +70,13 @@ See the Mulan PSL v2 for more details. */
 
 using namespace common;
 
+const char *CONF_HASH_JOIN_MEMORY_BUDGET = "HashJoinMemoryBudget";
+const char *CONF_HASH_AGGREGATION_MEMORY_BUDGET = "HashAggregationMemoryBudget";
+const char *CONF_SORT_MEMORY_BUDGET = "SortMemoryBudget";
+const char *CONF_TEMP_RELATION_MEMORY_BUDGET = "TempRelationMemoryBudget";
+const char *CONF_VECTORIZED_EXECUTION = "VectorizedExecution";
+const char *CONF_PARALLEL_AGGREGATION_WORKERS = "ParallelAggregationWorkers";
+
 //RC create_selection_executor(
 //   Trx *trx, const Selects &selects, const char *db, const char *table_name, SelectExeNode &select_node);
 
@@ -79,14 +103,63 @@ Stage *ExecuteStage::make_stage(const std::string &tag)
 //! Set properties for this object set in stage specific properties
 bool ExecuteStage::set_properties()
 {
-  //  std::string stageNameStr(stageName);
-  //  std::map<std::string, std::string> section = theGlobalProperties()->get(
-  //    stageNameStr);
-  //
-  //  std::map<std::string, std::string>::iterator it;
-  //
-  //  std::string key;
+  std::string stageNameStr(stage_name_);
+  std::map<std::string, std::string> section = get_properties()->get(stageNameStr);
+
+  std::map<std::string, std::string>::iterator iter = section.find(CONF_HASH_JOIN_MEMORY_BUDGET);
+  if (iter != section.end()) {
+    int64_t memory_budget = 0;
+    if (str_to_val(iter->second, memory_budget) && memory_budget > 0) {
+      HashJoinOperator::set_default_memory_budget(memory_budget);
+      LOG_INFO("Use %lld bytes as hash join memory budget", (long long)memory_budget);
+    }
+  }
+
+  iter = section.find(CONF_HASH_AGGREGATION_MEMORY_BUDGET);
+  if (iter != section.end()) {
+    int64_t memory_budget = 0;
+    if (str_to_val(iter->second, memory_budget) && memory_budget > 0) {
+      HashAggregationOperator::set_default_memory_budget(memory_budget);
+      LOG_INFO("Use %lld bytes as hash aggregation memory budget", (long long)memory_budget);
+    }
+  }
+
+  iter = section.find(CONF_SORT_MEMORY_BUDGET);
+  if (iter != section.end()) {
+    int64_t memory_budget = 0;
+    if (str_to_val(iter->second, memory_budget) && memory_budget > 0) {
+      SortOperator::set_default_memory_budget(memory_budget);
+      LOG_INFO("Use %lld bytes as sort memory budget", (long long)memory_budget);
+    }
+  }
+
+  iter = section.find(CONF_TEMP_RELATION_MEMORY_BUDGET);
+  if (iter != section.end()) {
+    int64_t memory_budget = 0;
+    if (str_to_val(iter->second, memory_budget) && memory_budget > 0) {
+      TempRelation::set_default_memory_budget(memory_budget);
+      LOG_INFO("Use %lld bytes as temp relation memory budget", (long long)memory_budget);
+    }
+  }
+
+  iter = section.find(CONF_VECTORIZED_EXECUTION);
+  if (iter != section.end()) {
+    int vectorized = 1;
+    if (str_to_val(iter->second, vectorized)) {
+      vectorized_ = vectorized != 0;
+    }
+    LOG_INFO("Vectorized execution is %s", vectorized_ ? "enabled" : "disabled");
+  }
 
+  parallel_workers_ = std::max(1, (int)std::thread::hardware_concurrency());
+  iter = section.find(CONF_PARALLEL_AGGREGATION_WORKERS);
+  if (iter != section.end()) {
+    int workers = 0;
+    if (str_to_val(iter->second, workers) && workers > 0) {
+      parallel_workers_ = workers;
+    }
+  }
+  LOG_INFO("Use at most %d workers for parallel aggregation", parallel_workers_);
   return true;
 }
 
@@ -142,7 +215,11 @@ void ExecuteStage::handle_request(common::StageEvent *event)
   if (stmt != nullptr) {
     switch (stmt->type()) {
     case StmtType::SELECT: {
-      do_select(sql_event);
+      RC rc = do_select(sql_event);
+      if (rc != RC::SUCCESS && rc != RC::RECORD_EOF) {
+        // 失败时可能只输出了一部分结果，不能缓存
+        session_event->stop_capture_result();
+      }
     } break;
     case StmtType::INSERT: {
       do_insert(sql_event);
@@ -171,6 +248,9 @@ void ExecuteStage::handle_request(common::StageEvent *event)
     case SCF_DESC_TABLE: {
       do_desc_table(sql_event);
     } break;
+    case SCF_ANALYZE_TABLE: {
+      do_analyze_table(sql_event);
+    } break;
     case SCF_DROP_TABLE: {
       do_drop_table(sql_event);
     } break;
@@ -253,48 +333,134 @@ void print_tuple_header(std::ostream &os, const ProjectOperator &oper, const Sel
 
 }
 
-void print_tuple_header(std::ostream &os, const AggregationOperator &oper){
-  const int aggre_num = oper.aggre_num();
-  const char* types[4] = {"COUNT", "MAX", "MIN", "AVG"};
+static std::string aggregation_name(const Aggregation &aggregation)
+{
+  const char* types[5] = {"COUNT", "MAX", "MIN", "AVG", "SUM"};
+  std::string s = std::string(types[aggregation.type]) + "(" + std::string(aggregation.attr.attribute_name) + ")";
+  transform(s.begin(),s.end(),s.begin(),::toupper);
+  return s;
+}
+
+static void print_aggre_cell(std::ostream &os, const Aggregation &aggregation, const AggreResult &result)
+{
+  if(aggregation.type == COUNT){
+    os << result.count;
+  } else if (aggregation.type == AVG) {
+    os << (float)aggre_result_avg(result);
+  } else if (aggregation.type == SUM) {
+    if (result.count == 0) {
+      os << "NULL";
+    } else if (result.result.type == INTS) {
+      os << result.int_sum;
+    } else {
+      os << (float)result.float_sum;
+    }
+  } else if (result.result.data == nullptr) {
+    // 没有任何数据时MIN/MAX没有结果
+    os << "NULL";
+  } else if (aggregation.type == MIN || aggregation.type == MAX) {
+    std::string str;
+    value_to_string(str, result.result);
+    os << str;
+  }
+}
+
+void print_tuple_header(std::ostream &os, const std::vector<Aggregation> &aggregations){
+  const int aggre_num = aggregations.size();
   for(int i = 0; i < aggre_num; i++){
-    const Aggregation aggregation = oper.aggregations()[i];
-    const char* attribute_name = aggregation.attr.attribute_name;
-    const char* type = types[aggregation.type];
-    std::string s = std::string(type) + "(" + std::string( attribute_name) + ")";
-    transform(s.begin(),s.end(),s.begin(),::toupper);
     if(i != 0) {
       os << " | ";
     } 
-      os << s;
+    os << aggregation_name(aggregations[i]);
   }
   if (aggre_num > 0) {
     os << '\n';
   }
 }
 
-void print_aggre_result(std::ostream &os, const AggregationOperator &oper){
-  const int aggre_num = oper.aggre_num();
+/**
+ * 分组输出的第i列是不是聚合函数。聚合函数记录了自己在select列表中的位置，其它列都是分组字段
+ */
+static bool is_aggre_column(size_t i, const std::vector<Aggregation> &aggregations, size_t aggre_index,
+                            size_t field_index, size_t field_num)
+{
+  if (aggre_index >= aggregations.size()) {
+    return false;
+  }
+  return field_index >= field_num || aggregations[aggre_index].position <= (int)i;
+}
+
+/**
+ * 分组聚合的表头，字段和聚合函数按照select列表中的顺序输出
+ */
+void print_tuple_header(std::ostream &os, const std::vector<Field> &fields,
+                        const std::vector<Aggregation> &aggregations)
+{
+  size_t field_index = 0;
+  size_t aggre_index = 0;
+  for (size_t i = 0; i < fields.size() + aggregations.size(); i++) {
+    if (i != 0) {
+      os << " | ";
+    }
+    if (is_aggre_column(i, aggregations, aggre_index, field_index, fields.size())) {
+      os << aggregation_name(aggregations[aggre_index++]);
+    } else {
+      os << fields[field_index++].field_name();
+    }
+  }
+  if (!fields.empty() || !aggregations.empty()) {
+    os << '\n';
+  }
+}
+
+void print_aggre_result(std::ostream &os, const std::vector<Aggregation> &aggregations,
+                        const std::vector<AggreResult> &aggre_results){
+  const int aggre_num = aggregations.size();
   for(int i = 0; i < aggre_num; i++){
-    const Aggregation aggregation = oper.aggregations()[i];
-    const AggreResult result = oper.aggre_results()[i];
     if (i != 0){
       os << " | ";
     }
-    if(aggregation.type == COUNT){
-      os << result.count;
-    } else if (aggregation.type == AVG) {
-      os << result.avg;
-    } else if (aggregation.type == MIN || aggregation.type == MAX) {
-      std::string str;
-      value_to_string(str, result.result);
-      os << str;
-    }
+    print_aggre_cell(os, aggregations[i], aggre_results[i]);
   }
   if (aggre_num > 0) {
     os << '\n';
   }
 }
 
+/**
+ * 输出一个分组的结果，分组字段来自tuple，列的顺序与表头相同
+ */
+static void print_group_result(std::ostream &os, const Tuple &tuple, const std::vector<Aggregation> &aggregations,
+                               const std::vector<AggreResult> &aggre_results)
+{
+  const size_t field_num = tuple.cell_num();
+  size_t field_index = 0;
+  size_t aggre_index = 0;
+  TupleCell cell;
+  std::string str;
+  for (size_t i = 0; i < field_num + aggregations.size(); i++) {
+    if (i != 0) {
+      os << " | ";
+    }
+    if (is_aggre_column(i, aggregations, aggre_index, field_index, field_num)) {
+      print_aggre_cell(os, aggregations[aggre_index], aggre_results[aggre_index]);
+      aggre_index++;
+      continue;
+    }
+    RC rc = tuple.cell_at(field_index++, cell);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to fetch field of cell. index=%d, rc=%s", (int)field_index - 1, strrc(rc));
+      continue;
+    }
+    str.clear();
+    cell.to_string(str);
+    os << str;
+  }
+  if (field_num > 0 || !aggregations.empty()) {
+    os << '\n';
+  }
+}
+
 //测试用例中没有字符串类型，所以不做类型检查，只检查field是否存在
 RC check_expr(const ExpressionNode *expr, const std::vector<Table*> tables) {
   if(expr->left == nullptr && expr->right == nullptr) {
@@ -345,7 +511,10 @@ RC check_expr(const ExpressionNode *expr, const std::vector<Table*> tables) {
   return RC::SUCCESS;
 }
 
-void tuple_to_string(std::ostream &os, const Tuple &tuple)
+/**
+ * 把一行追加到line中。只在这里按投影取出需要输出的字段，line在整个查询中复用
+ */
+void tuple_to_string(std::string &line, const Tuple &tuple)
 {
   TupleCell cell;
   RC rc = RC::SUCCESS;
@@ -358,81 +527,49 @@ void tuple_to_string(std::ostream &os, const Tuple &tuple)
     }
 
     if (!first_field) {
-      os << " | ";
+      line += " | ";
     } else {
       first_field = false;
     }
-    cell.to_string(os);
+    cell.to_string(line);
   }
 }
 
-void tuple_to_string(std::ostream &os, const Tuple &tuple, const SelectStmt &select_stmt) {
-  std::vector<ExpressionNode> exprs = select_stmt.exprs();
-  std::vector<Table*> tables = select_stmt.tables();
+void tuple_to_string(std::string &line, const Tuple &tuple, const SelectStmt &select_stmt) {
+  const std::vector<CompiledExpr> &exprs = select_stmt.compiled_exprs();
   if(tuple.cell_num() != 0 && exprs.size() != 0) {
-    os << " | ";
+    line += " | ";
   }
+  ExprValue value;
   for(int i = 0; i < exprs.size(); i++) {
-    ExpressionNode expr = exprs[i];
-    Value value = cal_expr_value(expr, tuple, tables);
-    std::string str;
-    value_to_string(str, value);
     if(i != 0) {
-      os << " | ";
+      line += " | ";
     }
-    os << str;
-  }
-}
-
-//create a temp_table for multi select
-Table* create_temp_tale(Db *db, std::vector<Table*> tables){
-  RC rc = RC::SUCCESS;
-  const char *table_name = "temp_table";
-  int attribute_count = 0;
-  for(Table *table: tables){
-    TableMeta table_meta = table->table_meta();
-    
-    attribute_count += table_meta.field_num() - table_meta.sys_field_num();
-  }
-  AttrInfo *attributed = new AttrInfo[attribute_count];
-  int index = 0;
-  for(int i = 0; i < tables.size(); i++){
-    TableMeta table_meta = tables[i]->table_meta();
-    const char *table_name = table_meta.name();
-    const std::vector<FieldMeta> *field_metas = table_meta.field_metas();
-    for(int j = 0; j < field_metas->size() - table_meta.sys_field_num(); j++){
-        const FieldMeta field_meta = (*field_metas)[table_meta.sys_field_num() + j];
-        std::string s = std::string(table_name) + "." + std::string(field_meta.name());
-        char *field_name = new char[s.size() + 1];
-        std::strcpy(field_name, s.c_str());
-        attributed[index].name = (char*)field_name;
-        attributed[index].type = field_meta.type();
-        attributed[index].length = field_meta.len();
-        index++;
+    // 除数为0时输出空值
+    const AttrType type = exprs[i].evaluate(tuple, value);
+    if (type != UNDEFINED) {
+      TupleCell(type, (char *)&value).to_string(line);
     }
   }
-  
-  rc = db->create_table(table_name, attribute_count, attributed);
-  if(rc != RC::SUCCESS){
-    LOG_WARN("failed to create temp_table, rc=%s",strrc(rc));
-    return nullptr;
-  }
-  // temp_table = *(db->find_table(table_name));
-  return db->find_table(table_name);
 }
 
-IndexScanOperator *try_to_create_index_scan_operator(FilterStmt *filter_stmt)
+/**
+ * 选出用来做索引扫描的条件，只做判断，不创建算子
+ * @return 没有可用的索引或者扫描整个表代价更低时返回nullptr
+ */
+static const FilterUnit *choose_index_filter(const std::vector<const FilterUnit *> &filter_units)
 {
-  const std::vector<FilterUnit *> &filter_units = filter_stmt->filter_units();
   if (filter_units.empty() ) {
     return nullptr;
   }
 
   // 在所有过滤条件中，找到字段与值做比较的条件，然后判断字段是否可以使用索引
   // 如果是多列索引，这里的处理需要更复杂。
-  // 这里的查找规则是比较简单的，就是尽量找到使用相等比较的索引
+  // 有统计信息时选择估算结果最少的条件，并且只在比扫描整个表代价更低时才使用索引
+  // 没有统计信息时尽量找到使用相等比较的索引
   // 如果没有就找范围比较的，但是直接排除不等比较的索引查询. (你知道为什么?)
   const FilterUnit *better_filter = nullptr;
+  double better_selectivity = -1;
   for (const FilterUnit * filter_unit : filter_units) {
     if (filter_unit->comp() == NOT_EQUAL) {
       continue;
@@ -443,17 +580,34 @@ IndexScanOperator *try_to_create_index_scan_operator(FilterStmt *filter_stmt)
     if (left->type() == ExprType::FIELD && right->type() == ExprType::VALUE) {
     } else if (left->type() == ExprType::VALUE && right->type() == ExprType::FIELD) {
       std::swap(left, right);
+    } else {
+      continue;
     }
     FieldExpr &left_field_expr = *(FieldExpr *)left;
     const Field &field = left_field_expr.field();
     const Table *table = field.table();
     Index *index = table->find_index_by_field(field.field_name());
+    // 哈希索引只能处理等值比较
+    if (index != nullptr && index->index_meta().type() == HASH_INDEX && filter_unit->comp() != EQUAL_TO) {
+      index = nullptr;
+    }
     if (index != nullptr) {
-      if (better_filter == nullptr) {
+      const double selectivity = CostModel::column_selectivity(filter_unit);
+      if (selectivity >= 0) {
+        if (better_selectivity < 0 || selectivity < better_selectivity) {
+          better_filter = filter_unit;
+          better_selectivity = selectivity;
+        }
+      } else if (better_filter == nullptr) {
         better_filter = filter_unit;
-      } else if (filter_unit->comp() == EQUAL_TO) {
+      } else if (filter_unit->comp() == EQUAL_TO && better_selectivity < 0) {
+        better_filter = filter_unit;
+      }
+      // 唯一索引上的等值查询最多只有一行，不需要再找了
+      if (filter_unit->comp() == EQUAL_TO && index->index_meta().unique()) {
         better_filter = filter_unit;
-    	break;
+        better_selectivity = -1;
+        break;
       }
     }
   }
@@ -462,6 +616,27 @@ IndexScanOperator *try_to_create_index_scan_operator(FilterStmt *filter_stmt)
     return nullptr;
   }
 
+  Expression *field_expr = better_filter->left();
+  if (field_expr->type() != ExprType::FIELD) {
+    field_expr = better_filter->right();
+  }
+  const Field &field = static_cast<FieldExpr *>(field_expr)->field();
+  const Table *table = field.table();
+  if (better_selectivity >= 0 && !CostModel::index_scan_cheaper(table, better_selectivity)) {
+    LOG_INFO("table scan is cheaper than index %s. table=%s, selectivity=%.3f",
+             table->find_index_by_field(field.field_name())->index_meta().name(), table->name(), better_selectivity);
+    return nullptr;
+  }
+  return better_filter;
+}
+
+static IndexScanOperator *try_to_create_index_scan_operator(const std::vector<const FilterUnit *> &filter_units)
+{
+  const FilterUnit *better_filter = choose_index_filter(filter_units);
+  if (better_filter == nullptr) {
+    return nullptr;
+  }
+
   Expression *left = better_filter->left();
   Expression *right = better_filter->right();
   CompOp comp = better_filter->comp();
@@ -469,11 +644,11 @@ IndexScanOperator *try_to_create_index_scan_operator(FilterStmt *filter_stmt)
     std::swap(left, right);
     switch (comp) {
     case EQUAL_TO:    { comp = EQUAL_TO; }    break;
-    case LESS_EQUAL:  { comp = GREAT_THAN; }  break;
+    case LESS_EQUAL:  { comp = GREAT_EQUAL; } break;
     case NOT_EQUAL:   { comp = NOT_EQUAL; }   break;
-    case LESS_THAN:   { comp = GREAT_EQUAL; } break;
-    case GREAT_EQUAL: { comp = LESS_THAN; }   break;
-    case GREAT_THAN:  { comp = LESS_EQUAL; }  break;
+    case LESS_THAN:   { comp = GREAT_THAN; }  break;
+    case GREAT_EQUAL: { comp = LESS_EQUAL; }  break;
+    case GREAT_THAN:  { comp = LESS_THAN; }   break;
     default: {
     	LOG_WARN("should not happen");
     }
@@ -539,44 +714,553 @@ IndexScanOperator *try_to_create_index_scan_operator(FilterStmt *filter_stmt)
 
   IndexScanOperator *oper = new IndexScanOperator(table, index,
        left_cell, left_inclusive, right_cell, right_inclusive);
+  if (comp == EQUAL_TO && index->index_meta().unique()) {
+    oper->set_single_row(true);
+  }
 
   LOG_INFO("use index for scan: %s in table %s", index->index_meta().name(), table->name());
   return oper;
 }
 
-RC ExecuteStage::do_select(SQLStageEvent *sql_event)
+IndexScanOperator *try_to_create_index_scan_operator(FilterStmt *filter_stmt)
 {
-  SelectStmt *select_stmt = (SelectStmt *)(sql_event->stmt());
-  SessionEvent *session_event = sql_event->session_event();
-  RC rc = RC::SUCCESS;
-  if (select_stmt->tables().size() != 1) {
+  const std::vector<FilterUnit *> &filter_units = filter_stmt->filter_units();
+  return try_to_create_index_scan_operator(std::vector<const FilterUnit *>(filter_units.begin(), filter_units.end()));
+}
+
+static bool can_use_index_for_scan(FilterStmt *filter_stmt)
+{
+  const std::vector<FilterUnit *> &filter_units = filter_stmt->filter_units();
+  return choose_index_filter(std::vector<const FilterUnit *>(filter_units.begin(), filter_units.end())) != nullptr;
+}
+
+static bool index_covers_expr(const Index &index, const ExpressionNode *expr)
+{
+  if (expr == nullptr) {
+    return true;
+  }
+  if (expr->is_attr && !index.index_meta().covers(expr->attr.attribute_name)) {
+    return false;
+  }
+  return index_covers_expr(index, expr->left) && index_covers_expr(index, expr->right);
+}
+
+/**
+ * 单表查询用到的字段是否都保存在索引中，是的话索引扫描就不需要再回表读取记录
+ */
+static bool index_covers_select(const Index &index, SelectStmt *select_stmt)
+{
+  const IndexMeta &index_meta = index.index_meta();
+  if (!select_stmt->subquery_units().empty()) {
+    return false;
+  }
+  for (const Field &field : select_stmt->query_fields()) {
+    if (!index_meta.covers(field.field_name())) {
+      return false;
+    }
+  }
+
+  for (const Field &field : select_stmt->correlated_fields()) {
+    if (!index_meta.covers(field.field_name())) {
+      return false;
+    }
+  }
+
+  for (const FilterUnit *filter_unit : select_stmt->filter_stmt()->filter_units()) {
+    for (const Expression *expr : {filter_unit->left(), filter_unit->right()}) {
+      if (expr->type() == ExprType::FIELD && !index_meta.covers(((const FieldExpr *)expr)->field_name())) {
+        return false;
+      }
+    }
+  }
+
+  for (const Field &field : select_stmt->group_by_fields()) {
+    if (!index_meta.covers(field.field_name())) {
+      return false;
+    }
+  }
+
+  for (const Aggregation &aggregation : select_stmt->aggregations()) {
+    const char *attribute_name = aggregation.attr.attribute_name;
+    if (0 != strcmp(attribute_name, "*") && !index_meta.covers(attribute_name)) {
+      return false;
+    }
+  }
+
+  for (const ExpressionNode &expr : select_stmt->exprs()) {
+    if (!index_covers_expr(index, &expr)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * 只有一个排序字段并且字段上有B+树索引时，可以按照索引顺序输出
+ */
+static Index *find_index_for_order(SelectStmt *select_stmt)
+{
+  const std::vector<OrderByUnit> &order_by_units = select_stmt->order_by_units();
+  if (order_by_units.size() != 1) {
+    return nullptr;
+  }
+
+  const Field &field = order_by_units[0].field;
+  Index *index = field.table()->find_index_by_field(field.field_name());
+  if (index == nullptr || index->index_meta().type() != BPLUS_TREE_INDEX) {
+    return nullptr;
+  }
+  return index;
+}
+
+/**
+ * @param ordered 不为空时尽量使用索引顺序满足ORDER BY，返回扫描结果是否已经有序
+ */
+static Operator *create_scan_operator(SelectStmt *select_stmt, bool *ordered = nullptr)
+{
+  IndexScanOperator *index_scan_oper = try_to_create_index_scan_operator(select_stmt->filter_stmt());
+
+  Index *order_index = ordered != nullptr ? find_index_for_order(select_stmt) : nullptr;
+  if (order_index != nullptr) {
+    const bool asc = select_stmt->order_by_units()[0].asc;
+    if (index_scan_oper == nullptr) {
+      // 没有可以用来过滤的索引，就扫描整个排序索引
+      index_scan_oper = new IndexScanOperator(select_stmt->tables()[0], order_index, nullptr, false, nullptr, false);
+    }
+    if (index_scan_oper->index() == order_index) {
+      LOG_INFO("use index order for order by: %s, asc=%d", order_index->index_meta().name(), asc);
+      index_scan_oper->set_reverse(!asc);
+      *ordered = true;
+    }
+  }
+
+  if (nullptr == index_scan_oper) {
+    return new TableScanOperator(select_stmt->tables()[0]);
+  }
+
+  if (index_covers_select(*index_scan_oper->index(), select_stmt)) {
+    LOG_INFO("use index only scan: %s", index_scan_oper->index()->index_meta().name());
+    index_scan_oper->set_index_only(true);
+  }
+  return index_scan_oper;
+}
+
+/**
+ * 没有过滤条件，并且只有MIN/MAX聚合，聚合字段上都有B+树索引
+ */
+static bool can_use_index_for_min_max(SelectStmt *select_stmt)
+{
+  if (!select_stmt->filter_stmt()->filter_units().empty() || !select_stmt->subquery_units().empty()) {
+    return false;
+  }
 
-    PredicateOperator inner_pred_oper(select_stmt->filter_stmt());
-    MultiSelectOperator multi_select_oper(&inner_pred_oper);
+  const Table *table = select_stmt->tables()[0];
+  for (const Aggregation &aggregation : select_stmt->aggregations()) {
+    if (aggregation.type != MIN && aggregation.type != MAX) {
+      return false;
+    }
+    Index *index = table->find_index_by_field(aggregation.attr.attribute_name);
+    if (index == nullptr || index->index_meta().type() != BPLUS_TREE_INDEX) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * 按照优化器生成的join_steps构造左深的连接树，创建的算子都保存在operators中
+ * 下推的单表条件在扫描时过滤，其它条件在涉及的表都连接之后过滤
+ */
+static Operator *create_join_operator(SelectStmt *select_stmt, std::vector<std::unique_ptr<Operator>> &operators)
+{
+  if (select_stmt->join_steps().size() != select_stmt->tables().size()) {
+    JoinPlanner::plan(select_stmt);
+  }
+
+  auto add_predicate = [&operators](Operator *child, const std::vector<const FilterUnit *> &filters) {
+    if (filters.empty()) {
+      return child;
+    }
+    PredicateOperator *pred_oper = new PredicateOperator(filters);
+    pred_oper->add_child(child);
+    operators.emplace_back(pred_oper);
+    return (Operator *)pred_oper;
+  };
+  auto add_scan = [&operators, &add_predicate](const JoinStep &step, Index *order_index) {
+    Operator *scan_oper = nullptr;
+    if (order_index != nullptr) {
+      scan_oper = new IndexScanOperator(step.table, order_index, nullptr, false, nullptr, false);
+    } else {
+      scan_oper = try_to_create_index_scan_operator(step.table_filters);
+      if (scan_oper == nullptr) {
+        scan_oper = new TableScanOperator(step.table);
+      }
+    }
+    operators.emplace_back(scan_oper);
+    return add_predicate(scan_oper, step.table_filters);
+  };
+
+  const std::vector<JoinStep> &steps = select_stmt->join_steps();
+  Index *first_order_index = steps[1].method == JoinMethod::SORT_MERGE ? steps[1].joined_index : nullptr;
+  Operator *joined_oper = add_scan(steps[0], first_order_index);
+  std::vector<Table *> joined_tables = {steps[0].table};
+
+  for (size_t i = 1; i < steps.size(); i++) {
+    const JoinStep &step = steps[i];
+    Table *table = step.table;
+    Operator *join_oper = nullptr;
+    switch (step.method) {
+      case JoinMethod::NESTED_LOOP: {
+        join_oper = new NestedLoopJoinOperator(joined_oper, joined_tables, add_scan(step, nullptr), {table});
+      } break;
+      case JoinMethod::HASH: {
+        Operator *table_oper = add_scan(step, nullptr);
+        if (step.build_table) {
+          join_oper = new HashJoinOperator(table_oper, {table}, joined_oper, joined_tables,
+                                           step.table_keys, step.joined_keys);
+        } else {
+          join_oper = new HashJoinOperator(joined_oper, joined_tables, table_oper, {table},
+                                           step.joined_keys, step.table_keys);
+        }
+      } break;
+      case JoinMethod::INDEX_NESTED_LOOP: {
+        join_oper = new IndexNestedLoopJoinOperator(joined_oper, joined_tables, table, step.index,
+                                                    step.joined_keys[0], step.table_keys[0]);
+      } break;
+      case JoinMethod::SORT_MERGE: {
+        SortMergeJoinOperator *merge_oper = new SortMergeJoinOperator(joined_oper, joined_tables,
+            add_scan(step, step.index), {table}, step.joined_keys, step.table_keys);
+        merge_oper->set_sorted(step.joined_index != nullptr, step.index != nullptr);
+        join_oper = merge_oper;
+      } break;
+    }
+    LOG_INFO("use %s for table %s", JoinPlanner::method_name(step.method), table->name());
 
-    std::vector<Table*> tables;
-    for (Table *table : select_stmt->tables()){
-      Operator *scan_oper = new TableScanOperator(table);
-      PredicateOperator *pred_oper = new PredicateOperator(select_stmt->filter_stmt());
+    operators.emplace_back(join_oper);
+    joined_oper = add_predicate(join_oper, step.join_filters);
+    joined_tables.push_back(table);
+  }
+  return joined_oper;
+}
+
+/**
+ * 把子查询改写成半连接或者反连接，每个子查询只执行一次，而不是对外层的每一行都执行
+ * 相关子查询的关联字段作为连接字段，聚合的子查询按关联字段分组。创建的算子都保存在operators中
+ */
+static Operator *add_subquery_operators(
+    SelectStmt *select_stmt, Operator *input, std::vector<std::unique_ptr<Operator>> &operators)
+{
+  for (const SubqueryUnit *unit : select_stmt->subquery_units()) {
+    SelectStmt *inner_stmt = unit->select_stmt();
+    Operator *inner_oper = nullptr;
+    if (inner_stmt->tables().size() != 1) {
+      inner_oper = create_join_operator(inner_stmt, operators);
+    } else {
+      Operator *scan_oper = create_scan_operator(inner_stmt);
+      operators.emplace_back(scan_oper);
+      PredicateOperator *pred_oper = new PredicateOperator(inner_stmt->filter_stmt());
       pred_oper->add_child(scan_oper);
-      multi_select_oper.add_child(scan_oper);
+      operators.emplace_back(pred_oper);
+      inner_oper = pred_oper;
+    }
+    inner_oper = add_subquery_operators(inner_stmt, inner_oper, operators);
+
+    HashAggregationOperator *aggre_oper = nullptr;
+    if (!inner_stmt->aggregations().empty()) {
+      aggre_oper = new HashAggregationOperator(unit->inner_keys(), inner_stmt->aggregations(), inner_stmt->tables()[0]);
+      aggre_oper->add_child(inner_oper);
+      operators.emplace_back(aggre_oper);
+      inner_oper = aggre_oper;
+    }
 
+    const CompOp comp = unit->comp();
+    SemiJoinOperator *semi_oper = new SemiJoinOperator(input, inner_oper, comp == NOT_IN_OP || comp == NOT_EXISTS_OP);
+    if (comp == IN_OP || comp == NOT_IN_OP) {
+      semi_oper->add_key(unit->left(), inner_stmt->query_fields()[0]);
+    }
+    for (size_t i = 0; i < unit->outer_keys().size(); i++) {
+      semi_oper->add_key(unit->outer_keys()[i], unit->inner_keys()[i]);
+    }
+    if (comp < NO_OP) {
+      if (aggre_oper != nullptr) {
+        semi_oper->set_compare(comp, unit->left(), aggre_oper);
+      } else {
+        semi_oper->set_compare(comp, unit->left(), inner_stmt->query_fields()[0]);
+      }
     }
+    operators.emplace_back(semi_oper);
+    input = semi_oper;
+  }
+  return input;
+}
 
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("cannot construct filter stmt");
-      return rc;
+/**
+ * 单表查询，没有排序和表达式，条件和聚合都有向量化的实现，并且不会使用索引时，可以按批执行
+ */
+static bool can_select_in_batch(SelectStmt *select_stmt)
+{
+  // LIMIT在按行执行时可以提前结束扫描
+  if (select_stmt->tables().size() != 1 || !select_stmt->order_by_units().empty() || !select_stmt->exprs().empty() ||
+      !select_stmt->group_by_fields().empty() || select_stmt->limit() >= 0 ||
+      !select_stmt->subquery_units().empty()) {
+    return false;
+  }
+  const std::vector<FilterUnit *> &filter_units = select_stmt->filter_stmt()->filter_units();
+  if (!BatchPredicateOperator::can_filter({filter_units.begin(), filter_units.end()})) {
+    return false;
+  }
+  if (can_use_index_for_scan(select_stmt->filter_stmt())) {
+    return false;
+  }
+  if (!select_stmt->aggregations().empty()) {
+    return BatchAggregationOperator::can_aggregate(select_stmt->aggregations(), select_stmt->tables()[0]) &&
+           !can_use_index_for_min_max(select_stmt);
+  }
+  return true;
+}
+
+/**
+ * 输出、过滤和聚合用到的所有字段，按批扫描时只读取这些字段
+ */
+static std::vector<Field> batch_scan_fields(SelectStmt *select_stmt)
+{
+  Table *table = select_stmt->tables()[0];
+  std::vector<Field> fields;
+  auto add_field = [&fields, table](const FieldMeta *field_meta) {
+    for (const Field &field : fields) {
+      if (field.meta() == field_meta) {
+        return;
+      }
     }
-    
-    PredicateOperator out_pred_oper(select_stmt->filter_stmt());
-    out_pred_oper.add_child(&multi_select_oper);
+    fields.push_back(Field(table, field_meta));
+  };
+
+  for (const Field &field : select_stmt->query_fields()) {
+    add_field(field.meta());
+  }
+  for (const FilterUnit *filter_unit : select_stmt->filter_stmt()->filter_units()) {
+    for (const Expression *expr : {filter_unit->left(), filter_unit->right()}) {
+      if (expr->type() == ExprType::FIELD) {
+        add_field(static_cast<const FieldExpr *>(expr)->field().meta());
+      }
+    }
+  }
+  for (const Aggregation &aggregation : select_stmt->aggregations()) {
+    const FieldMeta *field_meta = table->table_meta().field(aggregation.attr.attribute_name);
+    if (field_meta != nullptr) {
+      add_field(field_meta);
+    }
+  }
+  return fields;
+}
+
+/**
+ * 单表聚合按页面分段并行扫描，每个线程有自己的扫描和过滤算子，聚合算子最后合并各线程的部分结果
+ */
+static RC do_batch_aggregate(SelectStmt *select_stmt, std::ostream &os, int workers)
+{
+  Table *table = select_stmt->tables()[0];
+  const std::vector<FilterUnit *> &filter_units = select_stmt->filter_stmt()->filter_units();
+  const std::vector<Field> scan_fields = batch_scan_fields(select_stmt);
+
+  ParallelRecordScan parallel_scan;
+  RC rc = table->get_parallel_scan(parallel_scan);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  // 页面太少时并行没有收益
+  const int morsels = (parallel_scan.page_count() + ParallelRecordScan::MORSEL_PAGES - 1) /
+                      ParallelRecordScan::MORSEL_PAGES;
+  workers = std::max(1, std::min(workers, morsels));
+  if (workers > 1) {
+    LOG_INFO("aggregate table %s with %d workers. pages=%d", table->name(), workers, parallel_scan.page_count());
+  }
+
+  std::vector<std::unique_ptr<BatchTableScanOperator>> scan_opers;
+  std::vector<std::unique_ptr<BatchPredicateOperator>> pred_opers;
+  BatchAggregationOperator aggre_oper(select_stmt->aggregations(), table);
+  for (int i = 0; i < workers; i++) {
+    scan_opers.emplace_back(new BatchTableScanOperator(table, scan_fields));
+    scan_opers.back()->set_parallel_scan(&parallel_scan);
+    pred_opers.emplace_back(new BatchPredicateOperator({filter_units.begin(), filter_units.end()}));
+    pred_opers.back()->add_child(scan_opers.back().get());
+    aggre_oper.add_child(pred_opers.back().get());
+  }
+
+  if ((rc = aggre_oper.open()) != RC::SUCCESS) {
+    LOG_WARN("failed to open operator. rc=%s", strrc(rc));
+    aggre_oper.close();
+    return rc;
+  }
+  ColumnBatch *batch = nullptr;
+  rc = aggre_oper.next_batch(batch);
+  aggre_oper.close();
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("something wrong while aggregating. rc=%s", strrc(rc));
+    return rc;
+  }
+  print_tuple_header(os, aggre_oper.aggregations());
+  print_aggre_result(os, aggre_oper.aggregations(), aggre_oper.aggre_results());
+  return rc;
+}
+
+static RC do_batch_select(SelectStmt *select_stmt, std::ostream &os, int workers)
+{
+  if (!select_stmt->aggregations().empty()) {
+    return do_batch_aggregate(select_stmt, os, workers);
+  }
+
+  const std::vector<FilterUnit *> &filter_units = select_stmt->filter_stmt()->filter_units();
+  BatchTableScanOperator scan_oper(select_stmt->tables()[0], batch_scan_fields(select_stmt));
+  BatchPredicateOperator pred_oper({filter_units.begin(), filter_units.end()});
+  pred_oper.add_child(&scan_oper);
+
+  RC rc = RC::SUCCESS;
+  BatchProjectOperator project_oper(select_stmt->query_fields());
+  project_oper.add_child(&pred_oper);
+  if ((rc = project_oper.open()) != RC::SUCCESS) {
+    LOG_WARN("failed to open operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  // 表头与按行执行时一致
+  ProjectOperator header_oper;
+  for (const Field &field : select_stmt->query_fields()) {
+    header_oper.add_projection(field.table(), field.meta(), false);
+  }
+  print_tuple_header(os, header_oper, *select_stmt);
+
+  ColumnBatch *batch = nullptr;
+  std::string lines;
+  while ((rc = project_oper.next_batch(batch)) == RC::SUCCESS) {
+    lines.clear();
+    for (int row = 0; row < batch->size(); row++) {
+      for (int i = 0; i < batch->column_num(); i++) {
+        const ColumnVector &column = batch->column(i);
+        TupleCell cell(column.type(), const_cast<char *>(column.value(row)));
+        cell.set_length(column.width());
+        if (i != 0) {
+          lines += " | ";
+        }
+        cell.to_string(lines);
+      }
+      lines += '\n';
+    }
+    os.write(lines.data(), lines.size());
+    if (!os) {
+      rc = RC::IOERR_WRITE;
+      LOG_WARN("failed to send result to client. rc=%s", strrc(rc));
+      break;
+    }
+  }
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("something wrong while iterate operator. rc=%s", strrc(rc));
+    project_oper.close();
+  } else {
+    rc = project_oper.close();
+  }
+  return rc;
+}
+
+/**
+ * 有LIMIT时在input上面加一个LimitOperator。input是排序算子时排序只需要保留前limit+offset行
+ * @return 新的输入算子
+ */
+static Operator *add_limit_operator(
+    SelectStmt *select_stmt, Operator *input, SortOperator &sort_oper, LimitOperator &limit_oper)
+{
+  if (select_stmt->limit() < 0) {
+    return input;
+  }
+  if (input == &sort_oper) {
+    sort_oper.set_limit((int64_t)select_stmt->limit() + select_stmt->offset());
+  }
+  limit_oper.add_child(input);
+  return &limit_oper;
+}
+
+RC do_group_select(SelectStmt *select_stmt, std::ostream &os)
+{
+  Operator *scan_oper = create_scan_operator(select_stmt);
+  DEFER([&] () {delete scan_oper;});
+  PredicateOperator pred_oper(select_stmt->filter_stmt());
+  pred_oper.add_child(scan_oper);
+  std::vector<std::unique_ptr<Operator>> subquery_operators;
+  HashAggregationOperator aggre_oper(select_stmt->group_by_fields(), select_stmt->aggregations(),
+                                     select_stmt->tables()[0]);
+  aggre_oper.add_child(add_subquery_operators(select_stmt, &pred_oper, subquery_operators));
+  LimitOperator limit_oper(select_stmt->limit(), select_stmt->offset());
+  ProjectOperator project_oper;
+  if (select_stmt->limit() >= 0) {
+    limit_oper.add_child(&aggre_oper);
+    project_oper.add_child(&limit_oper);
+  } else {
+    project_oper.add_child(&aggre_oper);
+  }
+  for (const Field &field : select_stmt->query_fields()) {
+    project_oper.add_projection(field.table(), field.meta(), false);
+  }
+  RC rc = project_oper.open();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  print_tuple_header(os, select_stmt->query_fields(), aggre_oper.aggregations());
+  while ((rc = project_oper.next()) == RC::SUCCESS) {
+    print_group_result(os, *project_oper.current_tuple(), aggre_oper.aggregations(), aggre_oper.aggre_results());
+    if (!os) {
+      rc = RC::IOERR_WRITE;
+      LOG_WARN("failed to send result to client. rc=%s", strrc(rc));
+      break;
+    }
+  }
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("something wrong while iterate operator. rc=%s", strrc(rc));
+    project_oper.close();
+  } else {
+    rc = project_oper.close();
+  }
+  return rc;
+}
+
+/**
+ * 查询中途失败时丢弃还没有发送的结果。已经发给客户端的部分无法撤回，FAILURE跟在后面
+ */
+static void set_select_failure(SessionEvent *session_event)
+{
+  session_event->discard_result();
+  session_event->result_stream() << "FAILURE\n";
+}
+
+RC ExecuteStage::do_select(SQLStageEvent *sql_event)
+{
+  SelectStmt *select_stmt = (SelectStmt *)(sql_event->stmt());
+  SessionEvent *session_event = sql_event->session_event();
+  RC rc = RC::SUCCESS;
+  if (select_stmt->tables().size() != 1) {
+    std::vector<std::unique_ptr<Operator>> join_operators;
+    Operator *join_oper = create_join_operator(select_stmt, join_operators);
+    join_oper = add_subquery_operators(select_stmt, join_oper, join_operators);
+
+    SortOperator sort_oper(select_stmt->tables(), select_stmt->order_by_units());
+    sort_oper.add_child(join_oper);
+    Operator *input = join_oper;
+    if (!select_stmt->order_by_units().empty()) {
+      input = &sort_oper;
+    }
+    LimitOperator limit_oper(select_stmt->limit(), select_stmt->offset());
+    input = add_limit_operator(select_stmt, input, sort_oper, limit_oper);
     ProjectOperator project_oper;
-    project_oper.add_child(&out_pred_oper);
+    project_oper.add_child(input);
 
     
     rc = project_oper.open();
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to open operator");
+      set_select_failure(session_event);
       return rc;
     }
 
@@ -584,20 +1268,26 @@ RC ExecuteStage::do_select(SQLStageEvent *sql_event)
       project_oper.add_projection(field.table(), field.meta(), true);
     }
     
-    std::stringstream ss;
-    print_tuple_header(ss, project_oper, *select_stmt);
-    while ((rc = project_oper.next()) != RC::RECORD_EOF) {
-      if(rc == RC::SUCCESS){
-        Tuple * tuple = project_oper.current_tuple();
-        if (nullptr == tuple) {
-          rc = RC::INTERNAL;
-          LOG_WARN("failed to get current record. rc=%s", strrc(rc));
-          break;
-        }
-        
-        tuple_to_string(ss, *tuple);
-        tuple_to_string(ss, *tuple, *select_stmt);
-        ss << std::endl;
+    std::ostream &os = session_event->result_stream();
+    print_tuple_header(os, project_oper, *select_stmt);
+    std::string line;
+    while ((rc = project_oper.next()) == RC::SUCCESS) {
+      Tuple * tuple = project_oper.current_tuple();
+      if (nullptr == tuple) {
+        rc = RC::INTERNAL;
+        LOG_WARN("failed to get current record. rc=%s", strrc(rc));
+        break;
+      }
+
+      line.clear();
+      tuple_to_string(line, *tuple);
+      tuple_to_string(line, *tuple, *select_stmt);
+      line += '\n';
+      os.write(line.data(), line.size());
+      if (!os) {
+        rc = RC::IOERR_WRITE;
+        LOG_WARN("failed to send result to client. rc=%s", strrc(rc));
+        break;
       }
     }
    
@@ -607,61 +1297,81 @@ RC ExecuteStage::do_select(SQLStageEvent *sql_event)
     } else {
       rc = project_oper.close();
     }
-    session_event->set_response(ss.str());
-    
-    LOG_ERROR("ss: \n%s", ss.str().c_str());
+    return rc;
+  } else if (vectorized_ && can_select_in_batch(select_stmt)) {
+    LOG_INFO("use vectorized execution for table %s", select_stmt->tables()[0]->name());
+    rc = do_batch_select(select_stmt, session_event->result_stream(), parallel_workers_);
+    if (rc != RC::SUCCESS && rc != RC::RECORD_EOF) {
+      set_select_failure(session_event);
+    }
+    return rc;
+  } else if (!select_stmt->group_by_fields().empty()) {
+    rc = do_group_select(select_stmt, session_event->result_stream());
+    if (rc != RC::SUCCESS && rc != RC::RECORD_EOF) {
+      set_select_failure(session_event);
+    }
     return rc;
   } else if(select_stmt->aggregations().size() != 0){ //aggregation func
-      Operator *scan_oper = try_to_create_index_scan_operator(select_stmt->filter_stmt());
-      if (nullptr == scan_oper) {
-        scan_oper = new TableScanOperator(select_stmt->tables()[0]);
-      }
+      Operator *scan_oper = create_scan_operator(select_stmt);
 
       DEFER([&] () {delete scan_oper;});
       PredicateOperator pred_oper(select_stmt->filter_stmt());
       pred_oper.add_child(scan_oper);
+      std::vector<std::unique_ptr<Operator>> subquery_operators;
       
       AggregationOperator aggre_oper(select_stmt->aggregations(), select_stmt->tables()[0]);
-      aggre_oper.add_child(&pred_oper);
+      aggre_oper.add_child(add_subquery_operators(select_stmt, &pred_oper, subquery_operators));
+      aggre_oper.set_use_index(can_use_index_for_min_max(select_stmt));
       if((rc = aggre_oper.open()) != RC::SUCCESS){
         session_event->set_response("FAILURE\n");
         return rc;
       }
-      std::stringstream ss;
-      print_tuple_header(ss, aggre_oper);
+      std::ostream &os = session_event->result_stream();
+      print_tuple_header(os, aggre_oper.aggregations());
       while((rc = aggre_oper.next()) == RC::SUCCESS){
 
       }
       // for(int i = 0; i < aggre_oper.aggre_results().size(); i++){
         // LOG_ERROR("min: %s", (char*)(aggre_oper.aggre_results()[0].result.data));
       // }
-      print_aggre_result(ss, aggre_oper);
-      session_event->set_response(ss.str());
+      // 聚合只有一行结果
+      if (select_stmt->limit() < 0 || (select_stmt->limit() > 0 && select_stmt->offset() == 0)) {
+        print_aggre_result(os, aggre_oper.aggregations(), aggre_oper.aggre_results());
+      }
       return rc;
 
   } else {
-      Operator *scan_oper = try_to_create_index_scan_operator(select_stmt->filter_stmt());
-      if (nullptr == scan_oper) {
-        scan_oper = new TableScanOperator(select_stmt->tables()[0]);
-      }
+      bool ordered = false;
+      Operator *scan_oper = create_scan_operator(select_stmt, &ordered);
 
       DEFER([&] () {delete scan_oper;});
       
       PredicateOperator pred_oper(select_stmt->filter_stmt());
       pred_oper.add_child(scan_oper);
+      std::vector<std::unique_ptr<Operator>> subquery_operators;
+      Operator *input = add_subquery_operators(select_stmt, &pred_oper, subquery_operators);
+      SortOperator sort_oper(select_stmt->tables(), select_stmt->order_by_units());
+      sort_oper.add_child(input);
+      if (!select_stmt->order_by_units().empty() && !ordered) {
+        input = &sort_oper;
+      }
+      LimitOperator limit_oper(select_stmt->limit(), select_stmt->offset());
+      input = add_limit_operator(select_stmt, input, sort_oper, limit_oper);
       ProjectOperator project_oper;
-      project_oper.add_child(&pred_oper);
+      project_oper.add_child(input);
       for (const Field &field : select_stmt->query_fields()) {
         project_oper.add_projection(field.table(), field.meta(), false);
       }
       rc = project_oper.open();
       if (rc != RC::SUCCESS) {
         LOG_WARN("failed to open operator");
+        set_select_failure(session_event);
         return rc;
       }
 
-      std::stringstream ss;
-      print_tuple_header(ss, project_oper, *select_stmt);
+      std::ostream &os = session_event->result_stream();
+      print_tuple_header(os, project_oper, *select_stmt);
+      std::string line;
       while ((rc = project_oper.next()) == RC::SUCCESS) {
         // get current record
         // write to response
@@ -671,9 +1381,16 @@ RC ExecuteStage::do_select(SQLStageEvent *sql_event)
           LOG_WARN("failed to get current record. rc=%s", strrc(rc));
           break;
         }
-        tuple_to_string(ss, *tuple);
-        tuple_to_string(ss, *tuple, *select_stmt);
-        ss << std::endl;
+        line.clear();
+        tuple_to_string(line, *tuple);
+        tuple_to_string(line, *tuple, *select_stmt);
+        line += '\n';
+        os.write(line.data(), line.size());
+        if (!os) {
+          rc = RC::IOERR_WRITE;
+          LOG_WARN("failed to send result to client. rc=%s", strrc(rc));
+          break;
+        }
       }
 
       if (rc != RC::RECORD_EOF) {
@@ -682,7 +1399,6 @@ RC ExecuteStage::do_select(SQLStageEvent *sql_event)
       } else {
         rc = project_oper.close();
       }
-      session_event->set_response(ss.str());
       return rc;
     }
   
@@ -733,6 +1449,7 @@ RC ExecuteStage::do_drop_table(SQLStageEvent *sql_event)
   Db *db = session_event->session()->get_current_db();
   RC rc = db->drop_table(drop_table.relation_name);
   if (rc == RC::SUCCESS) {
+    PlanCache::instance().invalidate(db->name(), drop_table.relation_name);
     session_event->set_response("SUCCESS\n");
   } else {
     session_event->set_response("FAILURE\n");
@@ -751,7 +1468,16 @@ RC ExecuteStage::do_create_index(SQLStageEvent *sql_event)
     return RC::SCHEMA_TABLE_NOT_EXIST;
   }
 
-  RC rc = table->create_index(nullptr, create_index.index_name, create_index.attribute_name);
+  std::vector<std::string> include_fields;
+  for (size_t i = 0; i < create_index.include_num; i++) {
+    include_fields.push_back(create_index.include_attributes[i]);
+  }
+  RC rc = table->create_index(nullptr, create_index.index_name, create_index.attribute_name,
+                              create_index.unique != 0, include_fields, create_index.index_type);
+  if (rc == RC::SUCCESS) {
+    // 表的元数据换成了新的，缓存的Stmt中的字段指针不能再用
+    PlanCache::instance().invalidate(db->name(), create_index.relation_name);
+  }
   sql_event->session_event()->set_response(rc == RC::SUCCESS ? "SUCCESS\n" : "FAILURE\n");
   return rc;
 }
@@ -790,6 +1516,25 @@ RC ExecuteStage::do_desc_table(SQLStageEvent *sql_event)
   return RC::SUCCESS;
 }
 
+RC ExecuteStage::do_analyze_table(SQLStageEvent *sql_event)
+{
+  SessionEvent *session_event = sql_event->session_event();
+  Db *db = session_event->session()->get_current_db();
+  const char *table_name = sql_event->query()->sstr.analyze_table.relation_name;
+  Table *table = db->find_table(table_name);
+  if (nullptr == table) {
+    session_event->set_response("FAILURE\n");
+    return RC::SCHEMA_TABLE_NOT_EXIST;
+  }
+
+  RC rc = table->analyze(nullptr);
+  if (rc == RC::SUCCESS) {
+    PlanCache::instance().invalidate(db->name(), table_name);
+  }
+  session_event->set_response(rc == RC::SUCCESS ? "SUCCESS\n" : "FAILURE\n");
+  return rc;
+}
+
 RC ExecuteStage::do_insert(SQLStageEvent *sql_event)
 {
   Stmt *stmt = sql_event->stmt();
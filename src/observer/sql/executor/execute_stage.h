@@ -15,6 +15,8 @@ See the Mulan PSL v2 for more details. */
 #ifndef __OBSERVER_SQL_EXECUTE_STAGE_H__
 #define __OBSERVER_SQL_EXECUTE_STAGE_H__
 
+#include <ostream>
+
 #include "common/seda/stage.h"
 #include "sql/parser/parse.h"
 #include "rc.h"
@@ -22,6 +24,19 @@ See the Mulan PSL v2 for more details. */
 class SQLStageEvent;
 class SessionEvent;
 class SelectStmt;
+class FilterStmt;
+class IndexScanOperator;
+
+/**
+ * 在过滤条件中找一个可以走索引的字段与值的比较，"值 op 字段"按照对称的比较处理。
+ * 没有合适的条件或者扫描整个表更合算时返回nullptr
+ */
+IndexScanOperator *try_to_create_index_scan_operator(FilterStmt *filter_stmt);
+
+/**
+ * 执行带GROUP BY的单表查询，分组字段和聚合函数按照select列表中的顺序输出
+ */
+RC do_group_select(SelectStmt *select_stmt, std::ostream &os);
 
 class ExecuteStage : public common::Stage {
 public:
@@ -45,6 +60,7 @@ protected:
   RC do_create_index(SQLStageEvent *sql_event);
   RC do_show_tables(SQLStageEvent *sql_event);
   RC do_desc_table(SQLStageEvent *sql_event);
+  RC do_analyze_table(SQLStageEvent *sql_event);
   RC do_select(SQLStageEvent *sql_event);
   RC do_insert(SQLStageEvent *sql_event);
   RC do_delete(SQLStageEvent *sql_event);
@@ -54,6 +70,8 @@ protected:
 private:
   Stage *default_storage_stage_ = nullptr;
   Stage *mem_storage_stage_ = nullptr;
+  bool vectorized_ = true;  // 单表查询是否按批执行
+  int parallel_workers_ = 1;  // 按批执行的聚合最多使用的线程数
 };
 
 #endif  //__OBSERVER_SQL_EXECUTE_STAGE_H__
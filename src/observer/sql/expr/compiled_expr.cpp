@@ -0,0 +1,233 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+
+#include "common/log/log.h"
+#include "sql/expr/compiled_expr.h"
+#include "sql/expr/tuple.h"
+#include "util/util.h"
+
+RC CompiledExpr::compile(const ExpressionNode &expr, const std::vector<Table *> &tables)
+{
+  program_.clear();
+  fields_.clear();
+  result_type_ = UNDEFINED;
+  depth_ = 0;
+  max_depth_ = 0;
+
+  AttrType type = UNDEFINED;
+  RC rc = compile_node(expr, tables, type);
+  if (rc != RC::SUCCESS) {
+    program_.clear();
+    fields_.clear();
+    return rc;
+  }
+  result_type_ = type;
+  return RC::SUCCESS;
+}
+
+void CompiledExpr::emit(Opcode op, int field_index, ExprValue value)
+{
+  program_.push_back(Instruction{op, field_index, value});
+  switch (op) {
+    case Opcode::LOAD_INT_FIELD:
+    case Opcode::LOAD_FLOAT_FIELD:
+    case Opcode::LOAD_INT:
+    case Opcode::LOAD_FLOAT: {
+      depth_++;
+      max_depth_ = std::max(max_depth_, depth_);
+    } break;
+    case Opcode::INT_TO_FLOAT:
+    case Opcode::SECOND_INT_TO_FLOAT: {
+    } break;
+    default: {
+      depth_--;
+    } break;
+  }
+}
+
+void CompiledExpr::emit_arithmetic(CalOp op, AttrType left_type, AttrType right_type, AttrType &type)
+{
+  if (left_type == INTS && right_type == INTS) {
+    static const Opcode int_ops[] = {Opcode::ADD_INT, Opcode::SUB_INT, Opcode::MUL_INT, Opcode::DIV_INT};
+    emit(int_ops[op]);
+    type = INTS;
+    return;
+  }
+
+  if (left_type == INTS) {
+    emit(Opcode::SECOND_INT_TO_FLOAT);
+  }
+  if (right_type == INTS) {
+    emit(Opcode::INT_TO_FLOAT);
+  }
+  static const Opcode float_ops[] = {Opcode::ADD_FLOAT, Opcode::SUB_FLOAT, Opcode::MUL_FLOAT, Opcode::DIV_FLOAT};
+  emit(float_ops[op]);
+  type = FLOATS;
+}
+
+RC CompiledExpr::compile_node(const ExpressionNode &expr, const std::vector<Table *> &tables, AttrType &type)
+{
+  // 叶节点
+  if (expr.left == nullptr && expr.right == nullptr) {
+    if (expr.is_attr) {
+      Field field;
+      RC rc = get_field(tables, expr.attr, field);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("no such field in expression. field=%s", expr.attr.attribute_name);
+        return RC::SCHEMA_FIELD_MISSING;
+      }
+      type = field.attr_type();
+      if (type != INTS && type != FLOATS) {
+        LOG_WARN("unsupported field type in expression. field=%s, type=%d", expr.attr.attribute_name, type);
+        return RC::INVALID_ARGUMENT;
+      }
+      fields_.push_back(field);
+      emit(type == INTS ? Opcode::LOAD_INT_FIELD : Opcode::LOAD_FLOAT_FIELD, (int)fields_.size() - 1);
+      return RC::SUCCESS;
+    }
+    if (expr.is_value) {
+      type = expr.value.type;
+      ExprValue value;
+      if (type == INTS) {
+        value.int_value = *(int *)expr.value.data;
+        emit(Opcode::LOAD_INT, -1, value);
+      } else if (type == FLOATS) {
+        value.float_value = *(float *)expr.value.data;
+        emit(Opcode::LOAD_FLOAT, -1, value);
+      } else {
+        LOG_WARN("unsupported value type in expression. type=%d", type);
+        return RC::INVALID_ARGUMENT;
+      }
+      return RC::SUCCESS;
+    }
+    return RC::INVALID_ARGUMENT;
+  }
+
+  if (expr.left == nullptr) {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  AttrType left_type = UNDEFINED;
+  AttrType right_type = UNDEFINED;
+  if (expr.op >= PLUS_OP && expr.op <= DIVIDE_OP) {
+    if (expr.right == nullptr) {
+      return RC::INVALID_ARGUMENT;
+    }
+    RC rc = compile_node(*expr.left, tables, left_type);
+    if (rc == RC::SUCCESS) {
+      rc = compile_node(*expr.right, tables, right_type);
+    }
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    emit_arithmetic(expr.op, left_type, right_type, type);
+    return RC::SUCCESS;
+  }
+
+  if (expr.pre_op == MINUS_OP) {
+    // 负号按照0减去操作数计算
+    ExprValue zero;
+    zero.int_value = 0;
+    emit(Opcode::LOAD_INT, -1, zero);
+    RC rc = compile_node(*expr.left, tables, right_type);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    emit_arithmetic(MINUS_OP, INTS, right_type, type);
+    return RC::SUCCESS;
+  }
+  return compile_node(*expr.left, tables, type);
+}
+
+AttrType CompiledExpr::evaluate(const Tuple &tuple, ExprValue &value) const
+{
+  if (result_type_ == UNDEFINED) {
+    return UNDEFINED;
+  }
+
+  // 很深的表达式很少见，每次计算时分配，evaluate可以被多个线程同时调用
+  ExprValue local_stack[MAX_DEPTH];
+  std::vector<ExprValue> heap_stack;
+  ExprValue *stack = local_stack;
+  if (max_depth_ > MAX_DEPTH) {
+    heap_stack.resize(max_depth_);
+    stack = heap_stack.data();
+  }
+  int top = -1;
+  TupleCell cell;
+  for (const Instruction &instruction : program_) {
+    switch (instruction.op) {
+      case Opcode::LOAD_INT_FIELD: {
+        if (tuple.find_cell(fields_[instruction.field_index], cell) != RC::SUCCESS) {
+          return UNDEFINED;
+        }
+        stack[++top].int_value = *(const int *)cell.data();
+      } break;
+      case Opcode::LOAD_FLOAT_FIELD: {
+        if (tuple.find_cell(fields_[instruction.field_index], cell) != RC::SUCCESS) {
+          return UNDEFINED;
+        }
+        stack[++top].float_value = *(const float *)cell.data();
+      } break;
+      case Opcode::LOAD_INT:
+      case Opcode::LOAD_FLOAT: {
+        stack[++top] = instruction.value;
+      } break;
+      case Opcode::INT_TO_FLOAT: {
+        stack[top].float_value = (float)stack[top].int_value;
+      } break;
+      case Opcode::SECOND_INT_TO_FLOAT: {
+        stack[top - 1].float_value = (float)stack[top - 1].int_value;
+      } break;
+      case Opcode::ADD_INT: {
+        stack[top - 1].int_value += stack[top].int_value;
+        top--;
+      } break;
+      case Opcode::SUB_INT: {
+        stack[top - 1].int_value -= stack[top].int_value;
+        top--;
+      } break;
+      case Opcode::MUL_INT: {
+        stack[top - 1].int_value *= stack[top].int_value;
+        top--;
+      } break;
+      case Opcode::DIV_INT: {
+        if (stack[top].int_value == 0) {
+          return UNDEFINED;
+        }
+        stack[top - 1].int_value /= stack[top].int_value;
+        top--;
+      } break;
+      case Opcode::ADD_FLOAT: {
+        stack[top - 1].float_value += stack[top].float_value;
+        top--;
+      } break;
+      case Opcode::SUB_FLOAT: {
+        stack[top - 1].float_value -= stack[top].float_value;
+        top--;
+      } break;
+      case Opcode::MUL_FLOAT: {
+        stack[top - 1].float_value *= stack[top].float_value;
+        top--;
+      } break;
+      case Opcode::DIV_FLOAT: {
+        if (stack[top].float_value == 0) {
+          return UNDEFINED;
+        }
+        stack[top - 1].float_value /= stack[top].float_value;
+        top--;
+      } break;
+    }
+  }
+  value = stack[0];
+  return result_type_;
+}
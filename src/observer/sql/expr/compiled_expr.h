@@ -0,0 +1,93 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <vector>
+#include "rc.h"
+#include "sql/parser/parse_defs.h"
+#include "storage/common/field.h"
+
+class Tuple;
+class Table;
+
+/**
+ * 表达式计算的中间结果，类型在编译时已经确定
+ */
+union ExprValue {
+  int int_value;
+  float float_value;
+};
+
+/**
+ * 编译后的四则运算表达式
+ * 编译时确定每个字段和每一步运算的类型，把表达式树转换成后缀形式的指令序列，
+ * 计算时只在栈上保存中间结果，不再分配内存。中间结果超过MAX_DEPTH层的表达式在堆上分配
+ */
+class CompiledExpr
+{
+public:
+  static const int MAX_DEPTH = 32;  // 计算时在栈上保存的中间结果个数
+
+  /**
+   * 字段只支持INTS和FLOATS，两边都是INTS时按整数计算，否则按浮点数计算
+   * 编译失败时计算结果总是UNDEFINED
+   */
+  RC compile(const ExpressionNode &expr, const std::vector<Table *> &tables);
+
+  bool valid() const
+  {
+    return result_type_ != UNDEFINED;
+  }
+  AttrType result_type() const
+  {
+    return result_type_;
+  }
+
+  /**
+   * @return 结果的类型，除数为0或者字段不存在时返回UNDEFINED
+   */
+  AttrType evaluate(const Tuple &tuple, ExprValue &value) const;
+
+private:
+  enum class Opcode {
+    LOAD_INT_FIELD,
+    LOAD_FLOAT_FIELD,
+    LOAD_INT,
+    LOAD_FLOAT,
+    INT_TO_FLOAT,         // 栈顶转换成浮点数
+    SECOND_INT_TO_FLOAT,  // 栈顶下面的值转换成浮点数
+    ADD_INT,
+    SUB_INT,
+    MUL_INT,
+    DIV_INT,
+    ADD_FLOAT,
+    SUB_FLOAT,
+    MUL_FLOAT,
+    DIV_FLOAT,
+  };
+
+  struct Instruction {
+    Opcode op;
+    int field_index;  // LOAD_*_FIELD时在fields_中的下标
+    ExprValue value;  // LOAD_INT/LOAD_FLOAT时的常量
+  };
+
+  RC compile_node(const ExpressionNode &expr, const std::vector<Table *> &tables, AttrType &type);
+  void emit(Opcode op, int field_index = -1, ExprValue value = ExprValue{0});
+  void emit_arithmetic(CalOp op, AttrType left_type, AttrType right_type, AttrType &type);
+
+private:
+  std::vector<Instruction> program_;
+  std::vector<Field> fields_;
+  AttrType result_type_ = UNDEFINED;
+  int depth_ = 0;      // 编译时栈的当前深度
+  int max_depth_ = 0;
+};
@@ -13,7 +13,6 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/expr/tuple.h"
-#include "util/util.h"
 
 RC FieldExpr::get_value(const Tuple &tuple, TupleCell &cell) const
 {
@@ -28,10 +27,12 @@ RC ValueExpr::get_value(const Tuple &tuple, TupleCell & cell) const
 
 RC ExprExpr::get_value(const Tuple &tuple, TupleCell &cell) const
 {
-  Value value = cal_expr_value(expr_, tuple, tables_);
-  if (value.type == UNDEFINED && value.data == nullptr) {
+  const AttrType type = compiled_expr_.evaluate(tuple, result_);
+  if (type == UNDEFINED) {
     return RC::INVALID_ARGUMENT;
   }
-  cell_set_value(value, 0, cell); //表达式现在不支持string，默认传入长度0
+  cell.set_type(type);
+  cell.set_data((char *)&result_);
+  cell.set_length(0); //表达式现在不支持string，默认长度0
   return RC::SUCCESS;
 }
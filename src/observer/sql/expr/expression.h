@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 #include <string.h>
 #include "storage/common/field.h"
 #include "sql/expr/tuple_cell.h"
+#include "sql/expr/compiled_expr.h"
 
 class Tuple;
 
@@ -107,14 +108,20 @@ class ExprExpr : public Expression
 {
   public:
     ExprExpr() = default;
-    ExprExpr(const ExpressionNode &expr, std::vector<Table*> tables) : expr_(expr), tables_(tables){}
+    ExprExpr(const ExpressionNode &expr, const std::vector<Table*> &tables)
+    {
+      compiled_expr_.compile(expr, tables);
+    }
     virtual ~ExprExpr() = default;
+    /**
+     * 返回的cell指向这个表达式内部保存的结果，下一次计算之前有效
+     */
     RC get_value(const Tuple &tuple, TupleCell & cell) const override;
     ExprType type() const override
     {
       return ExprType::Expr;
     }
   private:
-    ExpressionNode expr_;
-    std::vector<Table*> tables_;
+    CompiledExpr compiled_expr_;
+    mutable ExprValue result_;
 };
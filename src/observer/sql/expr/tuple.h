@@ -70,6 +70,15 @@ public:
   virtual RC  find_cell(const Field &field, TupleCell &cell) const = 0;
 
   virtual RC  cell_spec_at(int index, const TupleCellSpec *&spec) const = 0;
+
+  /**
+   * 直接访问tuple中某个表的记录，不拷贝也不逐个字段查找，用于只在最上层按需取出字段值
+   * @return 记录的数据，tuple中没有这个表的原始记录时返回空
+   */
+  virtual const char *find_record(const Table *table) const
+  {
+    return nullptr;
+  }
 };
 
 class RowTuple : public Tuple
@@ -121,6 +130,15 @@ public:
 
   RC find_cell(const Field &field, TupleCell &cell) const override
   {
+    if (field.table() == table_) {
+      // 同一个表的字段可以直接按照偏移取值，不需要按名字查找
+      const FieldMeta *field_meta = field.meta();
+      cell.set_type(field_meta->type());
+      cell.set_data(this->record_->data() + field_meta->offset());
+      cell.set_length(field_meta->len());
+      return RC::SUCCESS;
+    }
+
     const char *table_name = field.table_name();
     if (0 != strcmp(table_name, table_->name())) {
       return RC::NOTFOUND;
@@ -147,6 +165,11 @@ public:
     return RC::SUCCESS;
   }
 
+  const char *find_record(const Table *table) const override
+  {
+    return table == table_ ? record_->data() : nullptr;
+  }
+
   Record &record()
   {
     return *record_;
@@ -196,6 +219,17 @@ public:
     return RC::NOTFOUND;
   }
 
+  const char *find_record(const Table *table) const override
+  {
+    for (const Tuple *tuple : tuples_) {
+      const char *record = tuple->find_record(table);
+      if (record != nullptr) {
+        return record;
+      }
+    }
+    return nullptr;
+  }
+
   void push_back(Tuple *tuple){
     tuples_.push_back(tuple);
   }
@@ -243,14 +277,30 @@ public:
     speces_.clear();
   }
 
+  /**
+   * 每行调用一次，找到投影字段所在的记录，之后取值时直接按偏移访问
+   */
   void set_tuple(Tuple *tuple)
   {
     this->tuple_ = tuple;
+    for (size_t i = 0; i < speces_.size(); i++) {
+      records_[i] = field_metas_[i] == nullptr ? nullptr : tuple->find_record(tables_[i]);
+    }
   }
 
   void add_cell_spec(TupleCellSpec *spec)
   {
     speces_.push_back(spec);
+    const Table *table = nullptr;
+    const FieldMeta *field_meta = nullptr;
+    if (spec->expression()->type() == ExprType::FIELD) {
+      const Field &field = ((const FieldExpr *)spec->expression())->field();
+      table = field.table();
+      field_meta = field.meta();
+    }
+    tables_.push_back(table);
+    field_metas_.push_back(field_meta);
+    records_.push_back(nullptr);
   }
   int cell_num() const override
   {
@@ -266,6 +316,13 @@ public:
       return RC::GENERIC_ERROR;
     }
 
+    if (records_[index] != nullptr) {
+      const FieldMeta *field_meta = field_metas_[index];
+      cell.set_type(field_meta->type());
+      cell.set_data(records_[index] + field_meta->offset());
+      cell.set_length(field_meta->len());
+      return RC::SUCCESS;
+    }
     const TupleCellSpec *spec = speces_[index];
     return spec->expression()->get_value(*tuple_, cell);
   }
@@ -282,7 +339,14 @@ public:
     spec = speces_[index];
     return RC::SUCCESS;
   }
+  const char *find_record(const Table *table) const override
+  {
+    return tuple_->find_record(table);
+  }
 private:
   std::vector<TupleCellSpec *> speces_;
+  std::vector<const Table *> tables_;
+  std::vector<const FieldMeta *> field_metas_;
+  std::vector<const char *> records_;  // 当前行中每个投影字段所在的记录
   Tuple *tuple_ = nullptr;
 };
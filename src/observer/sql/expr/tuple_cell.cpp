@@ -12,6 +12,9 @@ See the Mulan PSL v2 for more details. */
 // Created by WangYunlai on 2022/07/05.
 //
 
+#include <stdio.h>
+#include <string.h>
+
 #include "sql/expr/tuple_cell.h"
 #include "storage/common/field.h"
 #include "common/log/log.h"
@@ -42,7 +45,35 @@ void TupleCell::to_string(std::ostream &os) const
       }
       os << data_[i];
     }
+  } break;
+  default: {
+    LOG_WARN("unsupported attr type: %d", attr_type_);
+  } break;
   }
+}
+
+void TupleCell::to_string(std::string &str) const
+{
+  switch (attr_type_) {
+  case INTS: {
+    char buf[16];
+    const int len = snprintf(buf, sizeof(buf), "%d", *(int *)data_);
+    str.append(buf, len);
+  } break;
+  case FLOATS: {
+    // 与ostream默认的6位有效数字格式一致
+    char buf[32];
+    const int len = snprintf(buf, sizeof(buf), "%g", *(float *)data_);
+    str.append(buf, len);
+  } break;
+  case CHARS: {
+    if (length_ > 0) {
+      str.append(data_, strnlen(data_, length_));
+    }
+  } break;
+  case DATES: {
+    str.append(data_, strnlen(data_, 11));
+  } break;
   default: {
     LOG_WARN("unsupported attr type: %d", attr_type_);
   } break;
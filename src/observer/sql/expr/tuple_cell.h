@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <iostream>
+#include <string>
 #include "storage/common/table.h"
 #include "storage/common/field_meta.h"
 
@@ -36,6 +37,10 @@ public:
   void set_data(const char *data) { this->set_data(const_cast<char *>(data)); }
 
   void to_string(std::ostream &os) const;
+  /**
+   * 追加到str的末尾，输出格式与写到ostream时相同
+   */
+  void to_string(std::string &str) const;
 
   int compare(const TupleCell &other) const;
   int compare(const AggreResult &other) const;
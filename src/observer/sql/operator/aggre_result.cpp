@@ -0,0 +1,117 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "common/log/log.h"
+#include "sql/operator/aggre_result.h"
+#include "sql/expr/tuple_cell.h"
+#include "storage/common/table.h"
+
+RC check_aggregation(const Aggregation &aggregation, Table *table, const FieldMeta *&field_meta)
+{
+  field_meta = nullptr;
+  if (0 == strcmp(aggregation.attr.attribute_name, "*")) {
+    if (aggregation.type != COUNT) {
+      LOG_WARN("only count supports *. type=%d", aggregation.type);
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    return RC::SUCCESS;
+  }
+
+  field_meta = table->table_meta().field(aggregation.attr.attribute_name);
+  if (field_meta == nullptr) {
+    LOG_WARN("no such field to aggregate. field=%s", aggregation.attr.attribute_name);
+    return RC::SCHEMA_FIELD_MISSING;
+  }
+  if ((aggregation.type == AVG || aggregation.type == SUM) && field_meta->type() != INTS &&
+      field_meta->type() != FLOATS) {
+    LOG_WARN("avg and sum only support numbers. field=%s", aggregation.attr.attribute_name);
+    return RC::SCHEMA_FIELD_MISSING;
+  }
+  return RC::SUCCESS;
+}
+
+void init_aggre_result(AggreType type, const FieldMeta *field_meta, AggreResult &result)
+{
+  memset(&result, 0, sizeof(result));
+  result.type = type;
+  if (field_meta == nullptr) {
+    return;
+  }
+  result.result.type = field_meta->type();
+  result.char_length = field_meta->len();
+}
+
+void destroy_aggre_result(AggreResult &result)
+{
+  delete[](char *) result.result.data;
+  result.result.data = nullptr;
+}
+
+/**
+ * value比当前的MIN/MAX更合适时替换，第一个值到来时才分配内存
+ */
+static void update_min_max(AggreResult &result, const char *value)
+{
+  if (result.result.data == nullptr) {
+    result.result.data = new char[result.char_length + 1]();
+  } else {
+    TupleCell cell(result.result.type, const_cast<char *>(value));
+    cell.set_length(result.char_length);
+    const int compare = cell.compare(result);
+    if ((result.type == MIN && compare >= 0) || (result.type == MAX && compare <= 0)) {
+      return;
+    }
+  }
+  memcpy(result.result.data, value, result.char_length);
+}
+
+void update_aggre_result(AggreResult &result, const char *value)
+{
+  switch (result.type) {
+    case AVG:
+    case SUM: {
+      if (result.result.type == INTS) {
+        result.int_sum += *(const int *)value;
+      } else {
+        result.float_sum += *(const float *)value;
+      }
+    } break;
+    case MIN:
+    case MAX: {
+      update_min_max(result, value);
+    } break;
+    default: break;
+  }
+  result.count++;
+}
+
+void merge_aggre_result(AggreResult &result, const AggreResult &other)
+{
+  if (other.count == 0) {
+    return;
+  }
+  if (result.type == MIN || result.type == MAX) {
+    update_min_max(result, (const char *)other.result.data);
+  }
+  result.count += other.count;
+  result.int_sum += other.int_sum;
+  result.float_sum += other.float_sum;
+}
+
+double aggre_result_avg(const AggreResult &result)
+{
+  if (result.count == 0) {
+    return 0;
+  }
+  const double sum = result.result.type == INTS ? (double)result.int_sum : result.float_sum;
+  return sum / result.count;
+}
@@ -0,0 +1,48 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "rc.h"
+#include "sql/parser/parse_defs.h"
+
+class FieldMeta;
+class Table;
+
+/**
+ * 聚合中间状态的初始化、累加和合并，按行、按批和并行聚合都使用这里的语义
+ * INTS的和用64位整数累加，FLOATS的和用double累加，部分结果可以按任意顺序合并
+ */
+
+/**
+ * 检查聚合函数的字段，COUNT(*)时field_meta为空
+ */
+RC check_aggregation(const Aggregation &aggregation, Table *table, const FieldMeta *&field_meta);
+
+/**
+ * MIN/MAX的结果在第一个值到来时分配内存，没有数据时为空，用destroy_aggre_result释放
+ */
+void init_aggre_result(AggreType type, const FieldMeta *field_meta, AggreResult &result);
+void destroy_aggre_result(AggreResult &result);
+
+/**
+ * 累加一行，value是字段的值，COUNT时可以为空
+ */
+void update_aggre_result(AggreResult &result, const char *value);
+
+/**
+ * 把另一个部分结果合并进来，两边的聚合函数和字段相同
+ */
+void merge_aggre_result(AggreResult &result, const AggreResult &other);
+
+/**
+ * @return AVG的结果，没有数据时返回0
+ */
+double aggre_result_avg(const AggreResult &result);
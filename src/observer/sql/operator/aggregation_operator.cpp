@@ -1,75 +1,41 @@
 #include "common/log/log.h"
 #include "sql/operator/aggregation_operator.h"
+#include "sql/operator/aggre_result.h"
 #include "storage/common/record.h"
 #include "storage/common/table.h"
+#include "storage/index/index.h"
 #include "sql/parser/parse_defs.h"
 #include <math.h>
 #include <cfloat>
+#include <string.h>
 
 
 
 
-RC aggre_helper(Table *table, Tuple *tuple, std::vector<Aggregation> aggregations, std::vector<AggreResult> &aggre_results){
-  RC rc = RC::SUCCESS;    
-  for(int i = 0; i < aggregations.size(); i++) {
-    Aggregation aggregation = aggregations[i];
-    AggreResult &aggre_result = aggre_results[i];
-    const FieldMeta *field_meta = table->table_meta().field(aggregation.attr.attribute_name);
-    if(strcmp(aggregation.attr.attribute_name, "*") == 0 && aggregation.type == COUNT){
+AggregationOperator::~AggregationOperator()
+{
+  for (AggreResult &aggre_result : aggre_results_) {
+    destroy_aggre_result(aggre_result);
+  }
+}
 
-    } else if(field_meta == nullptr){
-        return RC::SCHEMA_FIELD_MISSING;
-    }
-    
-    Field field = Field(table, field_meta);
-
-    if(aggregation.type == COUNT){        
-        aggre_result.count++;
-    } else if(aggregation.type == AVG){
-        aggre_result.count++;
-        TupleCell cell;
-        tuple->find_cell(field, cell);
-        if (cell.attr_type() == INTS) {
-            int sum = *(int*)aggre_result.sum.data;
-            sum += *(int*)cell.data();
-            *(int*)(aggre_result.sum.data) = sum;
-            aggre_result.avg = sum / float(aggre_result.count);
-        } else if (cell.attr_type() == FLOATS) {
-            float sum = *(float*)aggre_result.sum.data;
-            sum += *(float*)cell.data();
-            *(float*)(aggre_result.sum.data) = sum;
-            aggre_result.avg = sum / float(aggre_result.count);
-        }
-        
-    } else if (aggregation.type == MIN) {
-        TupleCell cell;
-        tuple->find_cell(field, cell);
-        if (aggre_result.result.data == nullptr){
-            aggre_result.result.data = (void*)(cell.data());
-            aggre_result.char_length = cell.length();
-        }
-
-        const int compare = cell.compare(aggre_result);
-        if (compare < 0) {
-            aggre_result.result.data = (void*)(cell.data());
-            aggre_result.char_length = cell.length();
-        }
-    } else if (aggregation.type == MAX) {
-        TupleCell cell;
-        tuple->find_cell(field, cell);
-        if (aggre_result.result.data == nullptr){
-            aggre_result.result.data = (void*)(cell.data());
-            aggre_result.char_length = cell.length();
-        }
-
-        const int compare = cell.compare(aggre_result);
-        if (compare > 0) {
-            aggre_result.result.data = (void*)(cell.data());
-            aggre_result.char_length = cell.length();
-        }
-    } 
+// 子算子可能复用同一块记录内存（比如覆盖索引扫描），min/max会拷贝一份当前值
+RC AggregationOperator::aggre_one(const Tuple &tuple, int index)
+{
+  const Field &field = fields_[index];
+  if (field.meta() == nullptr) {
+    update_aggre_result(aggre_results_[index], nullptr);
+    return RC::SUCCESS;
   }
-  return rc;
+
+  TupleCell cell;
+  RC rc = tuple.find_cell(field, cell);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to find aggregation field. field=%s", field.field_name());
+    return rc;
+  }
+  update_aggre_result(aggre_results_[index], cell.data());
+  return RC::SUCCESS;
 }
 
 RC AggregationOperator::open()
@@ -85,58 +51,83 @@ RC AggregationOperator::open()
     LOG_WARN("failed to open child operator: %s", strrc(rc));
     return rc;
   }
-  for(int i = 0; i < aggregations_.size(); i++){
-    Aggregation aggregation = aggregations_[i];
-    AggreResult aggre_result;
-    const FieldMeta *field_meta = table_->table_meta().field(aggregation.attr.attribute_name);
-    
-    //check    
-    if((strcmp(aggregation.attr.attribute_name, "*") == 0 && aggregation.type == COUNT) ||
-    (field_meta != nullptr && aggregation.type == COUNT)){
-        aggre_result.count = 0;
-        aggre_results_.push_back(aggre_result);
-        continue;
-    } else if(field_meta == nullptr){
-        return RC::SCHEMA_FIELD_MISSING;
-    } 
-    const AttrType type = field_meta->type();
-    if((type == CHARS || type == DATES) && aggregation.type == AVG){
-        return RC::SCHEMA_FIELD_MISSING;
+  for (const Aggregation &aggregation : aggregations_) {
+    const FieldMeta *field_meta = nullptr;
+    rc = check_aggregation(aggregation, table_, field_meta);
+    if (rc != RC::SUCCESS) {
+      return rc;
     }
-    Value sum;
-    Value result;
-    sum.type = type;
-    result.type = type;
-    result.type = type;
-
-    if (aggregation.type == AVG) {
-        if (type == INTS) {
-            sum.data = new int;
-            *((int*)(sum.data)) = 0;
-        } else if(type == FLOATS) {
-            sum.data = new float;
-            *((float*)(sum.data)) = 0;
-        }
-    } 
-
-    aggre_result.count = 0;
-    aggre_result.sum = sum;
-    aggre_result.result = result;
+    // COUNT不需要读取字段
+    if (aggregation.type == COUNT) {
+      field_meta = nullptr;
+    }
+    fields_.push_back(Field(table_, field_meta));
+    AggreResult aggre_result;
+    init_aggre_result(aggregation.type, field_meta, aggre_result);
     aggre_results_.push_back(aggre_result);
   }
 
-
   return RC::SUCCESS;
 }
 
+RC AggregationOperator::aggregate_by_index()
+{
+  std::vector<char> record_data(table_->table_meta().record_size(), 0);
+  Record record;
+  record.set_data(record_data.data());
+  RowTuple tuple;
+  tuple.set_schema(table_, table_->table_meta().field_metas());
+  tuple.set_record(&record);
+
+  for (size_t i = 0; i < aggregations_.size(); i++) {
+    const Aggregation &aggregation = aggregations_[i];
+    Index *index = table_->find_index_by_field(aggregation.attr.attribute_name);
+    if (index == nullptr) {
+      LOG_WARN("no index for min/max. field=%s", aggregation.attr.attribute_name);
+      return RC::INTERNAL;
+    }
+
+    // MIN取索引中的第一个值，MAX反向扫描取最后一个值
+    IndexScanner *scanner = index->create_scanner(nullptr, 0, false, nullptr, 0, false, aggregation.type == MAX);
+    if (scanner == nullptr) {
+      LOG_WARN("failed to create index scanner. index=%s", index->index_meta().name());
+      return RC::INTERNAL;
+    }
+    RID rid;
+    RC rc = scanner->next_entry(&rid, record_data.data());
+    scanner->destroy();
+    if (rc == RC::RECORD_EOF) {
+      continue;
+    }
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to fetch index entry. index=%s, rc=%s", index->index_meta().name(), strrc(rc));
+      return rc;
+    }
+
+    rc = aggre_one(tuple, i);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  return RC::RECORD_EOF;
+}
+
 RC AggregationOperator::next()
 {
+  if (use_index_) {
+    return aggregate_by_index();
+  }
+
   RC rc = RC::SUCCESS;
   Operator *oper = children_[0];
   while(RC::SUCCESS == (rc = oper->next())) {
     Tuple *tuple = oper->current_tuple();
-    aggre_helper(table_, tuple, aggregations_, aggre_results_);
-    
+    for (size_t i = 0; i < aggregations_.size(); i++) {
+      rc = aggre_one(*tuple, i);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
   }
   return rc;
 }
@@ -10,15 +10,15 @@ public:
     : aggregations_(aggregations), table_(table)
   {}
 
-  virtual ~AggregationOperator() = default;
+  virtual ~AggregationOperator();
 
   RC open() override;
   RC next() override;
   RC close() override;
 
-  std::vector<AggreResult> aggre_results() const {return aggre_results_; }
+  const std::vector<AggreResult> &aggre_results() const {return aggre_results_; }
 
-  std::vector<Aggregation> aggregations() const {return aggregations_; }
+  const std::vector<Aggregation> &aggregations() const {return aggregations_; }
 
   int aggre_num() const{
     return aggregations_.size();
@@ -26,9 +26,23 @@ public:
 
   Tuple * current_tuple() override;
 
+  /**
+   * 没有过滤条件并且MIN/MAX的字段上都有B+树索引时，直接从索引的两端取值，不再扫描子算子
+   */
+  void set_use_index(bool use_index)
+  {
+    use_index_ = use_index;
+  }
+
+private:
+  RC aggregate_by_index();
+  RC aggre_one(const Tuple &tuple, int index);
+
 private:
   ProjectTuple tuple_;
   std::vector<Aggregation> aggregations_;
   std::vector<AggreResult> aggre_results_;
+  std::vector<Field> fields_;  // 每个聚合的字段，COUNT时没有字段
   Table *table_;
+  bool use_index_ = false;
 };
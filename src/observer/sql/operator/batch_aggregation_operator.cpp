@@ -0,0 +1,268 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <thread>
+
+#include "common/log/log.h"
+#include "sql/operator/batch_aggregation_operator.h"
+#include "sql/operator/aggre_result.h"
+#include "storage/common/table.h"
+#include "util/comparator.h"
+
+namespace {
+
+const float FLOAT_EPSILON = 1E-6;
+
+// 与compare_int/compare_float/compare_string的结果保持一致
+inline bool less(int left, int right)
+{
+  return left < right;
+}
+inline bool less(float left, float right)
+{
+  return left - right < -FLOAT_EPSILON;
+}
+
+// INTS累加到int64_t，FLOATS累加到double，避免溢出和累积误差
+template <typename T, typename S>
+S sum_values(const ColumnVector &column, const uint16_t *selection, int count, S sum)
+{
+  const T *values = column.values<T>();
+  for (int i = 0; i < count; i++) {
+    sum += values[selection[i]];
+  }
+  return sum;
+}
+
+template <typename T>
+void min_max_values(
+    const ColumnVector &column, const uint16_t *selection, int count, bool is_min, AggreResult &result)
+{
+  const T *values = column.values<T>();
+  T value = *(T *)result.result.data;
+  if (is_min) {
+    for (int i = 0; i < count; i++) {
+      const T v = values[selection[i]];
+      value = less(v, value) ? v : value;
+    }
+  } else {
+    for (int i = 0; i < count; i++) {
+      const T v = values[selection[i]];
+      value = less(value, v) ? v : value;
+    }
+  }
+  *(T *)result.result.data = value;
+}
+
+void min_max_strings(
+    const ColumnVector &column, const uint16_t *selection, int count, bool is_min, AggreResult &result)
+{
+  const int width = column.width();
+  for (int i = 0; i < count; i++) {
+    const char *value = column.value(selection[i]);
+    const int compare = compare_string((void *)value, width, result.result.data, (int)result.char_length);
+    if ((is_min && compare < 0) || (!is_min && compare > 0)) {
+      memcpy(result.result.data, value, width);
+    }
+  }
+}
+
+}  // namespace
+
+BatchAggregationOperator::~BatchAggregationOperator()
+{
+  clear_results();
+}
+
+void BatchAggregationOperator::clear_results()
+{
+  for (AggreResult &aggre_result : aggre_results_) {
+    destroy_aggre_result(aggre_result);
+  }
+  aggre_results_.clear();
+  for (Partial &partial : partials_) {
+    for (AggreResult &aggre_result : partial.results) {
+      destroy_aggre_result(aggre_result);
+    }
+  }
+  partials_.clear();
+}
+
+bool BatchAggregationOperator::can_aggregate(const std::vector<Aggregation> &aggregations, Table *table)
+{
+  for (const Aggregation &aggregation : aggregations) {
+    const FieldMeta *field_meta = nullptr;
+    if (check_aggregation(aggregation, table, field_meta) != RC::SUCCESS) {
+      return false;
+    }
+    if (field_meta == nullptr || aggregation.type == COUNT) {
+      continue;
+    }
+    const AttrType type = field_meta->type();
+    if (type != INTS && type != FLOATS && type != CHARS) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BatchAggregationOperator::init_results(std::vector<AggreResult> &results) const
+{
+  for (const Aggregation &aggregation : aggregations_) {
+    const FieldMeta *field_meta = nullptr;
+    if (aggregation.type != COUNT) {
+      field_meta = table_->table_meta().field(aggregation.attr.attribute_name);
+    }
+    AggreResult aggre_result;
+    init_aggre_result(aggregation.type, field_meta, aggre_result);
+    results.push_back(aggre_result);
+  }
+}
+
+RC BatchAggregationOperator::open()
+{
+  if (children_.empty()) {
+    LOG_WARN("batch aggregation operator must has at least one child");
+    return RC::INTERNAL;
+  }
+  if (!can_aggregate(aggregations_, table_)) {
+    LOG_WARN("unsupported aggregation. table=%s", table_->name());
+    return RC::SCHEMA_FIELD_MISSING;
+  }
+
+  // 再次open时丢掉上一次的结果，MIN/MAX的结果中有分配的内存
+  clear_results();
+  init_results(aggre_results_);
+  partials_.resize(children_.size());
+  for (size_t i = 0; i < children_.size(); i++) {
+    init_results(partials_[i].results);
+    RC rc = children_[i]->open();
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to open child operator: %s", strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC BatchAggregationOperator::aggregate(Partial &partial, const ColumnBatch &batch)
+{
+  if (!partial.bound) {
+    partial.columns.clear();
+    for (const Aggregation &aggregation : aggregations_) {
+      int column = -1;
+      if (aggregation.type != COUNT) {
+        column = batch.column_index(aggregation.attr.attribute_name);
+        if (column < 0) {
+          LOG_WARN("field is not in batch. field=%s", aggregation.attr.attribute_name);
+          return RC::SCHEMA_FIELD_MISSING;
+        }
+      }
+      partial.columns.push_back(column);
+    }
+    partial.bound = true;
+  }
+
+  const uint16_t *selection = batch.selection();
+  const int count = batch.selected_count();
+  if (count == 0) {
+    return RC::SUCCESS;
+  }
+  for (size_t i = 0; i < aggregations_.size(); i++) {
+    const Aggregation &aggregation = aggregations_[i];
+    AggreResult &result = partial.results[i];
+    if (aggregation.type == COUNT) {
+      result.count += count;
+      continue;
+    }
+
+    const ColumnVector &column = batch.column(partial.columns[i]);
+    if (aggregation.type == AVG || aggregation.type == SUM) {
+      if (column.type() == INTS) {
+        result.int_sum = sum_values<int>(column, selection, count, result.int_sum);
+      } else {
+        result.float_sum = sum_values<float>(column, selection, count, result.float_sum);
+      }
+      result.count += count;
+      continue;
+    }
+
+    // MIN/MAX用第一行初始化
+    if (result.result.data == nullptr) {
+      result.result.data = new char[result.char_length + 1]();
+      memcpy(result.result.data, column.value(selection[0]), column.width());
+    }
+    const bool is_min = aggregation.type == MIN;
+    switch (column.type()) {
+      case INTS: min_max_values<int>(column, selection, count, is_min, result); break;
+      case FLOATS: min_max_values<float>(column, selection, count, is_min, result); break;
+      case CHARS: min_max_strings(column, selection, count, is_min, result); break;
+      default: {
+        LOG_WARN("unsupported type: %d", column.type());
+        return RC::INTERNAL;
+      }
+    }
+    result.count += count;
+  }
+  return RC::SUCCESS;
+}
+
+RC BatchAggregationOperator::aggregate_child(int index)
+{
+  RC rc = RC::SUCCESS;
+  ColumnBatch *input = nullptr;
+  while (RC::SUCCESS == (rc = children_[index]->next_batch(input))) {
+    rc = aggregate(partials_[index], *input);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  return rc;
+}
+
+RC BatchAggregationOperator::next_batch(ColumnBatch *&batch)
+{
+  batch = nullptr;
+  std::vector<RC> rcs(children_.size(), RC::SUCCESS);
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < children_.size(); i++) {
+    workers.emplace_back([this, i, &rcs]() { rcs[i] = aggregate_child(i); });
+  }
+  rcs[0] = aggregate_child(0);
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  for (size_t i = 0; i < children_.size(); i++) {
+    if (rcs[i] != RC::RECORD_EOF) {
+      return rcs[i];
+    }
+  }
+  // 每个聚合函数的部分结果都可以直接相加或者比较，合并顺序不影响结果
+  for (Partial &partial : partials_) {
+    for (size_t i = 0; i < aggregations_.size(); i++) {
+      merge_aggre_result(aggre_results_[i], partial.results[i]);
+    }
+  }
+  return RC::RECORD_EOF;
+}
+
+RC BatchAggregationOperator::close()
+{
+  RC rc = RC::SUCCESS;
+  for (BatchOperator *child : children_) {
+    RC child_rc = child->close();
+    if (child_rc != RC::SUCCESS) {
+      rc = child_rc;
+    }
+  }
+  return rc;
+}
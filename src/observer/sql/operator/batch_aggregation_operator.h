@@ -0,0 +1,71 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/operator/batch_operator.h"
+#include "sql/parser/parse_defs.h"
+
+class Table;
+
+/**
+ * 向量化的聚合，结果与AggregationOperator相同
+ * 支持INTS、FLOATS、CHARS类型的字段
+ *
+ * 可以有多个子算子，每个子算子在一个线程中聚合出自己的部分结果，全部结束后再合并。
+ * 子算子之间不能共享状态，通常是共同扫描一个表的多个BatchTableScanOperator
+ */
+class BatchAggregationOperator : public BatchOperator
+{
+public:
+  BatchAggregationOperator(const std::vector<Aggregation> &aggregations, Table *table)
+      : aggregations_(aggregations), table_(table)
+  {}
+
+  virtual ~BatchAggregationOperator();
+
+  static bool can_aggregate(const std::vector<Aggregation> &aggregations, Table *table);
+
+  RC open() override;
+  /**
+   * 一次消费所有子算子的数据，结果通过aggre_results获取
+   * @return 成功时返回RECORD_EOF，batch为空
+   */
+  RC next_batch(ColumnBatch *&batch) override;
+  RC close() override;
+
+  const std::vector<Aggregation> &aggregations() const
+  {
+    return aggregations_;
+  }
+  const std::vector<AggreResult> &aggre_results() const
+  {
+    return aggre_results_;
+  }
+
+private:
+  // 一个子算子的部分结果
+  struct Partial {
+    std::vector<int> columns;  // 每个聚合的字段在批中的列号，COUNT不需要字段时为-1
+    std::vector<AggreResult> results;
+    bool bound = false;
+  };
+
+  void init_results(std::vector<AggreResult> &results) const;
+  void clear_results();
+  RC aggregate(Partial &partial, const ColumnBatch &batch);
+  RC aggregate_child(int index);
+
+private:
+  std::vector<Aggregation> aggregations_;
+  std::vector<AggreResult> aggre_results_;
+  std::vector<Partial> partials_;
+  Table *table_ = nullptr;
+};
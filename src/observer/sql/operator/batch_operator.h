@@ -0,0 +1,43 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <vector>
+#include "rc.h"
+#include "sql/operator/column_batch.h"
+
+/**
+ * 向量化执行的算子，每次返回一批数据而不是一行
+ */
+class BatchOperator
+{
+public:
+  BatchOperator()
+  {}
+
+  virtual ~BatchOperator() = default;
+
+  virtual RC open() = 0;
+  /**
+   * @param batch 指向算子内部的数据，下一次调用next_batch之前有效。可能没有选中任何行
+   * @return 没有更多数据时返回RECORD_EOF
+   */
+  virtual RC next_batch(ColumnBatch *&batch) = 0;
+  virtual RC close() = 0;
+
+  void add_child(BatchOperator *oper)
+  {
+    children_.push_back(oper);
+  }
+
+protected:
+  std::vector<BatchOperator *> children_;
+};
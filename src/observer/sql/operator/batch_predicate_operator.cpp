@@ -0,0 +1,330 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <algorithm>
+
+#include "common/log/log.h"
+#include "sql/operator/batch_predicate_operator.h"
+#include "sql/operator/filter_kernel.h"
+#include "sql/stmt/filter_stmt.h"
+#include "sql/expr/expression.h"
+#include "util/comparator.h"
+
+namespace {
+
+using ::filter_compare;
+
+const int DATE_COMPARE_LENGTH = 11;
+
+struct StringRef {
+  const char *data;
+  int length;
+};
+
+inline int filter_compare(const StringRef &left, const StringRef &right)
+{
+  return compare_string((void *)left.data, left.length, (void *)right.data, right.length);
+}
+
+template <typename S, typename T>
+struct ColumnOperand {
+  const S *values;
+  T operator()(int row) const
+  {
+    return (T)values[row];
+  }
+};
+
+template <typename T>
+struct ConstOperand {
+  T value;
+  T operator()(int) const
+  {
+    return value;
+  }
+};
+
+struct StringColumnOperand {
+  const char *data;
+  int width;
+  int length;  // 参与比较的长度
+  StringRef operator()(int row) const
+  {
+    return StringRef{data + (size_t)row * width, length};
+  }
+};
+
+/**
+ * 逐行计算条件，不满足条件的行在bitmap中置0
+ */
+template <CompOp OP, typename Left, typename Right>
+void filter_rows(const Left &left, const Right &right, int count, uint8_t *bitmap)
+{
+  for (int i = 0; i < count; i++) {
+    bitmap[i] &= filter_test<OP>(filter_compare(left(i), right(i)));
+  }
+}
+
+template <typename Left, typename Right>
+void filter_rows(CompOp comp, const Left &left, const Right &right, int count, uint8_t *bitmap)
+{
+  switch (comp) {
+    case EQUAL_TO: filter_rows<EQUAL_TO>(left, right, count, bitmap); break;
+    case LESS_EQUAL: filter_rows<LESS_EQUAL>(left, right, count, bitmap); break;
+    case NOT_EQUAL: filter_rows<NOT_EQUAL>(left, right, count, bitmap); break;
+    case LESS_THAN: filter_rows<LESS_THAN>(left, right, count, bitmap); break;
+    case GREAT_EQUAL: filter_rows<GREAT_EQUAL>(left, right, count, bitmap); break;
+    case GREAT_THAN: filter_rows<GREAT_THAN>(left, right, count, bitmap); break;
+    default: {
+      LOG_WARN("invalid compare type: %d", comp);
+      memset(bitmap, 0, count);
+    } break;
+  }
+}
+
+// 数值类型的一侧，按照T读取
+template <typename T, typename Func>
+void with_numeric_operand(const BatchPredicateOperator::Operand &operand, const ColumnBatch &batch, Func &&func)
+{
+  if (operand.column >= 0) {
+    const ColumnVector &column = batch.column(operand.column);
+    if (column.type() == INTS) {
+      func(ColumnOperand<int, T>{column.values<int>()});
+    } else {
+      func(ColumnOperand<float, T>{column.values<float>()});
+    }
+  } else if (operand.type == INTS) {
+    func(ConstOperand<T>{(T)(*(const int *)operand.value.data())});
+  } else {
+    func(ConstOperand<T>{(T)(*(const float *)operand.value.data())});
+  }
+}
+
+template <typename T>
+void filter_numeric(const BatchPredicateOperator::Filter &filter, const ColumnBatch &batch, int count, uint8_t *bitmap)
+{
+  with_numeric_operand<T>(filter.left, batch, [&](const auto &left) {
+    with_numeric_operand<T>(filter.right, batch, [&](const auto &right) {
+      filter_rows(filter.comp, left, right, count, bitmap);
+    });
+  });
+}
+
+/**
+ * 数值列与常量比较，使用SIMD实现
+ */
+void filter_numeric_constant(
+    const BatchPredicateOperator::Filter &filter, const ColumnBatch &batch, int count, uint8_t *bitmap)
+{
+  const ColumnVector &column = batch.column(filter.left.column);
+  const char *constant = filter.right.value.data();
+  if (column.type() == INTS && filter.right.type == INTS) {
+    filter_int_column(filter.comp, column.values<int>(), count, *(const int *)constant, bitmap);
+    return;
+  }
+  const float float_constant = filter.right.type == INTS ? (float)*(const int *)constant : *(const float *)constant;
+  if (column.type() == INTS) {
+    filter_int_column(filter.comp, column.values<int>(), count, float_constant, bitmap);
+  } else {
+    filter_float_column(filter.comp, column.values<float>(), count, float_constant, bitmap);
+  }
+}
+
+void filter_string(const BatchPredicateOperator::Filter &filter, const ColumnBatch &batch, int count, uint8_t *bitmap)
+{
+  // 日期按照格式化之后的字符串比较
+  const int length = filter.left.type == DATES ? DATE_COMPARE_LENGTH : -1;
+  auto with_operand = [&batch, length](const BatchPredicateOperator::Operand &operand, auto &&func) {
+    if (operand.column >= 0) {
+      const ColumnVector &column = batch.column(operand.column);
+      func(StringColumnOperand{column.data(), column.width(), length > 0 ? length : column.width()});
+    } else {
+      const char *data = length > 0 ? operand.date.c_str() : operand.value.data();
+      func(ConstOperand<StringRef>{StringRef{data, length > 0 ? length : operand.value.length()}});
+    }
+  };
+  with_operand(filter.left, [&](const auto &left) {
+    with_operand(filter.right, [&](const auto &right) {
+      filter_rows(filter.comp, left, right, count, bitmap);
+    });
+  });
+}
+
+bool get_operand_type(const Expression *expr, AttrType &type)
+{
+  if (expr->type() == ExprType::FIELD) {
+    type = static_cast<const FieldExpr *>(expr)->field().attr_type();
+    return true;
+  }
+  if (expr->type() == ExprType::VALUE) {
+    TupleCell cell;
+    static_cast<const ValueExpr *>(expr)->get_tuple_cell(cell);
+    type = cell.attr_type();
+    return true;
+  }
+  return false;
+}
+
+bool is_numeric(AttrType type)
+{
+  return type == INTS || type == FLOATS;
+}
+
+}  // namespace
+
+bool BatchPredicateOperator::can_filter(const std::vector<const FilterUnit *> &filter_units)
+{
+  for (const FilterUnit *filter_unit : filter_units) {
+    AttrType left_type = UNDEFINED;
+    AttrType right_type = UNDEFINED;
+    if (!get_operand_type(filter_unit->left(), left_type) || !get_operand_type(filter_unit->right(), right_type)) {
+      return false;
+    }
+    if (left_type == UNDEFINED || right_type == UNDEFINED) {
+      continue;  // 与行模式一样忽略这个条件
+    }
+    if (is_numeric(left_type) && is_numeric(right_type)) {
+      continue;
+    }
+    if (left_type == CHARS && right_type == CHARS) {
+      continue;
+    }
+    if (left_type == DATES && right_type == CHARS && filter_unit->left()->type() == ExprType::FIELD &&
+        filter_unit->right()->type() == ExprType::VALUE) {
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
+RC BatchPredicateOperator::open()
+{
+  if (children_.size() != 1) {
+    LOG_WARN("batch predicate operator must has one child");
+    return RC::INTERNAL;
+  }
+  bound_ = false;
+  always_false_ = false;
+  filters_.clear();
+  bitmap_.resize(ColumnBatch::CAPACITY);
+  return children_[0]->open();
+}
+
+RC BatchPredicateOperator::bind(const ColumnBatch &batch)
+{
+  auto bind_operand = [&batch](const Expression *expr, Operand &operand) {
+    if (expr->type() == ExprType::FIELD) {
+      const Field &field = static_cast<const FieldExpr *>(expr)->field();
+      operand.column = batch.column_index(field.field_name());
+      operand.type = field.attr_type();
+      if (operand.column < 0) {
+        LOG_WARN("field is not in batch. field=%s", field.field_name());
+        return RC::SCHEMA_FIELD_MISSING;
+      }
+    } else {
+      static_cast<const ValueExpr *>(expr)->get_tuple_cell(operand.value);
+      operand.type = operand.value.attr_type();
+    }
+    return RC::SUCCESS;
+  };
+
+  for (const FilterUnit *filter_unit : filter_units_) {
+    Filter filter;
+    filter.comp = filter_unit->comp();
+    RC rc = bind_operand(filter_unit->left(), filter.left);
+    if (rc == RC::SUCCESS) {
+      rc = bind_operand(filter_unit->right(), filter.right);
+    }
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (filter.left.type == UNDEFINED || filter.right.type == UNDEFINED) {
+      continue;
+    }
+    if (filter.left.column < 0 && filter.right.column < 0) {
+      // 两边都是常量，只需要计算一次
+      const int compare = filter.left.value.compare(filter.right.value);
+      const bool result = filter_test(filter.comp, compare);
+      always_false_ = always_false_ || !result;
+      continue;
+    }
+    if (filter.left.column < 0 && filter.left.type != CHARS) {
+      // 常量放到右边
+      std::swap(filter.left, filter.right);
+      filter.comp = filter_swap_comp(filter.comp);
+    }
+    if (filter.left.type == DATES) {
+      char date[DATE_COMPARE_LENGTH] = {0};
+      format_date(filter.right.value.data(), date);
+      filter.right.date.assign(date, DATE_COMPARE_LENGTH);
+    }
+    filters_.push_back(filter);
+  }
+  bound_ = true;
+  return RC::SUCCESS;
+}
+
+RC BatchPredicateOperator::next_batch(ColumnBatch *&batch)
+{
+  RC rc = children_[0]->next_batch(batch);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  if (!bound_) {
+    rc = bind(*batch);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  if (always_false_) {
+    batch->set_selected_count(0);
+    return RC::SUCCESS;
+  }
+
+  // 先按照selection设置bitmap，每个条件在bitmap上过滤所有行，最后再转换成selection
+  const int size = batch->size();
+  uint16_t *selection = batch->selection();
+  uint8_t *bitmap = bitmap_.data();
+  if (batch->selected_count() == size) {
+    memset(bitmap, 1, size);
+  } else {
+    memset(bitmap, 0, size);
+    for (int i = 0; i < batch->selected_count(); i++) {
+      bitmap[selection[i]] = 1;
+    }
+  }
+
+  for (const Filter &filter : filters_) {
+    if (filter.left.type == CHARS || filter.left.type == DATES) {
+      filter_string(filter, *batch, size, bitmap);
+    } else if (filter.right.column < 0) {
+      filter_numeric_constant(filter, *batch, size, bitmap);
+    } else if (filter.left.type == INTS && filter.right.type == INTS) {
+      filter_numeric<int>(filter, *batch, size, bitmap);
+    } else {
+      filter_numeric<float>(filter, *batch, size, bitmap);
+    }
+  }
+
+  int count = 0;
+  for (int i = 0; i < size; i++) {
+    selection[count] = (uint16_t)i;
+    count += bitmap[i];
+  }
+  batch->set_selected_count(count);
+  return RC::SUCCESS;
+}
+
+RC BatchPredicateOperator::close()
+{
+  return children_[0]->close();
+}
@@ -0,0 +1,63 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <string>
+#include "sql/operator/batch_operator.h"
+#include "sql/expr/tuple_cell.h"
+
+class FilterUnit;
+
+/**
+ * 向量化的过滤，每个条件按照两边的类型选择一个循环，只修改批中的selection
+ * 支持字段和常量之间的比较，类型是INTS、FLOATS、CHARS，或者INTS和FLOATS混合，
+ * 以及日期字段和字符串常量的比较。数值字段与常量的比较使用SIMD
+ */
+class BatchPredicateOperator : public BatchOperator
+{
+public:
+  BatchPredicateOperator(const std::vector<const FilterUnit *> &filter_units) : filter_units_(filter_units)
+  {}
+
+  virtual ~BatchPredicateOperator() = default;
+
+  static bool can_filter(const std::vector<const FilterUnit *> &filter_units);
+
+  RC open() override;
+  RC next_batch(ColumnBatch *&batch) override;
+  RC close() override;
+
+public:
+  /**
+   * 一个条件的一侧，字段时是批中的列号，否则是常量
+   */
+  struct Operand {
+    int column = -1;
+    AttrType type = UNDEFINED;
+    TupleCell value;
+    std::string date;  // 与日期比较时，格式化之后的常量
+  };
+  struct Filter {
+    CompOp comp = NO_OP;
+    Operand left;
+    Operand right;
+  };
+
+private:
+  RC bind(const ColumnBatch &batch);
+
+private:
+  std::vector<const FilterUnit *> filter_units_;
+  std::vector<Filter> filters_;
+  std::vector<uint8_t> bitmap_;  // 每行一个字节，1表示满足所有条件
+  bool bound_ = false;
+  bool always_false_ = false;  // 常量之间的比较结果为假
+};
@@ -0,0 +1,66 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "common/log/log.h"
+#include "sql/operator/batch_project_operator.h"
+
+RC BatchProjectOperator::open()
+{
+  if (children_.size() != 1) {
+    LOG_WARN("batch project operator must has one child");
+    return RC::INTERNAL;
+  }
+  batch_.init(fields_);
+  columns_.clear();
+  return children_[0]->open();
+}
+
+RC BatchProjectOperator::next_batch(ColumnBatch *&batch)
+{
+  ColumnBatch *input = nullptr;
+  RC rc = children_[0]->next_batch(input);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  if (columns_.empty()) {
+    for (const Field &field : fields_) {
+      const int index = input->column_index(field.field_name());
+      if (index < 0) {
+        LOG_WARN("field is not in batch. field=%s", field.field_name());
+        return RC::SCHEMA_FIELD_MISSING;
+      }
+      columns_.push_back(index);
+    }
+  }
+
+  const uint16_t *selection = input->selection();
+  const int count = input->selected_count();
+  for (size_t i = 0; i < columns_.size(); i++) {
+    const ColumnVector &from = input->column(columns_[i]);
+    ColumnVector &to = batch_.column((int)i);
+    const int width = from.width();
+    const char *src = from.data();
+    char *dst = to.data();
+    for (int j = 0; j < count; j++) {
+      memcpy(dst + (size_t)j * width, src + (size_t)selection[j] * width, width);
+    }
+  }
+  batch_.reset(count);
+  batch = &batch_;
+  return RC::SUCCESS;
+}
+
+RC BatchProjectOperator::close()
+{
+  return children_[0]->close();
+}
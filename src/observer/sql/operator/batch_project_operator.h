@@ -0,0 +1,34 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/operator/batch_operator.h"
+
+/**
+ * 按照selection把需要输出的字段拷贝到一个紧凑的批中，输出的批中所有行都有效
+ */
+class BatchProjectOperator : public BatchOperator
+{
+public:
+  BatchProjectOperator(const std::vector<Field> &fields) : fields_(fields)
+  {}
+
+  virtual ~BatchProjectOperator() = default;
+
+  RC open() override;
+  RC next_batch(ColumnBatch *&batch) override;
+  RC close() override;
+
+private:
+  std::vector<Field> fields_;
+  std::vector<int> columns_;  // 每个输出字段在子算子批中的列号
+  ColumnBatch batch_;
+};
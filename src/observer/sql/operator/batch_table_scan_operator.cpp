@@ -0,0 +1,107 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "common/log/log.h"
+#include "sql/operator/batch_table_scan_operator.h"
+#include "storage/common/table.h"
+
+RC BatchTableScanOperator::open()
+{
+  if (parallel_scan_ == nullptr) {
+    RC rc = table_->get_record_scanner(record_scanner_);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to open record scanner. table=%s, rc=%s", table_->name(), strrc(rc));
+      return rc;
+    }
+  }
+  page_index_ = 0;
+  morsel_end_ = 0;
+  batch_.init(fields_);
+  offsets_.clear();
+  for (const Field &field : fields_) {
+    offsets_.push_back(field.meta()->offset());
+  }
+  return RC::SUCCESS;
+}
+
+void BatchTableScanOperator::copy_record(const char *data, int row)
+{
+  const int column_num = batch_.column_num();
+  for (int i = 0; i < column_num; i++) {
+    ColumnVector &column = batch_.column(i);
+    memcpy(column.value(row), data + offsets_[i], column.width());
+  }
+}
+
+RC BatchTableScanOperator::next_parallel_record(Record &record)
+{
+  while (!page_fetched_ || !page_iterator_.has_next()) {
+    if (page_fetched_) {
+      parallel_scan_->release_page(page_handler_);
+      page_fetched_ = false;
+    }
+    if (page_index_ >= morsel_end_ && !parallel_scan_->next_morsel(page_index_, morsel_end_)) {
+      return RC::RECORD_EOF;
+    }
+    RC rc = parallel_scan_->fetch_page(page_index_++, page_handler_);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    page_fetched_ = true;
+    page_iterator_.init(page_handler_);
+  }
+  return page_iterator_.next(record);
+}
+
+RC BatchTableScanOperator::next_batch(ColumnBatch *&batch)
+{
+  int rows = 0;
+  Record record;
+  if (parallel_scan_ != nullptr) {
+    RC rc = RC::SUCCESS;
+    while (rows < ColumnBatch::CAPACITY && RC::SUCCESS == (rc = next_parallel_record(record))) {
+      copy_record(record.data(), rows++);
+    }
+    if (rc != RC::SUCCESS && rc != RC::RECORD_EOF) {
+      LOG_WARN("failed to read record. table=%s, rc=%s", table_->name(), strrc(rc));
+      return rc;
+    }
+  } else {
+    while (rows < ColumnBatch::CAPACITY && record_scanner_.has_next()) {
+      RC rc = record_scanner_.next(record);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to read record. table=%s, rc=%s", table_->name(), strrc(rc));
+        return rc;
+      }
+      copy_record(record.data(), rows++);
+    }
+  }
+
+  if (rows == 0) {
+    return RC::RECORD_EOF;
+  }
+  batch_.reset(rows);
+  batch = &batch_;
+  return RC::SUCCESS;
+}
+
+RC BatchTableScanOperator::close()
+{
+  if (parallel_scan_ != nullptr) {
+    if (page_fetched_) {
+      parallel_scan_->release_page(page_handler_);
+      page_fetched_ = false;
+    }
+    return RC::SUCCESS;
+  }
+  return record_scanner_.close_scan();
+}
@@ -0,0 +1,60 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/operator/batch_operator.h"
+#include "storage/common/record_manager.h"
+
+class Table;
+
+/**
+ * 扫描整个表，把需要的字段按列拷贝到批中
+ * 设置了ParallelRecordScan时只扫描自己领取到的页面，多个算子在不同线程中共同扫描一个表
+ */
+class BatchTableScanOperator : public BatchOperator
+{
+public:
+  BatchTableScanOperator(Table *table, const std::vector<Field> &fields) : table_(table), fields_(fields)
+  {}
+
+  virtual ~BatchTableScanOperator() = default;
+
+  void set_parallel_scan(ParallelRecordScan *parallel_scan)
+  {
+    parallel_scan_ = parallel_scan;
+  }
+
+  RC open() override;
+  RC next_batch(ColumnBatch *&batch) override;
+  RC close() override;
+
+private:
+  /**
+   * 并行扫描时取下一条记录，当前页面读完后释放并领取下一个页面
+   * @return 领取的页面都读完时返回RECORD_EOF
+   */
+  RC next_parallel_record(Record &record);
+  void copy_record(const char *data, int row);
+
+private:
+  Table *table_ = nullptr;
+  std::vector<Field> fields_;
+  std::vector<int> offsets_;  // 每个字段在记录中的偏移
+  RecordFileScanner record_scanner_;
+  ColumnBatch batch_;
+
+  ParallelRecordScan *parallel_scan_ = nullptr;
+  int page_index_ = 0;  // 当前morsel中下一个要读的页面
+  int morsel_end_ = 0;
+  bool page_fetched_ = false;
+  RecordPageHandler page_handler_;
+  RecordPageIterator page_iterator_;
+};
@@ -0,0 +1,50 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "sql/operator/column_batch.h"
+#include "storage/common/field_meta.h"
+
+void ColumnVector::init(const Field &field, int capacity)
+{
+  field_ = field;
+  width_ = field.meta()->len();
+  data_.assign((size_t)width_ * capacity, 0);
+}
+
+void ColumnBatch::init(const std::vector<Field> &fields)
+{
+  columns_.resize(fields.size());
+  for (size_t i = 0; i < fields.size(); i++) {
+    columns_[i].init(fields[i], CAPACITY);
+  }
+  selection_.resize(CAPACITY);
+  reset(0);
+}
+
+int ColumnBatch::column_index(const char *field_name) const
+{
+  for (size_t i = 0; i < columns_.size(); i++) {
+    if (0 == strcmp(columns_[i].field().field_name(), field_name)) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+void ColumnBatch::reset(int size)
+{
+  size_ = size;
+  selected_count_ = size;
+  for (int i = 0; i < size; i++) {
+    selection_[i] = (uint16_t)i;
+  }
+}
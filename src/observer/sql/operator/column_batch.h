@@ -0,0 +1,130 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "storage/common/field.h"
+
+/**
+ * 一列数据，按照字段的类型和长度连续存放，第i行在data() + i * width()
+ */
+class ColumnVector
+{
+public:
+  void init(const Field &field, int capacity);
+
+  const Field &field() const
+  {
+    return field_;
+  }
+  AttrType type() const
+  {
+    return field_.attr_type();
+  }
+  int width() const
+  {
+    return width_;
+  }
+
+  char *data()
+  {
+    return data_.data();
+  }
+  const char *data() const
+  {
+    return data_.data();
+  }
+  const char *value(int row) const
+  {
+    return data_.data() + (size_t)row * width_;
+  }
+  char *value(int row)
+  {
+    return data_.data() + (size_t)row * width_;
+  }
+
+  template <typename T>
+  const T *values() const
+  {
+    return (const T *)data_.data();
+  }
+
+private:
+  Field field_;
+  int width_ = 0;
+  std::vector<char> data_;
+};
+
+/**
+ * 向量化执行时算子之间传递的一批数据
+ * selection中按照顺序保存有效行的下标，过滤时只修改selection，不移动列中的数据
+ */
+class ColumnBatch
+{
+public:
+  static const int CAPACITY = 1024;
+
+  void init(const std::vector<Field> &fields);
+
+  int column_num() const
+  {
+    return (int)columns_.size();
+  }
+  ColumnVector &column(int index)
+  {
+    return columns_[index];
+  }
+  const ColumnVector &column(int index) const
+  {
+    return columns_[index];
+  }
+  /**
+   * @return 没有这个字段时返回-1
+   */
+  int column_index(const char *field_name) const;
+
+  /**
+   * 列中已经填充的行数
+   */
+  int size() const
+  {
+    return size_;
+  }
+  /**
+   * 设置填充的行数，所有行都有效
+   */
+  void reset(int size);
+
+  int selected_count() const
+  {
+    return selected_count_;
+  }
+  void set_selected_count(int count)
+  {
+    selected_count_ = count;
+  }
+  const uint16_t *selection() const
+  {
+    return selection_.data();
+  }
+  uint16_t *selection()
+  {
+    return selection_.data();
+  }
+
+private:
+  std::vector<ColumnVector> columns_;
+  std::vector<uint16_t> selection_;
+  int size_ = 0;
+  int selected_count_ = 0;
+};
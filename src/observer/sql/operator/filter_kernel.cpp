@@ -0,0 +1,207 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <math.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "common/log/log.h"
+#include "sql/operator/filter_kernel.h"
+
+namespace {
+
+// 与comparator中的epsilon相同，按double比较
+const double COMPARE_EPSILON = 1E-6;
+
+float min_float_above(double value)
+{
+  float result = (float)value;
+  if ((double)result <= value) {
+    result = nextafterf(result, INFINITY);
+  }
+  return result;
+}
+
+}  // namespace
+
+// float差值cmp满足 cmp > 1E-6 当且仅当 cmp >= FILTER_FLOAT_EPSILON
+const float FILTER_FLOAT_EPSILON = min_float_above(COMPARE_EPSILON);
+
+bool filter_test(CompOp comp, int compare)
+{
+  switch (comp) {
+    case EQUAL_TO: return filter_test<EQUAL_TO>(compare);
+    case LESS_EQUAL: return filter_test<LESS_EQUAL>(compare);
+    case NOT_EQUAL: return filter_test<NOT_EQUAL>(compare);
+    case LESS_THAN: return filter_test<LESS_THAN>(compare);
+    case GREAT_EQUAL: return filter_test<GREAT_EQUAL>(compare);
+    case GREAT_THAN: return filter_test<GREAT_THAN>(compare);
+    default: {
+      LOG_WARN("invalid compare type: %d", comp);
+    } break;
+  }
+  return false;
+}
+
+CompOp filter_swap_comp(CompOp comp)
+{
+  switch (comp) {
+    case LESS_EQUAL: return GREAT_EQUAL;
+    case LESS_THAN: return GREAT_THAN;
+    case GREAT_EQUAL: return LESS_EQUAL;
+    case GREAT_THAN: return LESS_THAN;
+    default: return comp;
+  }
+}
+
+namespace {
+
+#if defined(__SSE2__)
+/**
+ * 根据小于、等于、大于三个掩码得到比较符对应的掩码
+ */
+template <CompOp OP>
+inline __m128i select_mask(__m128i lt, __m128i eq, __m128i gt)
+{
+  const __m128i ones = _mm_set1_epi32(-1);
+  switch (OP) {
+    case EQUAL_TO: return eq;
+    case NOT_EQUAL: return _mm_xor_si128(eq, ones);
+    case LESS_THAN: return lt;
+    case LESS_EQUAL: return _mm_xor_si128(gt, ones);
+    case GREAT_THAN: return gt;
+    case GREAT_EQUAL: return _mm_xor_si128(lt, ones);
+    default: return _mm_setzero_si128();
+  }
+}
+
+struct IntSimd {
+  explicit IntSimd(int constant) : constant(_mm_set1_epi32(constant))
+  {}
+
+  template <CompOp OP>
+  __m128i mask(const int *values) const
+  {
+    const __m128i v = _mm_loadu_si128((const __m128i *)values);
+    return select_mask<OP>(_mm_cmplt_epi32(v, constant), _mm_cmpeq_epi32(v, constant), _mm_cmpgt_epi32(v, constant));
+  }
+
+  __m128i constant;
+};
+
+struct FloatSimd {
+  explicit FloatSimd(float constant)
+      : constant(_mm_set1_ps(constant)),
+        epsilon(_mm_set1_ps(FILTER_FLOAT_EPSILON)),
+        neg_epsilon(_mm_set1_ps(-FILTER_FLOAT_EPSILON))
+  {}
+
+  template <CompOp OP>
+  __m128i compare(__m128 v) const
+  {
+    const __m128 cmp = _mm_sub_ps(v, constant);
+    const __m128i gt = _mm_castps_si128(_mm_cmpge_ps(cmp, epsilon));
+    const __m128i lt = _mm_castps_si128(_mm_cmple_ps(cmp, neg_epsilon));
+    const __m128i eq = _mm_xor_si128(_mm_or_si128(gt, lt), _mm_set1_epi32(-1));
+    return select_mask<OP>(lt, eq, gt);
+  }
+
+  template <CompOp OP>
+  __m128i mask(const float *values) const
+  {
+    return compare<OP>(_mm_loadu_ps(values));
+  }
+
+  template <CompOp OP>
+  __m128i mask(const int *values) const
+  {
+    return compare<OP>(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)values)));
+  }
+
+  __m128 constant;
+  __m128 epsilon;
+  __m128 neg_epsilon;
+};
+
+template <typename C>
+struct SimdOf;
+template <>
+struct SimdOf<int> {
+  typedef IntSimd type;
+};
+template <>
+struct SimdOf<float> {
+  typedef FloatSimd type;
+};
+#endif
+
+/**
+ * @tparam T 列中值的类型
+ * @tparam C 比较时使用的类型
+ */
+template <CompOp OP, typename T, typename C>
+void filter_column(const T *values, int count, C constant, uint8_t *bitmap)
+{
+  int i = 0;
+#if defined(__SSE2__)
+  // 每次比较16个值，4组掩码压缩成16个字节
+  const typename SimdOf<C>::type simd(constant);
+  const __m128i one = _mm_set1_epi8(1);
+  for (; i + 16 <= count; i += 16) {
+    const __m128i m0 = simd.template mask<OP>(values + i);
+    const __m128i m1 = simd.template mask<OP>(values + i + 4);
+    const __m128i m2 = simd.template mask<OP>(values + i + 8);
+    const __m128i m3 = simd.template mask<OP>(values + i + 12);
+    const __m128i bytes = _mm_packs_epi16(_mm_packs_epi32(m0, m1), _mm_packs_epi32(m2, m3));
+    const __m128i old = _mm_loadu_si128((const __m128i *)(bitmap + i));
+    _mm_storeu_si128((__m128i *)(bitmap + i), _mm_and_si128(old, _mm_and_si128(bytes, one)));
+  }
+#endif
+  for (; i < count; i++) {
+    bitmap[i] &= filter_test<OP>(filter_compare((C)values[i], constant));
+  }
+}
+
+template <typename T, typename C>
+void filter_column(CompOp comp, const T *values, int count, C constant, uint8_t *bitmap)
+{
+  switch (comp) {
+    case EQUAL_TO: filter_column<EQUAL_TO>(values, count, constant, bitmap); break;
+    case LESS_EQUAL: filter_column<LESS_EQUAL>(values, count, constant, bitmap); break;
+    case NOT_EQUAL: filter_column<NOT_EQUAL>(values, count, constant, bitmap); break;
+    case LESS_THAN: filter_column<LESS_THAN>(values, count, constant, bitmap); break;
+    case GREAT_EQUAL: filter_column<GREAT_EQUAL>(values, count, constant, bitmap); break;
+    case GREAT_THAN: filter_column<GREAT_THAN>(values, count, constant, bitmap); break;
+    default: {
+      LOG_WARN("invalid compare type: %d", comp);
+      for (int i = 0; i < count; i++) {
+        bitmap[i] = 0;
+      }
+    } break;
+  }
+}
+
+}  // namespace
+
+void filter_int_column(CompOp comp, const int *values, int count, int constant, uint8_t *bitmap)
+{
+  filter_column(comp, values, count, constant, bitmap);
+}
+
+void filter_float_column(CompOp comp, const float *values, int count, float constant, uint8_t *bitmap)
+{
+  filter_column(comp, values, count, constant, bitmap);
+}
+
+void filter_int_column(CompOp comp, const int *values, int count, float constant, uint8_t *bitmap)
+{
+  filter_column(comp, values, count, constant, bitmap);
+}
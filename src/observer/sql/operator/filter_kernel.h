@@ -0,0 +1,63 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include "sql/parser/parse_defs.h"
+
+/**
+ * 过滤条件中字段与常量比较的专用实现，比较结果与TupleCell::compare一致
+ * 浮点数之间的差在epsilon以内时认为相等
+ */
+
+// float差值大于这个值时等价于大于comparator中的epsilon
+extern const float FILTER_FLOAT_EPSILON;
+
+inline int filter_compare(int left, int right)
+{
+  return (left > right) - (left < right);
+}
+
+inline int filter_compare(float left, float right)
+{
+  const float cmp = left - right;
+  return (cmp >= FILTER_FLOAT_EPSILON) - (cmp <= -FILTER_FLOAT_EPSILON);
+}
+
+template <CompOp OP>
+inline bool filter_test(int compare)
+{
+  switch (OP) {
+    case EQUAL_TO: return compare == 0;
+    case LESS_EQUAL: return compare <= 0;
+    case NOT_EQUAL: return compare != 0;
+    case LESS_THAN: return compare < 0;
+    case GREAT_EQUAL: return compare >= 0;
+    case GREAT_THAN: return compare > 0;
+    default: return false;
+  }
+}
+
+bool filter_test(CompOp comp, int compare);
+
+/**
+ * 交换比较的两边时对应的比较符，比如 1 < a 等价于 a > 1
+ */
+CompOp filter_swap_comp(CompOp comp);
+
+/**
+ * 一列连续的count个值与常量比较，不满足条件的行在bitmap中置0，bitmap中每行一个字节
+ * 支持SSE2时每次比较16个值
+ */
+void filter_int_column(CompOp comp, const int *values, int count, int constant, uint8_t *bitmap);
+void filter_float_column(CompOp comp, const float *values, int count, float constant, uint8_t *bitmap);
+// 整数列与浮点常量比较，整数先转换成浮点数
+void filter_int_column(CompOp comp, const int *values, int count, float constant, uint8_t *bitmap);
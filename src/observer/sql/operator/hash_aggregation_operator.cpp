@@ -0,0 +1,509 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "common/log/log.h"
+#include "sql/operator/hash_aggregation_operator.h"
+#include "sql/operator/aggre_result.h"
+#include "sql/expr/tuple_cell.h"
+#include "storage/common/table.h"
+
+RC GroupTuple::cell_at(int index, TupleCell &cell) const
+{
+  if (index < 0 || index >= (int)fields_.size()) {
+    LOG_WARN("invalid argument. index=%d", index);
+    return RC::INVALID_ARGUMENT;
+  }
+  const FieldMeta *field_meta = fields_[index].meta();
+  cell.set_type(field_meta->type());
+  cell.set_data(key_ + offsets_[index]);
+  cell.set_length(field_meta->len());
+  return RC::SUCCESS;
+}
+
+RC GroupTuple::find_cell(const Field &field, TupleCell &cell) const
+{
+  // 分组字段和输出字段都来自同一个表的元数据
+  for (size_t i = 0; i < fields_.size(); i++) {
+    if (fields_[i].meta() == field.meta()) {
+      return cell_at(i, cell);
+    }
+  }
+  return RC::NOTFOUND;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 每一层分区使用哈希值中的PARTITION_BITS位，从高位开始取，低位留给哈希表的槽
+static const int PARTITION_BITS = 4;
+static const int PARTITION_NUM = 1 << PARTITION_BITS;
+static const int MAX_PARTITION_LEVEL = 4;
+// 负载因子不超过一半，每个分组平均占用两个槽
+static const int SLOT_OVERHEAD = 2 * 8;
+static const int INITIAL_SLOTS = 256;
+
+static int64_t default_memory_budget = 64 * 1024 * 1024;
+
+static int partition_of(uint32_t hash, int level)
+{
+  return (hash >> (32 - PARTITION_BITS * (level + 1))) & (PARTITION_NUM - 1);
+}
+
+static uint32_t combine_hash(uint32_t seed, uint32_t hash)
+{
+  return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+static int align8(int size)
+{
+  return (size + 7) & ~7;
+}
+
+HashAggregationOperator::HashAggregationOperator(const std::vector<Field> &group_fields,
+                                                 const std::vector<Aggregation> &aggregations, Table *table)
+  : group_fields_(group_fields), aggregations_(aggregations), table_(table), memory_budget_(default_memory_budget)
+{}
+
+void HashAggregationOperator::set_default_memory_budget(int64_t bytes)
+{
+  default_memory_budget = bytes;
+}
+
+RC HashAggregationOperator::init_layout()
+{
+  key_offsets_.clear();
+  hashers_.clear();
+  states_.clear();
+
+  key_size_ = 0;
+  for (const Field &field : group_fields_) {
+    key_offsets_.push_back(key_size_);
+    AttrHasher hasher;
+    hasher.init(field.attr_type(), field.meta()->len());
+    hashers_.push_back(hasher);
+    key_size_ += field.meta()->len();
+  }
+
+  int offset = align8(key_size_);
+  for (const Aggregation &aggregation : aggregations_) {
+    AggreState state;
+    state.type = aggregation.type;
+    state.offset = offset;
+    const FieldMeta *field_meta = nullptr;
+    RC rc = check_aggregation(aggregation, table_, field_meta);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (field_meta != nullptr) {
+      state.field = Field(table_, field_meta);
+    }
+
+    // COUNT: 行数; AVG/SUM: 行数和int64_t或者double的和; MIN/MAX: 字段值和结束符
+    switch (aggregation.type) {
+      case COUNT: offset += sizeof(int64_t); break;
+      case AVG:
+      case SUM: offset += sizeof(int64_t) + sizeof(int64_t); break;
+      default: offset += state.field.meta()->len() + 1; break;
+    }
+    offset = align8(offset);
+    states_.push_back(state);
+  }
+  group_size_ = offset;
+  key_.resize(key_size_);
+  return RC::SUCCESS;
+}
+
+uint32_t HashAggregationOperator::key_hash(const char *key) const
+{
+  uint32_t hash = 0;
+  for (size_t i = 0; i < hashers_.size(); i++) {
+    hash = combine_hash(hash, hashers_[i](key + key_offsets_[i]));
+  }
+  return hash;
+}
+
+RC HashAggregationOperator::make_key(const Tuple &tuple, char *key, uint32_t &hash) const
+{
+  TupleCell cell;
+  for (size_t i = 0; i < group_fields_.size(); i++) {
+    const Field &field = group_fields_[i];
+    RC rc = tuple.find_cell(field, cell);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to find group field. field=%s", field.field_name());
+      return rc;
+    }
+
+    // key按字节比较，字符串结束符后面的内容清零，-0.0与0.0统一
+    char *dest = key + key_offsets_[i];
+    const int len = field.meta()->len();
+    switch (field.attr_type()) {
+      case CHARS:
+      case DATES: {
+        const size_t n = strnlen(cell.data(), len);
+        memcpy(dest, cell.data(), n);
+        memset(dest + n, 0, len - n);
+      } break;
+      case FLOATS: {
+        float value = *(const float *)cell.data();
+        if (value == 0) {
+          value = 0;
+        }
+        memcpy(dest, &value, sizeof(value));
+      } break;
+      default: {
+        memcpy(dest, cell.data(), len);
+      } break;
+    }
+  }
+  hash = key_hash(key);
+  return RC::SUCCESS;
+}
+
+int64_t HashAggregationOperator::memory_usage(int groups) const
+{
+  return (int64_t)groups * (group_size_ + SLOT_OVERHEAD);
+}
+
+void HashAggregationOperator::clear_table()
+{
+  groups_.clear();
+  group_count_ = 0;
+  slots_.assign(INITIAL_SLOTS, Slot{0, 0});
+  output_index_ = 0;
+}
+
+void HashAggregationOperator::grow_table()
+{
+  std::vector<Slot> slots(slots_.size() * 2, Slot{0, 0});
+  const uint32_t mask = slots.size() - 1;
+  for (const Slot &slot : slots_) {
+    if (slot.group == 0) {
+      continue;
+    }
+    uint32_t index = slot.hash & mask;
+    while (slots[index].group != 0) {
+      index = (index + 1) & mask;
+    }
+    slots[index] = slot;
+  }
+  slots_.swap(slots);
+}
+
+RC HashAggregationOperator::find_or_insert(const char *key, uint32_t hash, int level, char *&group, bool &inserted)
+{
+  uint32_t mask = slots_.size() - 1;
+  uint32_t index = hash & mask;
+  for (; slots_[index].group != 0; index = (index + 1) & mask) {
+    const Slot &slot = slots_[index];
+    if (slot.hash == hash && 0 == memcmp(this->group(slot.group - 1), key, key_size_)) {
+      group = this->group(slot.group - 1);
+      inserted = false;
+      return RC::SUCCESS;
+    }
+  }
+
+  // 新的分组放不下时先把已有的部分聚合结果写出去，最后一层或者一行超过页面大小时只能继续使用内存
+  if (group_count_ > 0 && memory_usage(group_count_ + 1) > memory_budget_ && level < MAX_PARTITION_LEVEL &&
+      SpillFile::can_spill(group_size_)) {
+    RC rc = spill(level);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  if ((size_t)(group_count_ + 1) * 2 > slots_.size()) {
+    grow_table();
+  }
+  mask = slots_.size() - 1;
+  index = hash & mask;
+  while (slots_[index].group != 0) {
+    index = (index + 1) & mask;
+  }
+
+  groups_.resize((size_t)(group_count_ + 1) * group_size_, 0);
+  group = this->group(group_count_);
+  memcpy(group, key, key_size_);
+  group_count_++;
+  slots_[index] = Slot{hash, (uint32_t)group_count_};
+  inserted = true;
+  return RC::SUCCESS;
+}
+
+RC HashAggregationOperator::update(char *group, const Tuple &tuple, bool first)
+{
+  TupleCell cell;
+  for (const AggreState &state : states_) {
+    char *data = group + state.offset;
+    if (state.type == COUNT) {
+      (*(int64_t *)data)++;
+      continue;
+    }
+
+    RC rc = tuple.find_cell(state.field, cell);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to find aggregation field. field=%s", state.field.field_name());
+      return rc;
+    }
+    if (state.type == AVG || state.type == SUM) {
+      (*(int64_t *)data)++;
+      if (cell.attr_type() == INTS) {
+        *(int64_t *)(data + sizeof(int64_t)) += *(const int *)cell.data();
+      } else {
+        *(double *)(data + sizeof(int64_t)) += *(const float *)cell.data();
+      }
+      continue;
+    }
+
+    const int len = state.field.meta()->len();
+    if (!first) {
+      TupleCell current(state.field.attr_type(), data);
+      current.set_length(len);
+      const int compare = cell.compare(current);
+      if ((state.type == MIN && compare >= 0) || (state.type == MAX && compare <= 0)) {
+        continue;
+      }
+    }
+    memcpy(data, cell.data(), len);
+  }
+  return RC::SUCCESS;
+}
+
+void HashAggregationOperator::merge(char *group, const char *partial)
+{
+  for (const AggreState &state : states_) {
+    char *data = group + state.offset;
+    const char *other = partial + state.offset;
+    switch (state.type) {
+      case COUNT: {
+        *(int64_t *)data += *(const int64_t *)other;
+      } break;
+      case AVG:
+      case SUM: {
+        *(int64_t *)data += *(const int64_t *)other;
+        if (state.field.attr_type() == INTS) {
+          *(int64_t *)(data + sizeof(int64_t)) += *(const int64_t *)(other + sizeof(int64_t));
+        } else {
+          *(double *)(data + sizeof(int64_t)) += *(const double *)(other + sizeof(int64_t));
+        }
+      } break;
+      default: {
+        const int len = state.field.meta()->len();
+        TupleCell current(state.field.attr_type(), data);
+        current.set_length(len);
+        TupleCell cell(state.field.attr_type(), const_cast<char *>(other));
+        cell.set_length(len);
+        const int compare = cell.compare(current);
+        if ((state.type == MIN && compare < 0) || (state.type == MAX && compare > 0)) {
+          memcpy(data, other, len);
+        }
+      } break;
+    }
+  }
+}
+
+RC HashAggregationOperator::spill(int level)
+{
+  if (spill_files_.empty()) {
+    LOG_INFO("hash aggregation exceeds memory budget %lld with %d groups, spill into %d partitions at level %d",
+             (long long)memory_budget_, group_count_, PARTITION_NUM, level);
+    for (int i = 0; i < PARTITION_NUM; i++) {
+      spill_files_.emplace_back(new SpillFile(group_size_));
+    }
+  }
+
+  for (const Slot &slot : slots_) {
+    if (slot.group == 0) {
+      continue;
+    }
+    RC rc = spill_files_[partition_of(slot.hash, level)]->append(group(slot.group - 1));
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to spill group. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  clear_table();
+  return RC::SUCCESS;
+}
+
+RC HashAggregationOperator::finish_level(int level)
+{
+  if (spill_files_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  // 已经分区时剩下的分组也写出去，同一个分组可能在多个分区文件中都有部分结果
+  RC rc = spill(level);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  for (std::unique_ptr<SpillFile> &file : spill_files_) {
+    if (file->row_count() == 0) {
+      continue;
+    }
+    Partition partition;
+    partition.level = level + 1;
+    partition.file = std::move(file);
+    pending_.push_back(std::move(partition));
+    spilled_partitions_++;
+  }
+  spill_files_.clear();
+  return RC::SUCCESS;
+}
+
+RC HashAggregationOperator::aggregate_partition(Partition &partition)
+{
+  clear_table();
+  RC rc = partition.file->rewind();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to rewind spill file. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  const char *row = nullptr;
+  while (RC::SUCCESS == (rc = partition.file->next(row))) {
+    char *group = nullptr;
+    bool inserted = false;
+    rc = find_or_insert(row, key_hash(row), partition.level, group, inserted);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (inserted) {
+      memcpy(group + key_size_, row + key_size_, group_size_ - key_size_);
+    } else {
+      merge(group, row);
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read spill file. rc=%s", strrc(rc));
+    return rc;
+  }
+  partition.file.reset();
+  return finish_level(partition.level);
+}
+
+RC HashAggregationOperator::open()
+{
+  if (children_.size() != 1) {
+    LOG_WARN("hash aggregation operator must has 1 child");
+    return RC::INTERNAL;
+  }
+
+  RC rc = init_layout();
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  Operator *child = children_[0];
+  rc = child->open();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open child operator: %s", strrc(rc));
+    return rc;
+  }
+
+  clear_table();
+  spill_files_.clear();
+  pending_.clear();
+  spilled_partitions_ = 0;
+
+  while (RC::SUCCESS == (rc = child->next())) {
+    const Tuple &tuple = *child->current_tuple();
+    uint32_t hash = 0;
+    rc = make_key(tuple, key_.data(), hash);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    char *group = nullptr;
+    bool inserted = false;
+    rc = find_or_insert(key_.data(), hash, 0, group, inserted);
+    if (rc == RC::SUCCESS) {
+      rc = update(group, tuple, inserted);
+    }
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read child operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = finish_level(0);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  tuple_.init(group_fields_, key_offsets_);
+  aggre_results_.assign(aggregations_.size(), AggreResult());
+  return RC::SUCCESS;
+}
+
+void HashAggregationOperator::fill_results(char *group)
+{
+  for (size_t i = 0; i < states_.size(); i++) {
+    const AggreState &state = states_[i];
+    char *data = group + state.offset;
+    AggreResult &result = aggre_results_[i];
+    result.type = state.type;
+    switch (state.type) {
+      case COUNT: {
+        result.count = *(int64_t *)data;
+      } break;
+      case AVG:
+      case SUM: {
+        result.count = *(int64_t *)data;
+        result.result.type = state.field.attr_type();
+        if (state.field.attr_type() == INTS) {
+          result.int_sum = *(int64_t *)(data + sizeof(int64_t));
+        } else {
+          result.float_sum = *(double *)(data + sizeof(int64_t));
+        }
+      } break;
+      default: {
+        result.result.type = state.field.attr_type();
+        result.result.data = data;
+        result.char_length = state.field.meta()->len();
+      } break;
+    }
+  }
+}
+
+RC HashAggregationOperator::next()
+{
+  while (output_index_ >= group_count_) {
+    if (pending_.empty()) {
+      return RC::RECORD_EOF;
+    }
+    Partition partition = std::move(pending_.front());
+    pending_.pop_front();
+    RC rc = aggregate_partition(partition);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  char *current = group(output_index_++);
+  tuple_.set_key(current);
+  fill_results(current);
+  return RC::SUCCESS;
+}
+
+RC HashAggregationOperator::close()
+{
+  if (spilled_partitions_ > 0) {
+    LOG_INFO("hash aggregation spilled %d partitions", spilled_partitions_);
+  }
+  groups_.clear();
+  slots_.clear();
+  group_count_ = 0;
+  output_index_ = 0;
+  spill_files_.clear();
+  pending_.clear();
+  children_[0]->close();
+  return RC::SUCCESS;
+}
@@ -0,0 +1,176 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "sql/operator/operator.h"
+#include "storage/common/field.h"
+#include "storage/index/extendible_hash.h"
+#include "storage/default/spill_file.h"
+#include "rc.h"
+
+/**
+ * 一个分组的分组字段，按照分组字段查找
+ */
+class GroupTuple : public Tuple
+{
+public:
+  GroupTuple() = default;
+  virtual ~GroupTuple() = default;
+
+  void init(const std::vector<Field> &fields, const std::vector<int> &offsets)
+  {
+    fields_ = fields;
+    offsets_ = offsets;
+  }
+  void set_key(const char *key)
+  {
+    key_ = key;
+  }
+
+  int cell_num() const override
+  {
+    return fields_.size();
+  }
+  RC cell_at(int index, TupleCell &cell) const override;
+  RC find_cell(const Field &field, TupleCell &cell) const override;
+  RC cell_spec_at(int index, const TupleCellSpec *&spec) const override
+  {
+    return RC::NOTFOUND;
+  }
+
+private:
+  std::vector<Field> fields_;
+  std::vector<int> offsets_;
+  const char *key_ = nullptr;
+};
+
+/**
+ * GROUP BY的哈希聚合，open时读完子算子的全部数据，之后每次next输出一个分组
+ * 分组通过current_tuple按字段访问，聚合结果通过aggre_results访问
+ *
+ * 每个分组是定长的一项：分组字段拼接成的key，后面是每个聚合函数的中间状态。
+ * 哈希表使用开放寻址，槽里只保存哈希值和分组的下标，分组本身连续存放。
+ * 分组个数超过内存限制时，把哈希表中已经部分聚合的分组按照哈希值写到多个分区文件中，
+ * 清空哈希表之后继续读取。输入读完之后逐个分区合并中间状态，分区仍然放不下时用哈希值的其它位再次分区
+ */
+class HashAggregationOperator : public Operator
+{
+public:
+  HashAggregationOperator(const std::vector<Field> &group_fields, const std::vector<Aggregation> &aggregations,
+                          Table *table);
+
+  virtual ~HashAggregationOperator() = default;
+
+  /**
+   * 哈希表最多使用的字节数，包括分组数据和槽
+   */
+  static void set_default_memory_budget(int64_t bytes);
+  void set_memory_budget(int64_t bytes)
+  {
+    memory_budget_ = bytes;
+  }
+
+  /**
+   * 写到临时文件中的分区个数，包括分区之后再次分区的
+   */
+  int spilled_partitions() const
+  {
+    return spilled_partitions_;
+  }
+
+  RC open() override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override
+  {
+    return &tuple_;
+  }
+
+  const std::vector<Aggregation> &aggregations() const
+  {
+    return aggregations_;
+  }
+  /**
+   * 当前分组的聚合结果，MIN/MAX的值指向分组内部的数据，下一次调用next之前有效
+   */
+  const std::vector<AggreResult> &aggre_results() const
+  {
+    return aggre_results_;
+  }
+
+private:
+  // 一个聚合函数的中间状态在分组中的位置
+  struct AggreState {
+    AggreType type;
+    Field field;         // COUNT(*)时没有字段
+    int offset = 0;
+  };
+
+  struct Slot {
+    uint32_t hash;
+    uint32_t group;      // 分组下标加1，0表示空槽
+  };
+
+  struct Partition {
+    int level = 0;
+    std::unique_ptr<SpillFile> file;
+  };
+
+  RC init_layout();
+  RC make_key(const Tuple &tuple, char *key, uint32_t &hash) const;
+  uint32_t key_hash(const char *key) const;
+  int64_t memory_usage(int groups) const;
+  char *group(int index)
+  {
+    return groups_.data() + (size_t)index * group_size_;
+  }
+
+  void clear_table();
+  void grow_table();
+  RC find_or_insert(const char *key, uint32_t hash, int level, char *&group, bool &inserted);
+  RC update(char *group, const Tuple &tuple, bool first);
+  void merge(char *group, const char *partial);
+
+  RC spill(int level);
+  RC finish_level(int level);
+  RC aggregate_partition(Partition &partition);
+  void fill_results(char *group);
+
+private:
+  std::vector<Field> group_fields_;
+  std::vector<Aggregation> aggregations_;
+  Table *table_ = nullptr;
+
+  std::vector<int> key_offsets_;
+  std::vector<AttrHasher> hashers_;
+  int key_size_ = 0;
+  std::vector<AggreState> states_;
+  int group_size_ = 0;
+  std::vector<char> key_;               // 当前输入行的key
+
+  std::vector<char> groups_;            // 所有分组连续存放
+  int group_count_ = 0;
+  std::vector<Slot> slots_;             // 个数是2的幂
+
+  int64_t memory_budget_;
+  std::vector<std::unique_ptr<SpillFile>> spill_files_;  // 当前层正在写的分区，为空表示没有分区
+  std::deque<Partition> pending_;       // 等待合并的分区
+  int spilled_partitions_ = 0;
+
+  int output_index_ = 0;
+  GroupTuple tuple_;
+  std::vector<AggreResult> aggre_results_;
+};
@@ -35,9 +35,9 @@ RC IndexScanOperator::open()
     return RC::INTERNAL;
   }
 
-  
   IndexScanner *index_scanner = index_->create_scanner(left_cell_.data(), left_cell_.length(), left_inclusive_,
-                                                       right_cell_.data(), right_cell_.length(), right_inclusive_);
+                                                       right_cell_.data(), right_cell_.length(), right_inclusive_,
+                                                       reverse_);
   if (nullptr == index_scanner) {
     LOG_WARN("failed to create index scanner");
     return RC::INTERNAL;
@@ -50,6 +50,11 @@ RC IndexScanOperator::open()
     return RC::INTERNAL;
   }
   index_scanner_ = index_scanner;
+  row_fetched_ = false;
+
+  if (index_only_) {
+    index_only_data_.assign(table_->table_meta().record_size(), 0);
+  }
 
   tuple_.set_schema(table_, table_->table_meta().field_metas());
   
@@ -58,12 +63,29 @@ RC IndexScanOperator::open()
 
 RC IndexScanOperator::next()
 {
+  if (single_row_ && row_fetched_) {
+    return RC::RECORD_EOF;
+  }
+
   RID rid;
+  if (index_only_) {
+    RC rc = index_scanner_->next_entry(&rid, index_only_data_.data());
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    row_fetched_ = true;
+    current_record_.set_rid(rid);
+    current_record_.set_data(index_only_data_.data());
+    return RC::SUCCESS;
+  }
+
   RC rc = index_scanner_->next_entry(&rid);
   if (rc != RC::SUCCESS) {
     return rc;
   }
 
+  row_fetched_ = true;
   return record_handler_->get_record(&rid, &current_record_);
 }
 
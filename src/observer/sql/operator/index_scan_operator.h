@@ -31,6 +31,35 @@ public:
   RC close() override;
 
   Tuple * current_tuple() override;
+
+  /**
+   * 唯一索引上的等值查询，拿到第一条记录后就可以结束扫描
+   */
+  void set_single_row(bool single_row)
+  {
+    single_row_ = single_row;
+  }
+
+  /**
+   * 覆盖索引扫描，直接从索引中拿到需要的字段，不读取数据文件
+   */
+  void set_index_only(bool index_only)
+  {
+    index_only_ = index_only;
+  }
+
+  /**
+   * 按照索引顺序从大到小输出，用于ORDER BY ... DESC
+   */
+  void set_reverse(bool reverse)
+  {
+    reverse_ = reverse;
+  }
+
+  Index *index() const
+  {
+    return index_;
+  }
 private:
   const Table *table_ = nullptr;
   Index *index_ = nullptr;
@@ -44,4 +73,12 @@ private:
   TupleCell right_cell_;
   bool left_inclusive_;
   bool right_inclusive_;
+
+  bool single_row_ = false;
+  bool row_fetched_ = false;
+
+  bool index_only_ = false;
+  std::vector<char> index_only_data_;
+
+  bool reverse_ = false;
 };
@@ -0,0 +1,955 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <algorithm>
+
+#include "common/log/log.h"
+#include "sql/operator/join_operator.h"
+#include "sql/expr/tuple_cell.h"
+#include "storage/common/table.h"
+#include "storage/common/record_manager.h"
+#include "storage/index/index.h"
+
+/**
+ * 把子算子中剩下的数据读出来放到RowSet中
+ */
+static RC fetch_all(Operator *oper, RowSet &rows)
+{
+  RC rc = RC::SUCCESS;
+  while (RC::SUCCESS == (rc = oper->next())) {
+    rows.append(*oper->current_tuple());
+  }
+  return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+}
+
+NestedLoopJoinOperator::NestedLoopJoinOperator(Operator *left, const std::vector<Table *> &left_tables,
+                                               Operator *right, const std::vector<Table *> &right_tables)
+  : JoinOperator(left, right), right_rows_(right_tables), right_tuple_(right_rows_.resident_rows()),
+    left_block_(left_tables), left_block_tuple_(left_block_)
+{}
+
+RC NestedLoopJoinOperator::open()
+{
+  RC rc = left_->open();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open left child. rc=%s", strrc(rc));
+    return rc;
+  }
+  rc = right_->open();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open right child. rc=%s", strrc(rc));
+    left_->close();
+    return rc;
+  }
+
+  right_rows_.clear();
+  while (RC::SUCCESS == (rc = right_->next())) {
+    rc = right_rows_.append(*right_->current_tuple());
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read right child. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  right_index_ = 0;
+  left_fetched_ = false;
+  left_block_.clear();
+  left_index_ = 0;
+  left_eof_ = false;
+  if (right_rows_.spilled()) {
+    LOG_INFO("use block nested loop join. right rows=%d", right_rows_.size());
+    tuple_.clear();
+    tuple_.push_back(&left_block_tuple_);
+    tuple_.push_back(&right_tuple_);
+  }
+  return RC::SUCCESS;
+}
+
+RC NestedLoopJoinOperator::next()
+{
+  if (right_rows_.size() == 0) {
+    return RC::RECORD_EOF;
+  }
+  if (right_rows_.spilled()) {
+    return next_in_blocks();
+  }
+
+  const RowSet &rows = right_rows_.resident_rows();
+  if (!left_fetched_ || right_index_ >= rows.size()) {
+    RC rc = left_->next();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    left_fetched_ = true;
+    right_index_ = 0;
+
+    tuple_.clear();
+    tuple_.push_back(left_->current_tuple());
+    tuple_.push_back(&right_tuple_);
+  }
+
+  right_tuple_.set_row(rows.row(right_index_++));
+  return RC::SUCCESS;
+}
+
+RC NestedLoopJoinOperator::fetch_left_block()
+{
+  left_block_.clear();
+  left_index_ = 0;
+  const int64_t budget = right_rows_.memory_budget();
+  while (!left_eof_ && (left_block_.size() == 0 || (int64_t)left_block_.size() * left_block_.row_size() < budget)) {
+    RC rc = left_->next();
+    if (rc == RC::RECORD_EOF) {
+      left_eof_ = true;
+    } else if (rc != RC::SUCCESS) {
+      return rc;
+    } else {
+      left_block_.append(*left_->current_tuple());
+    }
+  }
+  return left_block_.size() == 0 ? RC::RECORD_EOF : RC::SUCCESS;
+}
+
+RC NestedLoopJoinOperator::next_in_blocks()
+{
+  while (true) {
+    if (left_index_ < left_block_.size()) {
+      left_block_tuple_.set_row(left_block_.row(left_index_++));
+      return RC::SUCCESS;
+    }
+
+    // 当前右边的行已经和这一块左边的数据都连接过，换右边的下一行
+    const char *row = nullptr;
+    RC rc = left_block_.size() == 0 ? RC::RECORD_EOF : right_rows_.next(row);
+    if (rc == RC::SUCCESS) {
+      right_tuple_.set_row(row);
+      left_index_ = 0;
+      continue;
+    }
+    if (rc != RC::RECORD_EOF) {
+      LOG_WARN("failed to read right rows. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    // 右边读完了，读左边的下一块，再从头读右边
+    rc = fetch_left_block();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    rc = right_rows_.rewind();
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to rewind right rows. rc=%s", strrc(rc));
+      return rc;
+    }
+    left_index_ = left_block_.size();
+  }
+}
+
+RC NestedLoopJoinOperator::close()
+{
+  right_rows_.clear();
+  left_block_.clear();
+  left_->close();
+  right_->close();
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 每一层分区使用哈希值中的PARTITION_BITS位
+static const int PARTITION_BITS = 4;
+static const int PARTITION_NUM = 1 << PARTITION_BITS;
+static const int MAX_PARTITION_LEVEL = 32 / PARTITION_BITS;
+// 哈希表中每一行大概的额外开销
+static const int HASH_ENTRY_OVERHEAD = 32;
+
+static int64_t default_memory_budget = 64 * 1024 * 1024;
+
+static int partition_of(uint32_t hash, int level)
+{
+  return (hash >> (level * PARTITION_BITS)) & (PARTITION_NUM - 1);
+}
+
+HashJoinOperator::HashJoinOperator(Operator *build, const std::vector<Table *> &build_tables,
+                                   Operator *probe, const std::vector<Table *> &probe_tables,
+                                   const std::vector<Field> &build_keys, const std::vector<Field> &probe_keys)
+  : JoinOperator(build, probe), build_rows_(build_tables), build_tuple_(build_rows_),
+    probe_rows_(probe_tables), probe_tuple_(probe_rows_),
+    build_keys_(build_keys), probe_keys_(probe_keys), memory_budget_(default_memory_budget)
+{
+  for (size_t i = 0; i < build_keys_.size(); i++) {
+    const FieldMeta *build_meta = build_keys_[i].meta();
+    const FieldMeta *probe_meta = probe_keys_[i].meta();
+    build_key_offsets_.push_back(build_rows_.field_offset(build_keys_[i]));
+
+    AttrHasher build_hasher;
+    build_hasher.init(build_meta->type(), build_meta->len());
+    build_hashers_.push_back(build_hasher);
+
+    AttrHasher probe_hasher;
+    probe_hasher.init(probe_meta->type(), probe_meta->len());
+    probe_hashers_.push_back(probe_hasher);
+  }
+  probe_cells_.resize(probe_keys_.size());
+}
+
+bool HashJoinOperator::can_hash(const Field &left, const Field &right)
+{
+  return left.attr_type() == right.attr_type() && left.attr_type() != FLOATS;
+}
+
+void HashJoinOperator::set_default_memory_budget(int64_t bytes)
+{
+  default_memory_budget = bytes;
+}
+
+static uint32_t combine_hash(uint32_t seed, uint32_t hash)
+{
+  return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+uint32_t HashJoinOperator::build_hash(const char *row) const
+{
+  uint32_t hash = 0;
+  for (size_t i = 0; i < build_hashers_.size(); i++) {
+    hash = combine_hash(hash, build_hashers_[i](row + build_key_offsets_[i]));
+  }
+  return hash;
+}
+
+RC HashJoinOperator::probe_hash(const Tuple &tuple, uint32_t &hash)
+{
+  hash = 0;
+  for (size_t i = 0; i < probe_keys_.size(); i++) {
+    RC rc = tuple.find_cell(probe_keys_[i], probe_cells_[i]);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to find join key in probe tuple. field=%s.%s",
+               probe_keys_[i].table_name(), probe_keys_[i].field_name());
+      return rc;
+    }
+    hash = combine_hash(hash, probe_hashers_[i](probe_cells_[i].data()));
+  }
+  return RC::SUCCESS;
+}
+
+int64_t HashJoinOperator::build_memory(int rows) const
+{
+  return (int64_t)rows * (build_rows_.row_size() + HASH_ENTRY_OVERHEAD);
+}
+
+void HashJoinOperator::build_hash_table()
+{
+  hash_table_.clear();
+  for (int row = 0; row < build_rows_.size(); row++) {
+    hash_table_[build_hash(build_rows_.row(row))].push_back(row);
+  }
+}
+
+RC HashJoinOperator::open()
+{
+  for (int offset : build_key_offsets_) {
+    if (offset < 0) {
+      LOG_WARN("join key is not in build tables");
+      return RC::INTERNAL;
+    }
+  }
+
+  RC rc = left_->open();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open build child. rc=%s", strrc(rc));
+    return rc;
+  }
+  rc = right_->open();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open probe child. rc=%s", strrc(rc));
+    left_->close();
+    return rc;
+  }
+
+  build_rows_.clear();
+  hash_table_.clear();
+  partitions_.clear();
+  pending_.clear();
+  current_ = Partition();
+  resident_ = true;
+  input_done_ = false;
+  spilled_partitions_ = 0;
+
+  const bool can_spill = SpillFile::can_spill(build_rows_.row_size()) && SpillFile::can_spill(probe_rows_.row_size());
+  while (RC::SUCCESS == (rc = left_->next())) {
+    build_rows_.append(*left_->current_tuple());
+    if (!partitions_.empty()) {
+      const char *row = build_rows_.row(build_rows_.size() - 1);
+      const uint32_t hash = build_hash(row);
+      if (partition_of(hash, 0) != 0 || !resident_) {
+        rc = add_build_row(row, hash);
+        build_rows_.pop_back();
+      } else if (build_memory(build_rows_.size()) > memory_budget_) {
+        rc = start_partition();
+      }
+    } else if (can_spill && build_memory(build_rows_.size()) > memory_budget_) {
+      rc = start_partition();
+    }
+
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to partition build rows. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read build child. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  build_hash_table();
+  matches_ = nullptr;
+  match_index_ = 0;
+  LOG_INFO("hash join built %d rows into %d buckets, partitioned=%d",
+           build_rows_.size(), (int)hash_table_.size(), !partitions_.empty());
+  return RC::SUCCESS;
+}
+
+/**
+ * 内存中的build数据超过限制，把第0个分区之外的行写到临时文件中。
+ * 第0个分区本身也超过限制时整个写到临时文件中
+ */
+RC HashJoinOperator::start_partition()
+{
+  RC rc = RC::SUCCESS;
+  if (partitions_.empty()) {
+    partitions_.resize(PARTITION_NUM);
+    for (Partition &partition : partitions_) {
+      partition.build.reset(new SpillFile(build_rows_.row_size()));
+      partition.probe.reset(new SpillFile(probe_rows_.row_size()));
+    }
+
+    RowSet resident_rows(build_rows_.tables());
+    for (int i = 0; i < build_rows_.size(); i++) {
+      const char *row = build_rows_.row(i);
+      const uint32_t hash = build_hash(row);
+      if (partition_of(hash, 0) == 0) {
+        resident_rows.append_row(row);
+      } else if (RC::SUCCESS != (rc = add_build_row(row, hash))) {
+        return rc;
+      }
+    }
+    build_rows_ = std::move(resident_rows);
+    LOG_INFO("hash join exceeds memory budget %lld, partition build rows into %d partitions",
+             (long long)memory_budget_, PARTITION_NUM);
+  }
+
+  if (resident_ && build_memory(build_rows_.size()) > memory_budget_) {
+    resident_ = false;
+    for (int i = 0; i < build_rows_.size(); i++) {
+      rc = add_build_row(build_rows_.row(i), 0);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+    build_rows_.clear();
+    LOG_INFO("hash join spills the resident partition");
+  }
+  return RC::SUCCESS;
+}
+
+RC HashJoinOperator::add_build_row(const char *row, uint32_t hash)
+{
+  return partitions_[partition_of(hash, 0)].build->append(row);
+}
+
+RC HashJoinOperator::spill_probe_row(const Tuple &tuple, uint32_t hash)
+{
+  Partition &partition = partitions_[partition_of(hash, 0)];
+  if (partition.build->row_count() == 0) {
+    return RC::SUCCESS;
+  }
+
+  probe_rows_.clear();
+  probe_rows_.append(tuple);
+  return partition.probe->append(probe_rows_.row(0));
+}
+
+/**
+ * 按照下一层的哈希位把一个分区拆开，拆分之后的分区放到等待队列的最前面。
+ * 所有build行都落在同一个子分区时说明连接字段的值相同，再分区也没有用
+ */
+RC HashJoinOperator::repartition(Partition &partition, bool &split)
+{
+  split = false;
+  const int level = partition.level + 1;
+  std::vector<Partition> children(PARTITION_NUM);
+  for (Partition &child : children) {
+    child.level = level;
+    child.build.reset(new SpillFile(build_rows_.row_size()));
+    child.probe.reset(new SpillFile(probe_rows_.row_size()));
+  }
+
+  const char *row = nullptr;
+  RC rc = partition.build->rewind();
+  while (rc == RC::SUCCESS && RC::SUCCESS == (rc = partition.build->next(row))) {
+    rc = children[partition_of(build_hash(row), level)].build->append(row);
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to repartition build rows. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  for (const Partition &child : children) {
+    if (child.build->row_count() == partition.build->row_count()) {
+      LOG_WARN("hash join partition is skewed, load %d rows into memory at level %d",
+               partition.build->row_count(), partition.level);
+      return RC::SUCCESS;
+    }
+  }
+
+  rc = partition.probe->rewind();
+  while (rc == RC::SUCCESS && RC::SUCCESS == (rc = partition.probe->next(row))) {
+    probe_tuple_.set_row(row);
+    uint32_t hash = 0;
+    rc = probe_hash(probe_tuple_, hash);
+    if (rc == RC::SUCCESS) {
+      Partition &child = children[partition_of(hash, level)];
+      if (child.build->row_count() > 0) {
+        rc = child.probe->append(row);
+      }
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to repartition probe rows. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  for (auto iter = children.rbegin(); iter != children.rend(); ++iter) {
+    if (iter->build->row_count() > 0 && iter->probe->row_count() > 0) {
+      pending_.push_front(std::move(*iter));
+      spilled_partitions_++;
+    }
+  }
+  split = true;
+  return RC::SUCCESS;
+}
+
+/**
+ * 把下一个等待连接的分区的build数据读到内存中建立哈希表
+ * @return 没有剩余的分区时返回RECORD_EOF
+ */
+RC HashJoinOperator::load_next_partition()
+{
+  RC rc = RC::SUCCESS;
+  while (true) {
+    current_ = Partition();
+    build_rows_.clear();
+    hash_table_.clear();
+    matches_ = nullptr;
+    if (pending_.empty()) {
+      return RC::RECORD_EOF;
+    }
+
+    Partition partition = std::move(pending_.front());
+    pending_.pop_front();
+    if (build_memory(partition.build->row_count()) > memory_budget_ && partition.level + 1 < MAX_PARTITION_LEVEL) {
+      bool split = false;
+      rc = repartition(partition, split);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      if (split) {
+        continue;
+      }
+    }
+
+    const char *row = nullptr;
+    rc = partition.build->rewind();
+    while (rc == RC::SUCCESS && RC::SUCCESS == (rc = partition.build->next(row))) {
+      build_rows_.append_row(row);
+    }
+    if (rc != RC::RECORD_EOF) {
+      LOG_WARN("failed to load spilled build rows. rc=%s", strrc(rc));
+      return rc;
+    }
+    rc = partition.probe->rewind();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    build_hash_table();
+    current_ = std::move(partition);
+    return RC::SUCCESS;
+  }
+}
+
+bool HashJoinOperator::match(int build_row) const
+{
+  const char *data = build_rows_.row(build_row);
+  for (size_t i = 0; i < build_keys_.size(); i++) {
+    const FieldMeta *field_meta = build_keys_[i].meta();
+    TupleCell build_cell(field_meta->type(), const_cast<char *>(data + build_key_offsets_[i]));
+    build_cell.set_length(field_meta->len());
+    if (0 != build_cell.compare(probe_cells_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC HashJoinOperator::next()
+{
+  if (partitions_.empty() && pending_.empty() && current_.build == nullptr && build_rows_.size() == 0) {
+    return RC::RECORD_EOF;
+  }
+
+  RC rc = RC::SUCCESS;
+  while (true) {
+    if (matches_ != nullptr) {
+      while (match_index_ < matches_->size()) {
+        const int build_row = (*matches_)[match_index_++];
+        if (match(build_row)) {
+          build_tuple_.set_row(build_rows_.row(build_row));
+          return RC::SUCCESS;
+        }
+      }
+      matches_ = nullptr;
+    }
+
+    Tuple *probe_tuple = nullptr;
+    uint32_t hash = 0;
+    if (!input_done_) {
+      rc = right_->next();
+      if (rc == RC::RECORD_EOF) {
+        // probe输入读完了，开始连接写到临时文件中的分区
+        input_done_ = true;
+        for (Partition &partition : partitions_) {
+          if (partition.build->row_count() > 0 && partition.probe->row_count() > 0) {
+            pending_.push_back(std::move(partition));
+            spilled_partitions_++;
+          }
+        }
+        partitions_.clear();
+        build_rows_.clear();
+        hash_table_.clear();
+        continue;
+      }
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      probe_tuple = right_->current_tuple();
+      rc = probe_hash(*probe_tuple, hash);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      if (!partitions_.empty() && (partition_of(hash, 0) != 0 || !resident_)) {
+        rc = spill_probe_row(*probe_tuple, hash);
+        if (rc != RC::SUCCESS) {
+          LOG_WARN("failed to spill probe row. rc=%s", strrc(rc));
+          return rc;
+        }
+        continue;
+      }
+    } else {
+      const char *row = nullptr;
+      rc = current_.probe == nullptr ? RC::RECORD_EOF : current_.probe->next(row);
+      if (rc == RC::RECORD_EOF) {
+        rc = load_next_partition();
+        if (rc != RC::SUCCESS) {
+          return rc;
+        }
+        continue;
+      }
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to read spilled probe row. rc=%s", strrc(rc));
+        return rc;
+      }
+
+      probe_tuple_.set_row(row);
+      probe_tuple = &probe_tuple_;
+      rc = probe_hash(*probe_tuple, hash);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+
+    auto iter = hash_table_.find(hash);
+    if (iter == hash_table_.end()) {
+      continue;
+    }
+
+    matches_ = &iter->second;
+    match_index_ = 0;
+    tuple_.clear();
+    tuple_.push_back(probe_tuple);
+    tuple_.push_back(&build_tuple_);
+  }
+}
+
+RC HashJoinOperator::close()
+{
+  if (spilled_partitions_ > 0) {
+    LOG_INFO("hash join spilled %d partitions", spilled_partitions_);
+  }
+  build_rows_.clear();
+  hash_table_.clear();
+  partitions_.clear();
+  pending_.clear();
+  current_ = Partition();
+  matches_ = nullptr;
+  left_->close();
+  right_->close();
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 索引嵌套循环连接每次从左边读取的行数
+static const int INDEX_JOIN_BATCH_SIZE = 128;
+
+IndexNestedLoopJoinOperator::IndexNestedLoopJoinOperator(Operator *left, const std::vector<Table *> &left_tables,
+                                                         Table *right_table, Index *index,
+                                                         const Field &left_key, const Field &right_key)
+  : JoinOperator(left, nullptr), right_table_(right_table), index_(index),
+    left_key_(left_key), right_key_(right_key),
+    left_rows_(left_tables), left_tuple_(left_rows_), right_rows_({right_table}), right_tuple_(right_rows_)
+{
+  left_key_offset_ = left_rows_.field_offset(left_key_);
+  left_hasher_.init(left_key_.attr_type(), left_key_.meta()->len());
+  right_hasher_.init(right_key_.attr_type(), right_key_.meta()->len());
+}
+
+RC IndexNestedLoopJoinOperator::open()
+{
+  if (left_key_offset_ < 0 || index_ == nullptr) {
+    LOG_WARN("invalid index join. left key offset=%d", left_key_offset_);
+    return RC::INTERNAL;
+  }
+
+  record_handler_ = right_table_->record_handler();
+  RC rc = left_->open();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open left child. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  left_rows_.clear();
+  right_rows_.clear();
+  results_.clear();
+  result_index_ = 0;
+  left_done_ = false;
+
+  tuple_.clear();
+  tuple_.push_back(&left_tuple_);
+  tuple_.push_back(&right_tuple_);
+  return RC::SUCCESS;
+}
+
+/**
+ * 读取左边的一批数据，批量查找索引，匹配的结果放到results_中
+ */
+RC IndexNestedLoopJoinOperator::join_batch()
+{
+  left_rows_.clear();
+  right_rows_.clear();
+  results_.clear();
+  result_index_ = 0;
+
+  RC rc = RC::SUCCESS;
+  while (left_rows_.size() < INDEX_JOIN_BATCH_SIZE) {
+    rc = left_->next();
+    if (rc == RC::RECORD_EOF) {
+      left_done_ = true;
+      break;
+    }
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    left_rows_.append(*left_->current_tuple());
+  }
+  if (left_rows_.size() == 0) {
+    return RC::SUCCESS;
+  }
+
+  // 查找值的长度要与索引字段一致，字符串长度不同时截断或者补0，结果再用原始值比较
+  const int key_length = index_->field_meta().len();
+  const int left_length = left_key_.meta()->len();
+  keys_.assign((size_t)left_rows_.size() * key_length, 0);
+  std::vector<const char *> keys;
+  std::unordered_map<uint32_t, std::vector<int>> left_hash;
+  for (int i = 0; i < left_rows_.size(); i++) {
+    const char *left_key = left_rows_.row(i) + left_key_offset_;
+    char *key = keys_.data() + (size_t)i * key_length;
+    memcpy(key, left_key, std::min(key_length, left_length));
+    keys.push_back(key);
+    left_hash[left_hasher_(left_key)].push_back(i);
+  }
+
+  std::vector<RID> rids;
+  rc = index_->get_entries(keys, rids);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to get entries from index %s. rc=%s", index_->index_meta().name(), strrc(rc));
+    return rc;
+  }
+
+  const FieldMeta *right_meta = right_key_.meta();
+  const FieldMeta *left_meta = left_key_.meta();
+  Record record;
+  for (const RID &rid : rids) {
+    rc = record_handler_->get_record(&rid, &record);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get record. rid=%d:%d, rc=%s", rid.page_num, rid.slot_num, strrc(rc));
+      return rc;
+    }
+
+    right_rows_.append_row(record.data());
+    const int right_row = right_rows_.size() - 1;
+    char *right_key = const_cast<char *>(right_rows_.row(right_row)) + right_meta->offset();
+    auto iter = left_hash.find(right_hasher_(right_key));
+    if (iter == left_hash.end()) {
+      continue;
+    }
+
+    TupleCell right_cell(right_meta->type(), right_key);
+    right_cell.set_length(right_meta->len());
+    for (int left_row : iter->second) {
+      TupleCell left_cell(left_meta->type(), const_cast<char *>(left_rows_.row(left_row)) + left_key_offset_);
+      left_cell.set_length(left_meta->len());
+      if (0 == left_cell.compare(right_cell)) {
+        results_.emplace_back(left_row, right_row);
+      }
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC IndexNestedLoopJoinOperator::next()
+{
+  while (result_index_ >= results_.size()) {
+    if (left_done_) {
+      return RC::RECORD_EOF;
+    }
+    RC rc = join_batch();
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to join batch. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  const std::pair<int, int> &result = results_[result_index_++];
+  left_tuple_.set_row(left_rows_.row(result.first));
+  right_tuple_.set_row(right_rows_.row(result.second));
+  return RC::SUCCESS;
+}
+
+RC IndexNestedLoopJoinOperator::close()
+{
+  left_rows_.clear();
+  right_rows_.clear();
+  results_.clear();
+  keys_.clear();
+  left_->close();
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SortMergeJoinOperator::MergeInput::MergeInput(Operator *oper, const std::vector<Table *> &tables)
+  : oper(oper), rows(tables)
+{}
+
+RC SortMergeJoinOperator::MergeInput::open()
+{
+  RC rc = oper->open();
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  rows.clear();
+  order.clear();
+  pos = 0;
+  if (sorted) {
+    return RC::SUCCESS;
+  }
+
+  rc = fetch_all(oper, rows);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  order.resize(rows.size());
+  for (int i = 0; i < rows.size(); i++) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [this](int left, int right) {
+    return compare(rows.row(left), keys, rows.row(right), keys) < 0;
+  });
+  return RC::SUCCESS;
+}
+
+RC SortMergeJoinOperator::MergeInput::next(const char *&row)
+{
+  row = nullptr;
+  if (!sorted) {
+    if (pos < order.size()) {
+      row = rows.row(order[pos++]);
+    }
+    return RC::SUCCESS;
+  }
+
+  RC rc = oper->next();
+  if (rc == RC::RECORD_EOF) {
+    return RC::SUCCESS;
+  }
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  rows.clear();
+  rows.append(*oper->current_tuple());
+  row = rows.row(0);
+  return RC::SUCCESS;
+}
+
+void SortMergeJoinOperator::MergeInput::close()
+{
+  rows.clear();
+  order.clear();
+  oper->close();
+}
+
+SortMergeJoinOperator::SortMergeJoinOperator(Operator *left, const std::vector<Table *> &left_tables,
+                                             Operator *right, const std::vector<Table *> &right_tables,
+                                             const std::vector<Field> &left_keys, const std::vector<Field> &right_keys)
+  : JoinOperator(left, right), left_input_(left, left_tables), right_input_(right, right_tables),
+    group_(right_tables), left_tuple_(left_input_.rows), right_tuple_(group_)
+{
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    const FieldMeta *left_meta = left_keys[i].meta();
+    const FieldMeta *right_meta = right_keys[i].meta();
+    left_input_.keys.push_back({left_input_.rows.field_offset(left_keys[i]), left_meta->type(), left_meta->len()});
+    right_input_.keys.push_back({right_input_.rows.field_offset(right_keys[i]), right_meta->type(), right_meta->len()});
+  }
+}
+
+int SortMergeJoinOperator::compare(const char *left, const std::vector<SortKey> &left_keys,
+                                   const char *right, const std::vector<SortKey> &right_keys)
+{
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    TupleCell left_cell(left_keys[i].type, const_cast<char *>(left + left_keys[i].offset));
+    TupleCell right_cell(right_keys[i].type, const_cast<char *>(right + right_keys[i].offset));
+    left_cell.set_length(left_keys[i].length);
+    right_cell.set_length(right_keys[i].length);
+    const int result = left_cell.compare(right_cell);
+    if (result != 0) {
+      return result;
+    }
+  }
+  return 0;
+}
+
+RC SortMergeJoinOperator::fetch_left()
+{
+  return left_input_.next(left_row_);
+}
+
+RC SortMergeJoinOperator::fetch_right()
+{
+  return right_input_.next(right_row_);
+}
+
+RC SortMergeJoinOperator::open()
+{
+  for (size_t i = 0; i < left_input_.keys.size(); i++) {
+    if (left_input_.keys[i].offset < 0 || right_input_.keys[i].offset < 0) {
+      LOG_WARN("join key is not in join tables");
+      return RC::INTERNAL;
+    }
+  }
+
+  RC rc = left_input_.open();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open left child. rc=%s", strrc(rc));
+    return rc;
+  }
+  rc = right_input_.open();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open right child. rc=%s", strrc(rc));
+    left_input_.close();
+    return rc;
+  }
+
+  group_.clear();
+  group_pos_ = 0;
+  tuple_.clear();
+  tuple_.push_back(&left_tuple_);
+  tuple_.push_back(&right_tuple_);
+
+  rc = fetch_left();
+  if (rc == RC::SUCCESS) {
+    rc = fetch_right();
+  }
+  LOG_INFO("sort merge join opened. left sorted=%d, right sorted=%d", left_input_.sorted, right_input_.sorted);
+  return rc;
+}
+
+RC SortMergeJoinOperator::next()
+{
+  RC rc = RC::SUCCESS;
+  while (left_row_ != nullptr) {
+    if (group_.size() > 0) {
+      if (group_pos_ < group_.size()) {
+        left_tuple_.set_row(left_row_);
+        right_tuple_.set_row(group_.row(group_pos_++));
+        return RC::SUCCESS;
+      }
+
+      // 下一个左边行的连接字段相同时重复输出这一组
+      rc = fetch_left();
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      if (left_row_ != nullptr && 0 == compare(left_row_, left_input_.keys, group_.row(0), right_input_.keys)) {
+        group_pos_ = 0;
+      } else {
+        group_.clear();
+      }
+      continue;
+    }
+
+    if (right_row_ == nullptr) {
+      break;
+    }
+
+    const int result = compare(left_row_, left_input_.keys, right_row_, right_input_.keys);
+    if (result < 0) {
+      rc = fetch_left();
+    } else if (result > 0) {
+      rc = fetch_right();
+    } else {
+      // 把右边连接字段相同的行都读到group_中
+      do {
+        group_.append_row(right_row_);
+        rc = fetch_right();
+      } while (rc == RC::SUCCESS && right_row_ != nullptr &&
+               0 == compare(group_.row(0), right_input_.keys, right_row_, right_input_.keys));
+      group_pos_ = 0;
+    }
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  return RC::RECORD_EOF;
+}
+
+RC SortMergeJoinOperator::close()
+{
+  group_.clear();
+  left_row_ = nullptr;
+  right_row_ = nullptr;
+  left_input_.close();
+  right_input_.close();
+  return RC::SUCCESS;
+}
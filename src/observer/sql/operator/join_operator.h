@@ -14,25 +14,297 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
-#include "sql/parser/parse.h"
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 #include "sql/operator/operator.h"
+#include "sql/operator/row_set.h"
+#include "sql/operator/temp_relation.h"
+#include "storage/common/field.h"
+#include "storage/index/extendible_hash.h"
+#include "storage/default/spill_file.h"
 #include "rc.h"
 
-// TODO fixme
+class Index;
+class RecordFileHandler;
+
+/**
+ * 两个输入的连接，输出的tuple由两边的tuple组合而成，只能通过find_cell访问字段
+ * 连接条件之外的过滤由上层的PredicateOperator完成
+ */
 class JoinOperator : public Operator
 {
 public:
   JoinOperator(Operator *left, Operator *right)
-  {}
+    : left_(left), right_(right)
+  {
+    add_child(left);
+    if (right != nullptr) {
+      add_child(right);
+    }
+  }
 
   virtual ~JoinOperator() = default;
 
+  Tuple * current_tuple() override
+  {
+    return &tuple_;
+  }
+
+protected:
+  Operator *left_ = nullptr;
+  Operator *right_ = nullptr;
+  CompositeTuple tuple_;
+};
+
+/**
+ * 嵌套循环连接，用于没有等值条件的连接
+ * 右边的数据在open时读到临时关系中，之后不再重复扫描子算子。
+ * 右边超过内存限制写了临时文件时，左边按块读到内存中，每一块只从头读一遍右边的数据
+ */
+class NestedLoopJoinOperator : public JoinOperator
+{
+public:
+  NestedLoopJoinOperator(Operator *left, const std::vector<Table *> &left_tables,
+                         Operator *right, const std::vector<Table *> &right_tables);
+
+  virtual ~NestedLoopJoinOperator() = default;
+
+  /**
+   * 右边的数据和左边的一块数据分别最多使用的内存
+   */
+  void set_memory_budget(int64_t bytes)
+  {
+    right_rows_.set_memory_budget(bytes);
+  }
+  bool spilled() const
+  {
+    return right_rows_.spilled();
+  }
+
   RC open() override;
   RC next() override;
   RC close() override;
 
 private:
-  Operator *left_ = nullptr;
-  Operator *right_ = nullptr;
-  bool round_done_ = true;
+  RC next_in_blocks();
+  RC fetch_left_block();
+
+private:
+  TempRelation right_rows_;
+  RowSetTuple right_tuple_;
+  int right_index_ = 0;
+  bool left_fetched_ = false;
+
+  RowSet left_block_;  // 右边写了临时文件时，当前这一块左边的数据
+  RowSetTuple left_block_tuple_;
+  int left_index_ = 0;
+  bool left_eof_ = false;
+};
+
+/**
+ * 等值连接的哈希连接
+ * open时读取build一侧的全部数据建立哈希表，然后逐条读取probe一侧的数据查找匹配的行。
+ * 调用方应该把数据量较小的一侧作为build
+ *
+ * build一侧超过内存限制时按照哈希值把两边的数据分成多个分区，第0个分区尽量留在内存中直接连接，
+ * 其它分区写到临时文件里，probe一侧读完之后再逐个分区连接。
+ * 单个分区仍然放不下时使用哈希值的其它位继续分区，直到分不开或者达到最大层数
+ */
+class HashJoinOperator : public JoinOperator
+{
+public:
+  /**
+   * @param build_keys build一侧的连接字段，与probe_keys一一对应
+   */
+  HashJoinOperator(Operator *build, const std::vector<Table *> &build_tables,
+                   Operator *probe, const std::vector<Table *> &probe_tables,
+                   const std::vector<Field> &build_keys, const std::vector<Field> &probe_keys);
+
+  virtual ~HashJoinOperator() = default;
+
+  /**
+   * 两个字段的相等比较是否可以用哈希值判断
+   * 类型不同时比较的语义与哈希值不一致，浮点数的相等比较带有误差
+   */
+  static bool can_hash(const Field &left, const Field &right);
+
+  /**
+   * build一侧在内存中最多使用的字节数，包括哈希表的开销
+   */
+  static void set_default_memory_budget(int64_t bytes);
+  void set_memory_budget(int64_t bytes)
+  {
+    memory_budget_ = bytes;
+  }
+
+  /**
+   * 写到临时文件中的分区个数，包括分区之后再次分区的
+   */
+  int spilled_partitions() const
+  {
+    return spilled_partitions_;
+  }
+
+  RC open() override;
+  RC next() override;
+  RC close() override;
+
+private:
+  struct Partition {
+    int level = 0;
+    std::unique_ptr<SpillFile> build;
+    std::unique_ptr<SpillFile> probe;
+  };
+
+  bool match(int build_row) const;
+  uint32_t build_hash(const char *row) const;
+  RC probe_hash(const Tuple &tuple, uint32_t &hash);
+  int64_t build_memory(int rows) const;
+  void build_hash_table();
+
+  RC start_partition();
+  RC add_build_row(const char *row, uint32_t hash);
+  RC spill_probe_row(const Tuple &tuple, uint32_t hash);
+  RC load_next_partition();
+  RC repartition(Partition &partition, bool &split);
+
+private:
+  RowSet build_rows_;
+  RowSetTuple build_tuple_;
+  RowSet probe_rows_;          // 用来把probe一侧的tuple转换成行数据
+  RowSetTuple probe_tuple_;    // 从临时文件中读取的probe行
+
+  std::vector<Field> build_keys_;
+  std::vector<Field> probe_keys_;
+  std::vector<int> build_key_offsets_;
+  std::vector<AttrHasher> build_hashers_;
+  std::vector<AttrHasher> probe_hashers_;
+
+  std::unordered_map<uint32_t, std::vector<int>> hash_table_;
+  const std::vector<int> *matches_ = nullptr;  // 当前probe行哈希值相同的build行
+  size_t match_index_ = 0;
+  std::vector<TupleCell> probe_cells_;
+
+  int64_t memory_budget_;
+  std::vector<Partition> partitions_;   // 读取probe输入时第0层的分区，为空表示没有分区
+  bool resident_ = true;                // 第0个分区是否在内存中
+  std::deque<Partition> pending_;       // probe输入读完之后等待连接的分区
+  Partition current_;                   // 正在连接的分区
+  bool input_done_ = false;
+  int spilled_partitions_ = 0;
+};
+
+/**
+ * 索引嵌套循环连接，右边是一个在连接字段上有索引的表
+ * 每次从左边读取一批数据，用这一批的连接字段批量查找索引，查到的记录按照页面顺序读取。
+ * 适合左边数据很少、右边的表很大的情况
+ */
+class IndexNestedLoopJoinOperator : public JoinOperator
+{
+public:
+  /**
+   * @param index 右边的表在right_key上的索引
+   */
+  IndexNestedLoopJoinOperator(Operator *left, const std::vector<Table *> &left_tables,
+                              Table *right_table, Index *index, const Field &left_key, const Field &right_key);
+
+  virtual ~IndexNestedLoopJoinOperator() = default;
+
+  RC open() override;
+  RC next() override;
+  RC close() override;
+
+private:
+  RC join_batch();
+
+private:
+  Table *right_table_ = nullptr;
+  Index *index_ = nullptr;
+  RecordFileHandler *record_handler_ = nullptr;
+  Field left_key_;
+  Field right_key_;
+  int left_key_offset_ = -1;
+  AttrHasher left_hasher_;
+  AttrHasher right_hasher_;
+
+  RowSet left_rows_;           // 当前这一批左边的数据
+  RowSetTuple left_tuple_;
+  RowSet right_rows_;          // 这一批查到的右边的记录
+  RowSetTuple right_tuple_;
+  std::vector<char> keys_;     // 这一批的查找值，按照索引字段的长度排列
+  std::vector<std::pair<int, int>> results_;  // 匹配的左边行和右边行
+  size_t result_index_ = 0;
+  bool left_done_ = false;
+};
+
+/**
+ * 排序归并连接，两边都按照连接字段从小到大的顺序归并。
+ * 输入本身已经有序(比如按照索引顺序扫描)时直接逐行读取，只在内存中保存右边连接字段相同的一组数据；
+ * 否则先读到内存中排序
+ */
+class SortMergeJoinOperator : public JoinOperator
+{
+public:
+  SortMergeJoinOperator(Operator *left, const std::vector<Table *> &left_tables,
+                        Operator *right, const std::vector<Table *> &right_tables,
+                        const std::vector<Field> &left_keys, const std::vector<Field> &right_keys);
+
+  virtual ~SortMergeJoinOperator() = default;
+
+  void set_sorted(bool left_sorted, bool right_sorted)
+  {
+    left_input_.sorted = left_sorted;
+    right_input_.sorted = right_sorted;
+  }
+
+  RC open() override;
+  RC next() override;
+  RC close() override;
+
+private:
+  struct SortKey {
+    int offset;
+    AttrType type;
+    int length;
+  };
+
+  /**
+   * 归并的一个输入，按照连接字段的顺序逐行输出
+   */
+  struct MergeInput {
+    MergeInput(Operator *oper, const std::vector<Table *> &tables);
+
+    RC open();
+    /**
+     * @param row 没有更多数据时设置为nullptr。在下一次调用之前有效
+     */
+    RC next(const char *&row);
+    void close();
+
+    Operator *oper;
+    std::vector<SortKey> keys;
+    bool sorted = false;
+    RowSet rows;              // 有序时只保存当前一行，否则保存全部数据
+    std::vector<int> order;   // 排序之后的行号
+    size_t pos = 0;
+  };
+
+  static int compare(const char *left, const std::vector<SortKey> &left_keys,
+                     const char *right, const std::vector<SortKey> &right_keys);
+  RC fetch_left();
+  RC fetch_right();
+
+private:
+  MergeInput left_input_;
+  MergeInput right_input_;
+  const char *left_row_ = nullptr;
+  const char *right_row_ = nullptr;   // 右边下一个还没有放到group中的行
+
+  RowSet group_;        // 右边连接字段与left_row_相等的一组数据
+  int group_pos_ = 0;   // group_中下一个要输出的位置
+  RowSetTuple left_tuple_;
+  RowSetTuple right_tuple_;
 };
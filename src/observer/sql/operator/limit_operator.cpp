@@ -0,0 +1,48 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "common/log/log.h"
+#include "sql/operator/limit_operator.h"
+
+RC LimitOperator::open()
+{
+  if (children_.size() != 1) {
+    LOG_WARN("limit operator must has one child");
+    return RC::INTERNAL;
+  }
+  skipped_ = 0;
+  returned_ = 0;
+  return children_[0]->open();
+}
+
+RC LimitOperator::next()
+{
+  if (returned_ >= limit_) {
+    return RC::RECORD_EOF;
+  }
+
+  Operator *child = children_[0];
+  RC rc = RC::SUCCESS;
+  while (skipped_ < offset_) {
+    if ((rc = child->next()) != RC::SUCCESS) {
+      return rc;
+    }
+    skipped_++;
+  }
+  if ((rc = child->next()) == RC::SUCCESS) {
+    returned_++;
+  }
+  return rc;
+}
+
+RC LimitOperator::close()
+{
+  return children_[0]->close();
+}
@@ -0,0 +1,42 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/operator/operator.h"
+#include "rc.h"
+
+/**
+ * LIMIT/OFFSET: 跳过前offset行，最多输出limit行。
+ * 输出够limit行之后不再从子算子取数据，下面的扫描也随之停止
+ */
+class LimitOperator : public Operator
+{
+public:
+  LimitOperator(int limit, int offset) : limit_(limit), offset_(offset)
+  {}
+
+  virtual ~LimitOperator() = default;
+
+  RC open() override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override
+  {
+    return children_[0]->current_tuple();
+  }
+
+private:
+  int limit_ = 0;
+  int offset_ = 0;
+  int skipped_ = 0;
+  int returned_ = 0;
+};
@@ -17,6 +17,71 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/record.h"
 #include "sql/stmt/filter_stmt.h"
 #include "storage/common/field.h"
+#include "sql/operator/filter_kernel.h"
+#include "util/comparator.h"
+
+namespace {
+
+const int DATE_COMPARE_LENGTH = 11;
+
+// 整数字段与整数常量
+struct IntKernel {
+  template <CompOp OP>
+  static bool match(const char *data, const PredicateOperator::Filter &filter)
+  {
+    return filter_test<OP>(filter_compare(*(const int *)data, filter.int_value));
+  }
+};
+
+// 整数字段与浮点常量，整数转换成浮点数比较
+struct IntFloatKernel {
+  template <CompOp OP>
+  static bool match(const char *data, const PredicateOperator::Filter &filter)
+  {
+    return filter_test<OP>(filter_compare((float)*(const int *)data, filter.float_value));
+  }
+};
+
+struct FloatKernel {
+  template <CompOp OP>
+  static bool match(const char *data, const PredicateOperator::Filter &filter)
+  {
+    return filter_test<OP>(filter_compare(*(const float *)data, filter.float_value));
+  }
+};
+
+// 日期字段与字符串常量，常量已经格式化
+struct DateKernel {
+  template <CompOp OP>
+  static bool match(const char *data, const PredicateOperator::Filter &filter)
+  {
+    return filter_test<OP>(
+        compare_string((void *)data, DATE_COMPARE_LENGTH, (void *)filter.date_value, DATE_COMPARE_LENGTH));
+  }
+};
+
+template <typename Kernel>
+PredicateOperator::MatchFunc select_match(CompOp comp)
+{
+  switch (comp) {
+    case EQUAL_TO: return &Kernel::template match<EQUAL_TO>;
+    case LESS_EQUAL: return &Kernel::template match<LESS_EQUAL>;
+    case NOT_EQUAL: return &Kernel::template match<NOT_EQUAL>;
+    case LESS_THAN: return &Kernel::template match<LESS_THAN>;
+    case GREAT_EQUAL: return &Kernel::template match<GREAT_EQUAL>;
+    case GREAT_THAN: return &Kernel::template match<GREAT_THAN>;
+    default: return nullptr;
+  }
+}
+
+}  // namespace
+
+PredicateOperator::PredicateOperator(FilterStmt *filter_stmt)
+{
+  if (filter_stmt != nullptr) {
+    filter_units_.assign(filter_stmt->filter_units().begin(), filter_stmt->filter_units().end());
+  }
+}
 
 RC PredicateOperator::open()
 {
@@ -25,9 +90,57 @@ RC PredicateOperator::open()
     return RC::INTERNAL;
   }
 
+  prepare_filters();
   return children_[0]->open();
 }
 
+void PredicateOperator::prepare_filters()
+{
+  filters_.clear();
+  for (const FilterUnit *filter_unit : filter_units_) {
+    Filter filter;
+    filter.filter_unit = filter_unit;
+
+    const Expression *left_expr = filter_unit->left();
+    const Expression *right_expr = filter_unit->right();
+    CompOp comp = filter_unit->comp();
+    const FieldExpr *field_expr = nullptr;
+    const ValueExpr *value_expr = nullptr;
+    if (left_expr->type() == ExprType::FIELD && right_expr->type() == ExprType::VALUE) {
+      field_expr = static_cast<const FieldExpr *>(left_expr);
+      value_expr = static_cast<const ValueExpr *>(right_expr);
+    } else if (left_expr->type() == ExprType::VALUE && right_expr->type() == ExprType::FIELD) {
+      field_expr = static_cast<const FieldExpr *>(right_expr);
+      value_expr = static_cast<const ValueExpr *>(left_expr);
+      comp = filter_swap_comp(comp);
+    }
+
+    if (field_expr != nullptr) {
+      TupleCell value;
+      value_expr->get_tuple_cell(value);
+      const AttrType field_type = field_expr->field().attr_type();
+      const AttrType value_type = value.attr_type();
+      if (field_type == INTS && value_type == INTS) {
+        filter.int_value = *(const int *)value.data();
+        filter.match = select_match<IntKernel>(comp);
+      } else if (field_type == INTS && value_type == FLOATS) {
+        filter.float_value = *(const float *)value.data();
+        filter.match = select_match<IntFloatKernel>(comp);
+      } else if (field_type == FLOATS && (value_type == INTS || value_type == FLOATS)) {
+        filter.float_value = value_type == INTS ? (float)*(const int *)value.data() : *(const float *)value.data();
+        filter.match = select_match<FloatKernel>(comp);
+      } else if (field_type == DATES && value_type == CHARS && field_expr == left_expr) {
+        format_date(value.data(), filter.date_value);
+        filter.match = select_match<DateKernel>(comp);
+      }
+      if (filter.match != nullptr) {
+        filter.field = &field_expr->field();
+      }
+    }
+    filters_.push_back(filter);
+  }
+}
+
 RC PredicateOperator::next()
 {
   RC rc = RC::SUCCESS;
@@ -59,54 +172,40 @@ Tuple * PredicateOperator::current_tuple()
 
 bool PredicateOperator::do_predicate(RowTuple &tuple)
 {
-  if (filter_stmt_ == nullptr || filter_stmt_->filter_units().empty()) {
-    return true;
-  }
-
-  for (const FilterUnit *filter_unit : filter_stmt_->filter_units()) {
-    Expression *left_expr = filter_unit->left();
-    Expression *right_expr = filter_unit->right();
-    CompOp comp = filter_unit->comp();
-    TupleCell left_cell;
-    TupleCell right_cell;
-    left_expr->get_value(tuple, left_cell);
-    right_expr->get_value(tuple, right_cell);
-    
-    if(left_cell.attr_type() == UNDEFINED || right_cell.attr_type() == UNDEFINED){
+  TupleCell cell;
+  for (const Filter &filter : filters_) {
+    if (filter.field == nullptr) {
+      if (!match_filter(*filter.filter_unit, tuple)) {
+        return false;
+      }
       continue;
     }
-    const int compare = left_cell.compare(right_cell);
-    bool filter_result = false;
-    switch (comp) {
-    case EQUAL_TO: {
-      filter_result = (0 == compare); 
-    } break;
-    case LESS_EQUAL: {
-      filter_result = (compare <= 0); 
-    } break;
-    case NOT_EQUAL: {
-      filter_result = (compare != 0);
-    } break;
-    case LESS_THAN: {
-      filter_result = (compare < 0);
-    } break;
-    case GREAT_EQUAL: {
-      filter_result = (compare >= 0);
-    } break;
-    case GREAT_THAN: {
-      filter_result = (compare > 0);
-    } break;
-    default: {
-      LOG_WARN("invalid compare type: %d", comp);
-    } break;
-    }
-    if (!filter_result) {
+    if (tuple.find_cell(*filter.field, cell) != RC::SUCCESS || !filter.match(cell.data(), filter)) {
       return false;
     }
   }
   return true;
 }
 
+bool PredicateOperator::match_filter(const FilterUnit &filter_unit, const Tuple &tuple)
+{
+  Expression *left_expr = filter_unit.left();
+  Expression *right_expr = filter_unit.right();
+  TupleCell left_cell;
+  TupleCell right_cell;
+  RC left_rc = left_expr->get_value(tuple, left_cell);
+  RC right_rc = right_expr->get_value(tuple, right_cell);
+  if (left_rc != RC::SUCCESS || right_rc != RC::SUCCESS) {
+    // 表达式无法计算（比如除数为0）时不满足条件
+    return false;
+  }
+
+  if (left_cell.attr_type() == UNDEFINED || right_cell.attr_type() == UNDEFINED) {
+    return true;
+  }
+  return filter_test(filter_unit.comp(), left_cell.compare(right_cell));
+}
+
 // int PredicateOperator::tuple_cell_num() const
 // {
 //   return children_[0]->tuple_cell_num();
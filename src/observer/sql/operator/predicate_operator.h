@@ -14,9 +14,12 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <vector>
 #include "sql/operator/operator.h"
+#include "storage/common/field.h"
 
 class FilterStmt;
+class FilterUnit;
 
 /**
  * PredicateOperator 用于单个表中的记录过滤
@@ -25,8 +28,12 @@ class FilterStmt;
 class PredicateOperator : public Operator
 {
 public:
-  PredicateOperator(FilterStmt *filter_stmt)
-    : filter_stmt_(filter_stmt)
+  PredicateOperator(FilterStmt *filter_stmt);
+  /**
+   * 只计算其中的一部分条件，比如下推到连接之前的单表条件
+   */
+  PredicateOperator(const std::vector<const FilterUnit *> &filter_units)
+    : filter_units_(filter_units)
   {}
 
   virtual ~PredicateOperator() = default;
@@ -40,6 +47,29 @@ public:
   //RC tuple_cell_spec_at(int index, TupleCellSpec &spec) const override;
 
   bool do_predicate(RowTuple &tuple);
+
+public:
+  struct Filter;
+  typedef bool (*MatchFunc)(const char *data, const Filter &filter);
+
+  /**
+   * 字段与常量比较的条件在open时根据类型和比较符选择专用的比较函数，
+   * 计算时直接比较字段的数据，其它条件使用通用的比较
+   */
+  struct Filter {
+    const FilterUnit *filter_unit = nullptr;
+    const Field *field = nullptr;  // 为空时使用通用的比较
+    MatchFunc match = nullptr;
+    int int_value = 0;
+    float float_value = 0;
+    char date_value[12] = {0};  // 格式化之后的日期
+  };
+
+private:
+  void prepare_filters();
+  bool match_filter(const FilterUnit &filter_unit, const Tuple &tuple);
+
 private:
-  FilterStmt *filter_stmt_ = nullptr;
+  std::vector<const FilterUnit *> filter_units_;
+  std::vector<Filter> filters_;
 };
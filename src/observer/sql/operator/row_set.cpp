@@ -0,0 +1,104 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "sql/operator/row_set.h"
+#include "sql/expr/tuple_cell.h"
+#include "storage/common/table.h"
+#include "storage/common/field.h"
+
+RowSet::RowSet(const std::vector<Table *> &tables) : tables_(tables)
+{
+  for (const Table *table : tables_) {
+    table_offsets_.push_back(row_size_);
+    row_size_ += table->table_meta().record_size();
+  }
+}
+
+void RowSet::append(const Tuple &tuple)
+{
+  data_.resize(data_.size() + row_size_, 0);
+  char *row = data_.data() + (size_t)row_num_ * row_size_;
+  for (size_t i = 0; i < tables_.size(); i++) {
+    const Table *table = tables_[i];
+    const char *record = tuple.find_record(table);
+    if (record != nullptr) {
+      memcpy(row + table_offsets_[i], record, table->table_meta().record_size());
+      continue;
+    }
+    for (const FieldMeta &field_meta : *table->table_meta().field_metas()) {
+      TupleCell cell;
+      if (RC::SUCCESS == tuple.find_cell(Field(table, &field_meta), cell)) {
+        memcpy(row + table_offsets_[i] + field_meta.offset(), cell.data(), field_meta.len());
+      }
+    }
+  }
+  row_num_++;
+}
+
+void RowSet::append_row(const char *row)
+{
+  data_.insert(data_.end(), row, row + row_size_);
+  row_num_++;
+}
+
+void RowSet::set_row(int index, const char *row)
+{
+  memcpy(data_.data() + (size_t)index * row_size_, row, row_size_);
+}
+
+void RowSet::pop_back()
+{
+  if (row_num_ > 0) {
+    row_num_--;
+    data_.resize((size_t)row_num_ * row_size_);
+  }
+}
+
+void RowSet::clear()
+{
+  data_.clear();
+  row_num_ = 0;
+}
+
+int RowSet::field_offset(const Field &field) const
+{
+  for (size_t i = 0; i < tables_.size(); i++) {
+    if (tables_[i] == field.table()) {
+      return table_offsets_[i] + field.meta()->offset();
+    }
+  }
+  return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RowSetTuple::RowSetTuple(const RowSet &row_set)
+{
+  const std::vector<Table *> &tables = row_set.tables();
+  // RowTuple中保存的是records_中元素的地址，所以records_的大小不能再变化
+  records_.resize(tables.size());
+  for (size_t i = 0; i < tables.size(); i++) {
+    table_offsets_.push_back(row_set.table_offset(i));
+
+    RowTuple *row_tuple = new RowTuple();
+    row_tuple->set_schema(tables[i], tables[i]->table_meta().field_metas());
+    row_tuple->set_record(&records_[i]);
+    row_tuples_.emplace_back(row_tuple);
+    tuple_.push_back(row_tuple);
+  }
+}
+
+void RowSetTuple::set_row(const char *row)
+{
+  for (size_t i = 0; i < records_.size(); i++) {
+    records_[i].set_data(const_cast<char *>(row) + table_offsets_[i]);
+  }
+}
@@ -0,0 +1,130 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "sql/expr/tuple.h"
+#include "storage/common/record.h"
+
+class Table;
+class Field;
+
+/**
+ * 在内存中保存子算子输出的数据，比如排序和连接时需要先把一边的数据全部读出来
+ * 每一行由每个表的一条记录依次拼接而成，保存在一块连续的内存中
+ */
+class RowSet
+{
+public:
+  explicit RowSet(const std::vector<Table *> &tables);
+
+  /**
+   * 把tuple中每个表的记录拷贝成新的一行，tuple中没有原始记录的表通过find_cell逐个字段拷贝
+   */
+  void append(const Tuple &tuple);
+  /**
+   * 拷贝一行已经按照当前格式排列好的数据，比如从临时文件中读出来的行
+   */
+  void append_row(const char *row);
+  /**
+   * 用另一行数据覆盖第index行，row不能是第index行本身
+   */
+  void set_row(int index, const char *row);
+  void pop_back();
+  void clear();
+
+  int size() const
+  {
+    return row_num_;
+  }
+  const char *row(int index) const
+  {
+    return data_.data() + (size_t)index * row_size_;
+  }
+
+  const std::vector<Table *> &tables() const
+  {
+    return tables_;
+  }
+  int table_offset(int index) const
+  {
+    return table_offsets_[index];
+  }
+  int row_size() const
+  {
+    return row_size_;
+  }
+
+  /**
+   * 字段在一行数据中的偏移，字段所在的表不在当前集合中时返回-1
+   */
+  int field_offset(const Field &field) const;
+
+private:
+  std::vector<Table *> tables_;
+  std::vector<int> table_offsets_;
+  int row_size_ = 0;
+
+  std::vector<char> data_;
+  int row_num_ = 0;
+};
+
+/**
+ * 把RowSet中的一行数据当作tuple输出
+ */
+class RowSetTuple : public Tuple
+{
+public:
+  explicit RowSetTuple(const RowSet &row_set);
+  virtual ~RowSetTuple() = default;
+
+  /**
+   * @param row RowSet::row返回的数据，在下一次调用之前必须有效
+   */
+  void set_row(const char *row);
+
+  int cell_num() const override
+  {
+    return inner().cell_num();
+  }
+  RC cell_at(int index, TupleCell &cell) const override
+  {
+    return inner().cell_at(index, cell);
+  }
+  RC find_cell(const Field &field, TupleCell &cell) const override
+  {
+    return inner().find_cell(field, cell);
+  }
+  RC cell_spec_at(int index, const TupleCellSpec *&spec) const override
+  {
+    return inner().cell_spec_at(index, spec);
+  }
+  const char *find_record(const Table *table) const override
+  {
+    return inner().find_record(table);
+  }
+
+private:
+  const Tuple &inner() const
+  {
+    if (row_tuples_.size() == 1) {
+      return *row_tuples_[0];
+    }
+    return tuple_;
+  }
+
+private:
+  std::vector<int> table_offsets_;
+  std::vector<Record> records_;
+  std::vector<std::unique_ptr<RowTuple>> row_tuples_;
+  CompositeTuple tuple_;
+};
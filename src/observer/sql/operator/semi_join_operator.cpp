@@ -0,0 +1,311 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <limits.h>
+
+#include "common/log/log.h"
+#include "sql/operator/semi_join_operator.h"
+#include "sql/operator/hash_aggregation_operator.h"
+#include "sql/operator/aggre_result.h"
+#include "sql/operator/filter_kernel.h"
+#include "sql/expr/expression.h"
+
+static uint32_t combine_hash(uint32_t seed, uint32_t hash)
+{
+  return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+SemiJoinOperator::SemiJoinOperator(Operator *left, Operator *right, bool anti)
+    : left_(left), right_(right), anti_(anti)
+{
+  add_child(left);
+  add_child(right);
+}
+
+void SemiJoinOperator::add_key(const Expression *left_key, const Field &right_key)
+{
+  // 左边是字段或者常量时才知道类型，表达式的结果类型要计算之后才知道
+  AttrType left_type = UNDEFINED;
+  int left_length = 0;
+  if (left_key->type() == ExprType::FIELD) {
+    const Field &field = static_cast<const FieldExpr *>(left_key)->field();
+    left_type = field.attr_type();
+    left_length = field.meta()->len();
+  } else if (left_key->type() == ExprType::VALUE) {
+    TupleCell cell;
+    static_cast<const ValueExpr *>(left_key)->get_tuple_cell(cell);
+    left_type = cell.attr_type();
+    left_length = cell.length();
+  }
+
+  AttrHasher left_hasher;
+  left_hasher.init(left_type, left_length);
+  AttrHasher right_hasher;
+  right_hasher.init(right_key.attr_type(), right_key.meta()->len());
+
+  left_keys_.push_back(left_key);
+  right_keys_.push_back(right_key);
+  key_offsets_.push_back(row_size_);
+  hashable_.push_back(left_type == right_key.attr_type() && left_type != FLOATS);
+  left_hashers_.push_back(left_hasher);
+  right_hashers_.push_back(right_hasher);
+  row_size_ += right_key.meta()->len();
+}
+
+void SemiJoinOperator::set_compare(CompOp comp, const Expression *left, const Field &value_field)
+{
+  comp_ = comp;
+  compare_left_ = left;
+  value_field_ = value_field;
+  aggre_oper_ = nullptr;
+}
+
+void SemiJoinOperator::set_compare(CompOp comp, const Expression *left, const HashAggregationOperator *aggre_oper)
+{
+  comp_ = comp;
+  compare_left_ = left;
+  aggre_oper_ = aggre_oper;
+}
+
+uint32_t SemiJoinOperator::right_hash(const char *row) const
+{
+  uint32_t hash = 0;
+  for (size_t i = 0; i < right_keys_.size(); i++) {
+    if (hashable_[i]) {
+      hash = combine_hash(hash, right_hashers_[i](row + key_offsets_[i]));
+    }
+  }
+  return hash;
+}
+
+bool SemiJoinOperator::keys_equal(const char *row, const char *other) const
+{
+  for (size_t i = 0; i < right_keys_.size(); i++) {
+    TupleCell cell(right_keys_[i].attr_type(), const_cast<char *>(row + key_offsets_[i]));
+    cell.set_length(right_keys_[i].meta()->len());
+    TupleCell other_cell(right_keys_[i].attr_type(), const_cast<char *>(other + key_offsets_[i]));
+    other_cell.set_length(right_keys_[i].meta()->len());
+    if (cell.compare(other_cell) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC SemiJoinOperator::read_compare_value(Tuple &tuple, CompareValue &value)
+{
+  value.offset = values_.size();
+  value.is_null = false;
+  if (aggre_oper_ == nullptr) {
+    TupleCell cell;
+    RC rc = tuple.find_cell(value_field_, cell);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to find subquery field. rc=%d:%s", rc, strrc(rc));
+      return rc;
+    }
+    value.type = value_field_.attr_type();
+    value.length = value_field_.meta()->len();
+    values_.insert(values_.end(), cell.data(), cell.data() + value.length);
+    return RC::SUCCESS;
+  }
+
+  // 与输出聚合结果时的语义一致
+  const AggreResult &result = aggre_oper_->aggre_results()[0];
+  const char *data = nullptr;
+  int int_value = 0;
+  float float_value = 0;
+  value.type = INTS;
+  value.length = sizeof(int);
+  if (result.type == COUNT) {
+    int_value = (int)result.count;
+    data = (const char *)&int_value;
+  } else if ((result.type == MIN || result.type == MAX) ? result.result.data == nullptr : result.count == 0) {
+    value.is_null = true;
+    return RC::SUCCESS;
+  } else if (result.type == AVG) {
+    float_value = (float)aggre_result_avg(result);
+    value.type = FLOATS;
+    data = (const char *)&float_value;
+  } else if (result.type == SUM) {
+    if (result.result.type == INTS && result.int_sum >= INT_MIN && result.int_sum <= INT_MAX) {
+      int_value = (int)result.int_sum;
+      data = (const char *)&int_value;
+    } else {
+      float_value = result.result.type == INTS ? (float)result.int_sum : (float)result.float_sum;
+      value.type = FLOATS;
+      data = (const char *)&float_value;
+    }
+  } else {
+    value.type = result.result.type;
+    value.length = result.char_length;
+    data = (const char *)result.result.data;
+  }
+  values_.insert(values_.end(), data, data + value.length);
+  return RC::SUCCESS;
+}
+
+RC SemiJoinOperator::add_right_row(Tuple &tuple)
+{
+  const size_t offset = rows_.size();
+  rows_.resize(offset + row_size_);
+  for (size_t i = 0; i < right_keys_.size(); i++) {
+    TupleCell cell;
+    RC rc = tuple.find_cell(right_keys_[i], cell);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to find subquery key. rc=%d:%s", rc, strrc(rc));
+      return rc;
+    }
+    memcpy(rows_.data() + offset + key_offsets_[i], cell.data(), right_keys_[i].meta()->len());
+  }
+
+  const int index = row_count_;
+  std::vector<int> &bucket = hash_table_[right_hash(rows_.data() + offset)];
+  if (comp_ != NO_OP) {
+    // 标量子查询对外层的每一行最多只能有一个值
+    for (int other : bucket) {
+      if (keys_equal(rows_.data() + offset, rows_.data() + (size_t)other * row_size_)) {
+        LOG_WARN("scalar subquery returns more than one row");
+        return RC::INVALID_ARGUMENT;
+      }
+    }
+    CompareValue value;
+    RC rc = read_compare_value(tuple, value);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    compare_values_.push_back(value);
+  }
+  bucket.push_back(index);
+  row_count_++;
+  return RC::SUCCESS;
+}
+
+RC SemiJoinOperator::open()
+{
+  rows_.clear();
+  row_count_ = 0;
+  compare_values_.clear();
+  values_.clear();
+  hash_table_.clear();
+  left_cells_.resize(left_keys_.size());
+
+  RC rc = left_->open();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open left operator. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+  rc = right_->open();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open subquery operator. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+
+  while (RC::SUCCESS == (rc = right_->next())) {
+    rc = add_right_row(*right_->current_tuple());
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (row_size_ == 0 && comp_ == NO_OP) {
+      break;  // 不相关的EXISTS只关心有没有数据
+    }
+  }
+  if (rc != RC::SUCCESS && rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read subquery. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+  LOG_DEBUG("subquery finished. rows=%d, buckets=%d", row_count_, (int)hash_table_.size());
+  return RC::SUCCESS;
+}
+
+RC SemiJoinOperator::match(const Tuple &tuple, bool &matched)
+{
+  matched = false;
+  uint32_t hash = 0;
+  for (size_t i = 0; i < left_keys_.size(); i++) {
+    RC rc = left_keys_[i]->get_value(tuple, left_cells_[i]);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (hashable_[i]) {
+      hash = combine_hash(hash, left_hashers_[i](left_cells_[i].data()));
+    }
+  }
+
+  const CompareValue *value = nullptr;
+  auto iter = hash_table_.find(hash);
+  if (iter != hash_table_.end()) {
+    for (int index : iter->second) {
+      const char *row = rows_.data() + (size_t)index * row_size_;
+      bool equal = true;
+      for (size_t i = 0; i < left_keys_.size() && equal; i++) {
+        TupleCell cell(right_keys_[i].attr_type(), const_cast<char *>(row + key_offsets_[i]));
+        cell.set_length(right_keys_[i].meta()->len());
+        equal = left_cells_[i].compare(cell) == 0;
+      }
+      if (equal) {
+        matched = true;
+        value = comp_ == NO_OP ? nullptr : &compare_values_[index];
+        break;
+      }
+    }
+  }
+  if (comp_ == NO_OP) {
+    return RC::SUCCESS;
+  }
+
+  // 相关子查询没有数据的分组，COUNT的结果是0
+  int zero = 0;
+  TupleCell value_cell(INTS, (char *)&zero);
+  if (matched) {
+    if (value->is_null) {
+      matched = false;
+      return RC::SUCCESS;
+    }
+    value_cell = TupleCell(value->type, values_.data() + value->offset);
+    value_cell.set_length(value->length);
+  } else if (aggre_oper_ == nullptr || aggre_oper_->aggregations()[0].type != COUNT) {
+    return RC::SUCCESS;
+  }
+
+  TupleCell left_cell;
+  RC rc = compare_left_->get_value(tuple, left_cell);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  matched = filter_test(comp_, left_cell.compare(value_cell));
+  return RC::SUCCESS;
+}
+
+RC SemiJoinOperator::next()
+{
+  RC rc = RC::SUCCESS;
+  while (RC::SUCCESS == (rc = left_->next())) {
+    bool matched = false;
+    if (match(*left_->current_tuple(), matched) != RC::SUCCESS) {
+      continue;  // 无法计算的行既不满足IN也不满足NOT IN
+    }
+    if (matched != anti_) {
+      return RC::SUCCESS;
+    }
+  }
+  return rc;
+}
+
+RC SemiJoinOperator::close()
+{
+  left_->close();
+  right_->close();
+  rows_.clear();
+  compare_values_.clear();
+  values_.clear();
+  hash_table_.clear();
+  return RC::SUCCESS;
+}
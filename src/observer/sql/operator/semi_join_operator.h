@@ -0,0 +1,105 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "sql/operator/operator.h"
+#include "sql/expr/tuple_cell.h"
+#include "storage/common/field.h"
+#include "storage/index/extendible_hash.h"
+
+class Expression;
+class HashAggregationOperator;
+
+/**
+ * 子查询改写成的半连接（IN/EXISTS）和反连接（NOT IN/NOT EXISTS）
+ * open时把右边的子查询执行一次，按连接字段建哈希表，左边的每一行只查找哈希表，
+ * 半连接输出能找到匹配的行，反连接输出找不到匹配的行。
+ * 相关子查询的关联条件和IN的字段都作为连接字段。
+ *
+ * 标量子查询（left op (SELECT ...)）设置比较条件，子查询对每组连接字段最多只有一行，
+ * 找到这一行之后还要满足 left op value。子查询是聚合时，没有数据的分组COUNT为0，其它聚合为空
+ */
+class SemiJoinOperator : public Operator
+{
+public:
+  SemiJoinOperator(Operator *left, Operator *right, bool anti);
+
+  virtual ~SemiJoinOperator() = default;
+
+  /**
+   * 增加一对等值连接的字段，left_key在左边的行上计算
+   */
+  void add_key(const Expression *left_key, const Field &right_key);
+
+  /**
+   * 与子查询输出的字段比较
+   */
+  void set_compare(CompOp comp, const Expression *left, const Field &value_field);
+  /**
+   * 与子查询唯一的聚合结果比较，aggre_oper是右边的算子
+   */
+  void set_compare(CompOp comp, const Expression *left, const HashAggregationOperator *aggre_oper);
+
+  RC open() override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override
+  {
+    return left_->current_tuple();
+  }
+
+private:
+  /**
+   * 比较的值，is_null表示没有值（例如没有数据的MIN），不满足任何比较
+   */
+  struct CompareValue {
+    AttrType type;
+    int length;
+    size_t offset;  // 在values_中的位置
+    bool is_null;
+  };
+
+  RC add_right_row(Tuple &tuple);
+  RC read_compare_value(Tuple &tuple, CompareValue &value);
+  uint32_t right_hash(const char *row) const;
+  bool keys_equal(const char *row, const char *other) const;
+  RC match(const Tuple &tuple, bool &matched);
+
+private:
+  Operator *left_ = nullptr;
+  Operator *right_ = nullptr;
+  bool anti_ = false;
+
+  std::vector<const Expression *> left_keys_;
+  std::vector<Field> right_keys_;
+  std::vector<int> key_offsets_;  // 右边的连接字段在一行中的位置
+  std::vector<bool> hashable_;    // 两边类型相同时才能按哈希值查找，否则只能逐行比较
+  std::vector<AttrHasher> left_hashers_;
+  std::vector<AttrHasher> right_hashers_;
+  int row_size_ = 0;
+
+  CompOp comp_ = NO_OP;
+  const Expression *compare_left_ = nullptr;
+  Field value_field_;
+  const HashAggregationOperator *aggre_oper_ = nullptr;
+
+  std::vector<char> rows_;  // 右边每一行的连接字段
+  int row_count_ = 0;
+  std::vector<CompareValue> compare_values_;
+  std::vector<char> values_;
+  std::unordered_map<uint32_t, std::vector<int>> hash_table_;
+
+  std::vector<TupleCell> left_cells_;
+};
@@ -0,0 +1,413 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <algorithm>
+
+#include "common/log/log.h"
+#include "sql/operator/sort_operator.h"
+#include "storage/common/table.h"
+#include "storage/common/field.h"
+#include "storage/default/spill_file.h"
+
+// 一次最多同时归并的段数，每个段读取时占用一个页面
+static const int MERGE_WAYS = 16;
+
+static int64_t default_memory_budget = 64 * 1024 * 1024;
+
+static void encode_uint32(uint32_t value, char *key)
+{
+  key[0] = (char)(value >> 24);
+  key[1] = (char)(value >> 16);
+  key[2] = (char)(value >> 8);
+  key[3] = (char)value;
+}
+
+/**
+ * 多路归并若干个有序段，段中的每一行是key加上行数据。key相同时先输出编号小的段
+ */
+class SortMerger
+{
+public:
+  SortMerger(std::vector<std::unique_ptr<SpillFile>> runs, int key_size)
+    : runs_(std::move(runs)), rows_(runs_.size(), nullptr), key_size_(key_size)
+  {}
+
+  RC open()
+  {
+    for (size_t i = 0; i < runs_.size(); i++) {
+      RC rc = runs_[i]->rewind();
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      rc = push(i);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+    return RC::SUCCESS;
+  }
+
+  /**
+   * @param row 下一次调用next之前有效
+   */
+  RC next(const char *&row)
+  {
+    if (last_ >= 0) {
+      RC rc = push(last_);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      last_ = -1;
+    }
+    if (heap_.empty()) {
+      return RC::RECORD_EOF;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), Greater{this});
+    last_ = heap_.back();
+    heap_.pop_back();
+    row = rows_[last_];
+    return RC::SUCCESS;
+  }
+
+private:
+  // 读取段中的下一行并放入堆中，段读完时不放入
+  RC push(int run)
+  {
+    RC rc = runs_[run]->next(rows_[run]);
+    if (rc == RC::RECORD_EOF) {
+      return RC::SUCCESS;
+    }
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to read sorted run. rc=%s", strrc(rc));
+      return rc;
+    }
+    heap_.push_back(run);
+    std::push_heap(heap_.begin(), heap_.end(), Greater{this});
+    return RC::SUCCESS;
+  }
+
+  // 堆顶是最小的行
+  struct Greater {
+    const SortMerger *merger;
+    bool operator()(int left, int right) const
+    {
+      const int result = memcmp(merger->rows_[left], merger->rows_[right], merger->key_size_);
+      return result != 0 ? result > 0 : left > right;
+    }
+  };
+
+private:
+  std::vector<std::unique_ptr<SpillFile>> runs_;
+  std::vector<const char *> rows_;  // 每个段当前的行
+  int key_size_ = 0;
+  std::vector<int> heap_;
+  int last_ = -1;                   // 上一次输出的行所在的段
+};
+
+SortOperator::SortOperator(const std::vector<Table *> &tables, const std::vector<OrderByUnit> &order_by_units)
+  : rows_(tables), memory_budget_(default_memory_budget), tuple_(rows_)
+{
+  for (const OrderByUnit &unit : order_by_units) {
+    const int offset = rows_.field_offset(unit.field);
+    if (offset >= 0) {
+      const FieldMeta *field_meta = unit.field.meta();
+      sort_keys_.push_back({offset, field_meta->type(), field_meta->len(), unit.asc});
+      key_size_ += (field_meta->type() == INTS || field_meta->type() == FLOATS) ? 4 : field_meta->len();
+    }
+  }
+}
+
+SortOperator::~SortOperator() = default;
+
+void SortOperator::set_default_memory_budget(int64_t bytes)
+{
+  default_memory_budget = bytes;
+}
+
+/**
+ * INTS翻转符号位后按大端序存放；FLOATS非负数翻转符号位，负数翻转所有位；
+ * CHARS和DATES拷贝到结束符为止，后面补0。降序的字段再把所有位取反
+ */
+void SortOperator::encode_key(const char *row, char *key) const
+{
+  for (const SortKey &sort_key : sort_keys_) {
+    const char *value = row + sort_key.offset;
+    int length = 4;
+    switch (sort_key.type) {
+      case INTS: {
+        encode_uint32((uint32_t)*(const int *)value ^ 0x80000000u, key);
+      } break;
+      case FLOATS: {
+        float f = *(const float *)value;
+        if (f == 0) {
+          f = 0;  // -0.0与0.0相等
+        }
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        encode_uint32((bits & 0x80000000u) ? ~bits : bits | 0x80000000u, key);
+      } break;
+      default: {
+        length = sort_key.length;
+        const char *end = (const char *)memchr(value, 0, length);
+        const int size = end == nullptr ? length : end - value;
+        memcpy(key, value, size);
+        memset(key + size, 0, length - size);
+      } break;
+    }
+    if (!sort_key.asc) {
+      for (int i = 0; i < length; i++) {
+        key[i] = ~key[i];
+      }
+    }
+    key += length;
+  }
+}
+
+bool SortOperator::row_less(int left, int right) const
+{
+  const int result = memcmp(key(left), key(right), key_size_);
+  if (result != 0) {
+    return result < 0;
+  }
+  if (!sequences_.empty()) {
+    return sequences_[left] < sequences_[right];
+  }
+  return left < right;
+}
+
+int64_t SortOperator::memory_usage() const
+{
+  return (int64_t)rows_.size() * (rows_.row_size() + key_size_ + sizeof(int));
+}
+
+void SortOperator::append(const Tuple &tuple)
+{
+  rows_.append(tuple);
+  keys_.resize(keys_.size() + key_size_);
+  encode_key(rows_.row(rows_.size() - 1), keys_.data() + keys_.size() - key_size_);
+}
+
+/**
+ * 堆顶是保留的行中最大的一行，新的一行比它小时替换掉它
+ * 新的一行先追加到最后，比较之后再拷贝到堆顶的位置或者丢弃
+ */
+RC SortOperator::read_top_n(Operator *child)
+{
+  std::vector<int> heap;
+  auto less = [this](int left, int right) { return row_less(left, right); };
+  RC rc = RC::SUCCESS;
+  int sequence = 0;
+  while (limit_ > 0 && RC::SUCCESS == (rc = child->next())) {
+    append(*child->current_tuple());
+    sequences_.push_back(sequence++);
+    const int last = rows_.size() - 1;
+    if (last < limit_) {
+      heap.push_back(last);
+      std::push_heap(heap.begin(), heap.end(), less);
+      continue;
+    }
+
+    const int top = heap.front();
+    if (row_less(last, top)) {
+      std::pop_heap(heap.begin(), heap.end(), less);
+      rows_.set_row(top, rows_.row(last));
+      memcpy(keys_.data() + (size_t)top * key_size_, key(last), key_size_);
+      sequences_[top] = sequences_[last];
+      std::push_heap(heap.begin(), heap.end(), less);
+    }
+    rows_.pop_back();
+    keys_.resize(keys_.size() - key_size_);
+    sequences_.pop_back();
+  }
+  return limit_ > 0 ? rc : RC::RECORD_EOF;
+}
+
+void SortOperator::sort_rows()
+{
+  const int row_num = rows_.size();
+  sorted_rows_.resize(row_num);
+  for (int i = 0; i < row_num; i++) {
+    sorted_rows_[i] = i;
+  }
+  std::sort(sorted_rows_.begin(), sorted_rows_.end(), [this](int left, int right) { return row_less(left, right); });
+}
+
+RC SortOperator::spill_run()
+{
+  sort_rows();
+
+  const int row_size = rows_.row_size();
+  std::unique_ptr<SpillFile> run(new SpillFile(key_size_ + row_size));
+  std::vector<char> buffer(key_size_ + row_size);
+  for (int index : sorted_rows_) {
+    memcpy(buffer.data(), keys_.data() + (size_t)index * key_size_, key_size_);
+    memcpy(buffer.data() + key_size_, rows_.row(index), row_size);
+    RC rc = run->append(buffer.data());
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to write sorted run. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  runs_.push_back(std::move(run));
+  spilled_runs_++;
+
+  rows_.clear();
+  keys_.clear();
+  sorted_rows_.clear();
+  return RC::SUCCESS;
+}
+
+/**
+ * 段太多时，相邻的MERGE_WAYS个段归并成一个，直到可以一次归并完
+ */
+RC SortOperator::merge_runs()
+{
+  const int row_size = key_size_ + rows_.row_size();
+  while (runs_.size() > (size_t)MERGE_WAYS) {
+    std::vector<std::unique_ptr<SpillFile>> merged_runs;
+    for (size_t begin = 0; begin < runs_.size(); begin += MERGE_WAYS) {
+      const size_t end = std::min(begin + MERGE_WAYS, runs_.size());
+      if (end - begin == 1) {
+        merged_runs.push_back(std::move(runs_[begin]));
+        continue;
+      }
+
+      std::vector<std::unique_ptr<SpillFile>> inputs;
+      for (size_t i = begin; i < end; i++) {
+        inputs.push_back(std::move(runs_[i]));
+      }
+      SortMerger merger(std::move(inputs), key_size_);
+      RC rc = merger.open();
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      std::unique_ptr<SpillFile> run(new SpillFile(row_size));
+      const char *row = nullptr;
+      while (RC::SUCCESS == (rc = merger.next(row))) {
+        rc = run->append(row);
+        if (rc != RC::SUCCESS) {
+          LOG_WARN("failed to write merged run. rc=%s", strrc(rc));
+          return rc;
+        }
+      }
+      if (rc != RC::RECORD_EOF) {
+        return rc;
+      }
+      merged_runs.push_back(std::move(run));
+      spilled_runs_++;
+    }
+    runs_ = std::move(merged_runs);
+  }
+
+  merger_.reset(new SortMerger(std::move(runs_), key_size_));
+  runs_.clear();
+  return merger_->open();
+}
+
+RC SortOperator::open()
+{
+  if (children_.size() != 1) {
+    LOG_WARN("sort operator must has one child");
+    return RC::INTERNAL;
+  }
+
+  Operator *child = children_[0];
+  RC rc = child->open();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open child operator: %s", strrc(rc));
+    return rc;
+  }
+
+  rows_.clear();
+  keys_.clear();
+  sequences_.clear();
+  runs_.clear();
+  merger_.reset();
+  spilled_runs_ = 0;
+  // 多留一行的位置给正在比较的行
+  const int64_t row_memory = rows_.row_size() + key_size_ + 2 * sizeof(int);
+  const bool top_n = limit_ >= 0 && (limit_ + 1) * row_memory <= memory_budget_;
+  const bool can_spill = SpillFile::can_spill(key_size_ + rows_.row_size());
+  if (top_n) {
+    rc = read_top_n(child);
+  } else {
+    while (RC::SUCCESS == (rc = child->next())) {
+      append(*child->current_tuple());
+      if (can_spill && rows_.size() > 1 && memory_usage() > memory_budget_) {
+        rc = spill_run();
+        if (rc != RC::SUCCESS) {
+          break;
+        }
+      }
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to fetch child tuple. rc=%s", strrc(rc));
+    child->close();
+    return rc;
+  }
+
+  if (runs_.empty()) {
+    sort_rows();
+  } else {
+    if (rows_.size() > 0 && (rc = spill_run()) != RC::SUCCESS) {
+      child->close();
+      return rc;
+    }
+    if ((rc = merge_runs()) != RC::SUCCESS) {
+      LOG_WARN("failed to merge sorted runs. rc=%s", strrc(rc));
+      child->close();
+      return rc;
+    }
+  }
+
+  current_ = -1;
+  LOG_INFO("sort operator opened. rows in memory=%d, top n=%d, spilled runs=%d", (int)sorted_rows_.size(),
+      top_n ? 1 : 0, spilled_runs_);
+  return RC::SUCCESS;
+}
+
+RC SortOperator::next()
+{
+  if (merger_ != nullptr) {
+    const char *row = nullptr;
+    RC rc = merger_->next(row);
+    if (rc == RC::SUCCESS) {
+      tuple_.set_row(row + key_size_);
+    }
+    return rc;
+  }
+
+  if (current_ + 1 >= (int)sorted_rows_.size()) {
+    return RC::RECORD_EOF;
+  }
+
+  current_++;
+  tuple_.set_row(rows_.row(sorted_rows_[current_]));
+  return RC::SUCCESS;
+}
+
+RC SortOperator::close()
+{
+  rows_.clear();
+  keys_.clear();
+  sequences_.clear();
+  sorted_rows_.clear();
+  runs_.clear();
+  merger_.reset();
+  current_ = -1;
+  return children_[0]->close();
+}
+
+Tuple * SortOperator::current_tuple()
+{
+  return &tuple_;
+}
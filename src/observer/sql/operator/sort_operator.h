@@ -0,0 +1,112 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include "sql/operator/operator.h"
+#include "sql/operator/row_set.h"
+#include "sql/stmt/select_stmt.h"
+#include "rc.h"
+
+class Table;
+class SpillFile;
+class SortMerger;
+
+/**
+ * ORDER BY 的排序
+ * open时把子算子的所有数据拷贝到RowSet中，按照排序字段排好序之后再逐条输出。
+ * 如果数据已经按照索引的顺序输出，就不需要这个算子
+ *
+ * 每一行的排序字段编码成可以直接用memcmp比较的定长key，排序时只比较key。
+ * 数据超过内存限制时，把当前已经读到的行排好序写到临时文件中作为一个有序段（run），
+ * 输入读完之后多路归并所有的段；段太多时先分批归并成更少的段。相同key的行保持输入的顺序
+ *
+ * 设置了limit并且limit行可以放在内存中时（ORDER BY ... LIMIT），用大顶堆只保留当前最小的limit行
+ */
+class SortOperator : public Operator
+{
+public:
+  SortOperator(const std::vector<Table *> &tables, const std::vector<OrderByUnit> &order_by_units);
+
+  virtual ~SortOperator();
+
+  /**
+   * 内存中的行、key和排序下标最多使用的字节数
+   */
+  static void set_default_memory_budget(int64_t bytes);
+  void set_memory_budget(int64_t bytes)
+  {
+    memory_budget_ = bytes;
+  }
+
+  /**
+   * 只需要排序之后的前rows行，超出的行可以丢弃。-1表示需要所有的行
+   */
+  void set_limit(int64_t rows)
+  {
+    limit_ = rows;
+  }
+
+  /**
+   * 写到临时文件中的有序段个数，包括归并时生成的
+   */
+  int spilled_runs() const
+  {
+    return spilled_runs_;
+  }
+
+  RC open() override;
+  RC next() override;
+  RC close() override;
+
+  Tuple * current_tuple() override;
+
+private:
+  struct SortKey {
+    int offset;   // 字段在整行数据中的偏移
+    AttrType type;
+    int length;
+    bool asc;
+  };
+
+  void encode_key(const char *row, char *key) const;
+  const char *key(int index) const
+  {
+    return keys_.data() + (size_t)index * key_size_;
+  }
+  bool row_less(int left, int right) const;
+  int64_t memory_usage() const;
+  void append(const Tuple &tuple);
+  RC read_top_n(Operator *child);
+  void sort_rows();
+  RC spill_run();
+  RC merge_runs();
+
+private:
+  RowSet rows_;
+  std::vector<SortKey> sort_keys_;
+  int key_size_ = 0;
+  std::vector<char> keys_;       // 每一行的key，与rows_中的行一一对应
+  std::vector<int> sequences_;   // Top-N时每一行在输入中的序号，行的位置会被复用
+  int64_t limit_ = -1;
+
+  std::vector<int> sorted_rows_;
+  int current_ = -1;
+
+  int64_t memory_budget_;
+  std::vector<std::unique_ptr<SpillFile>> runs_;
+  std::unique_ptr<SortMerger> merger_;  // 有数据写到临时文件时，从这里输出
+  int spilled_runs_ = 0;
+
+  RowSetTuple tuple_;
+};
@@ -0,0 +1,73 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "common/log/log.h"
+#include "sql/operator/temp_relation.h"
+
+static int64_t default_memory_budget = 64 * 1024 * 1024;
+
+void TempRelation::set_default_memory_budget(int64_t bytes)
+{
+  default_memory_budget = bytes;
+}
+
+TempRelation::TempRelation(const std::vector<Table *> &tables)
+  : resident_rows_(tables), memory_budget_(default_memory_budget)
+{}
+
+RC TempRelation::append(const Tuple &tuple)
+{
+  resident_rows_.append(tuple);
+  const int row_size = resident_rows_.row_size();
+  if (spill_file_ == nullptr &&
+      ((int64_t)resident_rows_.size() * row_size <= memory_budget_ || !SpillFile::can_spill(row_size))) {
+    return RC::SUCCESS;
+  }
+
+  // 内存已经用完，之后的行都写到临时文件中，保持写入的顺序
+  if (spill_file_ == nullptr) {
+    LOG_INFO("temp relation exceeds memory budget, spill to file. rows=%d", resident_rows_.size());
+    spill_file_.reset(new SpillFile(row_size));
+  }
+  RC rc = spill_file_->append(resident_rows_.row(resident_rows_.size() - 1));
+  resident_rows_.pop_back();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to spill temp relation row. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+void TempRelation::clear()
+{
+  resident_rows_.clear();
+  spill_file_.reset();
+  read_index_ = 0;
+}
+
+RC TempRelation::rewind()
+{
+  read_index_ = 0;
+  if (spill_file_ != nullptr) {
+    return spill_file_->rewind();
+  }
+  return RC::SUCCESS;
+}
+
+RC TempRelation::next(const char *&row)
+{
+  if (read_index_ < resident_rows_.size()) {
+    row = resident_rows_.row(read_index_++);
+    return RC::SUCCESS;
+  }
+  if (spill_file_ == nullptr) {
+    return RC::RECORD_EOF;
+  }
+  return spill_file_->next(row);
+}
@@ -0,0 +1,76 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "sql/operator/row_set.h"
+#include "storage/default/spill_file.h"
+#include "rc.h"
+
+/**
+ * 保存算子中间结果的临时关系，只存在于一次查询中，不会在数据库中建表，也不写元数据
+ * 行的格式与RowSet相同。先放在内存中，超过内存限制之后后面的行追加到临时文件，
+ * 读取时先读内存中的行，再读文件中的行，可以反复从头读取
+ */
+class TempRelation
+{
+public:
+  explicit TempRelation(const std::vector<Table *> &tables);
+
+  static void set_default_memory_budget(int64_t bytes);
+  void set_memory_budget(int64_t bytes)
+  {
+    memory_budget_ = bytes;
+  }
+
+  RC append(const Tuple &tuple);
+  void clear();
+
+  /**
+   * 全部的行数，包括写到临时文件中的
+   */
+  int size() const
+  {
+    return resident_rows_.size() + (spill_file_ == nullptr ? 0 : spill_file_->row_count());
+  }
+  bool spilled() const
+  {
+    return spill_file_ != nullptr;
+  }
+  /**
+   * 留在内存中的行，没有写临时文件时就是全部的行
+   */
+  const RowSet &resident_rows() const
+  {
+    return resident_rows_;
+  }
+  int64_t memory_budget() const
+  {
+    return memory_budget_;
+  }
+
+  /**
+   * 从第一行开始读，写完之后第一次读之前也要调用
+   */
+  RC rewind();
+  /**
+   * @param row 格式与resident_rows().row()相同，下一次调用next之前有效
+   * @return 没有更多数据时返回RECORD_EOF
+   */
+  RC next(const char *&row);
+
+private:
+  RowSet resident_rows_;
+  int64_t memory_budget_ = 0;
+  std::unique_ptr<SpillFile> spill_file_;
+  int read_index_ = 0;  // 下一个要读的内存中的行
+};
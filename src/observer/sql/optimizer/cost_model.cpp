@@ -0,0 +1,103 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+
+#include "sql/optimizer/cost_model.h"
+#include "sql/stmt/filter_stmt.h"
+#include "sql/expr/expression.h"
+#include "storage/common/table.h"
+
+// 没有统计信息时各种条件的选择率
+static const double EQUAL_SELECTIVITY = 0.1;
+static const double NOT_EQUAL_SELECTIVITY = 0.9;
+static const double RANGE_SELECTIVITY = 1.0 / 3;
+
+// 代价以顺序读取一个页面为单位
+static const double PAGE_COST = 1.0;
+static const double ROW_COST = 0.01;        // 处理一行记录
+static const double INDEX_ROW_COST = 0.05;  // 通过索引找到一行，再按照RID读取记录
+
+static CompOp mirror_comp(CompOp comp)
+{
+  switch (comp) {
+    case LESS_EQUAL: return GREAT_EQUAL;
+    case LESS_THAN: return GREAT_THAN;
+    case GREAT_EQUAL: return LESS_EQUAL;
+    case GREAT_THAN: return LESS_THAN;
+    default: return comp;
+  }
+}
+
+double CostModel::column_selectivity(const FilterUnit *filter_unit)
+{
+  const Expression *left = filter_unit->left();
+  const Expression *right = filter_unit->right();
+  CompOp comp = filter_unit->comp();
+  if (left->type() == ExprType::VALUE && right->type() == ExprType::FIELD) {
+    std::swap(left, right);
+    comp = mirror_comp(comp);
+  }
+  if (left->type() != ExprType::FIELD || right->type() != ExprType::VALUE) {
+    return -1;
+  }
+
+  const Field &field = ((const FieldExpr *)left)->field();
+  const TableStats &stats = field.table()->table_meta().stats();
+  const ColumnStats *column = stats.column(field.field_name());
+  if (!stats.valid() || column == nullptr) {
+    return -1;
+  }
+
+  TupleCell value;
+  ((const ValueExpr *)right)->get_tuple_cell(value);
+  const AttrType field_type = field.attr_type();
+  if (value.attr_type() != field_type && !(field_type == DATES && value.attr_type() == CHARS)) {
+    return -1;
+  }
+  return column->selectivity(comp, value.data(), stats.row_count());
+}
+
+double CostModel::selectivity(const FilterUnit *filter_unit)
+{
+  const double result = column_selectivity(filter_unit);
+  if (result >= 0) {
+    return result;
+  }
+
+  switch (filter_unit->comp()) {
+    case EQUAL_TO: return EQUAL_SELECTIVITY;
+    case NOT_EQUAL: return NOT_EQUAL_SELECTIVITY;
+    default: return RANGE_SELECTIVITY;
+  }
+}
+
+double CostModel::distinct_count(const Field &field)
+{
+  const TableStats &stats = field.table()->table_meta().stats();
+  const ColumnStats *column = stats.column(field.field_name());
+  if (!stats.valid() || column == nullptr || stats.row_count() == 0) {
+    return -1;
+  }
+  return std::min(std::max<int64_t>(column->distinct_count(), 1), stats.row_count());
+}
+
+bool CostModel::index_scan_cheaper(const Table *table, double selectivity)
+{
+  const double rows = table->estimated_row_count();
+  // 第0页是文件头
+  const double pages = std::max(table->data_page_count() - 1, 1);
+  const double matched_rows = rows * selectivity;
+
+  const double table_scan_cost = pages * PAGE_COST + rows * ROW_COST;
+  // 每一行最多读一个页面，行数比页面多时每个页面最多读一次
+  const double index_scan_cost = std::min(matched_rows, pages) * PAGE_COST + matched_rows * INDEX_ROW_COST;
+  return index_scan_cost < table_scan_cost;
+}
@@ -0,0 +1,45 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+
+class FilterUnit;
+class Field;
+class Table;
+
+/**
+ * 根据表的统计信息估算条件的选择率和扫描的代价
+ */
+class CostModel
+{
+public:
+  /**
+   * 字段与常量比较的条件，用ANALYZE生成的直方图估算选择率
+   * @return 没有统计信息或者不是这种条件时返回负数
+   */
+  static double column_selectivity(const FilterUnit *filter_unit);
+
+  /**
+   * 没有统计信息时按照比较类型使用默认的选择率
+   */
+  static double selectivity(const FilterUnit *filter_unit);
+
+  /**
+   * 字段中不同值的个数，不知道时返回负数
+   */
+  static double distinct_count(const Field &field);
+
+  /**
+   * 按照估算的代价比较用索引读取满足条件的行和扫描整个表
+   */
+  static bool index_scan_cheaper(const Table *table, double selectivity);
+};
@@ -0,0 +1,308 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+
+#include "common/log/log.h"
+#include "sql/optimizer/join_planner.h"
+#include "sql/optimizer/cost_model.h"
+#include "sql/stmt/filter_stmt.h"
+#include "sql/operator/join_operator.h"
+#include "storage/common/table.h"
+#include "storage/index/index.h"
+
+// 已经连接的行数乘以这个值仍然不超过新表的行数时，逐行查索引比扫描整个表更合算
+static const int INDEX_JOIN_RATIO = 4;
+
+const char *JoinPlanner::method_name(JoinMethod method)
+{
+  switch (method) {
+    case JoinMethod::NESTED_LOOP: return "nested loop join";
+    case JoinMethod::HASH: return "hash join";
+    case JoinMethod::INDEX_NESTED_LOOP: return "index nested loop join";
+    case JoinMethod::SORT_MERGE: return "sort merge join";
+  }
+  return "unknown join";
+}
+
+static bool contains(const std::vector<Table *> &tables, const Table *table)
+{
+  return std::find(tables.begin(), tables.end(), table) != tables.end();
+}
+
+/**
+ * 条件中引用的表。表达式中引用的字段没有办法确定，认为引用了全部的表
+ */
+static void referenced_tables(const FilterUnit *filter_unit, const std::vector<Table *> &all_tables,
+                              std::vector<Table *> &tables)
+{
+  for (const Expression *expr : {filter_unit->left(), filter_unit->right()}) {
+    switch (expr->type()) {
+      case ExprType::FIELD: {
+        Table *table = const_cast<Table *>(((const FieldExpr *)expr)->field().table());
+        if (!contains(tables, table)) {
+          tables.push_back(table);
+        }
+      } break;
+      case ExprType::VALUE: {
+      } break;
+      default: {
+        tables = all_tables;
+        return;
+      }
+    }
+  }
+}
+
+static double estimate_table_rows(const Table *table, const std::vector<const FilterUnit *> &filters)
+{
+  double rows = std::max<double>(table->estimated_row_count(), 1);
+  for (const FilterUnit *filter_unit : filters) {
+    rows *= CostModel::selectivity(filter_unit);
+  }
+  return std::max(rows, 1.0);
+}
+
+/**
+ * 已经连接的表与table之间的等值条件，两边类型相同并且可以精确比较时可以作为连接字段
+ */
+static bool get_join_keys(const FilterUnit *filter_unit, const std::vector<Table *> &joined_tables,
+                          const Table *table, Field &joined_key, Field &table_key)
+{
+  const Expression *left = filter_unit->left();
+  const Expression *right = filter_unit->right();
+  if (filter_unit->comp() != EQUAL_TO || left->type() != ExprType::FIELD || right->type() != ExprType::FIELD) {
+    return false;
+  }
+
+  const Field &left_field = ((const FieldExpr *)left)->field();
+  const Field &right_field = ((const FieldExpr *)right)->field();
+  if (!HashJoinOperator::can_hash(left_field, right_field)) {
+    return false;
+  }
+  if (contains(joined_tables, left_field.table()) && right_field.table() == table) {
+    joined_key = left_field;
+    table_key = right_field;
+    return true;
+  }
+  if (contains(joined_tables, right_field.table()) && left_field.table() == table) {
+    joined_key = right_field;
+    table_key = left_field;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * 第一个等值条件除以两边不同值个数中较大的一个，没有统计信息时按照主外键连接估算，结果与较大的一边相同
+ * 其它条件按照选择率估算
+ */
+static double estimate_join_rows(double joined_rows, double table_rows, const std::vector<const FilterUnit *> &filters,
+                                 const std::vector<Table *> &joined_tables, const Table *table)
+{
+  double rows = joined_rows * table_rows;
+  bool has_key = false;
+  for (const FilterUnit *filter_unit : filters) {
+    Field joined_key;
+    Field table_key;
+    if (!has_key && get_join_keys(filter_unit, joined_tables, table, joined_key, table_key)) {
+      const double joined_distinct = CostModel::distinct_count(joined_key);
+      const double table_distinct = CostModel::distinct_count(table_key);
+      if (joined_distinct > 0 && table_distinct > 0) {
+        rows /= std::max(joined_distinct, table_distinct);
+      } else {
+        rows /= std::min(joined_rows, table_rows);
+      }
+      has_key = true;
+    } else {
+      rows *= CostModel::selectivity(filter_unit);
+    }
+  }
+  return std::max(rows, 1.0);
+}
+
+static Index *find_bplus_tree_index(const Field &field)
+{
+  Index *index = field.table()->find_index_by_field(field.field_name());
+  if (index == nullptr || index->index_meta().type() != BPLUS_TREE_INDEX) {
+    return nullptr;
+  }
+  return index;
+}
+
+/**
+ * 选择把step.table连接到joined_tables上的方式，连接算子已经保证的等值条件从join_filters中去掉
+ */
+static void choose_join_method(JoinStep &step, const std::vector<Table *> &joined_tables, double joined_rows,
+                               double table_rows, bool first_filtered)
+{
+  std::vector<const FilterUnit *> key_filters;
+  for (const FilterUnit *filter_unit : step.join_filters) {
+    Field joined_key;
+    Field table_key;
+    if (get_join_keys(filter_unit, joined_tables, step.table, joined_key, table_key)) {
+      step.joined_keys.push_back(joined_key);
+      step.table_keys.push_back(table_key);
+      key_filters.push_back(filter_unit);
+    }
+  }
+  if (key_filters.empty()) {
+    step.method = JoinMethod::NESTED_LOOP;
+    return;
+  }
+
+  // 把第一个有索引的连接字段换到最前面
+  Index *index = nullptr;
+  for (size_t i = 0; i < step.table_keys.size() && index == nullptr; i++) {
+    index = step.table->find_index_by_field(step.table_keys[i].field_name());
+    if (index != nullptr) {
+      std::swap(step.table_keys[0], step.table_keys[i]);
+      std::swap(step.joined_keys[0], step.joined_keys[i]);
+      std::swap(key_filters[0], key_filters[i]);
+    }
+  }
+
+  if (index != nullptr && joined_rows * INDEX_JOIN_RATIO <= step.table->estimated_row_count()) {
+    step.method = JoinMethod::INDEX_NESTED_LOOP;
+    step.index = index;
+  } else if (joined_tables.size() == 1 && !first_filtered && step.table_filters.empty() &&
+             find_bplus_tree_index(step.table_keys[0]) != nullptr &&
+             find_bplus_tree_index(step.joined_keys[0]) != nullptr) {
+    // 两边都要完整地读一遍，按照索引顺序读就不需要排序，也不需要把一边放到内存中建立哈希表
+    step.method = JoinMethod::SORT_MERGE;
+    step.index = find_bplus_tree_index(step.table_keys[0]);
+    step.joined_index = find_bplus_tree_index(step.joined_keys[0]);
+  } else {
+    step.method = JoinMethod::HASH;
+    step.build_table = table_rows <= joined_rows;
+  }
+
+  if (step.method != JoinMethod::HASH) {
+    // 只有第一个连接字段由连接算子处理，其它的等值条件在连接之后过滤
+    step.table_keys.resize(1);
+    step.joined_keys.resize(1);
+    key_filters.resize(1);
+  }
+  for (const FilterUnit *key_filter : key_filters) {
+    step.join_filters.erase(std::find(step.join_filters.begin(), step.join_filters.end(), key_filter));
+  }
+
+  if (step.method == JoinMethod::INDEX_NESTED_LOOP) {
+    // 不扫描table，table上的条件只能在连接之后计算
+    step.join_filters.insert(step.join_filters.end(), step.table_filters.begin(), step.table_filters.end());
+    step.table_filters.clear();
+  }
+}
+
+void JoinPlanner::plan(SelectStmt *select_stmt)
+{
+  const std::vector<Table *> &tables = select_stmt->tables();
+
+  // 按照引用的表把条件分开
+  std::vector<std::vector<const FilterUnit *>> table_filters(tables.size());
+  std::vector<const FilterUnit *> constant_filters;
+  std::vector<const FilterUnit *> join_filters;
+  std::vector<std::vector<Table *>> join_filter_tables;
+  for (const FilterUnit *filter_unit : select_stmt->filter_stmt()->filter_units()) {
+    std::vector<Table *> referenced;
+    referenced_tables(filter_unit, tables, referenced);
+    if (referenced.empty()) {
+      constant_filters.push_back(filter_unit);
+    } else if (referenced.size() == 1) {
+      const size_t index = std::find(tables.begin(), tables.end(), referenced[0]) - tables.begin();
+      table_filters[index].push_back(filter_unit);
+    } else {
+      join_filters.push_back(filter_unit);
+      join_filter_tables.push_back(referenced);
+    }
+  }
+
+  std::vector<double> table_rows;
+  size_t first = 0;
+  for (size_t i = 0; i < tables.size(); i++) {
+    table_rows.push_back(estimate_table_rows(tables[i], table_filters[i]));
+    if (table_rows[i] < table_rows[first]) {
+      first = i;
+    }
+  }
+
+  std::vector<JoinStep> steps;
+  std::vector<bool> joined(tables.size(), false);
+  std::vector<bool> filter_used(join_filters.size(), false);
+
+  JoinStep first_step;
+  first_step.table = tables[first];
+  first_step.table_filters = constant_filters;
+  first_step.table_filters.insert(first_step.table_filters.end(),
+                                  table_filters[first].begin(), table_filters[first].end());
+  first_step.rows = table_rows[first];
+  steps.push_back(first_step);
+  joined[first] = true;
+  std::vector<Table *> joined_tables = {tables[first]};
+  double joined_rows = table_rows[first];
+  LOG_INFO("join starts from table %s. estimated rows=%.0f", tables[first]->name(), joined_rows);
+
+  while (steps.size() < tables.size()) {
+    // 贪心地选择下一个表：优先选择有连接条件的，其次是连接之后行数最少的
+    int best = -1;
+    bool best_connected = false;
+    double best_rows = 0;
+    std::vector<const FilterUnit *> best_filters;
+    for (size_t i = 0; i < tables.size(); i++) {
+      if (joined[i]) {
+        continue;
+      }
+
+      std::vector<const FilterUnit *> filters;
+      for (size_t j = 0; j < join_filters.size(); j++) {
+        if (filter_used[j]) {
+          continue;
+        }
+        bool applicable = true;
+        for (const Table *table : join_filter_tables[j]) {
+          applicable = applicable && (table == tables[i] || contains(joined_tables, table));
+        }
+        if (applicable) {
+          filters.push_back(join_filters[j]);
+        }
+      }
+
+      const bool connected = !filters.empty();
+      const double rows = estimate_join_rows(joined_rows, table_rows[i], filters, joined_tables, tables[i]);
+      if (best < 0 || (connected && !best_connected) || (connected == best_connected && rows < best_rows)) {
+        best = i;
+        best_connected = connected;
+        best_rows = rows;
+        best_filters = filters;
+      }
+    }
+
+    JoinStep step;
+    step.table = tables[best];
+    step.table_filters = table_filters[best];
+    step.join_filters = best_filters;
+    step.rows = best_rows;
+    choose_join_method(step, joined_tables, joined_rows, table_rows[best], !steps[0].table_filters.empty());
+    for (size_t j = 0; j < join_filters.size(); j++) {
+      if (std::find(best_filters.begin(), best_filters.end(), join_filters[j]) != best_filters.end()) {
+        filter_used[j] = true;
+      }
+    }
+
+    LOG_INFO("join table %s with %s. table rows=%.0f, joined rows=%.0f, estimated rows=%.0f",
+             step.table->name(), method_name(step.method), table_rows[best], joined_rows, best_rows);
+    steps.push_back(step);
+    joined[best] = true;
+    joined_tables.push_back(tables[best]);
+    joined_rows = best_rows;
+  }
+
+  select_stmt->set_join_steps(steps);
+}
@@ -0,0 +1,32 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/stmt/select_stmt.h"
+
+/**
+ * 为多表查询生成左深的连接计划，结果保存在SelectStmt的join_steps中
+ */
+class JoinPlanner
+{
+public:
+  /**
+   * - 只涉及一个表的条件下推到这个表的扫描上，其它条件放在所有涉及的表都连接之后的那一步
+   * - 从过滤之后估算行数最少的表开始，每次贪心地选择与已连接的表有连接条件、连接结果最小的表
+   * - 没有等值条件时使用嵌套循环连接
+   * - 已经连接的数据比较少、新的表在连接字段上有索引时，用索引嵌套循环连接
+   * - 前两个表在连接字段上都有B+树索引时，按照索引顺序读取两边的数据做排序归并连接
+   * - 其它情况使用哈希连接，较小的一侧用来建立哈希表
+   */
+  static void plan(SelectStmt *select_stmt);
+
+  static const char *method_name(JoinMethod method);
+};
@@ -22,6 +22,10 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/seda/timer_stage.h"
+#include "event/sql_event.h"
+#include "sql/stmt/stmt.h"
+#include "sql/stmt/select_stmt.h"
+#include "sql/optimizer/join_planner.h"
 
 using namespace common;
 
@@ -83,7 +87,15 @@ void OptimizeStage::handle_event(StageEvent *event)
 {
   LOG_TRACE("Enter\n");
 
-  // optimize sql plan, here just pass the event to the next stage
+  SQLStageEvent *sql_event = static_cast<SQLStageEvent *>(event);
+  Stmt *stmt = sql_event->stmt();
+  if (stmt != nullptr && stmt->type() == StmtType::SELECT) {
+    SelectStmt *select_stmt = static_cast<SelectStmt *>(stmt);
+    if (select_stmt->tables().size() > 1) {
+      JoinPlanner::plan(select_stmt);
+    }
+  }
+
   execute_stage_->handle_event(event);
 
   LOG_TRACE("Exit\n");
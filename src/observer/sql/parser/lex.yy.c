@@ -349,8 +349,8 @@ static void yy_fatal_error (yyconst char msg[] ,yyscan_t yyscanner );
 	*yy_cp = '\0'; \
 	yyg->yy_c_buf_p = yy_cp;
 
-#define YY_NUM_RULES 60
-#define YY_END_OF_BUFFER 61
+#define YY_NUM_RULES 61
+#define YY_END_OF_BUFFER 62
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info
@@ -358,13 +358,13 @@ struct yy_trans_info
 	flex_int32_t yy_verify;
 	flex_int32_t yy_nxt;
 	};
-static yyconst flex_int16_t yy_accept[171] =
+static yyconst flex_int16_t yy_accept[172] =
     {   0,
-        0,    0,    0,    0,   61,   59,    1,    2,   59,   49,
+        0,    0,    0,    0,   62,   60,    1,    2,   60,   49,
        50,    7,   47,   51,   46,    6,   48,    3,    5,   55,
        52,   57,   45,   45,   45,   45,   45,   45,   45,   45,
        45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
-       45,   60,    0,   58,    3,    0,   53,   54,   56,   45,
+       45,   61,    0,   59,    3,    0,   53,   54,   56,   45,
        45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
        45,   45,   45,   45,   45,   45,   45,   45,   45,   16,
        45,   45,   45,   45,   45,   45,   45,   45,    4,   22,
@@ -377,7 +377,8 @@ static yyconst flex_int16_t yy_accept[171] =
        24,   39,   36,   45,   45,   17,   18,   45,   45,   45,
        45,   29,   45,   41,   45,   45,   34,   15,   45,   40,
        45,   45,   45,   13,   45,   45,   21,   30,   11,   26,
-       38,   23,   45,   19,   14,   27,   25,   45,   31,    0
+       38,   23,   45,   19,   14,   27,   25,   45,   31,   58,
+        0
     } ;
 
 static yyconst flex_int32_t yy_ec[256] =
@@ -388,7 +389,7 @@ static yyconst flex_int32_t yy_ec[256] =
         1,    4,    1,    5,    1,    1,    1,    1,    5,    6,
         7,    8,    9,   10,   11,   12,   13,   14,   14,   14,
        14,   14,   14,   14,   14,   14,   14,    1,   15,   16,
-       17,   18,    1,    1,   19,   20,   21,   22,   23,   24,
+       17,   18,   44,    1,   19,   20,   21,   22,   23,   24,
        25,   26,   27,   28,   29,   30,   31,   32,   33,   34,
        35,   36,   37,   38,   39,   40,   41,   42,   43,   35,
         1,    1,    1,    1,   35,    1,   19,   20,   21,   22,
@@ -412,147 +413,143 @@ static yyconst flex_int32_t yy_ec[256] =
         1,    1,    1,    1,    1
     } ;
 
-static yyconst flex_int32_t yy_meta[44] =
+static yyconst flex_int32_t yy_meta[45] =
     {   0,
         1,    1,    1,    2,    2,    1,    1,    1,    1,    1,
         2,    2,    2,    3,    1,    1,    1,    1,    3,    3,
         3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
         3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
-        3,    3,    3
+        3,    3,    3,    1
     } ;
 
-static yyconst flex_int16_t yy_base[175] =
+static yyconst flex_int16_t yy_base[172] =
     {   0,
-        0,    0,    0,    0,  318,  319,  319,  319,  312,  319,
-      319,  319,  319,  319,  302,  319,  319,   32,  319,   30,
-      319,  298,   31,   35,   36,   37,   38,   40,  300,   41,
-       43,   45,   51,   47,   53,   54,   63,   69,   65,   76,
-       67,  319,  308,  307,   80,  297,  319,  319,  319,    0,
-      296,   82,   77,   83,   84,   86,   87,   91,   93,   95,
-       97,   98,   99,  104,  113,  106,  100,  101,  107,  295,
-      108,  122,  126,  112,  127,  132,  128,  134,  294,  293,
-      292,  135,  139,  141,  142,  147,  150,  153,  149,  151,
-      154,  163,  157,  164,  166,  167,  170,  172,  169,  165,
-
-      177,  291,  290,  173,  182,  289,  176,  186,  190,  187,
-      194,  195,  196,  288,  197,  198,  199,  287,  286,  200,
-      285,  284,  283,  201,  282,  281,  202,  204,  205,  207,
-      280,  279,  278,  209,  211,  277,  276,  212,  208,  226,
-      228,  275,  216,  268,  233,  234,  267,  266,  236,  265,
-      231,  239,  238,  241,  247,  246,  261,  260,  259,  258,
-      254,  253,  250,  252,  251,  249,  213,  248,  102,  319,
-      283,  285,   79,   50
+        1,    1,   45,    1,    1,   90,    1,    1,   87,    1,
+        1,    1,    1,    1,   79,    1,    1,   82,    1,   78,
+        1,   80,  117,  138,  139,  144,  141,  143,   79,   80,
+       72,   72,   99,  149,  101,  101,  148,  116,  135,  158,
+      155,    1,    1,    1,    1,  168,    1,    1,    1,  173,
+        1,  162,  160,  161,  168,  186,  165,  151,  189,  157,
+      191,  187,  188,  192,  205,  196,  205,  186,  198,    1,
+      201,  202,  200,  202,  215,  214,  208,  216,    1,    1,
+        1,  214,  208,  214,  214,  228,  229,  226,  229,  217,
+      215,  235,  224,  222,  234,  231,  236,  237,  228,  230,
+
+      241,    1,    1,  234,  242,    1,  225,  246,  238,  250,
+      231,  235,  240,    1,  246,  236,  237,    1,    1,  238,
+        1,    1,    1,  239,    1,    1,  236,  249,  244,  245,
+        1,    1,    1,  262,  262,    1,    1,  261,  247,  263,
+      264,    1,  250,    1,  266,  267,    1,    1,  268,    1,
+      254,  274,  256,  258,  273,  260,    1,    1,    1,    1,
+        1,    1,  277,    1,    1,    1,    1,  270,    1,    1,
+      300
     } ;
 
-static yyconst flex_int16_t yy_def[175] =
+static yyconst flex_int16_t yy_def[172] =
     {   0,
-      170,    1,  171,  171,  170,  170,  170,  170,  172,  170,
-      170,  170,  170,  170,  170,  170,  170,  170,  170,  170,
-      170,  170,  173,  173,  173,  173,  173,  173,  173,  173,
-      173,  173,  173,  173,  173,  173,  173,  173,  173,  173,
-      173,  170,  172,  172,  170,  170,  170,  170,  170,  174,
-      173,  173,  173,  173,  173,  173,  173,  173,  173,  173,
-      173,  173,  173,  173,  173,  173,  173,  173,  173,  173,
-      173,  173,  173,  173,  173,  173,  173,  173,  170,  173,
-      173,  173,  173,  173,  173,  173,  173,  173,  173,  173,
-      173,  173,  173,  173,  173,  173,  173,  173,  173,  173,
-
-      173,  173,  173,  173,  173,  173,  173,  173,  173,  173,
-      173,  173,  173,  173,  173,  173,  173,  173,  173,  173,
-      173,  173,  173,  173,  173,  173,  173,  173,  173,  173,
-      173,  173,  173,  173,  173,  173,  173,  173,  173,  173,
-      173,  173,  173,  173,  173,  173,  173,  173,  173,  173,
-      173,  173,  173,  173,  173,  173,  173,  173,  173,  173,
-      173,  173,  173,  173,  173,  173,  173,  173,  173,    0,
-      170,  170,  170,  170
+      171,    1,    1,    3,  171,  171,    6,    6,    6,    6,
+        6,    6,    6,    6,    6,    6,    6,   15,    6,    6,
+        6,    6,    6,   23,   24,   24,   24,   24,   24,   24,
+       29,   29,   29,   29,   29,   29,   24,   29,   29,   29,
+       29,    6,    9,    9,   18,    6,    6,    6,    6,   23,
+       29,   29,   29,   29,   29,   29,   24,   29,   29,   29,
+       29,   29,   29,   29,   29,   29,   29,   27,   29,   29,
+       29,   29,   29,   29,   29,   29,   29,   24,   46,   29,
+       29,   29,   29,   29,   29,   29,   24,   24,   29,   29,
+       29,   29,   29,   29,   24,   29,   24,   24,   29,   29,
+
+       29,   29,   29,   29,   24,   29,   29,   29,   29,   29,
+       29,   29,   29,   29,   29,   29,   29,   29,   29,   29,
+       29,   29,   29,   29,   29,   29,   27,   29,   29,   29,
+       29,   29,   29,   29,   29,   29,   29,   24,   29,   24,
+       24,   29,   29,   29,   24,   24,   29,   29,   24,   29,
+       29,   29,   29,   29,   24,   29,   29,   29,   29,   29,
+       29,   29,   29,   29,   29,   29,   29,   29,   29,    6,
+        0
     } ;
 
-static yyconst flex_int16_t yy_nxt[363] =
+static yyconst flex_int16_t yy_nxt[345] =
     {   0,
-        6,    7,    8,    7,    9,   10,   11,   12,   13,   14,
-       15,   16,   17,   18,   19,   20,   21,   22,   23,   24,
-       25,   26,   27,   28,   29,   30,   31,   32,   29,   33,
-       34,   29,   35,   29,   29,   36,   37,   38,   39,   40,
-       41,   29,   29,   46,   50,   45,   47,   48,   50,   50,
-       50,   50,   50,   50,   50,   58,   50,   54,   50,   59,
-       50,   55,   52,   64,   50,   68,   50,   50,   56,   62,
-       53,   57,   60,   69,   65,   63,   50,   66,   50,   61,
-       50,   51,   50,   67,   70,   72,   71,   75,   73,   50,
-       50,   46,   78,   45,   77,   50,   50,   50,   76,   50,
-
-       50,   81,   83,   80,   50,   74,   50,   82,   50,   86,
-       50,   50,   50,   50,   50,   50,   84,   50,  101,   50,
-       50,   50,   88,   91,   85,   50,   50,   90,   87,   89,
-       92,   93,  100,   94,   95,   50,   96,  104,  103,   50,
-       50,   50,  102,  108,   97,   50,  109,   50,   50,   98,
-       99,  105,   50,  110,   50,   50,  112,  111,  107,  106,
-       50,  113,   50,   50,   50,  117,   50,   50,  118,  121,
-       50,  115,  119,  116,  114,  120,   50,   50,   50,   50,
-       50,  124,   50,   50,  122,   50,   50,  125,  127,   50,
-       50,  123,  129,  128,  130,   50,  132,  126,  133,   50,
-
-       50,  131,  134,   50,  135,  139,  137,   50,   50,   50,
-       50,   50,   50,   50,   50,   50,  136,   50,   50,  138,
-       50,   50,   50,  143,   50,   50,   50,  142,  152,   50,
-      141,  153,  140,  149,  154,  144,  145,  146,  147,   50,
-      150,   50,  151,  148,   50,  155,   50,   50,  156,   50,
-      157,   50,   50,  158,   50,  159,  160,  163,  161,   50,
-       50,   50,   50,   50,   50,   50,   50,   50,  162,  166,
-      168,   50,   50,   50,   50,  164,  169,  165,   50,   50,
-       50,   50,  167,   42,   42,   42,   43,   43,   50,   50,
-       50,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+        5,    6,    7,    8,    7,    9,   10,   11,   12,   13,
+       14,   15,   16,   17,   18,   19,   20,   21,   22,   23,
+       24,   25,   26,   27,   28,   29,   30,   31,   32,   29,
+       33,   34,   29,   35,   29,   29,   36,   37,   38,   39,
+       40,   41,   29,   29,  170,   42,   42,   42,   42,   42,
+       42,   42,   42,   42,   42,   42,   42,   42,   42,   42,
+       42,   42,   42,   42,   42,   42,   42,   42,   42,   42,
+       42,   42,   42,   42,   42,   42,   42,   42,   42,   42,
+       42,   42,   42,   42,   42,   42,   42,   42,   42,    5,
+       43,   44,   45,   46,   47,   48,   49,   43,   43,   43,
+
+       43,   51,   64,   65,   66,   43,   43,   43,   43,   43,
+       43,   43,   43,   43,   43,   43,   43,   43,   43,   43,
+       43,   43,   43,   43,   43,   43,   43,   43,   43,   43,
+       50,   67,   70,   71,   75,   51,   51,   51,   51,   51,
+       51,   51,   51,   51,   51,   51,   51,   51,   52,   51,
+       51,   51,   51,   51,   51,   51,   53,   51,   51,   51,
+       54,   51,   58,   51,   55,   51,   59,   68,   76,   51,
+       72,   56,   62,   73,   57,   69,   77,   51,   63,   60,
+       78,   79,   61,   80,   81,   82,   83,   86,   87,   90,
+       74,   50,   50,   50,   50,   50,   50,   50,   50,   50,
 
-       50,   50,   50,   50,   50,   50,   50,   79,   50,   50,
-       79,   44,   44,   50,   49,   45,   44,  170,    5,  170,
-      170,  170,  170,  170,  170,  170,  170,  170,  170,  170,
-      170,  170,  170,  170,  170,  170,  170,  170,  170,  170,
-      170,  170,  170,  170,  170,  170,  170,  170,  170,  170,
-      170,  170,  170,  170,  170,  170,  170,  170,  170,  170,
-      170,  170
+       50,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+       50,   50,   50,   50,   50,   50,   84,   91,   88,   92,
+       93,   94,  100,  101,   85,   89,   95,  102,   96,  103,
+      104,  105,  107,  108,  109,  110,   97,  111,  112,  106,
+      113,   98,   99,  114,  115,  116,  117,  118,  120,  121,
+      122,  119,  123,  124,  125,  126,  127,  128,  129,  130,
+      131,  132,  133,  134,  135,  136,  137,  138,  139,  140,
+      141,  142,  143,  144,  145,  146,  147,  148,  149,  150,
+      151,  152,  153,  154,  155,  156,  157,  158,  159,  160,
+      161,  162,  163,  164,  165,  166,  167,  168,  169,  171,
+
+      171,  171,  171,  171,  171,  171,  171,  171,  171,  171,
+      171,  171,  171,  171,  171,  171,  171,  171,  171,  171,
+      171,  171,  171,  171,  171,  171,  171,  171,  171,  171,
+      171,  171,  171,  171,  171,  171,  171,  171,  171,  171,
+      171,  171,  171,  171
     } ;
 
-static yyconst flex_int16_t yy_chk[363] =
+static yyconst flex_int16_t yy_chk[345] =
     {   0,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,   18,   23,   18,   20,   20,   24,   25,
-       26,   27,  174,   28,   30,   26,   31,   24,   32,   26,
-       34,   25,   23,   30,   33,   34,   35,   36,   25,   28,
-       23,   25,   26,   34,   31,   28,   37,   32,   39,   27,
-       41,  173,   38,   33,   35,   37,   36,   38,   37,   40,
-       53,   45,   41,   45,   40,   52,   54,   55,   39,   56,
-
-       57,   53,   55,   52,   58,   37,   59,   54,   60,   57,
-       61,   62,   63,   67,   68,  169,   56,   64,   67,   66,
-       69,   71,   59,   61,   56,   74,   65,   60,   58,   59,
-       62,   63,   66,   64,   65,   72,   65,   71,   69,   73,
-       75,   77,   68,   74,   65,   76,   75,   78,   82,   65,
-       65,   72,   83,   76,   84,   85,   78,   77,   73,   72,
-       86,   82,   89,   87,   90,   86,   88,   91,   87,   89,
-       93,   84,   87,   85,   83,   88,   92,   94,  100,   95,
-       96,   92,   99,   97,   90,   98,  104,   93,   95,  107,
-      101,   91,   97,   96,   98,  105,  100,   94,  101,  108,
-
-      110,   99,  104,  109,  105,  110,  108,  111,  112,  113,
-      115,  116,  117,  120,  124,  127,  107,  128,  129,  109,
-      130,  139,  134,  115,  135,  138,  167,  113,  134,  143,
-      112,  135,  111,  128,  138,  116,  117,  120,  124,  140,
-      129,  141,  130,  127,  151,  139,  145,  146,  140,  149,
-      141,  153,  152,  143,  154,  145,  146,  152,  149,  156,
-      155,  168,  166,  163,  165,  164,  162,  161,  151,  155,
-      163,  160,  159,  158,  157,  153,  168,  154,  150,  148,
-      147,  144,  156,  171,  171,  171,  172,  172,  142,  137,
-      136,  133,  132,  131,  126,  125,  123,  122,  121,  119,
-
-      118,  114,  106,  103,  102,   81,   80,   79,   70,   51,
-       46,   44,   43,   29,   22,   15,    9,    5,  170,  170,
-      170,  170,  170,  170,  170,  170,  170,  170,  170,  170,
-      170,  170,  170,  170,  170,  170,  170,  170,  170,  170,
-      170,  170,  170,  170,  170,  170,  170,  170,  170,  170,
-      170,  170,  170,  170,  170,  170,  170,  170,  170,  170,
-      170,  170
+        1,    1,    1,    1,    1,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    6,
+        9,    9,   15,   18,   20,   20,   22,    9,    9,    9,
+
+        9,   29,   30,   31,   32,    9,    9,    9,    9,    9,
+        9,    9,    9,    9,    9,    9,    9,    9,    9,    9,
+        9,    9,    9,    9,    9,    9,    9,    9,    9,    9,
+       23,   33,   35,   36,   38,   23,   23,   23,   23,   23,
+       23,   23,   23,   23,   23,   23,   23,   23,   23,   23,
+       23,   23,   23,   23,   23,   23,   23,   23,   23,   23,
+       24,   25,   26,   27,   25,   28,   26,   34,   39,   24,
+       37,   25,   28,   37,   25,   34,   40,   24,   28,   26,
+       41,   46,   27,   52,   53,   54,   55,   57,   58,   60,
+       37,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+
+       50,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+       50,   50,   50,   50,   50,   50,   56,   61,   59,   62,
+       63,   64,   66,   67,   56,   59,   65,   68,   65,   69,
+       71,   72,   73,   74,   75,   76,   65,   77,   78,   72,
+       82,   65,   65,   83,   84,   85,   86,   87,   88,   89,
+       90,   87,   91,   92,   93,   94,   95,   96,   97,   98,
+       99,  100,  101,  104,  105,  107,  108,  109,  110,  111,
+      112,  113,  115,  116,  117,  120,  124,  127,  128,  129,
+      130,  134,  135,  138,  139,  140,  141,  143,  145,  146,
+      149,  151,  152,  153,  154,  155,  156,  163,  168,  171,
+
+      171,  171,  171,  171,  171,  171,  171,  171,  171,  171,
+      171,  171,  171,  171,  171,  171,  171,  171,  171,  171,
+      171,  171,  171,  171,  171,  171,  171,  171,  171,  171,
+      171,  171,  171,  171,  171,  171,  171,  171,  171,  171,
+      171,  171,  171,  171
     } ;
 
 /* The intent behind this definition is that it'll catch
@@ -565,6 +562,7 @@ static yyconst flex_int16_t yy_chk[363] =
 #line 1 "lex_sql.l"
 #line 2 "lex_sql.l"
 #include<string.h>
+#include<strings.h>
 #include<stdio.h>
 
 struct ParserContext;
@@ -580,9 +578,45 @@ extern double atof();
 #endif // YYDEBUG
 
 #define RETURN_TOKEN(token) debug_printf("%s\n",#token);return token
+
+/* 关键字表，ID规则匹配后先查表，查不到的才是普通标识符 */
+static const struct {
+  const char *name;
+  int token;
+} keyword_tokens[] = {
+  {"UNIQUE", UNIQUE},
+  {"INCLUDE", INCLUDE},
+  {"USING", USING},
+  {"HASH", HASH},
+  {"ORDER", ORDER},
+  {"BY", BY},
+  {"ASC", ASC},
+  {"ANALYZE", ANALYZE},
+  {"GROUP", GROUP},
+  {"SUM", SUM_T},
+  {"LIMIT", LIMIT},
+  {"OFFSET", OFFSET},
+  {"IN", IN},
+  {"NOT", NOT},
+  {"EXISTS", EXISTS},
+  {"PREPARE", PREPARE},
+  {"EXECUTE", EXECUTE},
+  {"DEALLOCATE", DEALLOCATE},
+  {"AS", AS},
+};
+
+static int keyword_token(const char *text)
+{
+  for (size_t i = 0; i < sizeof(keyword_tokens) / sizeof(keyword_tokens[0]); i++) {
+    if (strcasecmp(text, keyword_tokens[i].name) == 0) {
+      return keyword_tokens[i].token;
+    }
+  }
+  return ID;
+}
 /* Prevent the need for linking with -lfl */
 
-#line 586 "lex.yy.c"
+#line 620 "lex.yy.c"
 
 #define INITIAL 0
 #define STR 1
@@ -816,10 +850,10 @@ YY_DECL
 	register int yy_act;
     struct yyguts_t * yyg = (struct yyguts_t*)yyscanner;
 
-#line 33 "lex_sql.l"
+#line 70 "lex_sql.l"
 
 
-#line 823 "lex.yy.c"
+#line 857 "lex.yy.c"
 
     yylval = yylval_param;
 
@@ -874,13 +908,13 @@ yy_match:
 			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 				{
 				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 171 )
+				if ( yy_current_state >= 172 )
 					yy_c = yy_meta[(unsigned int) yy_c];
 				}
 			yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
 			++yy_cp;
 			}
-		while ( yy_base[yy_current_state] != 319 );
+		while ( yy_base[yy_current_state] != 300 );
 
 yy_find_action:
 		yy_act = yy_accept[yy_current_state];
@@ -906,306 +940,311 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 35 "lex_sql.l"
+#line 72 "lex_sql.l"
 // ignore whitespace
 	YY_BREAK
 case 2:
 /* rule 2 can match eol */
 YY_RULE_SETUP
-#line 36 "lex_sql.l"
+#line 73 "lex_sql.l"
 ;
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 38 "lex_sql.l"
+#line 75 "lex_sql.l"
 yylval->number=atoi(yytext); RETURN_TOKEN(NUMBER);
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 39 "lex_sql.l"
+#line 76 "lex_sql.l"
 yylval->floats=(float)(atof(yytext)); RETURN_TOKEN(FLOAT);
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 41 "lex_sql.l"
+#line 78 "lex_sql.l"
 RETURN_TOKEN(SEMICOLON);
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 42 "lex_sql.l"
+#line 79 "lex_sql.l"
 RETURN_TOKEN(DOT);
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 43 "lex_sql.l"
+#line 80 "lex_sql.l"
 RETURN_TOKEN(STAR);
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 44 "lex_sql.l"
+#line 81 "lex_sql.l"
 RETURN_TOKEN(EXIT);
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 45 "lex_sql.l"
+#line 82 "lex_sql.l"
 RETURN_TOKEN(HELP);
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 46 "lex_sql.l"
+#line 83 "lex_sql.l"
 RETURN_TOKEN(DESC);
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 47 "lex_sql.l"
+#line 84 "lex_sql.l"
 RETURN_TOKEN(CREATE);
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 48 "lex_sql.l"
+#line 85 "lex_sql.l"
 RETURN_TOKEN(DROP);
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 49 "lex_sql.l"
+#line 86 "lex_sql.l"
 RETURN_TOKEN(TABLE);
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 50 "lex_sql.l"
+#line 87 "lex_sql.l"
 RETURN_TOKEN(TABLES);
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 51 "lex_sql.l"
+#line 88 "lex_sql.l"
 RETURN_TOKEN(INDEX);
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 52 "lex_sql.l"
+#line 89 "lex_sql.l"
 RETURN_TOKEN(ON);
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 53 "lex_sql.l"
+#line 90 "lex_sql.l"
 RETURN_TOKEN(SHOW);
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 54 "lex_sql.l"
+#line 91 "lex_sql.l"
 RETURN_TOKEN(SYNC);
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 55 "lex_sql.l"
+#line 92 "lex_sql.l"
 RETURN_TOKEN(SELECT);
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 56 "lex_sql.l"
+#line 93 "lex_sql.l"
 RETURN_TOKEN(FROM);
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 57 "lex_sql.l"
+#line 94 "lex_sql.l"
 RETURN_TOKEN(WHERE);
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 58 "lex_sql.l"
+#line 95 "lex_sql.l"
 RETURN_TOKEN(AND);
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 59 "lex_sql.l"
+#line 96 "lex_sql.l"
 RETURN_TOKEN(INSERT);
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 60 "lex_sql.l"
+#line 97 "lex_sql.l"
 RETURN_TOKEN(INTO);
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 61 "lex_sql.l"
+#line 98 "lex_sql.l"
 RETURN_TOKEN(VALUES);
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 62 "lex_sql.l"
+#line 99 "lex_sql.l"
 RETURN_TOKEN(DELETE);
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
-#line 63 "lex_sql.l"
+#line 100 "lex_sql.l"
 RETURN_TOKEN(UPDATE);
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
-#line 64 "lex_sql.l"
+#line 101 "lex_sql.l"
 RETURN_TOKEN(SET);
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 65 "lex_sql.l"
+#line 102 "lex_sql.l"
 RETURN_TOKEN(TRX_BEGIN);
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 66 "lex_sql.l"
+#line 103 "lex_sql.l"
 RETURN_TOKEN(TRX_COMMIT);
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
-#line 67 "lex_sql.l"
+#line 104 "lex_sql.l"
 RETURN_TOKEN(TRX_ROLLBACK);
 	YY_BREAK
 case 32:
 YY_RULE_SETUP
-#line 68 "lex_sql.l"
+#line 105 "lex_sql.l"
 RETURN_TOKEN(INT_T);
 	YY_BREAK
 case 33:
 YY_RULE_SETUP
-#line 69 "lex_sql.l"
+#line 106 "lex_sql.l"
 RETURN_TOKEN(STRING_T);
 	YY_BREAK
 case 34:
 YY_RULE_SETUP
-#line 70 "lex_sql.l"
+#line 107 "lex_sql.l"
 RETURN_TOKEN(FLOAT_T);
 	YY_BREAK
 case 35:
 YY_RULE_SETUP
-#line 71 "lex_sql.l"
+#line 108 "lex_sql.l"
 RETURN_TOKEN(DATE_T);
 	YY_BREAK
 case 36:
 YY_RULE_SETUP
-#line 72 "lex_sql.l"
+#line 109 "lex_sql.l"
 RETURN_TOKEN(LOAD);
 	YY_BREAK
 case 37:
 YY_RULE_SETUP
-#line 73 "lex_sql.l"
+#line 110 "lex_sql.l"
 RETURN_TOKEN(DATA);
 	YY_BREAK
 case 38:
 YY_RULE_SETUP
-#line 74 "lex_sql.l"
+#line 111 "lex_sql.l"
 RETURN_TOKEN(INFILE);
 	YY_BREAK
 case 39:
 YY_RULE_SETUP
-#line 75 "lex_sql.l"
+#line 112 "lex_sql.l"
 RETURN_TOKEN(JOIN);
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
-#line 76 "lex_sql.l"
+#line 113 "lex_sql.l"
 RETURN_TOKEN(INNER);
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
-#line 77 "lex_sql.l"
+#line 114 "lex_sql.l"
 RETURN_TOKEN(COUNT_T);
 	YY_BREAK
 case 42:
 YY_RULE_SETUP
-#line 78 "lex_sql.l"
+#line 115 "lex_sql.l"
 RETURN_TOKEN(MAX_T);
 	YY_BREAK
 case 43:
 YY_RULE_SETUP
-#line 79 "lex_sql.l"
+#line 116 "lex_sql.l"
 RETURN_TOKEN(MIN_T);
 	YY_BREAK
 case 44:
 YY_RULE_SETUP
-#line 80 "lex_sql.l"
+#line 117 "lex_sql.l"
 RETURN_TOKEN(AVG_T);
 	YY_BREAK
 case 45:
 YY_RULE_SETUP
-#line 81 "lex_sql.l"
-yylval->string=strdup(yytext); RETURN_TOKEN(ID);
+#line 118 "lex_sql.l"
+{ int token = keyword_token(yytext); if (token == ID) { yylval->string=strdup(yytext); } RETURN_TOKEN(token); }
 	YY_BREAK
 case 46:
 YY_RULE_SETUP
-#line 82 "lex_sql.l"
+#line 119 "lex_sql.l"
 RETURN_TOKEN(MINUS);
 	YY_BREAK
 case 47:
 YY_RULE_SETUP
-#line 83 "lex_sql.l"
+#line 120 "lex_sql.l"
 RETURN_TOKEN(PLUS);
 	YY_BREAK
 case 48:
 YY_RULE_SETUP
-#line 84 "lex_sql.l"
+#line 121 "lex_sql.l"
 RETURN_TOKEN(DIVIDE);
 	YY_BREAK
 case 49:
 YY_RULE_SETUP
-#line 85 "lex_sql.l"
+#line 122 "lex_sql.l"
 RETURN_TOKEN(LBRACE);
 	YY_BREAK
 case 50:
 YY_RULE_SETUP
-#line 86 "lex_sql.l"
+#line 123 "lex_sql.l"
 RETURN_TOKEN(RBRACE);
 	YY_BREAK
 case 51:
 YY_RULE_SETUP
-#line 88 "lex_sql.l"
+#line 125 "lex_sql.l"
 RETURN_TOKEN(COMMA);
 	YY_BREAK
 case 52:
 YY_RULE_SETUP
-#line 89 "lex_sql.l"
+#line 126 "lex_sql.l"
 RETURN_TOKEN(EQ);
 	YY_BREAK
 case 53:
 YY_RULE_SETUP
-#line 90 "lex_sql.l"
+#line 127 "lex_sql.l"
 RETURN_TOKEN(LE);
 	YY_BREAK
 case 54:
 YY_RULE_SETUP
-#line 91 "lex_sql.l"
+#line 128 "lex_sql.l"
 RETURN_TOKEN(NE);
 	YY_BREAK
 case 55:
 YY_RULE_SETUP
-#line 92 "lex_sql.l"
+#line 129 "lex_sql.l"
 RETURN_TOKEN(LT);
 	YY_BREAK
 case 56:
 YY_RULE_SETUP
-#line 93 "lex_sql.l"
+#line 130 "lex_sql.l"
 RETURN_TOKEN(GE);
 	YY_BREAK
 case 57:
 YY_RULE_SETUP
-#line 94 "lex_sql.l"
+#line 131 "lex_sql.l"
 RETURN_TOKEN(GT);
 	YY_BREAK
 case 58:
 YY_RULE_SETUP
-#line 95 "lex_sql.l"
-yylval->string=strdup(yytext); RETURN_TOKEN(SSS);
+#line 132 "lex_sql.l"
+RETURN_TOKEN(PARAM);
 	YY_BREAK
 case 59:
 YY_RULE_SETUP
-#line 97 "lex_sql.l"
-printf("Unknown character [%c]\n",yytext[0]); return yytext[0];
+#line 133 "lex_sql.l"
+yylval->string=strdup(yytext); RETURN_TOKEN(SSS);
 	YY_BREAK
 case 60:
 YY_RULE_SETUP
-#line 98 "lex_sql.l"
+#line 135 "lex_sql.l"
+printf("Unknown character [%c]\n",yytext[0]); return yytext[0];
+	YY_BREAK
+case 61:
+YY_RULE_SETUP
+#line 136 "lex_sql.l"
 ECHO;
 	YY_BREAK
-#line 1209 "lex.yy.c"
+#line 1248 "lex.yy.c"
 case YY_STATE_EOF(INITIAL):
 case YY_STATE_EOF(STR):
 	yyterminate();
@@ -1500,7 +1539,7 @@ static int yy_get_next_buffer (yyscan_t yyscanner)
 		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 			{
 			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 171 )
+			if ( yy_current_state >= 172 )
 				yy_c = yy_meta[(unsigned int) yy_c];
 			}
 		yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
@@ -1529,11 +1568,11 @@ static int yy_get_next_buffer (yyscan_t yyscanner)
 	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 		{
 		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 171 )
+		if ( yy_current_state >= 172 )
 			yy_c = yy_meta[(unsigned int) yy_c];
 		}
 	yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
-	yy_is_jam = (yy_current_state == 170);
+	yy_is_jam = (yy_current_state == 171);
 
 	return yy_is_jam ? 0 : yy_current_state;
 }
@@ -2372,7 +2411,7 @@ void yyfree (void * ptr , yyscan_t yyscanner)
 
 #define YYTABLES_NAME "yytables"
 
-#line 98 "lex_sql.l"
+#line 136 "lex_sql.l"
 
 
 
@@ -60,6 +60,12 @@ void value_init_string(Value *value, const char *v)
   value->type = CHARS;
   value->data = strdup(v);
 }
+void value_init_param(Value *value, int index)
+{
+  value->type = UNDEFINED;
+  value->data = malloc(sizeof(index));
+  memcpy(value->data, &index, sizeof(index));
+}
 
 int check_date(const char* date){
     int y,m,d;
@@ -148,6 +154,7 @@ void condition_init(Condition *condition, CompOp comp, ExpressionNode *left_expr
   condition->comp = comp;
   condition->left_expr = *left_expr;
   condition->right_expr = *right_expr;
+  condition->sub_select = nullptr;
 
   if(left_expr->is_attr) {
     condition->left_is_attr = 1;
@@ -160,6 +167,7 @@ void condition_init(Condition *condition, CompOp comp, ExpressionNode *left_expr
     condition->left_value = left_expr->value;
   } else {
     condition->left_is_value = 0;
+    memset(&condition->left_value, 0, sizeof(condition->left_value));
   }
 
   if(right_expr->is_attr) {
@@ -173,6 +181,7 @@ void condition_init(Condition *condition, CompOp comp, ExpressionNode *left_expr
     condition->right_value = right_expr->value;
   } else {
     condition->right_is_value = 0;
+    memset(&condition->right_value, 0, sizeof(condition->right_value));
   }
 
 
@@ -193,8 +202,25 @@ void condition_init(Condition *condition, CompOp comp, ExpressionNode *left_expr
   // }
 }
 
+void condition_init_subquery(Condition *condition, CompOp comp, ExpressionNode *left_expr, Selects *sub_select)
+{
+  memset(condition, 0, sizeof(*condition));
+  condition->comp = comp;
+  if (left_expr != nullptr) {
+    ExpressionNode right_expr;
+    memset(&right_expr, 0, sizeof(right_expr));
+    condition_init(condition, comp, left_expr, &right_expr);
+  }
+  condition->sub_select = sub_select;
+}
+
 void condition_destroy(Condition *condition)
 {
+  if (condition->sub_select != nullptr) {
+    selects_destroy(condition->sub_select);
+    free(condition->sub_select);
+    condition->sub_select = nullptr;
+  }
   if (condition->left_is_attr) {
     relation_attr_destroy(&condition->left_attr);
   } else {
@@ -221,6 +247,7 @@ void attr_info_destroy(AttrInfo *attr_info)
 void aggre_init(Aggregation *aggre, AggreType type, RelAttr * rel_attr){
   aggre->type = type;
   aggre->attr = *rel_attr;
+  aggre->position = 0;
 }
 void selects_init(Selects *selects, ...);
 void selects_append_attribute(Selects *selects, RelAttr *rel_attr)
@@ -242,6 +269,8 @@ void selects_append_conditions(Selects *selects, Condition conditions[], size_t
 }
 
 void selects_append_aggregation(Selects *selects, Aggregation *aggre){
+  // 聚合函数是从左到右归约的，这时前面的列表项都已经计数
+  aggre->position = selects->item_num++;
   selects->aggre[selects->aggre_size++] = *aggre;
 }
 
@@ -256,12 +285,42 @@ void selects_append_attr_expr(Selects *selectes, ExpressionNode *expr) {
   }
 }
 
+void selects_append_group_by(Selects *selects, RelAttr *rel_attr)
+{
+  if (selects->group_by_num >= MAX_NUM) {
+    LOG_WARN("too many group by attributes. max=%d", MAX_NUM);
+    relation_attr_destroy(rel_attr);
+    return;
+  }
+  selects->group_by[selects->group_by_num++] = *rel_attr;
+}
+
+void selects_append_order(Selects *selects, RelAttr *rel_attr, int asc)
+{
+  if (selects->order_num >= MAX_NUM) {
+    LOG_WARN("too many order by attributes. max=%d", MAX_NUM);
+    relation_attr_destroy(rel_attr);
+    return;
+  }
+  OrderBy &order = selects->orders[selects->order_num++];
+  order.attr = *rel_attr;
+  order.asc = asc;
+}
+
+void selects_set_limit(Selects *selects, int limit, int offset)
+{
+  selects->has_limit = 1;
+  selects->limit = limit;
+  selects->offset = offset;
+}
+
 void selects_destroy(Selects *selects)
 {
   for (size_t i = 0; i < selects->attr_num; i++) {
     relation_attr_destroy(&selects->attributes[i]);
   }
   selects->attr_num = 0;
+  selects->item_num = 0;
 
   for (size_t i = 0; i < selects->relation_num; i++) {
     free(selects->relations[i]);
@@ -273,6 +332,17 @@ void selects_destroy(Selects *selects)
     condition_destroy(&selects->conditions[i]);
   }
   selects->condition_num = 0;
+
+  for (size_t i = 0; i < selects->group_by_num; i++) {
+    relation_attr_destroy(&selects->group_by[i]);
+  }
+  selects->group_by_num = 0;
+
+  for (size_t i = 0; i < selects->order_num; i++) {
+    relation_attr_destroy(&selects->orders[i].attr);
+  }
+  selects->order_num = 0;
+  selects->has_limit = 0;
 }
 
 void inserts_init(Inserts *inserts, const char *relation_name, Value values[], size_t value_num)
@@ -379,12 +449,27 @@ void drop_table_destroy(DropTable *drop_table)
   drop_table->relation_name = nullptr;
 }
 
-void create_index_init(
-    CreateIndex *create_index, const char *index_name, const char *relation_name, const char *attr_name)
+void create_index_init(CreateIndex *create_index, const char *index_name, const char *relation_name,
+    const char *attr_name, int unique)
 {
   create_index->index_name = strdup(index_name);
   create_index->relation_name = strdup(relation_name);
   create_index->attribute_name = strdup(attr_name);
+  create_index->unique = unique;
+}
+
+void create_index_append_include(CreateIndex *create_index, const char *attr_name)
+{
+  if (create_index->include_num >= MAX_NUM) {
+    LOG_WARN("too many include attributes. max=%d", MAX_NUM);
+    return;
+  }
+  create_index->include_attributes[create_index->include_num++] = strdup(attr_name);
+}
+
+void create_index_set_type(CreateIndex *create_index, IndexType index_type)
+{
+  create_index->index_type = index_type;
 }
 
 void create_index_destroy(CreateIndex *create_index)
@@ -392,6 +477,12 @@ void create_index_destroy(CreateIndex *create_index)
   free(create_index->index_name);
   free(create_index->relation_name);
   free(create_index->attribute_name);
+  for (size_t i = 0; i < create_index->include_num; i++) {
+    free(create_index->include_attributes[i]);
+    create_index->include_attributes[i] = nullptr;
+  }
+  create_index->include_num = 0;
+  create_index->index_type = BPLUS_TREE_INDEX;
 
   create_index->index_name = nullptr;
   create_index->relation_name = nullptr;
@@ -420,6 +511,17 @@ void desc_table_destroy(DescTable *desc_table)
   desc_table->relation_name = nullptr;
 }
 
+void analyze_table_init(AnalyzeTable *analyze_table, const char *relation_name)
+{
+  analyze_table->relation_name = strdup(relation_name);
+}
+
+void analyze_table_destroy(AnalyzeTable *analyze_table)
+{
+  free((char *)analyze_table->relation_name);
+  analyze_table->relation_name = nullptr;
+}
+
 void load_data_init(LoadData *load_data, const char *relation_name, const char *file_name)
 {
   load_data->relation_name = strdup(relation_name);
@@ -443,10 +545,22 @@ void load_data_destroy(LoadData *load_data)
   load_data->file_name = nullptr;
 }
 
+void prepared_command_destroy(PreparedCommand *command)
+{
+  free(command->name);
+  command->name = nullptr;
+  for (size_t i = 0; i < command->value_num; i++) {
+    value_destroy(&command->values[i]);
+  }
+  command->value_num = 0;
+  command->sql = nullptr;
+}
+
 void query_init(Query *query)
 {
   query->flag = SCF_ERROR;
   memset(&query->sstr, 0, sizeof(query->sstr));
+  query->param_num = 0;
 }
 
 Query *query_create()
@@ -498,6 +612,10 @@ void query_reset(Query *query)
       desc_table_destroy(&query->sstr.desc_table);
     } break;
 
+    case SCF_ANALYZE_TABLE: {
+      analyze_table_destroy(&query->sstr.analyze_table);
+    } break;
+
     case SCF_LOAD_DATA: {
       load_data_destroy(&query->sstr.load_data);
     } break;
@@ -509,6 +627,7 @@ void query_reset(Query *query)
     case SCF_ERROR:
       break;
   }
+  query->param_num = 0;
 }
 
 void query_destroy(Query *query)
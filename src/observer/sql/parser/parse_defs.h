@@ -38,7 +38,11 @@ typedef enum {
   LESS_THAN,    //"<"     3
   GREAT_EQUAL,  //">="    4
   GREAT_THAN,   //">"     5
-  NO_OP
+  NO_OP,
+  IN_OP,          // IN (子查询)
+  NOT_IN_OP,      // NOT IN (子查询)
+  EXISTS_OP,      // EXISTS (子查询)，没有左边的表达式
+  NOT_EXISTS_OP   // NOT EXISTS (子查询)
 } CompOp;
 
 typedef enum {
@@ -64,9 +68,17 @@ typedef enum
   COUNT,
   MAX,
   MIN,
-  AVG
+  AVG,
+  SUM
 } AggreType;
 
+//索引类型
+typedef enum
+{
+  BPLUS_TREE_INDEX,
+  HASH_INDEX
+} IndexType;
+
 //属性值
 typedef struct _Value {
   AttrType type;  // type of value
@@ -86,6 +98,8 @@ typedef struct ExpressionNode{
   Value result; //解释表达式时，计算出的结果
 } ExpressionNode;
 
+struct _Selects;
+
 typedef struct _Condition {
   int left_is_attr;    // TRUE if left-hand side is an attribute
                        // 1时，操作符左边是属性名，0时，是属性值
@@ -102,25 +116,33 @@ typedef struct _Condition {
   ExpressionNode right_expr; //右表达式
   int right_is_expr;
   int left_is_expr;
-  
+  struct _Selects *sub_select; // 不为空时右边是子查询，比较符是IN/EXISTS或者与标量子查询比较
 } Condition;
 
 typedef struct {
   AggreType type;
   RelAttr attr;
+  int position;  // 在select列表中是第几项，分组输出时按照这个顺序
 } Aggregation;
 
+// 聚合函数的中间状态，AVG在输出时才用和除以行数
 typedef struct {
   AggreType type;
-  size_t count;
-  Value sum;
-  Value result;
-  float avg;
+  size_t count;         // 参与聚合的行数
+  int64_t int_sum;      // INTS字段的SUM/AVG
+  double float_sum;     // FLOATS字段的SUM/AVG
+  Value result;         // MIN/MAX的值，SUM/AVG时只有type有意义
   size_t char_length; //the length for STRING type
 } AggreResult;
 
-// struct of select
+// ORDER BY中的一项
 typedef struct {
+  RelAttr attr;
+  int asc;  // 1: ASC, 0: DESC
+} OrderBy;
+
+// struct of select
+typedef struct _Selects {
   size_t attr_num;                // Length of attrs in Select clause
   RelAttr attributes[MAX_NUM];    // attrs in Select clause
   size_t relation_num;            // Length of relations in Fro clause
@@ -131,6 +153,14 @@ typedef struct {
   Aggregation aggre[MAX_NUM];
   ExpressionNode expr[MAX_NUM];
   size_t expr_size;
+  size_t item_num;                // 已经解析的select列表项数
+  size_t group_by_num;            // Length of group by attrs
+  RelAttr group_by[MAX_NUM];      // attrs in Group By clause
+  size_t order_num;               // Length of order by attrs
+  OrderBy orders[MAX_NUM];        // attrs in Order By clause
+  int has_limit;                  // whether there is a Limit clause
+  int limit;                      // max number of rows to return
+  int offset;                     // number of rows to skip
 } Selects;
 
 // struct of insert
@@ -179,6 +209,10 @@ typedef struct {
   char *index_name;      // Index name
   char *relation_name;   // Relation name
   char *attribute_name;  // Attribute name
+  int unique;            // 1 for CREATE UNIQUE INDEX
+  size_t include_num;    // Length of include attributes
+  char *include_attributes[MAX_NUM];  // INCLUDE (...) attributes stored in index leaves
+  IndexType index_type;  // USING HASH
 } CreateIndex;
 
 // struct of  drop_index
@@ -190,6 +224,10 @@ typedef struct {
   const char *relation_name;
 } DescTable;
 
+typedef struct {
+  const char *relation_name;
+} AnalyzeTable;
+
 typedef struct {
   const char *relation_name;
   const char *file_name;
@@ -205,6 +243,7 @@ union Queries {
   CreateIndex create_index;
   DropIndex drop_index;
   DescTable desc_table;
+  AnalyzeTable analyze_table;
   LoadData load_data;
   char *errors;
 };
@@ -228,12 +267,30 @@ enum SqlCommandFlag {
   SCF_ROLLBACK,
   SCF_LOAD_DATA,
   SCF_HELP,
-  SCF_EXIT
+  SCF_EXIT,
+  SCF_ANALYZE_TABLE
 };
+typedef enum {
+  PREPARED_NONE,        // 不是下面几种语句
+  PREPARED_PREPARE,     // PREPARE name AS statement
+  PREPARED_EXECUTE,     // EXECUTE name [(value, ...)]
+  PREPARED_DEALLOCATE   // DEALLOCATE name
+} PreparedCommandType;
+
+// 预处理语句的命令，只经过词法分析
+typedef struct {
+  PreparedCommandType type;
+  char *name;             // 预处理语句的名字
+  const char *sql;        // PREPARE时AS后面的语句，指向原来的SQL
+  size_t value_num;       // EXECUTE时参数的个数
+  Value values[MAX_NUM];  // EXECUTE时参数的值
+} PreparedCommand;
+
 // struct of flag and sql_struct
 typedef struct Query {
   enum SqlCommandFlag flag;
   union Queries sstr;
+  size_t param_num;  // 参数?的个数，参数的值绑定之后才能resolve
 } Query;
 
 #ifdef __cplusplus
@@ -246,6 +303,10 @@ void relation_attr_destroy(RelAttr *relation_attr);
 void value_init_integer(Value *value, int v);
 void value_init_float(Value *value, float v);
 void value_init_string(Value *value, const char *v);
+/**
+ * 参数?，type是UNDEFINED，data中是参数的序号
+ */
+void value_init_param(Value *value, int index);
 int value_init_date(Value *value, const char* v);
 int check_date(const char* date);
 void format_date(const char* v, char *date);
@@ -255,6 +316,10 @@ ExpressionNode *expression_init(ExpressionNode *left, ExpressionNode *right, Rel
 void expr_destroy(ExpressionNode *expr);
 
 void condition_init(Condition *condition, CompOp comp, ExpressionNode *left_expr, ExpressionNode *right_expr);
+/**
+ * 右边是子查询的条件，EXISTS/NOT EXISTS时left_expr为空。子查询的内存由条件负责释放
+ */
+void condition_init_subquery(Condition *condition, CompOp comp, ExpressionNode *left_expr, Selects *sub_select);
 void condition_destroy(Condition *condition);
 
 void aggre_init(Aggregation *aggre, AggreType type, RelAttr * rel_attr);
@@ -268,6 +333,9 @@ void selects_append_relation(Selects *selects, const char *relation_name);
 void selects_append_conditions(Selects *selects, Condition conditions[], size_t condition_num);
 void selects_append_aggregation(Selects *selects, Aggregation *aggre);
 void selects_append_attr_expr(Selects *selectes, ExpressionNode *expr);
+void selects_append_group_by(Selects *selects, RelAttr *rel_attr);
+void selects_append_order(Selects *selects, RelAttr *rel_attr, int asc);
+void selects_set_limit(Selects *selects, int limit, int offset);
 void selects_destroy(Selects *selects);
 
 void inserts_init(Inserts *inserts, const char *relation_name, Value values[], size_t value_num);
@@ -288,8 +356,10 @@ void create_table_destroy(CreateTable *create_table);
 void drop_table_init(DropTable *drop_table, const char *relation_name);
 void drop_table_destroy(DropTable *drop_table);
 
-void create_index_init(
-    CreateIndex *create_index, const char *index_name, const char *relation_name, const char *attr_name);
+void create_index_init(CreateIndex *create_index, const char *index_name, const char *relation_name,
+    const char *attr_name, int unique);
+void create_index_append_include(CreateIndex *create_index, const char *attr_name);
+void create_index_set_type(CreateIndex *create_index, IndexType index_type);
 void create_index_destroy(CreateIndex *create_index);
 
 void drop_index_init(DropIndex *drop_index, const char *index_name);
@@ -298,6 +368,9 @@ void drop_index_destroy(DropIndex *drop_index);
 void desc_table_init(DescTable *desc_table, const char *relation_name);
 void desc_table_destroy(DescTable *desc_table);
 
+void analyze_table_init(AnalyzeTable *analyze_table, const char *relation_name);
+void analyze_table_destroy(AnalyzeTable *analyze_table);
+
 void load_data_init(LoadData *load_data, const char *relation_name, const char *file_name);
 void load_data_destroy(LoadData *load_data);
 
@@ -306,6 +379,16 @@ Query *query_create();  // create and init
 void query_reset(Query *query);
 void query_destroy(Query *query);  // reset and delete
 
+/**
+ * 把SQL中的常量换成参数?，见yacc_sql.y
+ */
+int sql_normalize(const char *s, char **normalized, Value values[], int max_value_num, int *value_num);
+/**
+ * 识别预处理语句的命令，见yacc_sql.y
+ */
+int sql_parse_prepared_command(const char *s, PreparedCommand *command);
+void prepared_command_destroy(PreparedCommand *command);
+
 #ifdef __cplusplus
 }
 #endif  // __cplusplus
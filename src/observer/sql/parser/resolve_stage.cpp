@@ -102,6 +102,12 @@ void ResolveStage::handle_event(StageEvent *event)
   }
 
   Query *query = sql_event->query();
+  if (query->param_num > 0) {
+    LOG_WARN("cannot resolve statement with unbound parameters. param_num=%d", (int)query->param_num);
+    session_event->set_response("FAILURE\n");
+    return;
+  }
+
   Stmt *stmt = nullptr;
   RC rc = Stmt::create_stmt(db, *query, stmt);
   if (rc != RC::SUCCESS && rc != RC::UNIMPLENMENT) {
@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.7.4.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -46,10 +46,10 @@
    USER NAME SPACE" below.  */
 
 /* Identify Bison output, and Bison version.  */
-#define YYBISON 30704
+#define YYBISON 30802
 
 /* Bison version string.  */
-#define YYBISON_VERSION "3.7.4"
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -78,6 +78,7 @@
 #include<stdio.h>
 #include<stdlib.h>
 #include<string.h>
+#include<ctype.h>
 
 typedef struct ParserContext {
   Query * ssql;
@@ -90,6 +91,10 @@ typedef struct ParserContext {
   Condition conditions[MAX_NUM];
   CompOp comp;
 	char id[MAX_NUM];
+  Selects *selects;                      // 当前正在解析的SELECT，子查询中指向子查询
+  int select_depth;
+  Selects *outer_selects[MAX_NUM];       // 外层的SELECT
+  size_t outer_condition_length[MAX_NUM]; // 进入子查询时外层已经解析的条件个数
 } ParserContext;
 
 //获取子串
@@ -125,7 +130,7 @@ ParserContext *get_context(yyscan_t scanner)
 #define CONTEXT get_context(scanner)
 
 
-#line 129 "yacc_sql.tab.c"
+#line 134 "yacc_sql.tab.c"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -198,63 +203,98 @@ enum yysymbol_kind_t
   YYSYMBOL_MIN_T = 42,                     /* MIN_T  */
   YYSYMBOL_MAX_T = 43,                     /* MAX_T  */
   YYSYMBOL_AVG_T = 44,                     /* AVG_T  */
-  YYSYMBOL_EQ = 45,                        /* EQ  */
-  YYSYMBOL_LT = 46,                        /* LT  */
-  YYSYMBOL_GT = 47,                        /* GT  */
-  YYSYMBOL_LE = 48,                        /* LE  */
-  YYSYMBOL_GE = 49,                        /* GE  */
-  YYSYMBOL_NE = 50,                        /* NE  */
-  YYSYMBOL_NUMBER = 51,                    /* NUMBER  */
-  YYSYMBOL_FLOAT = 52,                     /* FLOAT  */
-  YYSYMBOL_ID = 53,                        /* ID  */
-  YYSYMBOL_PATH = 54,                      /* PATH  */
-  YYSYMBOL_SSS = 55,                       /* SSS  */
-  YYSYMBOL_STAR = 56,                      /* STAR  */
-  YYSYMBOL_STRING_V = 57,                  /* STRING_V  */
-  YYSYMBOL_MINUS = 58,                     /* MINUS  */
-  YYSYMBOL_PLUS = 59,                      /* PLUS  */
-  YYSYMBOL_DIVIDE = 60,                    /* DIVIDE  */
-  YYSYMBOL_YYACCEPT = 61,                  /* $accept  */
-  YYSYMBOL_commands = 62,                  /* commands  */
-  YYSYMBOL_command = 63,                   /* command  */
-  YYSYMBOL_exit = 64,                      /* exit  */
-  YYSYMBOL_help = 65,                      /* help  */
-  YYSYMBOL_sync = 66,                      /* sync  */
-  YYSYMBOL_begin = 67,                     /* begin  */
-  YYSYMBOL_commit = 68,                    /* commit  */
-  YYSYMBOL_rollback = 69,                  /* rollback  */
-  YYSYMBOL_drop_table = 70,                /* drop_table  */
-  YYSYMBOL_show_tables = 71,               /* show_tables  */
-  YYSYMBOL_desc_table = 72,                /* desc_table  */
-  YYSYMBOL_create_index = 73,              /* create_index  */
-  YYSYMBOL_drop_index = 74,                /* drop_index  */
-  YYSYMBOL_create_table = 75,              /* create_table  */
-  YYSYMBOL_attr_def_list = 76,             /* attr_def_list  */
-  YYSYMBOL_attr_def = 77,                  /* attr_def  */
-  YYSYMBOL_number = 78,                    /* number  */
-  YYSYMBOL_type = 79,                      /* type  */
-  YYSYMBOL_ID_get = 80,                    /* ID_get  */
-  YYSYMBOL_insert = 81,                    /* insert  */
-  YYSYMBOL_value_list = 82,                /* value_list  */
-  YYSYMBOL_value = 83,                     /* value  */
-  YYSYMBOL_delete = 84,                    /* delete  */
-  YYSYMBOL_update = 85,                    /* update  */
-  YYSYMBOL_select = 86,                    /* select  */
-  YYSYMBOL_select_aggregation_func = 87,   /* select_aggregation_func  */
-  YYSYMBOL_aggregation_func_list = 88,     /* aggregation_func_list  */
-  YYSYMBOL_aggregation_func = 89,          /* aggregation_func  */
-  YYSYMBOL_aggregation_func_type = 90,     /* aggregation_func_type  */
-  YYSYMBOL_select_inner_join = 91,         /* select_inner_join  */
-  YYSYMBOL_inner_join_list = 92,           /* inner_join_list  */
-  YYSYMBOL_select_attr = 93,               /* select_attr  */
-  YYSYMBOL_attr_list = 94,                 /* attr_list  */
-  YYSYMBOL_rel_list = 95,                  /* rel_list  */
-  YYSYMBOL_expr = 96,                      /* expr  */
-  YYSYMBOL_where = 97,                     /* where  */
-  YYSYMBOL_condition_list = 98,            /* condition_list  */
-  YYSYMBOL_condition = 99,                 /* condition  */
-  YYSYMBOL_comOp = 100,                    /* comOp  */
-  YYSYMBOL_load_data = 101                 /* load_data  */
+  YYSYMBOL_SUM_T = 45,                     /* SUM_T  */
+  YYSYMBOL_UNIQUE = 46,                    /* UNIQUE  */
+  YYSYMBOL_INCLUDE = 47,                   /* INCLUDE  */
+  YYSYMBOL_USING = 48,                     /* USING  */
+  YYSYMBOL_HASH = 49,                      /* HASH  */
+  YYSYMBOL_ORDER = 50,                     /* ORDER  */
+  YYSYMBOL_BY = 51,                        /* BY  */
+  YYSYMBOL_ASC = 52,                       /* ASC  */
+  YYSYMBOL_ANALYZE = 53,                   /* ANALYZE  */
+  YYSYMBOL_GROUP = 54,                     /* GROUP  */
+  YYSYMBOL_LIMIT = 55,                     /* LIMIT  */
+  YYSYMBOL_OFFSET = 56,                    /* OFFSET  */
+  YYSYMBOL_IN = 57,                        /* IN  */
+  YYSYMBOL_NOT = 58,                       /* NOT  */
+  YYSYMBOL_EXISTS = 59,                    /* EXISTS  */
+  YYSYMBOL_PREPARE = 60,                   /* PREPARE  */
+  YYSYMBOL_EXECUTE = 61,                   /* EXECUTE  */
+  YYSYMBOL_DEALLOCATE = 62,                /* DEALLOCATE  */
+  YYSYMBOL_AS = 63,                        /* AS  */
+  YYSYMBOL_EQ = 64,                        /* EQ  */
+  YYSYMBOL_LT = 65,                        /* LT  */
+  YYSYMBOL_GT = 66,                        /* GT  */
+  YYSYMBOL_LE = 67,                        /* LE  */
+  YYSYMBOL_GE = 68,                        /* GE  */
+  YYSYMBOL_NE = 69,                        /* NE  */
+  YYSYMBOL_PARAM = 70,                     /* PARAM  */
+  YYSYMBOL_NUMBER = 71,                    /* NUMBER  */
+  YYSYMBOL_FLOAT = 72,                     /* FLOAT  */
+  YYSYMBOL_ID = 73,                        /* ID  */
+  YYSYMBOL_PATH = 74,                      /* PATH  */
+  YYSYMBOL_SSS = 75,                       /* SSS  */
+  YYSYMBOL_STAR = 76,                      /* STAR  */
+  YYSYMBOL_STRING_V = 77,                  /* STRING_V  */
+  YYSYMBOL_MINUS = 78,                     /* MINUS  */
+  YYSYMBOL_PLUS = 79,                      /* PLUS  */
+  YYSYMBOL_DIVIDE = 80,                    /* DIVIDE  */
+  YYSYMBOL_YYACCEPT = 81,                  /* $accept  */
+  YYSYMBOL_commands = 82,                  /* commands  */
+  YYSYMBOL_command = 83,                   /* command  */
+  YYSYMBOL_exit = 84,                      /* exit  */
+  YYSYMBOL_help = 85,                      /* help  */
+  YYSYMBOL_sync = 86,                      /* sync  */
+  YYSYMBOL_begin = 87,                     /* begin  */
+  YYSYMBOL_commit = 88,                    /* commit  */
+  YYSYMBOL_rollback = 89,                  /* rollback  */
+  YYSYMBOL_drop_table = 90,                /* drop_table  */
+  YYSYMBOL_show_tables = 91,               /* show_tables  */
+  YYSYMBOL_desc_table = 92,                /* desc_table  */
+  YYSYMBOL_analyze_table = 93,             /* analyze_table  */
+  YYSYMBOL_create_index = 94,              /* create_index  */
+  YYSYMBOL_index_include = 95,             /* index_include  */
+  YYSYMBOL_index_include_list = 96,        /* index_include_list  */
+  YYSYMBOL_index_include_attr = 97,        /* index_include_attr  */
+  YYSYMBOL_index_using = 98,               /* index_using  */
+  YYSYMBOL_drop_index = 99,                /* drop_index  */
+  YYSYMBOL_create_table = 100,             /* create_table  */
+  YYSYMBOL_attr_def_list = 101,            /* attr_def_list  */
+  YYSYMBOL_attr_def = 102,                 /* attr_def  */
+  YYSYMBOL_number = 103,                   /* number  */
+  YYSYMBOL_type = 104,                     /* type  */
+  YYSYMBOL_ID_get = 105,                   /* ID_get  */
+  YYSYMBOL_insert = 106,                   /* insert  */
+  YYSYMBOL_value_list = 107,               /* value_list  */
+  YYSYMBOL_value = 108,                    /* value  */
+  YYSYMBOL_delete = 109,                   /* delete  */
+  YYSYMBOL_update = 110,                   /* update  */
+  YYSYMBOL_select = 111,                   /* select  */
+  YYSYMBOL_sub_select = 112,               /* sub_select  */
+  YYSYMBOL_113_1 = 113,                    /* $@1  */
+  YYSYMBOL_aggregation_func = 114,         /* aggregation_func  */
+  YYSYMBOL_aggregation_func_type = 115,    /* aggregation_func_type  */
+  YYSYMBOL_select_inner_join = 116,        /* select_inner_join  */
+  YYSYMBOL_inner_join_list = 117,          /* inner_join_list  */
+  YYSYMBOL_select_attr = 118,              /* select_attr  */
+  YYSYMBOL_119_2 = 119,                    /* $@2  */
+  YYSYMBOL_attr_list = 120,                /* attr_list  */
+  YYSYMBOL_121_3 = 121,                    /* $@3  */
+  YYSYMBOL_group_by = 122,                 /* group_by  */
+  YYSYMBOL_group_item_list = 123,          /* group_item_list  */
+  YYSYMBOL_group_item = 124,               /* group_item  */
+  YYSYMBOL_order_by = 125,                 /* order_by  */
+  YYSYMBOL_order_item_list = 126,          /* order_item_list  */
+  YYSYMBOL_order_item = 127,               /* order_item  */
+  YYSYMBOL_limit = 128,                    /* limit  */
+  YYSYMBOL_order_direction = 129,          /* order_direction  */
+  YYSYMBOL_rel_list = 130,                 /* rel_list  */
+  YYSYMBOL_expr = 131,                     /* expr  */
+  YYSYMBOL_where = 132,                    /* where  */
+  YYSYMBOL_condition_list = 133,           /* condition_list  */
+  YYSYMBOL_condition = 134,                /* condition  */
+  YYSYMBOL_comOp = 135,                    /* comOp  */
+  YYSYMBOL_load_data = 136                 /* load_data  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -298,6 +338,18 @@ typedef int_least16_t yytype_int16;
 typedef short yytype_int16;
 #endif
 
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
 #if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
 typedef __UINT_LEAST8_TYPE__ yytype_uint8;
 #elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
@@ -359,7 +411,7 @@ typedef int yytype_uint16;
 
 
 /* Stored state numbers (used for stacks). */
-typedef yytype_uint8 yy_state_t;
+typedef yytype_int16 yy_state_t;
 
 /* State numbers in computations.  */
 typedef int yy_state_fast_t;
@@ -395,17 +447,23 @@ typedef int yy_state_fast_t;
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && ! defined __ICC && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                            \
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
     _Pragma ("GCC diagnostic push")                                     \
     _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
 # define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
@@ -564,19 +622,19 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  2
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   184
+#define YYLAST   296
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  61
+#define YYNTOKENS  81
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  41
+#define YYNNTS  56
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  93
+#define YYNRULES  130
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  197
+#define YYNSTATES  274
 
 /* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   315
+#define YYMAXUTOK   335
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
@@ -621,23 +679,29 @@ static const yytype_int8 yytranslate[] =
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
       35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
       45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
-      55,    56,    57,    58,    59,    60
+      55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
+      75,    76,    77,    78,    79,    80
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   145,   145,   147,   151,   152,   153,   154,   155,   156,
-     157,   158,   159,   160,   161,   162,   163,   164,   165,   166,
-     167,   168,   169,   173,   178,   183,   189,   195,   201,   207,
-     213,   219,   226,   234,   241,   250,   252,   256,   267,   280,
-     283,   284,   285,   286,   289,   298,   314,   316,   321,   324,
-     327,   334,   344,   354,   372,   387,   388,   391,   399,   409,
-     410,   411,   412,   417,   433,   435,   441,   446,   459,   461,
-     479,   481,   486,   492,   498,   504,   510,   516,   523,   529,
-     536,   542,   550,   552,   557,   559,   565,   720,   721,   722,
-     723,   724,   725,   729
+       0,   174,   174,   176,   180,   181,   182,   183,   184,   185,
+     186,   187,   188,   189,   190,   191,   192,   193,   194,   195,
+     196,   197,   198,   202,   207,   212,   218,   224,   230,   236,
+     242,   248,   255,   262,   267,   274,   276,   278,   280,   283,
+     288,   290,   297,   304,   313,   315,   319,   330,   343,   346,
+     347,   348,   349,   352,   361,   377,   379,   384,   387,   390,
+     394,   400,   410,   420,   439,   438,   460,   468,   478,   479,
+     480,   481,   482,   487,   503,   505,   510,   516,   516,   526,
+     533,   535,   535,   545,   556,   558,   560,   562,   565,   571,
+     578,   580,   582,   584,   587,   593,   600,   602,   606,   612,
+     613,   614,   617,   619,   624,   630,   636,   642,   648,   654,
+     661,   667,   674,   680,   688,   690,   694,   696,   701,   708,
+     714,   720,   726,   732,   886,   887,   888,   889,   890,   891,
+     895
 };
 #endif
 
@@ -659,17 +723,22 @@ static const char *const yytname[] =
   "TRX_COMMIT", "TRX_ROLLBACK", "INT_T", "STRING_T", "FLOAT_T", "DATE_T",
   "HELP", "EXIT", "DOT", "INTO", "VALUES", "FROM", "WHERE", "AND", "SET",
   "ON", "LOAD", "DATA", "INFILE", "JOIN", "INNER", "COUNT_T", "MIN_T",
-  "MAX_T", "AVG_T", "EQ", "LT", "GT", "LE", "GE", "NE", "NUMBER", "FLOAT",
-  "ID", "PATH", "SSS", "STAR", "STRING_V", "MINUS", "PLUS", "DIVIDE",
-  "$accept", "commands", "command", "exit", "help", "sync", "begin",
-  "commit", "rollback", "drop_table", "show_tables", "desc_table",
-  "create_index", "drop_index", "create_table", "attr_def_list",
-  "attr_def", "number", "type", "ID_get", "insert", "value_list", "value",
-  "delete", "update", "select", "select_aggregation_func",
-  "aggregation_func_list", "aggregation_func", "aggregation_func_type",
-  "select_inner_join", "inner_join_list", "select_attr", "attr_list",
-  "rel_list", "expr", "where", "condition_list", "condition", "comOp",
-  "load_data", YY_NULLPTR
+  "MAX_T", "AVG_T", "SUM_T", "UNIQUE", "INCLUDE", "USING", "HASH", "ORDER",
+  "BY", "ASC", "ANALYZE", "GROUP", "LIMIT", "OFFSET", "IN", "NOT",
+  "EXISTS", "PREPARE", "EXECUTE", "DEALLOCATE", "AS", "EQ", "LT", "GT",
+  "LE", "GE", "NE", "PARAM", "NUMBER", "FLOAT", "ID", "PATH", "SSS",
+  "STAR", "STRING_V", "MINUS", "PLUS", "DIVIDE", "$accept", "commands",
+  "command", "exit", "help", "sync", "begin", "commit", "rollback",
+  "drop_table", "show_tables", "desc_table", "analyze_table",
+  "create_index", "index_include", "index_include_list",
+  "index_include_attr", "index_using", "drop_index", "create_table",
+  "attr_def_list", "attr_def", "number", "type", "ID_get", "insert",
+  "value_list", "value", "delete", "update", "select", "sub_select", "$@1",
+  "aggregation_func", "aggregation_func_type", "select_inner_join",
+  "inner_join_list", "select_attr", "$@2", "attr_list", "$@3", "group_by",
+  "group_item_list", "group_item", "order_by", "order_item_list",
+  "order_item", "limit", "order_direction", "rel_list", "expr", "where",
+  "condition_list", "condition", "comOp", "load_data", YY_NULLPTR
 };
 
 static const char *
@@ -679,22 +748,7 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_int16 yytoknum[] =
-{
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,   297,   298,   299,   300,   301,   302,   303,   304,
-     305,   306,   307,   308,   309,   310,   311,   312,   313,   314,
-     315
-};
-#endif
-
-#define YYPACT_NINF (-163)
+#define YYPACT_NINF (-189)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
@@ -704,182 +758,238 @@ static const yytype_int16 yytoknum[] =
 #define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-    -163,    84,  -163,    28,    70,   -13,   -46,    10,    32,    23,
-      24,     6,    61,    74,    82,    87,    88,    55,  -163,  -163,
-    -163,  -163,  -163,  -163,  -163,  -163,  -163,  -163,  -163,  -163,
-    -163,  -163,  -163,  -163,  -163,  -163,  -163,  -163,    34,    47,
-      48,    49,    -2,  -163,  -163,  -163,  -163,  -163,  -163,    78,
-    -163,  -163,    -2,    -2,  -163,   -16,  -163,    91,    77,     7,
-     106,   115,  -163,    66,    68,    90,  -163,  -163,  -163,  -163,
-    -163,    92,   112,    94,   119,   128,     2,    79,   -44,   -44,
-      27,    80,   -30,    81,    -2,    -2,    -2,    -2,    -2,  -163,
-    -163,  -163,   105,   104,    85,    86,    89,    93,  -163,  -163,
-    -163,  -163,  -163,   104,   120,   122,    -7,     7,  -163,   -44,
-     -44,  -163,   124,    -2,   140,    99,   116,  -163,   129,    50,
-     133,   147,  -163,  -163,    98,   113,   104,  -163,   -42,    67,
-     121,  -163,   -42,   149,    89,   136,  -163,  -163,  -163,  -163,
-     141,   103,  -163,   142,   108,   155,   144,  -163,  -163,  -163,
-    -163,  -163,  -163,    -2,    -2,  -163,   104,   110,   129,   156,
-     114,   150,  -163,   131,  -163,   -42,   151,   -38,   121,   161,
-     166,  -163,  -163,  -163,   153,   168,    -2,   144,   169,  -163,
-    -163,  -163,  -163,  -163,   134,  -163,  -163,   137,   104,   125,
-     170,   145,  -163,    -2,   121,   134,  -163
+    -189,     6,  -189,    35,    22,    47,   -59,    41,    26,    20,
+      27,   -12,    59,    62,    67,    69,    70,    39,    72,  -189,
+    -189,  -189,  -189,  -189,  -189,  -189,  -189,  -189,  -189,  -189,
+    -189,  -189,  -189,  -189,  -189,  -189,  -189,  -189,  -189,    21,
+      24,    71,    40,    48,    37,  -189,  -189,  -189,  -189,  -189,
+    -189,  -189,  -189,    65,  -189,  -189,    37,    37,  -189,    81,
+      84,    83,    99,   121,   124,  -189,    56,    57,   101,  -189,
+    -189,  -189,  -189,  -189,   103,    74,   127,   113,    80,   152,
+     153,    66,    86,   -45,   -45,    61,  -189,   -29,    88,    37,
+      37,    37,    37,    81,  -189,  -189,   132,   137,   114,    97,
+     173,   115,   116,   156,  -189,  -189,  -189,  -189,    81,    99,
+     181,   182,     5,  -189,   -45,   -45,  -189,  -189,   184,    79,
+     198,   139,   176,  -189,  -189,   191,   158,   194,   138,  -189,
+      81,  -189,  -189,   140,   175,   137,   -15,   157,   196,   128,
+     185,  -189,   -15,   209,   115,   200,  -189,  -189,  -189,  -189,
+     203,   147,   205,  -189,   204,   150,   170,   207,   196,   217,
+    -189,   196,   171,  -189,  -189,  -189,  -189,  -189,  -189,    95,
+      79,  -189,   137,   154,   191,   226,   159,   214,   160,  -189,
+     197,   183,   186,   -15,   218,  -189,  -189,  -189,   196,    -4,
+    -189,    99,   185,   234,   235,  -189,  -189,  -189,   222,   193,
+     224,    79,   169,   192,   189,   207,   242,    47,  -189,  -189,
+    -189,  -189,  -189,   230,   199,   193,   208,   221,  -189,   177,
+     180,   249,  -189,  -189,   223,   187,   206,   250,   199,   219,
+     137,   188,   238,    12,  -189,   201,  -189,   190,  -189,  -189,
+    -189,  -189,   256,   195,   259,  -189,   169,  -189,   202,  -189,
+    -189,   246,   210,   204,    19,  -189,   231,  -189,  -189,    -2,
+     177,  -189,   137,  -189,   187,    79,  -189,  -189,   248,  -189,
+     185,  -189,   208,  -189
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
-static const yytype_int8 yydefact[] =
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_uint8 yydefact[] =
 {
        2,     0,     1,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     3,    22,
-      21,    16,    17,    18,    19,    11,    12,    13,    14,    15,
-      10,     7,     9,     8,     4,     6,     5,    20,     0,     0,
-       0,     0,     0,    59,    60,    61,    62,    48,    49,    79,
-      50,    66,     0,     0,    81,     0,    55,     0,     0,    68,
-       0,     0,    25,     0,     0,     0,    26,    27,    28,    24,
-      23,     0,     0,     0,     0,     0,     0,     0,    77,    76,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,    67,
-      31,    30,     0,    82,     0,     0,     0,     0,    29,    33,
-      78,    80,    56,    82,     0,     0,    70,    68,    74,    73,
-      72,    75,     0,     0,     0,     0,     0,    44,    35,     0,
-       0,     0,    58,    57,     0,     0,    82,    69,     0,     0,
-      84,    51,     0,     0,     0,     0,    40,    41,    42,    43,
-      38,     0,    54,    70,     0,     0,    46,    87,    88,    89,
-      90,    91,    92,     0,     0,    83,    82,     0,    35,     0,
-       0,     0,    71,     0,    53,     0,     0,    86,    84,     0,
-       0,    36,    34,    39,     0,     0,     0,    46,     0,    85,
-      52,    93,    37,    32,    64,    47,    45,     0,    82,     0,
-       0,     0,    63,     0,    84,    64,    65
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     3,
+      22,    21,    16,    17,    18,    19,    10,    11,    12,    13,
+      14,    15,     9,     6,     8,     7,     4,     5,    20,     0,
+       0,     0,     0,     0,     0,    68,    69,    70,    71,    72,
+      60,    57,    58,   111,    59,    76,     0,     0,   113,    80,
+       0,     0,    77,     0,     0,    25,     0,     0,     0,    26,
+      27,    28,    24,    23,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,   109,   108,     0,    79,     0,     0,     0,
+       0,     0,     0,    80,    31,    30,     0,   114,     0,     0,
+       0,     0,     0,     0,    29,    42,   110,   112,    80,    81,
+       0,     0,   102,   106,   105,   104,   107,    78,     0,     0,
+       0,     0,     0,    32,    53,    44,     0,     0,     0,    83,
+      80,    67,    66,     0,     0,   114,     0,     0,     0,     0,
+     116,    61,     0,     0,     0,     0,    49,    50,    51,    52,
+      47,     0,     0,    82,   102,     0,    84,    55,     0,     0,
+     122,     0,     0,   124,   125,   126,   127,   128,   129,     0,
+       0,   115,   114,     0,    44,     0,     0,     0,     0,   103,
+       0,     0,    90,     0,     0,   123,    64,   120,     0,     0,
+     119,   118,   116,     0,     0,    45,    43,    48,     0,    35,
+       0,     0,     0,     0,    96,    55,     0,     0,   121,   117,
+      62,   130,    46,     0,    40,    35,    74,    88,    86,     0,
+       0,     0,    56,    54,     0,     0,     0,     0,    40,     0,
+     114,     0,    85,    99,    92,    97,    63,     0,    39,    37,
+      41,    33,     0,     0,     0,    89,     0,   101,     0,   100,
+      94,    91,     0,   102,     0,    34,     0,    73,    87,    99,
+       0,    98,   114,    36,     0,     0,    95,    93,     0,    38,
+     116,    65,    74,    75
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -163,  -163,  -163,  -163,  -163,  -163,  -163,  -163,  -163,  -163,
-    -163,  -163,  -163,  -163,  -163,    17,    43,  -163,  -163,  -163,
-    -163,     4,  -124,  -163,  -163,  -163,  -163,  -163,   102,  -163,
-    -163,   -12,  -163,    72,    41,    -5,  -102,  -162,  -149,  -163,
-    -163
+    -189,  -189,  -189,  -189,  -189,  -189,  -189,  -189,  -189,  -189,
+    -189,  -189,  -189,  -189,    52,  -189,     7,    42,  -189,  -189,
+      98,   125,  -189,  -189,  -189,  -189,    68,  -129,  -189,  -189,
+    -189,     2,  -189,   211,  -189,  -189,     4,    73,  -189,   -84,
+    -189,  -189,  -189,    28,  -189,  -189,    17,  -189,    23,  -152,
+      -5,  -134,  -188,  -167,  -189,  -189
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int16 yydefgoto[] =
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
 {
-      -1,     1,    18,    19,    20,    21,    22,    23,    24,    25,
-      26,    27,    28,    29,    30,   135,   118,   174,   140,   119,
-      31,   166,    54,    32,    33,    34,    35,    55,    56,    57,
-      36,   188,    58,    89,   126,   129,   114,   155,   130,   153,
-      37
+       0,     1,    19,    20,    21,    22,    23,    24,    25,    26,
+      27,    28,    29,    30,   214,   254,   239,   227,    31,    32,
+     145,   125,   198,   150,   126,    33,   184,    58,    34,    35,
+      36,   160,   207,    59,    60,    37,   230,    61,    93,    86,
+     130,   182,   232,   218,   204,   251,   234,   221,   250,   135,
+     139,   120,   171,   140,   169,    38
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
-static const yytype_uint8 yytable[] =
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
 {
-      59,   121,    80,    42,   146,   168,   179,    60,   156,    47,
-      48,   124,    85,    50,    42,    81,    88,    61,    85,   100,
-      86,    87,    88,   104,   145,    84,   105,   184,    43,    44,
-      45,    46,   195,   125,    38,    62,    39,    76,    47,    48,
-      49,   177,    50,    51,   194,    52,    53,    78,    79,    47,
-      48,    49,    63,    50,   169,    64,    52,    53,    85,    65,
-      86,    87,    88,    85,    66,    86,    87,    88,    43,    44,
-      45,    46,   136,   137,   138,   139,    40,    67,    41,   107,
-     108,   109,   110,   111,     2,    68,   190,    72,     3,     4,
-      69,    70,    71,     5,     6,     7,     8,     9,    10,    11,
-      73,    74,    75,    12,    13,    14,    77,    82,    83,    90,
-      15,    16,   147,   148,   149,   150,   151,   152,    91,    92,
-      17,    93,    98,    85,    94,    86,    87,    88,    96,    97,
-      95,    99,   101,   103,   106,   112,   113,   122,   115,   123,
-     128,   116,   117,   131,   132,   133,   120,   134,   167,   141,
-     142,   143,   144,   159,   154,   157,   161,   160,   164,   172,
-     124,   163,   165,   170,   180,   173,   176,   175,   178,   181,
-     182,   183,   186,   192,   187,   171,   189,   158,   191,   127,
-     193,   185,   102,   196,   162
+      62,   156,   179,   192,   209,   186,     2,   157,   247,   117,
+       3,     4,    44,   172,    63,     5,     6,     7,     8,     9,
+      10,    11,   247,   133,   129,    12,    13,    14,    42,    65,
+      43,    89,    15,    16,   216,    92,   263,   264,   193,    81,
+     248,    39,    17,    40,   110,   134,   153,   111,    64,    66,
+     249,    83,    84,    44,   205,    50,    51,    52,    67,    18,
+      54,    68,    69,    44,   249,    70,    50,    51,    52,    53,
+      71,    54,    72,    73,    56,    57,    74,    44,    75,    78,
+     109,    41,   272,   106,   113,   114,   115,   116,    45,    46,
+      47,    48,    49,    82,    76,    44,   244,    77,   270,    85,
+      87,   262,    45,    46,    47,    48,    49,    50,    51,    52,
+      53,   189,    54,    79,    88,    56,    57,    50,    51,    52,
+      53,    80,    54,    55,    94,    56,    57,    95,   268,    96,
+      97,    50,    51,    52,    53,    98,    54,   137,   138,    56,
+      57,    99,    89,   101,    90,    91,    92,   100,   102,    50,
+      51,    52,    53,   103,    54,   104,   105,    56,    57,   107,
+     185,   112,   118,   187,   191,    50,    51,    52,    53,   119,
+      54,   190,   122,    56,    57,    89,   123,    90,    91,    92,
+     146,   147,   148,   149,    81,   161,   162,   121,   124,   127,
+     208,   128,   163,   164,   165,   166,   167,   168,   131,   132,
+     136,   141,    62,   142,    89,   143,    90,    91,    92,   144,
+     151,   152,   159,   154,   155,   173,   158,   175,   170,   176,
+     177,   178,   133,   180,   181,   183,   186,   194,   188,   196,
+     197,   199,   201,   200,   202,   206,   203,   210,   211,   212,
+     213,   215,   217,   219,   220,   223,   225,   226,   229,   231,
+     233,   235,   236,   241,   237,   240,   246,   252,   243,   255,
+     238,   245,   257,   253,   260,   271,   265,   228,   256,   174,
+     242,   269,   195,   222,   258,   259,   273,   267,     0,     0,
+     224,   261,   266,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,   108
 };
 
-static const yytype_uint8 yycheck[] =
+static const yytype_int16 yycheck[] =
 {
-       5,   103,    18,    16,   128,   154,   168,    53,   132,    51,
-      52,    18,    56,    55,    16,    31,    60,     7,    56,    17,
-      58,    59,    60,    53,   126,    18,    56,   176,    41,    42,
-      43,    44,   194,    40,     6,     3,     8,    42,    51,    52,
-      53,   165,    55,    56,   193,    58,    59,    52,    53,    51,
-      52,    53,    29,    55,   156,    31,    58,    59,    56,    53,
-      58,    59,    60,    56,     3,    58,    59,    60,    41,    42,
-      43,    44,    22,    23,    24,    25,     6,     3,     8,    84,
-      85,    86,    87,    88,     0,     3,   188,    53,     4,     5,
-       3,     3,    37,     9,    10,    11,    12,    13,    14,    15,
-      53,    53,    53,    19,    20,    21,    28,    16,    31,     3,
-      26,    27,    45,    46,    47,    48,    49,    50,     3,    53,
-      36,    53,     3,    56,    34,    58,    59,    60,    16,    35,
-      38,     3,    53,    53,    53,    30,    32,    17,    53,    17,
-      16,    55,    53,     3,    45,    29,    53,    18,   153,    16,
-       3,    53,    39,    17,    33,     6,    53,    16,     3,     3,
-      18,    53,    18,    53,     3,    51,    35,    17,    17,     3,
-      17,     3,     3,     3,    40,   158,    39,   134,    53,   107,
-      35,   177,    80,   195,   143
+       5,   135,   154,   170,   192,     9,     0,   136,    10,    93,
+       4,     5,    16,   142,    73,     9,    10,    11,    12,    13,
+      14,    15,    10,    18,   108,    19,    20,    21,     6,     3,
+       8,    76,    26,    27,   201,    80,    17,    18,   172,    44,
+      28,     6,    36,     8,    73,    40,   130,    76,     7,    29,
+      52,    56,    57,    16,   183,    70,    71,    72,    31,    53,
+      75,    73,     3,    16,    52,     3,    70,    71,    72,    73,
+       3,    75,     3,     3,    78,    79,    37,    16,     6,     8,
+      85,    46,   270,    17,    89,    90,    91,    92,    41,    42,
+      43,    44,    45,    28,    73,    16,   230,    73,   265,    18,
+      16,   253,    41,    42,    43,    44,    45,    70,    71,    72,
+      73,    16,    75,    73,    31,    78,    79,    70,    71,    72,
+      73,    73,    75,    76,     3,    78,    79,     3,   262,    73,
+      73,    70,    71,    72,    73,    34,    75,    58,    59,    78,
+      79,    38,    76,    16,    78,    79,    80,    73,    35,    70,
+      71,    72,    73,    73,    75,     3,     3,    78,    79,    73,
+     158,    73,    30,   161,   169,    70,    71,    72,    73,    32,
+      75,   169,    75,    78,    79,    76,     3,    78,    79,    80,
+      22,    23,    24,    25,   189,    57,    58,    73,    73,    73,
+     188,    35,    64,    65,    66,    67,    68,    69,    17,    17,
+      16,     3,   207,    64,    76,    29,    78,    79,    80,    18,
+      16,    73,    16,    73,    39,     6,    59,    17,    33,    16,
+      73,    16,    18,    73,    54,    18,     9,    73,    57,     3,
+      71,    17,    35,    73,    51,    17,    50,     3,     3,    17,
+      47,    17,    73,    51,    55,     3,    16,    48,    40,    28,
+      73,    71,     3,     3,    31,    49,    18,    56,    39,     3,
+      73,    73,     3,    73,    18,    17,    35,   215,    73,   144,
+     228,   264,   174,   205,   246,    73,   272,   260,    -1,    -1,
+     207,    71,   259,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    85
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
-static const yytype_int8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_uint8 yystos[] =
 {
-       0,    62,     0,     4,     5,     9,    10,    11,    12,    13,
-      14,    15,    19,    20,    21,    26,    27,    36,    63,    64,
-      65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
-      75,    81,    84,    85,    86,    87,    91,   101,     6,     8,
-       6,     8,    16,    41,    42,    43,    44,    51,    52,    53,
-      55,    56,    58,    59,    83,    88,    89,    90,    93,    96,
-      53,     7,     3,    29,    31,    53,     3,     3,     3,     3,
-       3,    37,    53,    53,    53,    53,    96,    28,    96,    96,
-      18,    31,    16,    31,    18,    56,    58,    59,    60,    94,
-       3,     3,    53,    53,    34,    38,    16,    35,     3,     3,
-      17,    53,    89,    53,    53,    56,    53,    96,    96,    96,
-      96,    96,    30,    32,    97,    53,    55,    53,    77,    80,
-      53,    97,    17,    17,    18,    40,    95,    94,    16,    96,
-      99,     3,    45,    29,    18,    76,    22,    23,    24,    25,
-      79,    16,     3,    53,    39,    97,    83,    45,    46,    47,
-      48,    49,    50,   100,    33,    98,    83,     6,    77,    17,
-      16,    53,    95,    53,     3,    18,    82,    96,    99,    97,
-      53,    76,     3,    51,    78,    17,    35,    83,    17,    98,
-       3,     3,    17,     3,    99,    82,     3,    40,    92,    39,
-      97,    53,     3,    35,    99,    98,    92
+       0,    82,     0,     4,     5,     9,    10,    11,    12,    13,
+      14,    15,    19,    20,    21,    26,    27,    36,    53,    83,
+      84,    85,    86,    87,    88,    89,    90,    91,    92,    93,
+      94,    99,   100,   106,   109,   110,   111,   116,   136,     6,
+       8,    46,     6,     8,    16,    41,    42,    43,    44,    45,
+      70,    71,    72,    73,    75,    76,    78,    79,   108,   114,
+     115,   118,   131,    73,     7,     3,    29,    31,    73,     3,
+       3,     3,     3,     3,    37,     6,    73,    73,     8,    73,
+      73,   131,    28,   131,   131,    18,   120,    16,    31,    76,
+      78,    79,    80,   119,     3,     3,    73,    73,    34,    38,
+      73,    16,    35,    73,     3,     3,    17,    73,   114,   131,
+      73,    76,    73,   131,   131,   131,   131,   120,    30,    32,
+     132,    73,    75,     3,    73,   102,   105,    73,    35,   120,
+     121,    17,    17,    18,    40,   130,    16,    58,    59,   131,
+     134,     3,    64,    29,    18,   101,    22,    23,    24,    25,
+     104,    16,    73,   120,    73,    39,   132,   108,    59,    16,
+     112,    57,    58,    64,    65,    66,    67,    68,    69,   135,
+      33,   133,   108,     6,   102,    17,    16,    73,    16,   130,
+      73,    54,   122,    18,   107,   112,     9,   112,    57,    16,
+     112,   131,   134,   132,    73,   101,     3,    71,   103,    17,
+      73,    35,    51,    50,   125,   108,    17,   113,   112,   133,
+       3,     3,    17,    47,    95,    17,   134,    73,   124,    51,
+      55,   128,   107,     3,   118,    16,    48,    98,    95,    40,
+     117,    28,   123,    73,   127,    71,     3,    31,    73,    97,
+      49,     3,    98,    39,   132,    73,    18,    10,    28,    52,
+     129,   126,    56,    73,    96,     3,    73,     3,   124,    73,
+      18,    71,   130,    17,    18,    35,   129,   127,   132,    97,
+     134,    17,   133,   117
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_int8 yyr1[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_uint8 yyr1[] =
 {
-       0,    61,    62,    62,    63,    63,    63,    63,    63,    63,
-      63,    63,    63,    63,    63,    63,    63,    63,    63,    63,
-      63,    63,    63,    64,    65,    66,    67,    68,    69,    70,
-      71,    72,    73,    74,    75,    76,    76,    77,    77,    78,
-      79,    79,    79,    79,    80,    81,    82,    82,    83,    83,
-      83,    84,    85,    86,    87,    88,    88,    89,    89,    90,
-      90,    90,    90,    91,    92,    92,    93,    93,    94,    94,
-      95,    95,    96,    96,    96,    96,    96,    96,    96,    96,
-      96,    96,    97,    97,    98,    98,    99,   100,   100,   100,
-     100,   100,   100,   101
+       0,    81,    82,    82,    83,    83,    83,    83,    83,    83,
+      83,    83,    83,    83,    83,    83,    83,    83,    83,    83,
+      83,    83,    83,    84,    85,    86,    87,    88,    89,    90,
+      91,    92,    93,    94,    94,    95,    95,    96,    96,    97,
+      98,    98,    99,   100,   101,   101,   102,   102,   103,   104,
+     104,   104,   104,   105,   106,   107,   107,   108,   108,   108,
+     108,   109,   110,   111,   113,   112,   114,   114,   115,   115,
+     115,   115,   115,   116,   117,   117,   118,   119,   118,   118,
+     120,   121,   120,   120,   122,   122,   123,   123,   124,   124,
+     125,   125,   126,   126,   127,   127,   128,   128,   128,   129,
+     129,   129,   130,   130,   131,   131,   131,   131,   131,   131,
+     131,   131,   131,   131,   132,   132,   133,   133,   134,   134,
+     134,   134,   134,   134,   135,   135,   135,   135,   135,   135,
+     136
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     0,     2,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     2,     2,     2,     2,     2,     2,     4,
-       3,     3,     9,     4,     8,     0,     3,     5,     2,     1,
-       1,     1,     1,     1,     1,     9,     0,     3,     1,     1,
-       1,     5,     8,     7,     6,     1,     3,     4,     4,     1,
-       1,     1,     1,    12,     0,     7,     1,     2,     0,     3,
-       0,     3,     3,     3,     3,     3,     2,     2,     3,     1,
-       3,     1,     0,     3,     0,     3,     3,     1,     1,     1,
-       1,     1,     1,     8
+       3,     3,     4,    11,    12,     0,     5,     0,     3,     1,
+       0,     2,     4,     8,     0,     3,     5,     2,     1,     1,
+       1,     1,     1,     1,     9,     0,     3,     1,     1,     1,
+       1,     5,     8,    10,     0,     9,     4,     4,     1,     1,
+       1,     1,     1,    12,     0,     7,     1,     0,     3,     2,
+       0,     0,     4,     3,     0,     4,     0,     3,     1,     3,
+       0,     4,     0,     3,     2,     4,     0,     2,     4,     0,
+       1,     1,     0,     3,     3,     3,     3,     3,     2,     2,
+       3,     1,     3,     1,     0,     3,     0,     3,     3,     3,
+       3,     4,     2,     3,     1,     1,     1,     1,     1,     1,
+       8
 };
 
 
@@ -891,6 +1001,7 @@ enum { YYENOMEM = -2 };
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
@@ -931,10 +1042,7 @@ do {                                            \
     YYFPRINTF Args;                             \
 } while (0)
 
-/* This macro is provided for backward compatibility. */
-# ifndef YY_LOCATION_PRINT
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
+
 
 
 # define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
@@ -958,16 +1066,12 @@ yy_symbol_value_print (FILE *yyo,
                        yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, void *scanner)
 {
   FILE *yyoutput = yyo;
-  YYUSE (yyoutput);
-  YYUSE (scanner);
+  YY_USE (yyoutput);
+  YY_USE (scanner);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yykind < YYNTOKENS)
-    YYPRINT (yyo, yytoknum[yykind], *yyvaluep);
-# endif
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yykind);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -1081,14 +1185,14 @@ static void
 yydestruct (const char *yymsg,
             yysymbol_kind_t yykind, YYSTYPE *yyvaluep, void *scanner)
 {
-  YYUSE (yyvaluep);
-  YYUSE (scanner);
+  YY_USE (yyvaluep);
+  YY_USE (scanner);
   if (!yymsg)
     yymsg = "Deleting";
   YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yykind);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -1157,6 +1261,7 @@ YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
   YYDPRINTF ((stderr, "Starting parse\n"));
 
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   goto yysetstate;
 
 
@@ -1182,7 +1287,7 @@ yysetstate:
 
   if (yyss + yystacksize - 1 <= yyssp)
 #if !defined yyoverflow && !defined YYSTACK_RELOCATE
-    goto yyexhaustedlab;
+    YYNOMEM;
 #else
     {
       /* Get the current used size of the three stacks, in elements.  */
@@ -1210,7 +1315,7 @@ yysetstate:
 # else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
@@ -1221,7 +1326,7 @@ yysetstate:
           YY_CAST (union yyalloc *,
                    YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
@@ -1243,6 +1348,7 @@ yysetstate:
     }
 #endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
+
   if (yystate == YYFINAL)
     YYACCEPT;
 
@@ -1355,99 +1461,133 @@ yyreduce:
   switch (yyn)
     {
   case 23: /* exit: EXIT SEMICOLON  */
-#line 173 "yacc_sql.y"
+#line 202 "yacc_sql.y"
                    {
         CONTEXT->ssql->flag=SCF_EXIT;//"exit";
     }
-#line 1363 "yacc_sql.tab.c"
+#line 1469 "yacc_sql.tab.c"
     break;
 
   case 24: /* help: HELP SEMICOLON  */
-#line 178 "yacc_sql.y"
+#line 207 "yacc_sql.y"
                    {
         CONTEXT->ssql->flag=SCF_HELP;//"help";
     }
-#line 1371 "yacc_sql.tab.c"
+#line 1477 "yacc_sql.tab.c"
     break;
 
   case 25: /* sync: SYNC SEMICOLON  */
-#line 183 "yacc_sql.y"
+#line 212 "yacc_sql.y"
                    {
       CONTEXT->ssql->flag = SCF_SYNC;
     }
-#line 1379 "yacc_sql.tab.c"
+#line 1485 "yacc_sql.tab.c"
     break;
 
   case 26: /* begin: TRX_BEGIN SEMICOLON  */
-#line 189 "yacc_sql.y"
+#line 218 "yacc_sql.y"
                         {
       CONTEXT->ssql->flag = SCF_BEGIN;
     }
-#line 1387 "yacc_sql.tab.c"
+#line 1493 "yacc_sql.tab.c"
     break;
 
   case 27: /* commit: TRX_COMMIT SEMICOLON  */
-#line 195 "yacc_sql.y"
+#line 224 "yacc_sql.y"
                          {
       CONTEXT->ssql->flag = SCF_COMMIT;
     }
-#line 1395 "yacc_sql.tab.c"
+#line 1501 "yacc_sql.tab.c"
     break;
 
   case 28: /* rollback: TRX_ROLLBACK SEMICOLON  */
-#line 201 "yacc_sql.y"
+#line 230 "yacc_sql.y"
                            {
       CONTEXT->ssql->flag = SCF_ROLLBACK;
     }
-#line 1403 "yacc_sql.tab.c"
+#line 1509 "yacc_sql.tab.c"
     break;
 
   case 29: /* drop_table: DROP TABLE ID SEMICOLON  */
-#line 207 "yacc_sql.y"
+#line 236 "yacc_sql.y"
                             {
         CONTEXT->ssql->flag = SCF_DROP_TABLE;//"drop_table";
         drop_table_init(&CONTEXT->ssql->sstr.drop_table, (yyvsp[-1].string));
     }
-#line 1412 "yacc_sql.tab.c"
+#line 1518 "yacc_sql.tab.c"
     break;
 
   case 30: /* show_tables: SHOW TABLES SEMICOLON  */
-#line 213 "yacc_sql.y"
+#line 242 "yacc_sql.y"
                           {
       CONTEXT->ssql->flag = SCF_SHOW_TABLES;
     }
-#line 1420 "yacc_sql.tab.c"
+#line 1526 "yacc_sql.tab.c"
     break;
 
   case 31: /* desc_table: DESC ID SEMICOLON  */
-#line 219 "yacc_sql.y"
+#line 248 "yacc_sql.y"
                       {
       CONTEXT->ssql->flag = SCF_DESC_TABLE;
       desc_table_init(&CONTEXT->ssql->sstr.desc_table, (yyvsp[-1].string));
     }
-#line 1429 "yacc_sql.tab.c"
+#line 1535 "yacc_sql.tab.c"
+    break;
+
+  case 32: /* analyze_table: ANALYZE TABLE ID SEMICOLON  */
+#line 255 "yacc_sql.y"
+                               {
+      CONTEXT->ssql->flag = SCF_ANALYZE_TABLE;
+      analyze_table_init(&CONTEXT->ssql->sstr.analyze_table, (yyvsp[-1].string));
+    }
+#line 1544 "yacc_sql.tab.c"
+    break;
+
+  case 33: /* create_index: CREATE INDEX ID ON ID LBRACE ID RBRACE index_include index_using SEMICOLON  */
+#line 263 "yacc_sql.y"
+                {
+			CONTEXT->ssql->flag = SCF_CREATE_INDEX;//"create_index";
+			create_index_init(&CONTEXT->ssql->sstr.create_index, (yyvsp[-8].string), (yyvsp[-6].string), (yyvsp[-4].string), 0);
+		}
+#line 1553 "yacc_sql.tab.c"
     break;
 
-  case 32: /* create_index: CREATE INDEX ID ON ID LBRACE ID RBRACE SEMICOLON  */
-#line 227 "yacc_sql.y"
+  case 34: /* create_index: CREATE UNIQUE INDEX ID ON ID LBRACE ID RBRACE index_include index_using SEMICOLON  */
+#line 268 "yacc_sql.y"
                 {
 			CONTEXT->ssql->flag = SCF_CREATE_INDEX;//"create_index";
-			create_index_init(&CONTEXT->ssql->sstr.create_index, (yyvsp[-6].string), (yyvsp[-4].string), (yyvsp[-2].string));
+			create_index_init(&CONTEXT->ssql->sstr.create_index, (yyvsp[-8].string), (yyvsp[-6].string), (yyvsp[-4].string), 1);
 		}
-#line 1438 "yacc_sql.tab.c"
+#line 1562 "yacc_sql.tab.c"
     break;
 
-  case 33: /* drop_index: DROP INDEX ID SEMICOLON  */
-#line 235 "yacc_sql.y"
+  case 39: /* index_include_attr: ID  */
+#line 284 "yacc_sql.y"
+                {
+			create_index_append_include(&CONTEXT->ssql->sstr.create_index, (yyvsp[0].string));
+		}
+#line 1570 "yacc_sql.tab.c"
+    break;
+
+  case 41: /* index_using: USING HASH  */
+#line 291 "yacc_sql.y"
+                {
+			create_index_set_type(&CONTEXT->ssql->sstr.create_index, HASH_INDEX);
+		}
+#line 1578 "yacc_sql.tab.c"
+    break;
+
+  case 42: /* drop_index: DROP INDEX ID SEMICOLON  */
+#line 298 "yacc_sql.y"
                 {
 			CONTEXT->ssql->flag=SCF_DROP_INDEX;//"drop_index";
 			drop_index_init(&CONTEXT->ssql->sstr.drop_index, (yyvsp[-1].string));
 		}
-#line 1447 "yacc_sql.tab.c"
+#line 1587 "yacc_sql.tab.c"
     break;
 
-  case 34: /* create_table: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE SEMICOLON  */
-#line 242 "yacc_sql.y"
+  case 43: /* create_table: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE SEMICOLON  */
+#line 305 "yacc_sql.y"
                 {
 			CONTEXT->ssql->flag=SCF_CREATE_TABLE;//"create_table";
 			// CONTEXT->ssql->sstr.create_table.attribute_count = CONTEXT->value_length;
@@ -1455,17 +1595,17 @@ yyreduce:
 			//临时变量清零	
 			CONTEXT->value_length = 0;
 		}
-#line 1459 "yacc_sql.tab.c"
+#line 1599 "yacc_sql.tab.c"
     break;
 
-  case 36: /* attr_def_list: COMMA attr_def attr_def_list  */
-#line 252 "yacc_sql.y"
+  case 45: /* attr_def_list: COMMA attr_def attr_def_list  */
+#line 315 "yacc_sql.y"
                                    {    }
-#line 1465 "yacc_sql.tab.c"
+#line 1605 "yacc_sql.tab.c"
     break;
 
-  case 37: /* attr_def: ID_get type LBRACE number RBRACE  */
-#line 257 "yacc_sql.y"
+  case 46: /* attr_def: ID_get type LBRACE number RBRACE  */
+#line 320 "yacc_sql.y"
                 {
 			AttrInfo attribute;
 			attr_info_init(&attribute, CONTEXT->id, (yyvsp[-3].number), (yyvsp[-1].number));
@@ -1476,11 +1616,11 @@ yyreduce:
 			// CONTEXT->ssql->sstr.create_table.attributes[CONTEXT->value_length].length = $4;
 			CONTEXT->value_length++;
 		}
-#line 1480 "yacc_sql.tab.c"
+#line 1620 "yacc_sql.tab.c"
     break;
 
-  case 38: /* attr_def: ID_get type  */
-#line 268 "yacc_sql.y"
+  case 47: /* attr_def: ID_get type  */
+#line 331 "yacc_sql.y"
                 {
 			AttrInfo attribute;
 			attr_info_init(&attribute, CONTEXT->id, (yyvsp[0].number), 4);
@@ -1491,50 +1631,50 @@ yyreduce:
 			// CONTEXT->ssql->sstr.create_table.attributes[CONTEXT->value_length].length=4; // default attribute length
 			CONTEXT->value_length++;
 		}
-#line 1495 "yacc_sql.tab.c"
+#line 1635 "yacc_sql.tab.c"
     break;
 
-  case 39: /* number: NUMBER  */
-#line 280 "yacc_sql.y"
+  case 48: /* number: NUMBER  */
+#line 343 "yacc_sql.y"
                        {(yyval.number) = (yyvsp[0].number);}
-#line 1501 "yacc_sql.tab.c"
+#line 1641 "yacc_sql.tab.c"
     break;
 
-  case 40: /* type: INT_T  */
-#line 283 "yacc_sql.y"
+  case 49: /* type: INT_T  */
+#line 346 "yacc_sql.y"
               { (yyval.number)=INTS; }
-#line 1507 "yacc_sql.tab.c"
+#line 1647 "yacc_sql.tab.c"
     break;
 
-  case 41: /* type: STRING_T  */
-#line 284 "yacc_sql.y"
+  case 50: /* type: STRING_T  */
+#line 347 "yacc_sql.y"
                   { (yyval.number)=CHARS; }
-#line 1513 "yacc_sql.tab.c"
+#line 1653 "yacc_sql.tab.c"
     break;
 
-  case 42: /* type: FLOAT_T  */
-#line 285 "yacc_sql.y"
+  case 51: /* type: FLOAT_T  */
+#line 348 "yacc_sql.y"
                  { (yyval.number)=FLOATS; }
-#line 1519 "yacc_sql.tab.c"
+#line 1659 "yacc_sql.tab.c"
     break;
 
-  case 43: /* type: DATE_T  */
-#line 286 "yacc_sql.y"
+  case 52: /* type: DATE_T  */
+#line 349 "yacc_sql.y"
                     {(yyval.number)=DATES;}
-#line 1525 "yacc_sql.tab.c"
+#line 1665 "yacc_sql.tab.c"
     break;
 
-  case 44: /* ID_get: ID  */
-#line 290 "yacc_sql.y"
+  case 53: /* ID_get: ID  */
+#line 353 "yacc_sql.y"
         {
 		char *temp=(yyvsp[0].string); 
 		snprintf(CONTEXT->id, sizeof(CONTEXT->id), "%s", temp);
 	}
-#line 1534 "yacc_sql.tab.c"
+#line 1674 "yacc_sql.tab.c"
     break;
 
-  case 45: /* insert: INSERT INTO ID VALUES LBRACE value value_list RBRACE SEMICOLON  */
-#line 299 "yacc_sql.y"
+  case 54: /* insert: INSERT INTO ID VALUES LBRACE value value_list RBRACE SEMICOLON  */
+#line 362 "yacc_sql.y"
                 {
 			// CONTEXT->values[CONTEXT->value_length++] = *$6;
 
@@ -1549,44 +1689,52 @@ yyreduce:
       //临时变量清零
       CONTEXT->value_length=0;
     }
-#line 1553 "yacc_sql.tab.c"
+#line 1693 "yacc_sql.tab.c"
     break;
 
-  case 47: /* value_list: COMMA value value_list  */
-#line 316 "yacc_sql.y"
+  case 56: /* value_list: COMMA value value_list  */
+#line 379 "yacc_sql.y"
                               { 
   		// CONTEXT->values[CONTEXT->value_length++] = *$2;
 	  }
-#line 1561 "yacc_sql.tab.c"
+#line 1701 "yacc_sql.tab.c"
     break;
 
-  case 48: /* value: NUMBER  */
-#line 321 "yacc_sql.y"
+  case 57: /* value: NUMBER  */
+#line 384 "yacc_sql.y"
           {	
   		value_init_integer(&CONTEXT->values[CONTEXT->value_length++], (yyvsp[0].number));
 		}
-#line 1569 "yacc_sql.tab.c"
+#line 1709 "yacc_sql.tab.c"
     break;
 
-  case 49: /* value: FLOAT  */
-#line 324 "yacc_sql.y"
+  case 58: /* value: FLOAT  */
+#line 387 "yacc_sql.y"
           {
   		value_init_float(&CONTEXT->values[CONTEXT->value_length++], (yyvsp[0].floats));
 		}
-#line 1577 "yacc_sql.tab.c"
+#line 1717 "yacc_sql.tab.c"
     break;
 
-  case 50: /* value: SSS  */
-#line 327 "yacc_sql.y"
+  case 59: /* value: SSS  */
+#line 390 "yacc_sql.y"
          {
 			(yyvsp[0].string) = substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
   		value_init_string(&CONTEXT->values[CONTEXT->value_length++], (yyvsp[0].string));
 		}
-#line 1586 "yacc_sql.tab.c"
+#line 1726 "yacc_sql.tab.c"
+    break;
+
+  case 60: /* value: PARAM  */
+#line 394 "yacc_sql.y"
+           {
+  		value_init_param(&CONTEXT->values[CONTEXT->value_length++], CONTEXT->ssql->param_num++);
+		}
+#line 1734 "yacc_sql.tab.c"
     break;
 
-  case 51: /* delete: DELETE FROM ID where SEMICOLON  */
-#line 335 "yacc_sql.y"
+  case 61: /* delete: DELETE FROM ID where SEMICOLON  */
+#line 401 "yacc_sql.y"
                 {
 			CONTEXT->ssql->flag = SCF_DELETE;//"delete";
 			deletes_init_relation(&CONTEXT->ssql->sstr.deletion, (yyvsp[-2].string));
@@ -1594,11 +1742,11 @@ yyreduce:
 					CONTEXT->conditions, CONTEXT->condition_length);
 			CONTEXT->condition_length = 0;	
     }
-#line 1598 "yacc_sql.tab.c"
+#line 1746 "yacc_sql.tab.c"
     break;
 
-  case 52: /* update: UPDATE ID SET ID EQ value where SEMICOLON  */
-#line 345 "yacc_sql.y"
+  case 62: /* update: UPDATE ID SET ID EQ value where SEMICOLON  */
+#line 411 "yacc_sql.y"
                 {
 			CONTEXT->ssql->flag = SCF_UPDATE;//"update";
 			Value *value = &CONTEXT->values[0];
@@ -1606,16 +1754,16 @@ yyreduce:
 					CONTEXT->conditions, CONTEXT->condition_length);
 			CONTEXT->condition_length = 0;
 		}
-#line 1610 "yacc_sql.tab.c"
+#line 1758 "yacc_sql.tab.c"
     break;
 
-  case 53: /* select: SELECT select_attr FROM ID rel_list where SEMICOLON  */
-#line 355 "yacc_sql.y"
+  case 63: /* select: SELECT select_attr FROM ID rel_list where group_by order_by limit SEMICOLON  */
+#line 421 "yacc_sql.y"
                 {
 			// CONTEXT->ssql->sstr.selection.relations[CONTEXT->from_length++]=$4;
-			selects_append_relation(&CONTEXT->ssql->sstr.selection, (yyvsp[-3].string));
+			selects_append_relation(CONTEXT->selects, (yyvsp[-6].string));
 
-			selects_append_conditions(&CONTEXT->ssql->sstr.selection, CONTEXT->conditions, CONTEXT->condition_length);
+			selects_append_conditions(CONTEXT->selects, CONTEXT->conditions, CONTEXT->condition_length);
 
 			CONTEXT->ssql->flag=SCF_SELECT;//"select";
 			// CONTEXT->ssql->sstr.selection.attr_num = CONTEXT->select_length;
@@ -1626,83 +1774,100 @@ yyreduce:
 			CONTEXT->select_length=0;
 			CONTEXT->value_length = 0;
 	}
-#line 1630 "yacc_sql.tab.c"
+#line 1778 "yacc_sql.tab.c"
     break;
 
-  case 54: /* select_aggregation_func: SELECT aggregation_func_list FROM ID where SEMICOLON  */
-#line 373 "yacc_sql.y"
-        {
-		selects_append_relation(&CONTEXT->ssql->sstr.selection, (yyvsp[-2].string));
-		selects_append_conditions(&CONTEXT->ssql->sstr.selection, CONTEXT->conditions, CONTEXT->condition_length);
-		CONTEXT->ssql->flag=SCF_SELECT;//"select";
-		// CONTEXT->ssql->sstr.selection.attr_num = CONTEXT->select_length;
-
-		//临时变量清零
-		CONTEXT->condition_length=0;
-		CONTEXT->from_length=0;
-		CONTEXT->select_length=0;
-		CONTEXT->value_length = 0;
-	}
-#line 1647 "yacc_sql.tab.c"
+  case 64: /* $@1: %empty  */
+#line 439 "yacc_sql.y"
+                {
+			// 子查询的内容解析到新的Selects中，条件也单独收集
+			CONTEXT->outer_selects[CONTEXT->select_depth] = CONTEXT->selects;
+			CONTEXT->outer_condition_length[CONTEXT->select_depth] = CONTEXT->condition_length;
+			CONTEXT->select_depth++;
+			CONTEXT->selects = (Selects *)calloc(1, sizeof(Selects));
+		}
+#line 1790 "yacc_sql.tab.c"
     break;
 
-  case 57: /* aggregation_func: aggregation_func_type LBRACE STAR RBRACE  */
-#line 391 "yacc_sql.y"
+  case 65: /* sub_select: LBRACE SELECT $@1 select_attr FROM ID rel_list where RBRACE  */
+#line 447 "yacc_sql.y"
+                {
+			Selects *selects = CONTEXT->selects;
+			selects_append_relation(selects, (yyvsp[-3].string));
+			CONTEXT->select_depth--;
+			size_t condition_start = CONTEXT->outer_condition_length[CONTEXT->select_depth];
+			selects_append_conditions(selects, CONTEXT->conditions + condition_start,
+					CONTEXT->condition_length - condition_start);
+			CONTEXT->condition_length = condition_start;
+			CONTEXT->selects = CONTEXT->outer_selects[CONTEXT->select_depth];
+			(yyval.selects1) = selects;
+		}
+#line 1806 "yacc_sql.tab.c"
+    break;
+
+  case 66: /* aggregation_func: aggregation_func_type LBRACE STAR RBRACE  */
+#line 460 "yacc_sql.y"
                                                  {
 		RelAttr attr;
 		relation_attr_init(&attr, NULL, "*");
 		Aggregation aggre;
 		aggre_init(&aggre, CONTEXT->aggre_type, &attr);
-		selects_append_aggregation(&CONTEXT->ssql->sstr.selection, &aggre);
+		selects_append_aggregation(CONTEXT->selects, &aggre);
 		
 	}
-#line 1660 "yacc_sql.tab.c"
+#line 1819 "yacc_sql.tab.c"
     break;
 
-  case 58: /* aggregation_func: aggregation_func_type LBRACE ID RBRACE  */
-#line 399 "yacc_sql.y"
+  case 67: /* aggregation_func: aggregation_func_type LBRACE ID RBRACE  */
+#line 468 "yacc_sql.y"
                                                  {
 		RelAttr attr;
 		relation_attr_init(&attr, NULL, (yyvsp[-1].string));
 		Aggregation aggre;
 		aggre_init(&aggre, CONTEXT->aggre_type, &attr);
-		selects_append_aggregation(&CONTEXT->ssql->sstr.selection, &aggre);
+		selects_append_aggregation(CONTEXT->selects, &aggre);
 		
 	}
-#line 1673 "yacc_sql.tab.c"
+#line 1832 "yacc_sql.tab.c"
     break;
 
-  case 59: /* aggregation_func_type: COUNT_T  */
-#line 409 "yacc_sql.y"
+  case 68: /* aggregation_func_type: COUNT_T  */
+#line 478 "yacc_sql.y"
                  {CONTEXT->aggre_type = COUNT;}
-#line 1679 "yacc_sql.tab.c"
+#line 1838 "yacc_sql.tab.c"
     break;
 
-  case 60: /* aggregation_func_type: MIN_T  */
-#line 410 "yacc_sql.y"
+  case 69: /* aggregation_func_type: MIN_T  */
+#line 479 "yacc_sql.y"
                {CONTEXT->aggre_type = MIN;}
-#line 1685 "yacc_sql.tab.c"
+#line 1844 "yacc_sql.tab.c"
     break;
 
-  case 61: /* aggregation_func_type: MAX_T  */
-#line 411 "yacc_sql.y"
+  case 70: /* aggregation_func_type: MAX_T  */
+#line 480 "yacc_sql.y"
                {CONTEXT->aggre_type = MAX;}
-#line 1691 "yacc_sql.tab.c"
+#line 1850 "yacc_sql.tab.c"
     break;
 
-  case 62: /* aggregation_func_type: AVG_T  */
-#line 412 "yacc_sql.y"
+  case 71: /* aggregation_func_type: AVG_T  */
+#line 481 "yacc_sql.y"
                {CONTEXT->aggre_type = AVG;}
-#line 1697 "yacc_sql.tab.c"
+#line 1856 "yacc_sql.tab.c"
     break;
 
-  case 63: /* select_inner_join: SELECT select_attr FROM ID INNER JOIN ID ON condition inner_join_list where SEMICOLON  */
-#line 417 "yacc_sql.y"
+  case 72: /* aggregation_func_type: SUM_T  */
+#line 482 "yacc_sql.y"
+               {CONTEXT->aggre_type = SUM;}
+#line 1862 "yacc_sql.tab.c"
+    break;
+
+  case 73: /* select_inner_join: SELECT select_attr FROM ID INNER JOIN ID ON condition inner_join_list where SEMICOLON  */
+#line 487 "yacc_sql.y"
                                                                                              {
 			// CONTEXT->ssql->sstr.selection.relations[CONTEXT->from_length++]=$4;
-			selects_append_relation(&CONTEXT->ssql->sstr.selection, (yyvsp[-8].string));
-			selects_append_relation(&CONTEXT->ssql->sstr.selection, (yyvsp[-5].string));
-			selects_append_conditions(&CONTEXT->ssql->sstr.selection, CONTEXT->conditions, CONTEXT->condition_length);
+			selects_append_relation(CONTEXT->selects, (yyvsp[-8].string));
+			selects_append_relation(CONTEXT->selects, (yyvsp[-5].string));
+			selects_append_conditions(CONTEXT->selects, CONTEXT->conditions, CONTEXT->condition_length);
 
 			CONTEXT->ssql->flag=SCF_SELECT;//"select";
 			// CONTEXT->ssql->sstr.selection.attr_num = CONTEXT->select_length;
@@ -1713,118 +1878,209 @@ yyreduce:
 			CONTEXT->select_length=0;
 			CONTEXT->value_length = 0;
 	}
-#line 1717 "yacc_sql.tab.c"
+#line 1882 "yacc_sql.tab.c"
     break;
 
-  case 65: /* inner_join_list: INNER JOIN ID ON condition condition_list inner_join_list  */
-#line 435 "yacc_sql.y"
+  case 75: /* inner_join_list: INNER JOIN ID ON condition condition_list inner_join_list  */
+#line 505 "yacc_sql.y"
                                                                    {
-		fprintf(stdout, "inner_join_list\n");
-		selects_append_relation(&CONTEXT->ssql->sstr.selection, (yyvsp[-4].string));
+		selects_append_relation(CONTEXT->selects, (yyvsp[-4].string));
 	}
-#line 1726 "yacc_sql.tab.c"
+#line 1890 "yacc_sql.tab.c"
     break;
 
-  case 66: /* select_attr: STAR  */
-#line 441 "yacc_sql.y"
+  case 76: /* select_attr: STAR  */
+#line 510 "yacc_sql.y"
          {  
 			RelAttr attr;
 			relation_attr_init(&attr, NULL, "*");
-			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
+			selects_append_attribute(CONTEXT->selects, &attr);
+			CONTEXT->selects->item_num++;
 		}
-#line 1736 "yacc_sql.tab.c"
+#line 1901 "yacc_sql.tab.c"
     break;
 
-  case 67: /* select_attr: expr attr_list  */
-#line 446 "yacc_sql.y"
-                     {
+  case 77: /* $@2: %empty  */
+#line 516 "yacc_sql.y"
+           {
+			// 列表是从右向左追加的，在这里按照从左到右的顺序计数
+			CONTEXT->selects->item_num++;
+		}
+#line 1910 "yacc_sql.tab.c"
+    break;
+
+  case 78: /* select_attr: expr $@2 attr_list  */
+#line 519 "yacc_sql.y"
+                            {
 			// RelAttr attr;
 			// relation_attr_init(&attr, NULL, $1);
-			// selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
+			// selects_append_attribute(CONTEXT->selects, &attr);
 
-			selects_append_attr_expr(&CONTEXT->ssql->sstr.selection, (yyvsp[-1].express_node));
+			selects_append_attr_expr(CONTEXT->selects, (yyvsp[-2].express_node));
 		}
-#line 1748 "yacc_sql.tab.c"
+#line 1922 "yacc_sql.tab.c"
     break;
 
-  case 69: /* attr_list: COMMA expr attr_list  */
-#line 461 "yacc_sql.y"
-                           {
+  case 81: /* $@3: %empty  */
+#line 535 "yacc_sql.y"
+                 {
+			CONTEXT->selects->item_num++;
+		}
+#line 1930 "yacc_sql.tab.c"
+    break;
+
+  case 82: /* attr_list: COMMA expr $@3 attr_list  */
+#line 537 "yacc_sql.y"
+                            {
 			// RelAttr attr;
 			// relation_attr_init(&attr, NULL, $2);
-			// selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
-			selects_append_attr_expr(&CONTEXT->ssql->sstr.selection, (yyvsp[-1].express_node));
+			// selects_append_attribute(CONTEXT->selects, &attr);
+			selects_append_attr_expr(CONTEXT->selects, (yyvsp[-2].express_node));
      	  // CONTEXT->ssql->sstr.selection.attributes[CONTEXT->select_length].relation_name = NULL;
         // CONTEXT->ssql->sstr.selection.attributes[CONTEXT->select_length++].attribute_name=$2;
       }
-#line 1761 "yacc_sql.tab.c"
+#line 1943 "yacc_sql.tab.c"
     break;
 
-  case 71: /* rel_list: COMMA ID rel_list  */
-#line 481 "yacc_sql.y"
+  case 88: /* group_item: ID  */
+#line 566 "yacc_sql.y"
+                {
+			RelAttr attr;
+			relation_attr_init(&attr, NULL, (yyvsp[0].string));
+			selects_append_group_by(CONTEXT->selects, &attr);
+		}
+#line 1953 "yacc_sql.tab.c"
+    break;
+
+  case 89: /* group_item: ID DOT ID  */
+#line 572 "yacc_sql.y"
+                {
+			RelAttr attr;
+			relation_attr_init(&attr, (yyvsp[-2].string), (yyvsp[0].string));
+			selects_append_group_by(CONTEXT->selects, &attr);
+		}
+#line 1963 "yacc_sql.tab.c"
+    break;
+
+  case 94: /* order_item: ID order_direction  */
+#line 588 "yacc_sql.y"
+                {
+			RelAttr attr;
+			relation_attr_init(&attr, NULL, (yyvsp[-1].string));
+			selects_append_order(CONTEXT->selects, &attr, (yyvsp[0].number));
+		}
+#line 1973 "yacc_sql.tab.c"
+    break;
+
+  case 95: /* order_item: ID DOT ID order_direction  */
+#line 594 "yacc_sql.y"
+                {
+			RelAttr attr;
+			relation_attr_init(&attr, (yyvsp[-3].string), (yyvsp[-1].string));
+			selects_append_order(CONTEXT->selects, &attr, (yyvsp[0].number));
+		}
+#line 1983 "yacc_sql.tab.c"
+    break;
+
+  case 97: /* limit: LIMIT NUMBER  */
+#line 603 "yacc_sql.y"
+                {
+			selects_set_limit(CONTEXT->selects, (yyvsp[0].number), 0);
+		}
+#line 1991 "yacc_sql.tab.c"
+    break;
+
+  case 98: /* limit: LIMIT NUMBER OFFSET NUMBER  */
+#line 607 "yacc_sql.y"
+                {
+			selects_set_limit(CONTEXT->selects, (yyvsp[-2].number), (yyvsp[0].number));
+		}
+#line 1999 "yacc_sql.tab.c"
+    break;
+
+  case 99: /* order_direction: %empty  */
+#line 612 "yacc_sql.y"
+                { (yyval.number) = 1; }
+#line 2005 "yacc_sql.tab.c"
+    break;
+
+  case 100: /* order_direction: ASC  */
+#line 613 "yacc_sql.y"
+          { (yyval.number) = 1; }
+#line 2011 "yacc_sql.tab.c"
+    break;
+
+  case 101: /* order_direction: DESC  */
+#line 614 "yacc_sql.y"
+           { (yyval.number) = 0; }
+#line 2017 "yacc_sql.tab.c"
+    break;
+
+  case 103: /* rel_list: COMMA ID rel_list  */
+#line 619 "yacc_sql.y"
                         {	
-				selects_append_relation(&CONTEXT->ssql->sstr.selection, (yyvsp[-1].string));
+				selects_append_relation(CONTEXT->selects, (yyvsp[-1].string));
 		  }
-#line 1769 "yacc_sql.tab.c"
+#line 2025 "yacc_sql.tab.c"
     break;
 
-  case 72: /* expr: expr PLUS expr  */
-#line 486 "yacc_sql.y"
+  case 104: /* expr: expr PLUS expr  */
+#line 624 "yacc_sql.y"
                     {
 			fprintf(stdout, "expr '+' expr\n");
 			ExpressionNode *expression = expression_init((yyvsp[-2].express_node), (yyvsp[0].express_node), NULL, NULL);
 			expression->op = PLUS_OP;
 			(yyval.express_node) = expression;
 	}
-#line 1780 "yacc_sql.tab.c"
+#line 2036 "yacc_sql.tab.c"
     break;
 
-  case 73: /* expr: expr MINUS expr  */
-#line 492 "yacc_sql.y"
+  case 105: /* expr: expr MINUS expr  */
+#line 630 "yacc_sql.y"
                          {
 			fprintf(stdout, "expr '-' expr\n");
 			ExpressionNode *expression = expression_init((yyvsp[-2].express_node), (yyvsp[0].express_node), NULL, NULL);
 			expression->op = MINUS_OP;
 			(yyval.express_node) = expression;
 	}
-#line 1791 "yacc_sql.tab.c"
+#line 2047 "yacc_sql.tab.c"
     break;
 
-  case 74: /* expr: expr STAR expr  */
-#line 498 "yacc_sql.y"
+  case 106: /* expr: expr STAR expr  */
+#line 636 "yacc_sql.y"
                         {
 			fprintf(stdout, "expr '*' expr\n");
 			ExpressionNode *expression = expression_init((yyvsp[-2].express_node), (yyvsp[0].express_node), NULL, NULL);
 			expression->op = MULTI_OP;
 			(yyval.express_node) = expression;
 	}
-#line 1802 "yacc_sql.tab.c"
+#line 2058 "yacc_sql.tab.c"
     break;
 
-  case 75: /* expr: expr DIVIDE expr  */
-#line 504 "yacc_sql.y"
+  case 107: /* expr: expr DIVIDE expr  */
+#line 642 "yacc_sql.y"
                           {
 			fprintf(stdout, "expr '/' expr\n");
 			ExpressionNode *expression = expression_init((yyvsp[-2].express_node), (yyvsp[0].express_node), NULL, NULL);
 			expression->op = DIVIDE_OP;
 			(yyval.express_node) = expression;
 	}
-#line 1813 "yacc_sql.tab.c"
+#line 2069 "yacc_sql.tab.c"
     break;
 
-  case 76: /* expr: PLUS expr  */
-#line 510 "yacc_sql.y"
+  case 108: /* expr: PLUS expr  */
+#line 648 "yacc_sql.y"
                         {
 			fprintf(stdout, "+expr\n");
 			ExpressionNode *expression = expression_init((yyvsp[0].express_node), NULL, NULL, NULL);
 			expression->pre_op = PLUS_OP;
 			(yyval.express_node) = expression;
 	}
-#line 1824 "yacc_sql.tab.c"
+#line 2080 "yacc_sql.tab.c"
     break;
 
-  case 77: /* expr: MINUS expr  */
-#line 516 "yacc_sql.y"
+  case 109: /* expr: MINUS expr  */
+#line 654 "yacc_sql.y"
                      {
 			fprintf(stdout, "-expr\n");
 			ExpressionNode *expression = expression_init((yyvsp[0].express_node), NULL, NULL, NULL);
@@ -1832,22 +2088,22 @@ yyreduce:
 			(yyval.express_node) = expression;
 
 	}
-#line 1836 "yacc_sql.tab.c"
+#line 2092 "yacc_sql.tab.c"
     break;
 
-  case 78: /* expr: LBRACE expr RBRACE  */
-#line 523 "yacc_sql.y"
+  case 110: /* expr: LBRACE expr RBRACE  */
+#line 661 "yacc_sql.y"
                             {
 			fprintf(stdout, "expr\n");
 			ExpressionNode *expression = expression_init((yyvsp[-1].express_node), NULL, NULL, NULL);
 			expression->has_brace = true;
 			(yyval.express_node) = expression;
 	}
-#line 1847 "yacc_sql.tab.c"
+#line 2103 "yacc_sql.tab.c"
     break;
 
-  case 79: /* expr: ID  */
-#line 529 "yacc_sql.y"
+  case 111: /* expr: ID  */
+#line 667 "yacc_sql.y"
              {
 			fprintf(stdout, "ID\n");
 			RelAttr attr;
@@ -1855,106 +2111,154 @@ yyreduce:
 			(yyval.express_node) = expression_init( NULL, NULL, &attr, NULL);
 			
 	}
-#line 1859 "yacc_sql.tab.c"
+#line 2115 "yacc_sql.tab.c"
     break;
 
-  case 80: /* expr: ID DOT ID  */
-#line 536 "yacc_sql.y"
+  case 112: /* expr: ID DOT ID  */
+#line 674 "yacc_sql.y"
                     {
 		   fprintf(stdout, "ID DOT ID\n");
 		   RelAttr attr;
 		   relation_attr_init(&attr, (yyvsp[-2].string), (yyvsp[0].string));
 		   (yyval.express_node) = expression_init( NULL, NULL, &attr, NULL);
 	}
-#line 1870 "yacc_sql.tab.c"
+#line 2126 "yacc_sql.tab.c"
     break;
 
-  case 81: /* expr: value  */
-#line 542 "yacc_sql.y"
+  case 113: /* expr: value  */
+#line 680 "yacc_sql.y"
                 {
 			fprintf(stdout, "value\n");
 			Value *value = &CONTEXT->values[CONTEXT->value_length - 1];
 			(yyval.express_node) = expression_init(NULL, NULL, NULL, value);
 	}
-#line 1880 "yacc_sql.tab.c"
+#line 2136 "yacc_sql.tab.c"
     break;
 
-  case 83: /* where: WHERE condition condition_list  */
-#line 552 "yacc_sql.y"
+  case 115: /* where: WHERE condition condition_list  */
+#line 690 "yacc_sql.y"
                                      {	
-			fprintf(stdout, "where\n");
 				// CONTEXT->conditions[CONTEXT->condition_length++]=*$2;
 			}
-#line 1889 "yacc_sql.tab.c"
+#line 2144 "yacc_sql.tab.c"
     break;
 
-  case 85: /* condition_list: AND condition condition_list  */
-#line 559 "yacc_sql.y"
+  case 117: /* condition_list: AND condition condition_list  */
+#line 696 "yacc_sql.y"
                                    {
-		fprintf(stdout, "condition_list\n");
 				// CONTEXT->conditions[CONTEXT->condition_length++]=*$2;
 			}
-#line 1898 "yacc_sql.tab.c"
+#line 2152 "yacc_sql.tab.c"
     break;
 
-  case 86: /* condition: expr comOp expr  */
-#line 566 "yacc_sql.y"
+  case 118: /* condition: expr comOp expr  */
+#line 702 "yacc_sql.y"
             {
 			fprintf(stdout, "expr comOp expr\n");
 			Condition condition;
-			condition_init(&condition, CONTEXT->comp, (yyvsp[-2].express_node), (yyvsp[0].express_node));
+			condition_init(&condition, (yyvsp[-1].number), (yyvsp[-2].express_node), (yyvsp[0].express_node));
+			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
+		}
+#line 2163 "yacc_sql.tab.c"
+    break;
+
+  case 119: /* condition: expr comOp sub_select  */
+#line 709 "yacc_sql.y"
+                {
+			Condition condition;
+			condition_init_subquery(&condition, (yyvsp[-1].number), (yyvsp[-2].express_node), (yyvsp[0].selects1));
 			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 		}
-#line 1909 "yacc_sql.tab.c"
+#line 2173 "yacc_sql.tab.c"
     break;
 
-  case 87: /* comOp: EQ  */
-#line 720 "yacc_sql.y"
-             { CONTEXT->comp = EQUAL_TO; }
-#line 1915 "yacc_sql.tab.c"
+  case 120: /* condition: expr IN sub_select  */
+#line 715 "yacc_sql.y"
+                {
+			Condition condition;
+			condition_init_subquery(&condition, IN_OP, (yyvsp[-2].express_node), (yyvsp[0].selects1));
+			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
+		}
+#line 2183 "yacc_sql.tab.c"
     break;
 
-  case 88: /* comOp: LT  */
+  case 121: /* condition: expr NOT IN sub_select  */
 #line 721 "yacc_sql.y"
-         { CONTEXT->comp = LESS_THAN; }
-#line 1921 "yacc_sql.tab.c"
+                {
+			Condition condition;
+			condition_init_subquery(&condition, NOT_IN_OP, (yyvsp[-3].express_node), (yyvsp[0].selects1));
+			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
+		}
+#line 2193 "yacc_sql.tab.c"
     break;
 
-  case 89: /* comOp: GT  */
-#line 722 "yacc_sql.y"
-         { CONTEXT->comp = GREAT_THAN; }
-#line 1927 "yacc_sql.tab.c"
+  case 122: /* condition: EXISTS sub_select  */
+#line 727 "yacc_sql.y"
+                {
+			Condition condition;
+			condition_init_subquery(&condition, EXISTS_OP, NULL, (yyvsp[0].selects1));
+			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
+		}
+#line 2203 "yacc_sql.tab.c"
     break;
 
-  case 90: /* comOp: LE  */
-#line 723 "yacc_sql.y"
-         { CONTEXT->comp = LESS_EQUAL; }
-#line 1933 "yacc_sql.tab.c"
+  case 123: /* condition: NOT EXISTS sub_select  */
+#line 733 "yacc_sql.y"
+                {
+			Condition condition;
+			condition_init_subquery(&condition, NOT_EXISTS_OP, NULL, (yyvsp[0].selects1));
+			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
+		}
+#line 2213 "yacc_sql.tab.c"
+    break;
+
+  case 124: /* comOp: EQ  */
+#line 886 "yacc_sql.y"
+             { CONTEXT->comp = EQUAL_TO; (yyval.number) = EQUAL_TO; }
+#line 2219 "yacc_sql.tab.c"
+    break;
+
+  case 125: /* comOp: LT  */
+#line 887 "yacc_sql.y"
+         { CONTEXT->comp = LESS_THAN; (yyval.number) = LESS_THAN; }
+#line 2225 "yacc_sql.tab.c"
     break;
 
-  case 91: /* comOp: GE  */
-#line 724 "yacc_sql.y"
-         { CONTEXT->comp = GREAT_EQUAL; }
-#line 1939 "yacc_sql.tab.c"
+  case 126: /* comOp: GT  */
+#line 888 "yacc_sql.y"
+         { CONTEXT->comp = GREAT_THAN; (yyval.number) = GREAT_THAN; }
+#line 2231 "yacc_sql.tab.c"
     break;
 
-  case 92: /* comOp: NE  */
-#line 725 "yacc_sql.y"
-         { CONTEXT->comp = NOT_EQUAL; }
-#line 1945 "yacc_sql.tab.c"
+  case 127: /* comOp: LE  */
+#line 889 "yacc_sql.y"
+         { CONTEXT->comp = LESS_EQUAL; (yyval.number) = LESS_EQUAL; }
+#line 2237 "yacc_sql.tab.c"
     break;
 
-  case 93: /* load_data: LOAD DATA INFILE SSS INTO TABLE ID SEMICOLON  */
-#line 730 "yacc_sql.y"
+  case 128: /* comOp: GE  */
+#line 890 "yacc_sql.y"
+         { CONTEXT->comp = GREAT_EQUAL; (yyval.number) = GREAT_EQUAL; }
+#line 2243 "yacc_sql.tab.c"
+    break;
+
+  case 129: /* comOp: NE  */
+#line 891 "yacc_sql.y"
+         { CONTEXT->comp = NOT_EQUAL; (yyval.number) = NOT_EQUAL; }
+#line 2249 "yacc_sql.tab.c"
+    break;
+
+  case 130: /* load_data: LOAD DATA INFILE SSS INTO TABLE ID SEMICOLON  */
+#line 896 "yacc_sql.y"
                 {
 		  CONTEXT->ssql->flag = SCF_LOAD_DATA;
 			load_data_init(&CONTEXT->ssql->sstr.load_data, (yyvsp[-1].string), (yyvsp[-4].string));
 		}
-#line 1954 "yacc_sql.tab.c"
+#line 2258 "yacc_sql.tab.c"
     break;
 
 
-#line 1958 "yacc_sql.tab.c"
+#line 2262 "yacc_sql.tab.c"
 
       default: break;
     }
@@ -2036,6 +2340,7 @@ yyerrorlab:
      label yyerrorlab therefore never appears in user code.  */
   if (0)
     YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -2096,7 +2401,7 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
 /*-----------------------------------.
@@ -2104,24 +2409,22 @@ yyacceptlab:
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
-#if !defined yyoverflow
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (scanner, YY_("memory exhausted"));
   yyresult = 2;
-  goto yyreturn;
-#endif
+  goto yyreturnlab;
 
 
-/*-------------------------------------------------------.
-| yyreturn -- parsing is finished, clean up and return.  |
-`-------------------------------------------------------*/
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2148,7 +2451,7 @@ yyreturn:
   return yyresult;
 }
 
-#line 735 "yacc_sql.y"
+#line 901 "yacc_sql.y"
 
 //_____________________________________________________________________
 extern void scan_string(const char *str, yyscan_t scanner);
@@ -2160,8 +2463,170 @@ int sql_parse(const char *s, Query *sqls){
 	yyscan_t scanner;
 	yylex_init_extra(&context, &scanner);
 	context.ssql = sqls;
+	context.selects = &sqls->sstr.selection;
 	scan_string(s, scanner);
 	int result = yyparse(scanner);
 	yylex_destroy(scanner);
 	return result;
 }
+
+/**
+ * 把SQL中的常量换成参数?，作为执行计划缓存的key。LIMIT/OFFSET后面的数字不是常量，保留原样，
+ * 记号之间只保留一个空格，关键字换成大写
+ * 换掉的常量按出现的顺序放到values中，与解析normalized得到的参数一一对应
+ * @return 0 成功，normalized由调用者free；
+ *         -1 不是SELECT/INSERT/UPDATE/DELETE、本来就有参数或者常量超过max_value_num，values中的常量已经释放
+ */
+int sql_normalize(const char *s, char **normalized, Value values[], int max_value_num, int *value_num)
+{
+	ParserContext context;
+	memset(&context, 0, sizeof(context));
+
+	yyscan_t scanner;
+	yylex_init_extra(&context, &scanner);
+	scan_string(s, scanner);
+
+	// 每个记号后面加一个空格，常量换成?不会变长
+	char *buffer = malloc(strlen(s) * 2 + 1);
+	size_t length = 0;
+	int result = 0;
+	int count = 0;
+	int previous = 0;
+	int token;
+	YYSTYPE lval;
+	while (result == 0 && (token = yylex(&lval, scanner)) != 0) {
+		if (previous == 0 && token != SELECT && token != INSERT && token != UPDATE && token != DELETE) {
+			result = -1;
+		}
+		const char *text = yyget_text(scanner);
+		int is_value = 0;
+		if ((token == NUMBER && previous != LIMIT && previous != OFFSET) || token == FLOAT || token == SSS) {
+			is_value = 1;
+			if (count >= max_value_num) {
+				result = -1;
+			} else if (token == NUMBER) {
+				value_init_integer(&values[count++], lval.number);
+			} else if (token == FLOAT) {
+				value_init_float(&values[count++], lval.floats);
+			} else {
+				char *str = substr(lval.string, 1, strlen(lval.string) - 2);
+				value_init_string(&values[count++], str);
+				free(str);
+			}
+		} else if (token == PARAM) {
+			result = -1;
+		}
+		if (token == ID || token == SSS) {
+			free(lval.string);
+		}
+
+		// 关键字不区分大小写，统一成大写
+		text = is_value ? "?" : text;
+		for (const char *c = text; *c != '\0'; c++) {
+			buffer[length++] = token == ID ? *c : toupper(*c);
+		}
+		buffer[length++] = ' ';
+		previous = token;
+	}
+	yylex_destroy(scanner);
+
+	if (result != 0 || length == 0) {
+		for (int i = 0; i < count; i++) {
+			value_destroy(&values[i]);
+		}
+		free(buffer);
+		return -1;
+	}
+	buffer[length - 1] = '\0';
+	*normalized = buffer;
+	*value_num = count;
+	return 0;
+}
+
+static void free_token_string(int token, YYSTYPE *lval)
+{
+	if (token == ID || token == SSS) {
+		free(lval->string);
+	}
+}
+
+/**
+ * 只用词法分析识别 PREPARE name AS statement、EXECUTE name [(value, ...)] 和 DEALLOCATE name，
+ * 执行预处理语句时只需要读出参数的值，不用再做语法分析
+ * @return 0 成功，或者不是这几种语句（type是PREPARED_NONE）；-1 语法错误
+ */
+int sql_parse_prepared_command(const char *s, PreparedCommand *command)
+{
+	memset(command, 0, sizeof(*command));
+
+	ParserContext context;
+	memset(&context, 0, sizeof(context));
+
+	yyscan_t scanner;
+	yylex_init_extra(&context, &scanner);
+	scan_string(s, scanner);
+
+	YYSTYPE lval;
+	int token = yylex(&lval, scanner);
+	// 词法分析的缓冲区是s的副本，用第一个记号的位置换算出记号在s中的位置
+	const char *base = yyget_text(scanner) - strspn(s, " \t\b\f\n");
+	switch (token) {
+		case PREPARE: command->type = PREPARED_PREPARE; break;
+		case EXECUTE: command->type = PREPARED_EXECUTE; break;
+		case DEALLOCATE: command->type = PREPARED_DEALLOCATE; break;
+		default: {
+			free_token_string(token, &lval);
+			yylex_destroy(scanner);
+			return 0;
+		}
+	}
+
+	int result = -1;
+	token = yylex(&lval, scanner);
+	if (token == ID) {
+		command->name = lval.string;
+		token = yylex(&lval, scanner);
+		if (command->type == PREPARED_PREPARE) {
+			if (token == AS) {
+				command->sql = s + (yyget_text(scanner) + yyget_leng(scanner) - base);
+				result = 0;
+			}
+		} else if (command->type == PREPARED_EXECUTE && token == LBRACE) {
+			// 参数之间用逗号分隔，只能是常量
+			int expect_value = 1;
+			while ((token = yylex(&lval, scanner)) != 0) {
+				if (expect_value && (token == NUMBER || token == FLOAT || token == SSS) && command->value_num < MAX_NUM) {
+					Value *value = &command->values[command->value_num++];
+					if (token == NUMBER) {
+						value_init_integer(value, lval.number);
+					} else if (token == FLOAT) {
+						value_init_float(value, lval.floats);
+					} else {
+						char *str = substr(lval.string, 1, strlen(lval.string) - 2);
+						value_init_string(value, str);
+						free(str);
+					}
+					expect_value = 0;
+				} else if (!expect_value && token == COMMA) {
+					expect_value = 1;
+				} else {
+					break;
+				}
+				free_token_string(token, &lval);
+			}
+			if (token == RBRACE && (!expect_value || command->value_num == 0)) {
+				token = yylex(&lval, scanner);
+				result = (token == SEMICOLON || token == 0) ? 0 : -1;
+			}
+		} else {
+			result = (token == SEMICOLON || token == 0) ? 0 : -1;
+		}
+	}
+	free_token_string(token, &lval);
+	yylex_destroy(scanner);
+
+	if (result != 0) {
+		prepared_command_destroy(command);
+	}
+	return result;
+}
@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.7.4.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -96,22 +96,42 @@ extern int yydebug;
     MIN_T = 297,                   /* MIN_T  */
     MAX_T = 298,                   /* MAX_T  */
     AVG_T = 299,                   /* AVG_T  */
-    EQ = 300,                      /* EQ  */
-    LT = 301,                      /* LT  */
-    GT = 302,                      /* GT  */
-    LE = 303,                      /* LE  */
-    GE = 304,                      /* GE  */
-    NE = 305,                      /* NE  */
-    NUMBER = 306,                  /* NUMBER  */
-    FLOAT = 307,                   /* FLOAT  */
-    ID = 308,                      /* ID  */
-    PATH = 309,                    /* PATH  */
-    SSS = 310,                     /* SSS  */
-    STAR = 311,                    /* STAR  */
-    STRING_V = 312,                /* STRING_V  */
-    MINUS = 313,                   /* MINUS  */
-    PLUS = 314,                    /* PLUS  */
-    DIVIDE = 315                   /* DIVIDE  */
+    SUM_T = 300,                   /* SUM_T  */
+    UNIQUE = 301,                  /* UNIQUE  */
+    INCLUDE = 302,                 /* INCLUDE  */
+    USING = 303,                   /* USING  */
+    HASH = 304,                    /* HASH  */
+    ORDER = 305,                   /* ORDER  */
+    BY = 306,                      /* BY  */
+    ASC = 307,                     /* ASC  */
+    ANALYZE = 308,                 /* ANALYZE  */
+    GROUP = 309,                   /* GROUP  */
+    LIMIT = 310,                   /* LIMIT  */
+    OFFSET = 311,                  /* OFFSET  */
+    IN = 312,                      /* IN  */
+    NOT = 313,                     /* NOT  */
+    EXISTS = 314,                  /* EXISTS  */
+    PREPARE = 315,                 /* PREPARE  */
+    EXECUTE = 316,                 /* EXECUTE  */
+    DEALLOCATE = 317,              /* DEALLOCATE  */
+    AS = 318,                      /* AS  */
+    EQ = 319,                      /* EQ  */
+    LT = 320,                      /* LT  */
+    GT = 321,                      /* GT  */
+    LE = 322,                      /* LE  */
+    GE = 323,                      /* GE  */
+    NE = 324,                      /* NE  */
+    PARAM = 325,                   /* PARAM  */
+    NUMBER = 326,                  /* NUMBER  */
+    FLOAT = 327,                   /* FLOAT  */
+    ID = 328,                      /* ID  */
+    PATH = 329,                    /* PATH  */
+    SSS = 330,                     /* SSS  */
+    STAR = 331,                    /* STAR  */
+    STRING_V = 332,                /* STRING_V  */
+    MINUS = 333,                   /* MINUS  */
+    PLUS = 334,                    /* PLUS  */
+    DIVIDE = 335                   /* DIVIDE  */
   };
   typedef enum yytokentype yytoken_kind_t;
 #endif
@@ -120,7 +140,7 @@ extern int yydebug;
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 114 "yacc_sql.y"
+#line 139 "yacc_sql.y"
 
   struct _Attr *attr;
   struct _Condition *condition1;
@@ -130,8 +150,9 @@ union YYSTYPE
   float floats;
 	char *position;
   struct ExpressionNode *express_node;
+  struct _Selects *selects1;
 
-#line 135 "yacc_sql.tab.h"
+#line 156 "yacc_sql.tab.h"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -141,6 +162,8 @@ typedef union YYSTYPE YYSTYPE;
 
 
 
+
 int yyparse (void *scanner);
 
+
 #endif /* !YY_YY_YACC_SQL_TAB_H_INCLUDED  */
@@ -9,6 +9,7 @@
 #include<stdio.h>
 #include<stdlib.h>
 #include<string.h>
+#include<ctype.h>
 
 typedef struct ParserContext {
   Query * ssql;
@@ -21,6 +22,10 @@ typedef struct ParserContext {
   Condition conditions[MAX_NUM];
   CompOp comp;
 	char id[MAX_NUM];
+  Selects *selects;                      // 当前正在解析的SELECT，子查询中指向子查询
+  int select_depth;
+  Selects *outer_selects[MAX_NUM];       // 外层的SELECT
+  size_t outer_condition_length[MAX_NUM]; // 进入子查询时外层已经解析的条件个数
 } ParserContext;
 
 //获取子串
@@ -104,12 +109,32 @@ ParserContext *get_context(yyscan_t scanner)
 		MIN_T
 		MAX_T
 		AVG_T
+		SUM_T
+		UNIQUE
+		INCLUDE
+		USING
+		HASH
+		ORDER
+		BY
+		ASC
+		ANALYZE
+		GROUP
+		LIMIT
+		OFFSET
+		IN
+		NOT
+		EXISTS
+		PREPARE
+		EXECUTE
+		DEALLOCATE
+		AS
         EQ
         LT
         GT
         LE
         GE
         NE
+        PARAM
 
 %union {
   struct _Attr *attr;
@@ -120,6 +145,7 @@ ParserContext *get_context(yyscan_t scanner)
   float floats;
 	char *position;
   struct ExpressionNode *express_node;
+  struct _Selects *selects1;
 }
 
 %token <number> NUMBER
@@ -136,6 +162,9 @@ ParserContext *get_context(yyscan_t scanner)
 %type <value1> value;
 %type <number> number;
 %type <express_node> expr;
+%type <number> order_direction;
+%type <number> comOp;
+%type <selects1> sub_select;
 
 %left MINUS PLUS
 %left STAR DIVIDE
@@ -150,7 +179,6 @@ commands:		//commands or sqls. parser starts here.
 command:
 	  select  
 	| select_inner_join
-	| select_aggregation_func
 	| insert
 	| update
 	| delete
@@ -158,6 +186,7 @@ command:
 	| drop_table
 	| show_tables
 	| desc_table
+	| analyze_table
 	| create_index	
 	| drop_index
 	| sync
@@ -222,11 +251,45 @@ desc_table:
     }
     ;
 
+analyze_table:
+    ANALYZE TABLE ID SEMICOLON {
+      CONTEXT->ssql->flag = SCF_ANALYZE_TABLE;
+      analyze_table_init(&CONTEXT->ssql->sstr.analyze_table, $3);
+    }
+    ;
+
 create_index:		/*create index 语句的语法解析树*/
-    CREATE INDEX ID ON ID LBRACE ID RBRACE SEMICOLON 
+    CREATE INDEX ID ON ID LBRACE ID RBRACE index_include index_using SEMICOLON 
+		{
+			CONTEXT->ssql->flag = SCF_CREATE_INDEX;//"create_index";
+			create_index_init(&CONTEXT->ssql->sstr.create_index, $3, $5, $7, 0);
+		}
+    | CREATE UNIQUE INDEX ID ON ID LBRACE ID RBRACE index_include index_using SEMICOLON
 		{
 			CONTEXT->ssql->flag = SCF_CREATE_INDEX;//"create_index";
-			create_index_init(&CONTEXT->ssql->sstr.create_index, $3, $5, $7);
+			create_index_init(&CONTEXT->ssql->sstr.create_index, $4, $6, $8, 1);
+		}
+    ;
+
+index_include:
+    /* empty */
+    | INCLUDE LBRACE index_include_attr index_include_list RBRACE
+    ;
+index_include_list:
+    /* empty */
+    | index_include_list COMMA index_include_attr
+    ;
+index_include_attr:
+    ID
+		{
+			create_index_append_include(&CONTEXT->ssql->sstr.create_index, $1);
+		}
+    ;
+index_using:
+    /* empty */
+    | USING HASH
+		{
+			create_index_set_type(&CONTEXT->ssql->sstr.create_index, HASH_INDEX);
 		}
     ;
 
@@ -328,6 +391,9 @@ value:
 			$1 = substr($1,1,strlen($1)-2);
   		value_init_string(&CONTEXT->values[CONTEXT->value_length++], $1);
 		}
+    |PARAM {
+  		value_init_param(&CONTEXT->values[CONTEXT->value_length++], CONTEXT->ssql->param_num++);
+		}
     ;
     
 delete:		/*  delete 语句的语法解析树*/
@@ -351,12 +417,12 @@ update:			/*  update 语句的语法解析树*/
 		}
     ;
 select:				/*  select 语句的语法解析树*/
-    SELECT select_attr FROM ID rel_list where SEMICOLON
+    SELECT select_attr FROM ID rel_list where group_by order_by limit SEMICOLON
 		{
 			// CONTEXT->ssql->sstr.selection.relations[CONTEXT->from_length++]=$4;
-			selects_append_relation(&CONTEXT->ssql->sstr.selection, $4);
+			selects_append_relation(CONTEXT->selects, $4);
 
-			selects_append_conditions(&CONTEXT->ssql->sstr.selection, CONTEXT->conditions, CONTEXT->condition_length);
+			selects_append_conditions(CONTEXT->selects, CONTEXT->conditions, CONTEXT->condition_length);
 
 			CONTEXT->ssql->flag=SCF_SELECT;//"select";
 			// CONTEXT->ssql->sstr.selection.attr_num = CONTEXT->select_length;
@@ -368,32 +434,35 @@ select:				/*  select 语句的语法解析树*/
 			CONTEXT->value_length = 0;
 	}
 	;
-select_aggregation_func:
-	SELECT aggregation_func_list FROM ID where SEMICOLON
-	{
-		selects_append_relation(&CONTEXT->ssql->sstr.selection, $4);
-		selects_append_conditions(&CONTEXT->ssql->sstr.selection, CONTEXT->conditions, CONTEXT->condition_length);
-		CONTEXT->ssql->flag=SCF_SELECT;//"select";
-		// CONTEXT->ssql->sstr.selection.attr_num = CONTEXT->select_length;
-
-		//临时变量清零
-		CONTEXT->condition_length=0;
-		CONTEXT->from_length=0;
-		CONTEXT->select_length=0;
-		CONTEXT->value_length = 0;
-	}
-
-aggregation_func_list:
-      aggregation_func
-	| aggregation_func_list COMMA aggregation_func;
-
+sub_select:
+    LBRACE SELECT
+		{
+			// 子查询的内容解析到新的Selects中，条件也单独收集
+			CONTEXT->outer_selects[CONTEXT->select_depth] = CONTEXT->selects;
+			CONTEXT->outer_condition_length[CONTEXT->select_depth] = CONTEXT->condition_length;
+			CONTEXT->select_depth++;
+			CONTEXT->selects = (Selects *)calloc(1, sizeof(Selects));
+		}
+    select_attr FROM ID rel_list where RBRACE
+		{
+			Selects *selects = CONTEXT->selects;
+			selects_append_relation(selects, $6);
+			CONTEXT->select_depth--;
+			size_t condition_start = CONTEXT->outer_condition_length[CONTEXT->select_depth];
+			selects_append_conditions(selects, CONTEXT->conditions + condition_start,
+					CONTEXT->condition_length - condition_start);
+			CONTEXT->condition_length = condition_start;
+			CONTEXT->selects = CONTEXT->outer_selects[CONTEXT->select_depth];
+			$$ = selects;
+		}
+	;
 aggregation_func:
 	aggregation_func_type LBRACE STAR RBRACE {
 		RelAttr attr;
 		relation_attr_init(&attr, NULL, "*");
 		Aggregation aggre;
 		aggre_init(&aggre, CONTEXT->aggre_type, &attr);
-		selects_append_aggregation(&CONTEXT->ssql->sstr.selection, &aggre);
+		selects_append_aggregation(CONTEXT->selects, &aggre);
 		
 	}
 	| aggregation_func_type LBRACE ID RBRACE {
@@ -401,7 +470,7 @@ aggregation_func:
 		relation_attr_init(&attr, NULL, $3);
 		Aggregation aggre;
 		aggre_init(&aggre, CONTEXT->aggre_type, &attr);
-		selects_append_aggregation(&CONTEXT->ssql->sstr.selection, &aggre);
+		selects_append_aggregation(CONTEXT->selects, &aggre);
 		
 	};
 
@@ -409,16 +478,17 @@ aggregation_func_type:
 	  COUNT_T{CONTEXT->aggre_type = COUNT;}
 	| MIN_T{CONTEXT->aggre_type = MIN;}
 	| MAX_T{CONTEXT->aggre_type = MAX;}
-	| AVG_T{CONTEXT->aggre_type = AVG;};
+	| AVG_T{CONTEXT->aggre_type = AVG;}
+	| SUM_T{CONTEXT->aggre_type = SUM;};
 
 
 
 select_inner_join:
 	SELECT select_attr FROM ID INNER JOIN ID ON condition inner_join_list where SEMICOLON{
 			// CONTEXT->ssql->sstr.selection.relations[CONTEXT->from_length++]=$4;
-			selects_append_relation(&CONTEXT->ssql->sstr.selection, $4);
-			selects_append_relation(&CONTEXT->ssql->sstr.selection, $7);
-			selects_append_conditions(&CONTEXT->ssql->sstr.selection, CONTEXT->conditions, CONTEXT->condition_length);
+			selects_append_relation(CONTEXT->selects, $4);
+			selects_append_relation(CONTEXT->selects, $7);
+			selects_append_conditions(CONTEXT->selects, CONTEXT->conditions, CONTEXT->condition_length);
 
 			CONTEXT->ssql->flag=SCF_SELECT;//"select";
 			// CONTEXT->ssql->sstr.selection.attr_num = CONTEXT->select_length;
@@ -433,52 +503,121 @@ select_inner_join:
 inner_join_list:
 /* empty */
 	| INNER JOIN ID ON condition condition_list inner_join_list{
-		selects_append_relation(&CONTEXT->ssql->sstr.selection, $3);
+		selects_append_relation(CONTEXT->selects, $3);
 	};
 
 select_attr:
     STAR {  
 			RelAttr attr;
 			relation_attr_init(&attr, NULL, "*");
-			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
+			selects_append_attribute(CONTEXT->selects, &attr);
+			CONTEXT->selects->item_num++;
 		}
-    | expr attr_list {
+    | expr {
+			// 列表是从右向左追加的，在这里按照从左到右的顺序计数
+			CONTEXT->selects->item_num++;
+		} attr_list {
 			// RelAttr attr;
 			// relation_attr_init(&attr, NULL, $1);
-			// selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
+			// selects_append_attribute(CONTEXT->selects, &attr);
 
-			selects_append_attr_expr(&CONTEXT->ssql->sstr.selection, $1);
+			selects_append_attr_expr(CONTEXT->selects, $1);
 		}
+    | aggregation_func attr_list
   	// | ID DOT ID attr_list {
 	// 		RelAttr attr;
 	// 		relation_attr_init(&attr, $1, $3);
-	// 		selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
+	// 		selects_append_attribute(CONTEXT->selects, &attr);
 	// 	}
     ;
 attr_list:
     /* empty */
-    | COMMA expr attr_list {
+    | COMMA expr {
+			CONTEXT->selects->item_num++;
+		} attr_list {
 			// RelAttr attr;
 			// relation_attr_init(&attr, NULL, $2);
-			// selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
-			selects_append_attr_expr(&CONTEXT->ssql->sstr.selection, $2);
+			// selects_append_attribute(CONTEXT->selects, &attr);
+			selects_append_attr_expr(CONTEXT->selects, $2);
      	  // CONTEXT->ssql->sstr.selection.attributes[CONTEXT->select_length].relation_name = NULL;
         // CONTEXT->ssql->sstr.selection.attributes[CONTEXT->select_length++].attribute_name=$2;
       }
+    | COMMA aggregation_func attr_list
     //| COMMA expr attr_list {
 			// RelAttr attr;
 			// relation_attr_init(&attr, $2, $4);
-			// selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
+			// selects_append_attribute(CONTEXT->selects, &attr);
         // CONTEXT->ssql->sstr.selection.attributes[CONTEXT->select_length].attribute_name=$4;
         // CONTEXT->ssql->sstr.selection.attributes[CONTEXT->select_length++].relation_name=$2;
   	 // }
 	// | COMMA expr attr_list
   	;
 
+group_by:
+    /* empty */
+    | GROUP BY group_item group_item_list
+    ;
+group_item_list:
+    /* empty */
+    | group_item_list COMMA group_item
+    ;
+group_item:
+    ID
+		{
+			RelAttr attr;
+			relation_attr_init(&attr, NULL, $1);
+			selects_append_group_by(CONTEXT->selects, &attr);
+		}
+    | ID DOT ID
+		{
+			RelAttr attr;
+			relation_attr_init(&attr, $1, $3);
+			selects_append_group_by(CONTEXT->selects, &attr);
+		}
+    ;
+order_by:
+    /* empty */
+    | ORDER BY order_item order_item_list
+    ;
+order_item_list:
+    /* empty */
+    | order_item_list COMMA order_item
+    ;
+order_item:
+    ID order_direction
+		{
+			RelAttr attr;
+			relation_attr_init(&attr, NULL, $1);
+			selects_append_order(CONTEXT->selects, &attr, $2);
+		}
+    | ID DOT ID order_direction
+		{
+			RelAttr attr;
+			relation_attr_init(&attr, $1, $3);
+			selects_append_order(CONTEXT->selects, &attr, $4);
+		}
+    ;
+limit:
+    /* empty */
+    | LIMIT NUMBER
+		{
+			selects_set_limit(CONTEXT->selects, $2, 0);
+		}
+    | LIMIT NUMBER OFFSET NUMBER
+		{
+			selects_set_limit(CONTEXT->selects, $2, $4);
+		}
+    ;
+order_direction:
+    /* empty */ { $$ = 1; }
+    | ASC { $$ = 1; }
+    | DESC { $$ = 0; }
+    ;
+
 rel_list:
     /* empty */
     | COMMA ID rel_list {	
-				selects_append_relation(&CONTEXT->ssql->sstr.selection, $2);
+				selects_append_relation(CONTEXT->selects, $2);
 		  }
     ;
 expr:
@@ -563,7 +702,37 @@ condition:
 	    {
 			fprintf(stdout, "expr comOp expr\n");
 			Condition condition;
-			condition_init(&condition, CONTEXT->comp, $1, $3);
+			condition_init(&condition, $2, $1, $3);
+			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
+		}
+    | expr comOp sub_select
+		{
+			Condition condition;
+			condition_init_subquery(&condition, $2, $1, $3);
+			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
+		}
+    | expr IN sub_select
+		{
+			Condition condition;
+			condition_init_subquery(&condition, IN_OP, $1, $3);
+			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
+		}
+    | expr NOT IN sub_select
+		{
+			Condition condition;
+			condition_init_subquery(&condition, NOT_IN_OP, $1, $4);
+			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
+		}
+    | EXISTS sub_select
+		{
+			Condition condition;
+			condition_init_subquery(&condition, EXISTS_OP, NULL, $2);
+			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
+		}
+    | NOT EXISTS sub_select
+		{
+			Condition condition;
+			condition_init_subquery(&condition, NOT_EXISTS_OP, NULL, $3);
 			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 		}
 
@@ -714,12 +883,12 @@ condition:
     ;
 
 comOp:
-  	  EQ { CONTEXT->comp = EQUAL_TO; }
-    | LT { CONTEXT->comp = LESS_THAN; }
-    | GT { CONTEXT->comp = GREAT_THAN; }
-    | LE { CONTEXT->comp = LESS_EQUAL; }
-    | GE { CONTEXT->comp = GREAT_EQUAL; }
-    | NE { CONTEXT->comp = NOT_EQUAL; }
+  	  EQ { CONTEXT->comp = EQUAL_TO; $$ = EQUAL_TO; }
+    | LT { CONTEXT->comp = LESS_THAN; $$ = LESS_THAN; }
+    | GT { CONTEXT->comp = GREAT_THAN; $$ = GREAT_THAN; }
+    | LE { CONTEXT->comp = LESS_EQUAL; $$ = LESS_EQUAL; }
+    | GE { CONTEXT->comp = GREAT_EQUAL; $$ = GREAT_EQUAL; }
+    | NE { CONTEXT->comp = NOT_EQUAL; $$ = NOT_EQUAL; }
     ;
 
 load_data:
@@ -740,8 +909,170 @@ int sql_parse(const char *s, Query *sqls){
 	yyscan_t scanner;
 	yylex_init_extra(&context, &scanner);
 	context.ssql = sqls;
+	context.selects = &sqls->sstr.selection;
 	scan_string(s, scanner);
 	int result = yyparse(scanner);
 	yylex_destroy(scanner);
 	return result;
 }
+
+/**
+ * 把SQL中的常量换成参数?，作为执行计划缓存的key。LIMIT/OFFSET后面的数字不是常量，保留原样，
+ * 记号之间只保留一个空格，关键字换成大写
+ * 换掉的常量按出现的顺序放到values中，与解析normalized得到的参数一一对应
+ * @return 0 成功，normalized由调用者free；
+ *         -1 不是SELECT/INSERT/UPDATE/DELETE、本来就有参数或者常量超过max_value_num，values中的常量已经释放
+ */
+int sql_normalize(const char *s, char **normalized, Value values[], int max_value_num, int *value_num)
+{
+	ParserContext context;
+	memset(&context, 0, sizeof(context));
+
+	yyscan_t scanner;
+	yylex_init_extra(&context, &scanner);
+	scan_string(s, scanner);
+
+	// 每个记号后面加一个空格，常量换成?不会变长
+	char *buffer = malloc(strlen(s) * 2 + 1);
+	size_t length = 0;
+	int result = 0;
+	int count = 0;
+	int previous = 0;
+	int token;
+	YYSTYPE lval;
+	while (result == 0 && (token = yylex(&lval, scanner)) != 0) {
+		if (previous == 0 && token != SELECT && token != INSERT && token != UPDATE && token != DELETE) {
+			result = -1;
+		}
+		const char *text = yyget_text(scanner);
+		int is_value = 0;
+		if ((token == NUMBER && previous != LIMIT && previous != OFFSET) || token == FLOAT || token == SSS) {
+			is_value = 1;
+			if (count >= max_value_num) {
+				result = -1;
+			} else if (token == NUMBER) {
+				value_init_integer(&values[count++], lval.number);
+			} else if (token == FLOAT) {
+				value_init_float(&values[count++], lval.floats);
+			} else {
+				char *str = substr(lval.string, 1, strlen(lval.string) - 2);
+				value_init_string(&values[count++], str);
+				free(str);
+			}
+		} else if (token == PARAM) {
+			result = -1;
+		}
+		if (token == ID || token == SSS) {
+			free(lval.string);
+		}
+
+		// 关键字不区分大小写，统一成大写
+		text = is_value ? "?" : text;
+		for (const char *c = text; *c != '\0'; c++) {
+			buffer[length++] = token == ID ? *c : toupper(*c);
+		}
+		buffer[length++] = ' ';
+		previous = token;
+	}
+	yylex_destroy(scanner);
+
+	if (result != 0 || length == 0) {
+		for (int i = 0; i < count; i++) {
+			value_destroy(&values[i]);
+		}
+		free(buffer);
+		return -1;
+	}
+	buffer[length - 1] = '\0';
+	*normalized = buffer;
+	*value_num = count;
+	return 0;
+}
+
+static void free_token_string(int token, YYSTYPE *lval)
+{
+	if (token == ID || token == SSS) {
+		free(lval->string);
+	}
+}
+
+/**
+ * 只用词法分析识别 PREPARE name AS statement、EXECUTE name [(value, ...)] 和 DEALLOCATE name，
+ * 执行预处理语句时只需要读出参数的值，不用再做语法分析
+ * @return 0 成功，或者不是这几种语句（type是PREPARED_NONE）；-1 语法错误
+ */
+int sql_parse_prepared_command(const char *s, PreparedCommand *command)
+{
+	memset(command, 0, sizeof(*command));
+
+	ParserContext context;
+	memset(&context, 0, sizeof(context));
+
+	yyscan_t scanner;
+	yylex_init_extra(&context, &scanner);
+	scan_string(s, scanner);
+
+	YYSTYPE lval;
+	int token = yylex(&lval, scanner);
+	// 词法分析的缓冲区是s的副本，用第一个记号的位置换算出记号在s中的位置
+	const char *base = yyget_text(scanner) - strspn(s, " \t\b\f\n");
+	switch (token) {
+		case PREPARE: command->type = PREPARED_PREPARE; break;
+		case EXECUTE: command->type = PREPARED_EXECUTE; break;
+		case DEALLOCATE: command->type = PREPARED_DEALLOCATE; break;
+		default: {
+			free_token_string(token, &lval);
+			yylex_destroy(scanner);
+			return 0;
+		}
+	}
+
+	int result = -1;
+	token = yylex(&lval, scanner);
+	if (token == ID) {
+		command->name = lval.string;
+		token = yylex(&lval, scanner);
+		if (command->type == PREPARED_PREPARE) {
+			if (token == AS) {
+				command->sql = s + (yyget_text(scanner) + yyget_leng(scanner) - base);
+				result = 0;
+			}
+		} else if (command->type == PREPARED_EXECUTE && token == LBRACE) {
+			// 参数之间用逗号分隔，只能是常量
+			int expect_value = 1;
+			while ((token = yylex(&lval, scanner)) != 0) {
+				if (expect_value && (token == NUMBER || token == FLOAT || token == SSS) && command->value_num < MAX_NUM) {
+					Value *value = &command->values[command->value_num++];
+					if (token == NUMBER) {
+						value_init_integer(value, lval.number);
+					} else if (token == FLOAT) {
+						value_init_float(value, lval.floats);
+					} else {
+						char *str = substr(lval.string, 1, strlen(lval.string) - 2);
+						value_init_string(value, str);
+						free(str);
+					}
+					expect_value = 0;
+				} else if (!expect_value && token == COMMA) {
+					expect_value = 1;
+				} else {
+					break;
+				}
+				free_token_string(token, &lval);
+			}
+			if (token == RBRACE && (!expect_value || command->value_num == 0)) {
+				token = yylex(&lval, scanner);
+				result = (token == SEMICOLON || token == 0) ? 0 : -1;
+			}
+		} else {
+			result = (token == SEMICOLON || token == 0) ? 0 : -1;
+		}
+	}
+	free_token_string(token, &lval);
+	yylex_destroy(scanner);
+
+	if (result != 0) {
+		prepared_command_destroy(command);
+	}
+	return result;
+}
@@ -0,0 +1,425 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/parser/parse.h"
+#include "sql/stmt/stmt.h"
+#include "storage/common/db.h"
+#include "common/log/log.h"
+#include "common/metrics/metrics.h"
+#include "common/metrics/metrics_registry.h"
+
+using namespace common;
+
+namespace {
+
+const int MAX_PARAM_NUM = MAX_NUM * 4;
+
+/**
+ * 从启动开始的命中率，MetricsStage定期输出
+ */
+class PlanCacheHitRatio : public Gauge
+{
+public:
+  PlanCacheHitRatio()
+  {
+    set_snapshot(new SnapshotBasic<double>());
+  }
+
+  void snapshot() override
+  {
+    const long hits = PlanCache::instance().hit_count();
+    const long total = hits + PlanCache::instance().miss_count();
+    double ratio = total == 0 ? 0 : (double)hits / total;
+    static_cast<SnapshotBasic<double> *>(snapshot_value_)->setValue(ratio);
+  }
+};
+
+struct PlanCacheMetrics {
+  PlanCacheMetrics()
+  {
+    MetricsRegistry &metrics_registry = get_metrics_registry();
+    metrics_registry.register_metric("plan_cache.hit", hit);
+    metrics_registry.register_metric("plan_cache.miss", miss);
+    metrics_registry.register_metric("plan_cache.stmt_reuse", stmt_reuse);
+    metrics_registry.register_metric("plan_cache.invalidate", invalidate);
+    metrics_registry.register_metric("plan_cache.hit_ratio", hit_ratio);
+  }
+
+  Meter *hit = new Meter();         // 跳过了解析
+  Meter *miss = new Meter();
+  Meter *stmt_reuse = new Meter();  // 常量也相同，跳过了resolve
+  Meter *invalidate = new Meter();
+  PlanCacheHitRatio *hit_ratio = new PlanCacheHitRatio();
+};
+
+PlanCacheMetrics &plan_cache_metrics()
+{
+  static PlanCacheMetrics metrics;
+  return metrics;
+}
+
+bool value_equal(const Value &value, const Value &other)
+{
+  if (value.type != other.type) {
+    return false;
+  }
+  switch (value.type) {
+    case INTS:
+      return 0 == memcmp(value.data, other.data, sizeof(int));
+    case FLOATS:
+      return 0 == memcmp(value.data, other.data, sizeof(float));
+    case CHARS:
+      return 0 == strcmp((const char *)value.data, (const char *)other.data);
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+CachedPlan::CachedPlan(const std::string &key, Query *query) : key_(key), query_(query)
+{
+  params_.resize(query->param_num);
+  switch (query->flag) {
+    case SCF_SELECT: {
+      collect_params(query->sstr.selection);
+    } break;
+    case SCF_INSERT: {
+      Inserts &inserts = query->sstr.insertion;
+      tables_.push_back(inserts.relation_name);
+      for (size_t i = 0; i < inserts.value_num; i++) {
+        add_param(inserts.values[i]);
+      }
+    } break;
+    case SCF_UPDATE: {
+      Updates &updates = query->sstr.update;
+      tables_.push_back(updates.relation_name);
+      add_param(updates.value);
+      for (size_t i = 0; i < updates.condition_num; i++) {
+        collect_params(updates.conditions[i]);
+      }
+    } break;
+    case SCF_DELETE: {
+      Deletes &deletes = query->sstr.deletion;
+      tables_.push_back(deletes.relation_name);
+      for (size_t i = 0; i < deletes.condition_num; i++) {
+        collect_params(deletes.conditions[i]);
+      }
+    } break;
+    default: {
+    } break;
+  }
+  std::sort(tables_.begin(), tables_.end());
+  tables_.erase(std::unique(tables_.begin(), tables_.end()), tables_.end());
+
+  // 参数的序号已经记下来了，解析时分配的内存不再需要
+  for (std::vector<Value *> &locations : params_) {
+    if (!locations.empty()) {
+      free(locations[0]->data);
+    }
+    for (Value *location : locations) {
+      location->data = nullptr;
+    }
+  }
+}
+
+CachedPlan::~CachedPlan()
+{
+  delete stmt_;
+  stmt_ = nullptr;
+  clear_values();
+  query_destroy(query_);
+  query_ = nullptr;
+}
+
+void CachedPlan::collect_params(Selects &selects)
+{
+  for (size_t i = 0; i < selects.relation_num; i++) {
+    tables_.push_back(selects.relations[i]);
+  }
+  for (size_t i = 0; i < selects.condition_num; i++) {
+    collect_params(selects.conditions[i]);
+  }
+  for (size_t i = 0; i < selects.expr_size; i++) {
+    collect_params(selects.expr[i]);
+  }
+}
+
+void CachedPlan::collect_params(Condition &condition)
+{
+  if (condition.left_is_value) {
+    add_param(condition.left_value);
+  }
+  if (condition.right_is_value) {
+    add_param(condition.right_value);
+  }
+  collect_params(condition.left_expr);
+  collect_params(condition.right_expr);
+  if (condition.sub_select != nullptr) {
+    collect_params(*condition.sub_select);
+  }
+}
+
+void CachedPlan::collect_params(ExpressionNode &expr)
+{
+  if (expr.is_value) {
+    add_param(expr.value);
+  }
+  if (expr.left != nullptr) {
+    collect_params(*expr.left);
+  }
+  if (expr.right != nullptr) {
+    collect_params(*expr.right);
+  }
+}
+
+void CachedPlan::add_param(Value &value)
+{
+  if (value.type != UNDEFINED || value.data == nullptr) {
+    return;
+  }
+  const int index = *(const int *)value.data;
+  if (index >= 0 && index < (int)params_.size()) {
+    params_[index].push_back(&value);
+  }
+}
+
+void CachedPlan::clear_values()
+{
+  for (std::vector<Value *> &locations : params_) {
+    for (Value *location : locations) {
+      location->type = UNDEFINED;
+      location->data = nullptr;
+    }
+  }
+  for (Value &value : values_) {
+    value_destroy(&value);
+  }
+  values_.clear();
+}
+
+void CachedPlan::reset_stmt()
+{
+  delete stmt_;
+  stmt_ = nullptr;
+}
+
+RC CachedPlan::bind(Db *db, std::vector<Value> &values, bool &reused)
+{
+  reused = stmt_ != nullptr && values.size() == values_.size() &&
+           std::equal(values.begin(), values.end(), values_.begin(), value_equal);
+  if (reused) {
+    for (Value &value : values) {
+      value_destroy(&value);
+    }
+    values.clear();
+    return RC::SUCCESS;
+  }
+
+  if (values.size() != params_.size()) {
+    LOG_WARN("parameter number mismatch. params=%d, values=%d", (int)params_.size(), (int)values.size());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // Stmt中引用了上一次的常量，先删除Stmt再释放常量
+  delete stmt_;
+  stmt_ = nullptr;
+  clear_values();
+  values_.swap(values);
+  for (size_t i = 0; i < params_.size(); i++) {
+    for (Value *location : params_[i]) {
+      *location = values_[i];
+    }
+  }
+
+  RC rc = Stmt::create_stmt(db, *query_, stmt_);
+  if (rc != RC::SUCCESS) {
+    LOG_TRACE("failed to resolve cached plan. rc=%s", strrc(rc));
+    stmt_ = nullptr;
+  }
+  return rc;
+}
+
+PlanCache &PlanCache::instance()
+{
+  static PlanCache plan_cache;
+  return plan_cache;
+}
+
+void PlanCache::set_capacity(size_t capacity)
+{
+  std::lock_guard<std::mutex> lock_guard(mutex_);
+  capacity_ = capacity;
+  while (plans_.size() > capacity_) {
+    CachedPlan *plan = plans_.back();
+    plan_map_.erase(plan->key());
+    plans_.pop_back();
+    delete plan;
+  }
+}
+
+size_t PlanCache::size()
+{
+  std::lock_guard<std::mutex> lock_guard(mutex_);
+  return plans_.size();
+}
+
+uint64_t PlanCache::table_version(const std::string &db_table)
+{
+  auto iter = table_versions_.find(db_table);
+  return iter == table_versions_.end() ? 0 : iter->second;
+}
+
+bool PlanCache::is_valid(CachedPlan *plan)
+{
+  const std::string db_name = plan->key().substr(0, plan->key().find(':'));
+  const std::vector<std::string> &tables = plan->tables();
+  std::vector<uint64_t> &versions = plan->table_versions();
+  for (size_t i = 0; i < tables.size() && i < versions.size(); i++) {
+    if (versions[i] != table_version(db_name + "." + tables[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+CachedPlan *PlanCache::take(const std::string &key)
+{
+  std::lock_guard<std::mutex> lock_guard(mutex_);
+  auto iter = plan_map_.find(key);
+  if (iter == plan_map_.end()) {
+    return nullptr;
+  }
+  CachedPlan *plan = *iter->second;
+  plans_.erase(iter->second);
+  plan_map_.erase(iter);
+  if (!is_valid(plan)) {
+    plan_cache_metrics().invalidate->inc();
+    delete plan;
+    return nullptr;
+  }
+  return plan;
+}
+
+CachedPlan *PlanCache::acquire(Db *db, const char *sql)
+{
+  if (capacity_ == 0) {
+    return nullptr;
+  }
+
+  Value values[MAX_PARAM_NUM];
+  int value_num = 0;
+  char *normalized = nullptr;
+  if (0 != sql_normalize(sql, &normalized, values, MAX_PARAM_NUM, &value_num)) {
+    return nullptr;
+  }
+  const std::string key = std::string(db->name()) + ":" + normalized;
+  std::vector<Value> bind_values(values, values + value_num);
+
+  CachedPlan *plan = take(key);
+  if (plan != nullptr) {
+    hit_count_++;
+    plan_cache_metrics().hit->inc();
+  } else {
+    miss_count_++;
+    plan_cache_metrics().miss->inc();
+
+    Query *query = query_create();
+    if (parse(normalized, query) != RC::SUCCESS || query->param_num != bind_values.size()) {
+      query_destroy(query);
+      for (Value &value : bind_values) {
+        value_destroy(&value);
+      }
+      free(normalized);
+      return nullptr;
+    }
+    plan = new CachedPlan(key, query);
+  }
+  free(normalized);
+
+  bool reused = false;
+  RC rc = bind(db, plan, bind_values, reused);
+  if (rc != RC::SUCCESS) {
+    delete plan;
+    return nullptr;
+  }
+  return plan;
+}
+
+RC PlanCache::bind(Db *db, CachedPlan *plan, std::vector<Value> &values, bool &reused)
+{
+  {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    if (!is_valid(plan)) {
+      plan->reset_stmt();
+    }
+    std::vector<uint64_t> &versions = plan->table_versions();
+    versions.clear();
+    for (const std::string &table : plan->tables()) {
+      versions.push_back(table_version(std::string(db->name()) + "." + table));
+    }
+  }
+
+  RC rc = plan->bind(db, values, reused);
+  if (rc == RC::SUCCESS && reused) {
+    plan_cache_metrics().stmt_reuse->inc();
+  }
+  return rc;
+}
+
+void PlanCache::release(CachedPlan *plan)
+{
+  std::lock_guard<std::mutex> lock_guard(mutex_);
+  if (!is_valid(plan)) {
+    plan_cache_metrics().invalidate->inc();
+    delete plan;
+    return;
+  }
+
+  // 并发执行同一条语句时可能已经放回了一份
+  auto iter = plan_map_.find(plan->key());
+  if (iter != plan_map_.end()) {
+    delete *iter->second;
+    plans_.erase(iter->second);
+    plan_map_.erase(iter);
+  }
+  plans_.push_front(plan);
+  plan_map_[plan->key()] = plans_.begin();
+
+  while (plans_.size() > capacity_) {
+    CachedPlan *last = plans_.back();
+    plan_map_.erase(last->key());
+    plans_.pop_back();
+    delete last;
+  }
+}
+
+void PlanCache::invalidate(const char *db_name, const char *table_name)
+{
+  std::lock_guard<std::mutex> lock_guard(mutex_);
+  table_versions_[std::string(db_name) + "." + table_name]++;
+
+  for (auto iter = plans_.begin(); iter != plans_.end();) {
+    CachedPlan *plan = *iter;
+    if (is_valid(plan)) {
+      ++iter;
+      continue;
+    }
+    plan_cache_metrics().invalidate->inc();
+    plan_map_.erase(plan->key());
+    iter = plans_.erase(iter);
+    delete plan;
+  }
+}
@@ -0,0 +1,153 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sql/parser/parse_defs.h"
+#include "rc.h"
+
+class Db;
+class Stmt;
+
+/**
+ * 缓存的一条语句。模板是SQL中的常量换成参数?之后解析得到的Query，
+ * 执行时把这一次的常量填到参数出现的位置上。常量与上一次相同时直接复用resolve好的Stmt，
+ * 不同时跳过词法和语法分析，只重新resolve
+ */
+class CachedPlan
+{
+public:
+  CachedPlan(const std::string &key, Query *query);
+  ~CachedPlan();
+
+  const std::string &key() const
+  {
+    return key_;
+  }
+  Query *query() const
+  {
+    return query_;
+  }
+  Stmt *stmt() const
+  {
+    return stmt_;
+  }
+  /**
+   * 语句引用的表，包括子查询中的
+   */
+  const std::vector<std::string> &tables() const
+  {
+    return tables_;
+  }
+  std::vector<uint64_t> &table_versions()
+  {
+    return table_versions_;
+  }
+  /**
+   * 当前绑定的常量，按参数的顺序
+   */
+  const std::vector<Value> &values() const
+  {
+    return values_;
+  }
+
+  /**
+   * 绑定参数并resolve
+   * @param values 个数与参数相同，常量的内存交给CachedPlan管理
+   * @param reused 常量与上一次相同，没有重新resolve
+   */
+  RC bind(Db *db, std::vector<Value> &values, bool &reused);
+  /**
+   * 丢掉resolve的结果，下一次bind时重新resolve
+   */
+  void reset_stmt();
+
+private:
+  void collect_params(Selects &selects);
+  void collect_params(Condition &condition);
+  void collect_params(ExpressionNode &expr);
+  void add_param(Value &value);
+  void clear_values();
+
+private:
+  std::string key_;
+  Query *query_ = nullptr;
+  std::vector<std::vector<Value *>> params_;  // 每个参数在模板中出现的位置，解析时值被复制到了多个地方
+  std::vector<Value> values_;                 // 当前绑定的常量
+  Stmt *stmt_ = nullptr;
+  std::vector<std::string> tables_;
+  std::vector<uint64_t> table_versions_;  // resolve时这些表的版本，DDL之后版本变化，Stmt不能再用
+};
+
+/**
+ * 执行计划缓存，按照数据库名和换掉常量之后的SQL查找。
+ * 取出的CachedPlan由使用者独占，用完之后再放回，同一条语句并发执行时各自解析一份。
+ * 对表执行DDL时表的版本加一，引用这个表的计划都会失效
+ */
+class PlanCache
+{
+public:
+  static PlanCache &instance();
+
+  void set_capacity(size_t capacity);
+
+  /**
+   * 返回绑定好这一次的常量并且resolve好的计划，用完之后调用release放回
+   * @return 不能缓存的语句（不是增删改查、解析或者resolve失败）返回nullptr，按照原来的流程处理
+   */
+  CachedPlan *acquire(Db *db, const char *sql);
+  void release(CachedPlan *plan);
+
+  /**
+   * 绑定参数并resolve，引用的表在上一次resolve之后有过DDL时一定重新resolve。
+   * 不在缓存中的计划（例如会话中PREPARE的语句）也用它执行
+   */
+  RC bind(Db *db, CachedPlan *plan, std::vector<Value> &values, bool &reused);
+
+  /**
+   * 表结构或者索引变化之后调用
+   */
+  void invalidate(const char *db_name, const char *table_name);
+
+  uint64_t table_version(const std::string &db_table);
+
+  long hit_count() const
+  {
+    return hit_count_.load();
+  }
+  long miss_count() const
+  {
+    return miss_count_.load();
+  }
+  size_t size();
+
+private:
+  PlanCache() = default;
+
+  CachedPlan *take(const std::string &key);
+  bool is_valid(CachedPlan *plan);
+
+private:
+  std::mutex mutex_;
+  size_t capacity_ = 1024;
+  std::list<CachedPlan *> plans_;  // 最近使用的在前面
+  std::unordered_map<std::string, std::list<CachedPlan *>::iterator> plan_map_;
+  std::unordered_map<std::string, uint64_t> table_versions_;  // key是 db.table
+
+  std::atomic<long> hit_count_{0};
+  std::atomic<long> miss_count_{0};
+};
@@ -22,9 +22,17 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/seda/timer_stage.h"
+#include "event/sql_event.h"
+#include "event/session_event.h"
+#include "session/session.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/parser/parse.h"
+#include "storage/common/db.h"
 
 using namespace common;
 
+const char *CONF_PLAN_CACHE_CAPACITY = "PlanCacheCapacity";
+
 //! Constructor
 PlanCacheStage::PlanCacheStage(const char *tag) : Stage(tag)
 {}
@@ -48,14 +56,17 @@ Stage *PlanCacheStage::make_stage(const std::string &tag)
 //! Set properties for this object set in stage specific properties
 bool PlanCacheStage::set_properties()
 {
-  //  std::string stageNameStr(stage_name_);
-  //  std::map<std::string, std::string> section = g_properties()->get(
-  //    stageNameStr);
-  //
-  //  std::map<std::string, std::string>::iterator it;
-  //
-  //  std::string key;
-
+  std::string stageNameStr(stage_name_);
+  std::map<std::string, std::string> section = get_properties()->get(stageNameStr);
+
+  std::map<std::string, std::string>::iterator iter = section.find(CONF_PLAN_CACHE_CAPACITY);
+  if (iter != section.end()) {
+    int capacity = 0;
+    if (str_to_val(iter->second, capacity) && capacity >= 0) {
+      PlanCache::instance().set_capacity(capacity);
+      LOG_INFO("Plan cache holds at most %d statements", capacity);
+    }
+  }
   return true;
 }
 
@@ -65,8 +76,13 @@ bool PlanCacheStage::initialize()
   LOG_TRACE("Enter");
 
   std::list<Stage *>::iterator stgp = next_stage_list_.begin();
-  //  execute_stage = *(stgp++);
   parse_stage_ = *(stgp++);
+  if (stgp != next_stage_list_.end()) {
+    query_cache_stage_ = *(stgp++);
+  } else {
+    LOG_WARN("QueryCacheStage is not configured after PlanCacheStage, plan cache is disabled");
+    PlanCache::instance().set_capacity(0);
+  }
 
   LOG_TRACE("Exit");
   return true;
@@ -84,31 +100,145 @@ void PlanCacheStage::handle_event(StageEvent *event)
 {
   LOG_TRACE("Enter\n");
 
-  // Add callback to update plan cache
-  /*
-  CompletionCallback *cb = new (std::nothrow) CompletionCallback(this, nullptr);
-  if (cb == nullptr) {
-    LOG_ERROR("Failed to new callback for SQLStageEvent");
-    event->done_immediate();
+  SQLStageEvent *sql_event = static_cast<SQLStageEvent *>(event);
+  SessionEvent *session_event = sql_event->session_event();
+  Db *db = session_event->session()->get_current_db();
+  if (db == nullptr || query_cache_stage_ == nullptr) {
+    parse_stage_->handle_event(event);
+    LOG_TRACE("Exit\n");
+    return;
+  }
+
+  PreparedCommand command;
+  if (0 != sql_parse_prepared_command(sql_event->sql().c_str(), &command)) {
+    finish_event(sql_event, "Failed to parse sql\n");
+    LOG_TRACE("Exit\n");
+    return;
+  }
+  if (command.type != PREPARED_NONE) {
+    handle_prepared_command(sql_event, command);
+    prepared_command_destroy(&command);
+    LOG_TRACE("Exit\n");
+    return;
+  }
+
+  CachedPlan *plan = PlanCache::instance().acquire(db, sql_event->sql().c_str());
+  if (plan == nullptr) {
+    // 不能缓存的语句，以及解析或者resolve失败的语句，都按原来的流程处理
+    parse_stage_->handle_event(event);
+    LOG_TRACE("Exit\n");
     return;
   }
 
-  event->push_callback(cb);
-   */
-  // do nothing here, pass the event to the next stage
-  parse_stage_->handle_event(event);
+  // 跳过解析和resolve，执行完之后把计划放回缓存
+  execute_plan(sql_event, plan);
+  PlanCache::instance().release(plan);
+  sql_event->done_immediate();
 
   LOG_TRACE("Exit\n");
   return;
 }
 
-void PlanCacheStage::callback_event(StageEvent *event, CallbackContext *context)
+void PlanCacheStage::handle_prepared_command(SQLStageEvent *sql_event, PreparedCommand &command)
 {
-  LOG_TRACE("Enter\n");
+  Session *session = sql_event->session_event()->session();
+  Db *db = session->get_current_db();
+  switch (command.type) {
+    case PREPARED_PREPARE: {
+      Query *query = query_create();
+      if (parse(command.sql, query) != RC::SUCCESS) {
+        query_destroy(query);
+        finish_event(sql_event, "Failed to parse sql\n");
+        return;
+      }
+      if (query->flag != SCF_SELECT && query->flag != SCF_INSERT && query->flag != SCF_UPDATE &&
+          query->flag != SCF_DELETE) {
+        LOG_WARN("only select/insert/update/delete can be prepared. flag=%d", query->flag);
+        query_destroy(query);
+        finish_event(sql_event, "FAILURE\n");
+        return;
+      }
+
+      CachedPlan *plan = new CachedPlan(std::string(db->name()) + ":" + command.sql, query);
+      RC rc = RC::SUCCESS;
+      for (const std::string &table : plan->tables()) {
+        if (db->find_table(table.c_str()) == nullptr) {
+          LOG_WARN("no such table. db=%s, table_name=%s", db->name(), table.c_str());
+          rc = RC::SCHEMA_TABLE_NOT_EXIST;
+        }
+      }
+      // 参数的类型要到EXECUTE时才知道，没有参数的语句现在就resolve
+      if (rc == RC::SUCCESS && query->param_num == 0) {
+        std::vector<Value> values;
+        bool reused = false;
+        rc = PlanCache::instance().bind(db, plan, values, reused);
+      }
+      if (rc != RC::SUCCESS) {
+        delete plan;
+        finish_event(sql_event, "FAILURE\n");
+        return;
+      }
+      session->add_prepared_plan(command.name, plan);
+      finish_event(sql_event, "SUCCESS\n");
+    } break;
+
+    case PREPARED_EXECUTE: {
+      CachedPlan *plan = session->find_prepared_plan(command.name);
+      if (plan == nullptr) {
+        LOG_WARN("no such prepared statement: %s", command.name);
+        finish_event(sql_event, "FAILURE\n");
+        return;
+      }
+
+      // 参数的值交给计划管理
+      std::vector<Value> values(command.values, command.values + command.value_num);
+      command.value_num = 0;
+      bool reused = false;
+      RC rc = PlanCache::instance().bind(db, plan, values, reused);
+      for (Value &value : values) {
+        value_destroy(&value);
+      }
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to execute prepared statement %s. rc=%s", command.name, strrc(rc));
+        finish_event(sql_event, "FAILURE\n");
+        return;
+      }
+      execute_plan(sql_event, plan);
+      sql_event->done_immediate();
+    } break;
+
+    case PREPARED_DEALLOCATE: {
+      finish_event(sql_event, session->remove_prepared_plan(command.name) ? "SUCCESS\n" : "FAILURE\n");
+    } break;
+
+    default: {
+    } break;
+  }
+}
+
+void PlanCacheStage::execute_plan(SQLStageEvent *sql_event, CachedPlan *plan)
+{
+  sql_event->set_query(plan->query());
+  sql_event->set_stmt(plan->stmt());
+  sql_event->set_plan(plan);
+  query_cache_stage_->handle_event(sql_event);
+  sql_event->session_event()->done_immediate();
+
+  sql_event->set_query(nullptr);
+  sql_event->set_stmt(nullptr);
+  sql_event->set_plan(nullptr);
+}
 
-  // update execute plan here
-  // event->done_immediate();
+void PlanCacheStage::finish_event(SQLStageEvent *sql_event, const char *response)
+{
+  sql_event->session_event()->set_response(response);
+  sql_event->session_event()->done_immediate();
+  sql_event->done_immediate();
+}
 
+void PlanCacheStage::callback_event(StageEvent *event, CallbackContext *context)
+{
+  LOG_TRACE("Enter\n");
   LOG_TRACE("Exit\n");
   return;
 }
@@ -16,6 +16,10 @@ See the Mulan PSL v2 for more details. */
 #define __OBSERVER_SQL_PLAN_CACHE_STAGE_H__
 
 #include "common/seda/stage.h"
+#include "sql/parser/parse_defs.h"
+
+class SQLStageEvent;
+class CachedPlan;
 
 class PlanCacheStage : public common::Stage {
 public:
@@ -33,8 +37,14 @@ protected:
   void callback_event(common::StageEvent *event, common::CallbackContext *context);
 
 protected:
+private:
+  void handle_prepared_command(SQLStageEvent *sql_event, PreparedCommand &command);
+  void execute_plan(SQLStageEvent *sql_event, CachedPlan *plan);
+  void finish_event(SQLStageEvent *sql_event, const char *response);
+
 private:
   Stage *parse_stage_ = nullptr;
+  Stage *query_cache_stage_ = nullptr;
 };
 
 #endif  //__OBSERVER_SQL_PLAN_CACHE_STAGE_H__
@@ -0,0 +1,182 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <iterator>
+
+#include "sql/query_cache/query_cache.h"
+#include "storage/common/db.h"
+#include "storage/common/table.h"
+#include "common/log/log.h"
+#include "common/metrics/metrics.h"
+#include "common/metrics/metrics_registry.h"
+
+using namespace common;
+
+namespace {
+
+struct QueryCacheMetrics {
+  QueryCacheMetrics()
+  {
+    MetricsRegistry &metrics_registry = get_metrics_registry();
+    metrics_registry.register_metric("query_cache.hit", hit);
+    metrics_registry.register_metric("query_cache.miss", miss);
+    metrics_registry.register_metric("query_cache.invalidate", invalidate);
+    metrics_registry.register_metric("query_cache.evict", evict);
+  }
+
+  Meter *hit = new Meter();
+  Meter *miss = new Meter();
+  Meter *invalidate = new Meter();  // 表修改过，结果过期
+  Meter *evict = new Meter();       // 内存不够被淘汰
+};
+
+QueryCacheMetrics &query_cache_metrics()
+{
+  static QueryCacheMetrics metrics;
+  return metrics;
+}
+
+}  // namespace
+
+size_t QueryCache::CachedResult::memory_size() const
+{
+  size_t size = sizeof(CachedResult) + key.size() * 2 + result.size() + table_versions.size() * sizeof(uint64_t);
+  for (const std::string &table : tables) {
+    size += sizeof(std::string) + table.size();
+  }
+  return size;
+}
+
+QueryCache &QueryCache::instance()
+{
+  static QueryCache query_cache;
+  return query_cache;
+}
+
+void QueryCache::set_memory_limit(size_t memory_limit)
+{
+  std::lock_guard<std::mutex> lock_guard(mutex_);
+  memory_limit_.store(memory_limit);
+  evict();
+}
+
+std::string QueryCache::make_key(const std::string &statement, const std::vector<Value> &values)
+{
+  // 每个常量前面加上类型，字符串带上结尾的0，不同的常量序列不会得到相同的key
+  std::string key = statement;
+  for (const Value &value : values) {
+    key.push_back('\0');
+    key.push_back((char)value.type);
+    switch (value.type) {
+      case INTS:
+      case FLOATS: {
+        key.append((const char *)value.data, 4);
+      } break;
+      case CHARS:
+      case DATES: {
+        key.append((const char *)value.data, strlen((const char *)value.data) + 1);
+      } break;
+      default: {
+      } break;
+    }
+  }
+  return key;
+}
+
+bool QueryCache::table_versions(Db *db, const std::vector<std::string> &tables, std::vector<uint64_t> &versions)
+{
+  versions.clear();
+  for (const std::string &table_name : tables) {
+    Table *table = db->find_table(table_name.c_str());
+    if (table == nullptr) {
+      return false;
+    }
+    versions.push_back(table->modify_version());
+  }
+  return true;
+}
+
+bool QueryCache::get(Db *db, const std::string &key, std::string &result)
+{
+  std::lock_guard<std::mutex> lock_guard(mutex_);
+  auto iter = result_map_.find(key);
+  if (iter == result_map_.end()) {
+    miss_count_++;
+    query_cache_metrics().miss->inc();
+    return false;
+  }
+
+  std::vector<uint64_t> versions;
+  if (!table_versions(db, iter->second->tables, versions) || versions != iter->second->table_versions) {
+    erase(iter->second);
+    miss_count_++;
+    query_cache_metrics().invalidate->inc();
+    query_cache_metrics().miss->inc();
+    return false;
+  }
+
+  results_.splice(results_.begin(), results_, iter->second);
+  result = iter->second->result;
+  hit_count_++;
+  query_cache_metrics().hit->inc();
+  return true;
+}
+
+void QueryCache::put(const std::string &key, std::string &&result, const std::vector<std::string> &tables,
+    const std::vector<uint64_t> &table_versions)
+{
+  if (result.size() > max_result_size()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock_guard(mutex_);
+  auto iter = result_map_.find(key);
+  if (iter != result_map_.end()) {
+    erase(iter->second);
+  }
+
+  results_.emplace_front();
+  CachedResult &cached_result = results_.front();
+  cached_result.key = key;
+  cached_result.result = std::move(result);
+  cached_result.tables = tables;
+  cached_result.table_versions = table_versions;
+  result_map_.emplace(key, results_.begin());
+  memory_usage_ += cached_result.memory_size();
+  evict();
+}
+
+size_t QueryCache::size()
+{
+  std::lock_guard<std::mutex> lock_guard(mutex_);
+  return results_.size();
+}
+
+size_t QueryCache::memory_usage()
+{
+  std::lock_guard<std::mutex> lock_guard(mutex_);
+  return memory_usage_;
+}
+
+void QueryCache::erase(std::list<CachedResult>::iterator iter)
+{
+  memory_usage_ -= iter->memory_size();
+  result_map_.erase(iter->key);
+  results_.erase(iter);
+}
+
+void QueryCache::evict()
+{
+  while (!results_.empty() && memory_usage_ > memory_limit_.load()) {
+    erase(std::prev(results_.end()));
+    query_cache_metrics().evict->inc();
+  }
+}
@@ -0,0 +1,106 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sql/parser/parse_defs.h"
+
+class Db;
+
+/**
+ * 查询结果缓存。key是换掉常量之后的SQL加上这一次的常量，value是发给客户端的完整结果。
+ * 缓存时记下涉及的每个表的修改版本，表中的数据修改之后版本变化，取结果时发现版本不同就丢掉。
+ * 结果占用的内存超过上限时淘汰最久没有用过的
+ */
+class QueryCache
+{
+public:
+  static QueryCache &instance();
+
+  /**
+   * @param memory_limit 所有结果最多占用的内存，0表示不缓存
+   */
+  void set_memory_limit(size_t memory_limit);
+  bool enabled() const
+  {
+    return memory_limit_.load() > 0;
+  }
+  /**
+   * 单个结果的上限，避免一个大结果把其它结果都挤出去
+   */
+  size_t max_result_size() const
+  {
+    return memory_limit_.load() / 8;
+  }
+
+  /**
+   * @param statement 换掉常量之后的SQL，包括数据库名
+   * @param values 这一次的常量
+   */
+  static std::string make_key(const std::string &statement, const std::vector<Value> &values);
+
+  /**
+   * 取出当前的表版本，有表不存在时返回false
+   */
+  static bool table_versions(Db *db, const std::vector<std::string> &tables, std::vector<uint64_t> &versions);
+
+  /**
+   * 查找缓存的结果，涉及的表修改过时结果失效
+   */
+  bool get(Db *db, const std::string &key, std::string &result);
+  /**
+   * @param table_versions 开始执行查询之前取出的表版本，执行期间有修改时这个结果下次取的时候就会失效
+   */
+  void put(const std::string &key, std::string &&result, const std::vector<std::string> &tables,
+      const std::vector<uint64_t> &table_versions);
+
+  size_t size();
+  size_t memory_usage();
+  long hit_count() const
+  {
+    return hit_count_.load();
+  }
+  long miss_count() const
+  {
+    return miss_count_.load();
+  }
+
+private:
+  struct CachedResult {
+    std::string key;
+    std::string result;
+    std::vector<std::string> tables;
+    std::vector<uint64_t> table_versions;
+
+    size_t memory_size() const;
+  };
+
+  QueryCache() = default;
+
+  void erase(std::list<CachedResult>::iterator iter);
+  void evict();
+
+private:
+  std::mutex mutex_;
+  std::atomic<size_t> memory_limit_{0};
+  size_t memory_usage_ = 0;
+  std::list<CachedResult> results_;  // 最近使用的在前面
+  std::unordered_map<std::string, std::list<CachedResult>::iterator> result_map_;
+
+  std::atomic<long> hit_count_{0};
+  std::atomic<long> miss_count_{0};
+};
@@ -22,9 +22,17 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/seda/timer_stage.h"
+#include "event/sql_event.h"
+#include "event/session_event.h"
+#include "session/session.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/query_cache/query_cache.h"
+#include "sql/stmt/stmt.h"
 
 using namespace common;
 
+const char *CONF_QUERY_CACHE_MEMORY = "QueryCacheMemory";
+
 //! Constructor
 QueryCacheStage::QueryCacheStage(const char *tag) : Stage(tag)
 {}
@@ -48,14 +56,17 @@ Stage *QueryCacheStage::make_stage(const std::string &tag)
 //! Set properties for this object set in stage specific properties
 bool QueryCacheStage::set_properties()
 {
-  //  std::string stageNameStr(stage_name_);
-  //  std::map<std::string, std::string> section = g_properties()->get(
-  //    stageNameStr);
-  //
-  //  std::map<std::string, std::string>::iterator it;
-  //
-  //  std::string key;
-
+  std::string stageNameStr(stage_name_);
+  std::map<std::string, std::string> section = get_properties()->get(stageNameStr);
+
+  std::map<std::string, std::string>::iterator iter = section.find(CONF_QUERY_CACHE_MEMORY);
+  if (iter != section.end()) {
+    long long memory = 0;
+    if (str_to_val(iter->second, memory) && memory >= 0) {
+      QueryCache::instance().set_memory_limit(memory);
+      LOG_INFO("Query cache may use %lld bytes of memory", memory);
+    }
+  }
   return true;
 }
 
@@ -83,7 +94,42 @@ void QueryCacheStage::handle_event(StageEvent *event)
 {
   LOG_TRACE("Enter\n");
 
+  // 只缓存经过执行计划缓存的查询，计划的key就是换掉常量之后的SQL。
+  // 显式事务中的查询可能看到自己还没有提交的修改，不使用缓存
+  SQLStageEvent *sql_event = static_cast<SQLStageEvent *>(event);
+  SessionEvent *session_event = sql_event->session_event();
+  Session *session = session_event->session();
+  CachedPlan *plan = sql_event->plan();
+  Stmt *stmt = sql_event->stmt();
+  QueryCache &query_cache = QueryCache::instance();
+  if (!query_cache.enabled() || plan == nullptr || stmt == nullptr || stmt->type() != StmtType::SELECT ||
+      session->is_trx_multi_operation_mode()) {
+    optimize_stage_->handle_event(event);
+    LOG_TRACE("Exit\n");
+    return;
+  }
+
+  Db *db = session->get_current_db();
+  const std::string key = QueryCache::make_key(plan->key(), plan->values());
+  std::string result;
+  if (query_cache.get(db, key, result)) {
+    session_event->result_stream().write(result.data(), result.size());
+    LOG_TRACE("Exit\n");
+    return;
+  }
+
+  // 先取表版本再执行，执行期间表被修改时缓存的结果下一次就会失效
+  std::vector<uint64_t> table_versions;
+  if (!QueryCache::table_versions(db, plan->tables(), table_versions)) {
+    optimize_stage_->handle_event(event);
+    LOG_TRACE("Exit\n");
+    return;
+  }
+  session_event->start_capture_result(query_cache.max_result_size());
   optimize_stage_->handle_event(event);
+  if (session_event->finish_capture_result(result) && session_event->get_response_len() == 0) {
+    query_cache.put(key, std::move(result), plan->tables(), table_versions);
+  }
 
   LOG_TRACE("Exit\n");
   return;
@@ -78,78 +78,55 @@ RC get_table_and_field(Db *db, Table *default_table, std::unordered_map<std::str
   return RC::SUCCESS;
 }
 
-RC FilterStmt::create_filter_unit(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
-				  const Condition &condition, FilterUnit *&filter_unit)
+RC FilterStmt::create_expression(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
+                                 int is_attr, int is_value, const RelAttr &attr, const Value &value,
+                                 const ExpressionNode &expr_node, Expression *&expr)
 {
-  RC rc = RC::SUCCESS;
-  
-  CompOp comp = condition.comp;
-  if (comp < EQUAL_TO || comp >= NO_OP) {
-    LOG_WARN("invalid compare operator : %d", comp);
-    return RC::INVALID_ARGUMENT;
-  }
-
-  Expression *left = nullptr;
-  Expression *right = nullptr;
-  if (condition.left_is_attr) {
+  expr = nullptr;
+  if (is_attr) {
     Table *table = nullptr;
     const FieldMeta *field = nullptr;
-    rc = get_table_and_field(db, default_table, tables, condition.left_attr, table, field);  
+    RC rc = get_table_and_field(db, default_table, tables, attr, table, field);
     if (rc != RC::SUCCESS) {
       LOG_WARN("cannot find attr");
       return rc;
     }
-    left = new FieldExpr(table, field);
-  } else if(condition.left_is_value) {
-    //   default_table->table_meta().field(condition)
-    //   LOG_ERROR("condition.left_value.type: %d", condition.left_value.type);
-    //   if(condition.right_value.type == CHARS && condition.left_value.type == DATES ||
-    //   condition.right_value.type == DATES && condition.left_value.type == CHARS){
-    //   LOG_ERROR("start str to date");
-    //   Value *left_value = new Value;
-    //   memcpy(left_value, &(condition.left_value), sizeof(*left_value));
-    //   int ret = value_init_date(left_value, (char*)condition.left_value.data);
-    //   left = new ValueExpr(*left_value);
-    // } else {
-      left = new ValueExpr(condition.left_value);
-    // }
+    expr = new FieldExpr(table, field);
+  } else if (is_value) {
+    expr = new ValueExpr(value);
   } else {
     std::vector<Table*> tables_vector;
     for(std::unordered_map<std::string, Table*>::iterator it = tables->begin(); it != tables->end(); ++it){
         tables_vector.push_back(it->second);
     }
-    left = new ExprExpr(condition.left_expr, tables_vector);
+    expr = new ExprExpr(expr_node, tables_vector);
   }
+  return RC::SUCCESS;
+}
 
-  if (condition.right_is_attr) {
-    Table *table = nullptr;
-    const FieldMeta *field = nullptr;
-    rc = get_table_and_field(db, default_table, tables, condition.right_attr, table, field);  
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("cannot find attr");
-      delete left;
-      return rc;
-    }
-    right = new FieldExpr(table, field);
-  } else if(condition.right_is_value){
-    // LOG_ERROR("condition.right_value.type: %d", condition.right_value.type);
-    // LOG_ERROR("condition.left_value.type: %d", condition.left_value.type);
-    // if(condition.right_value.type == CHARS && condition.left_value.type == DATES ||
-    // condition.right_value.type == DATES && condition.left_value.type == CHARS){
-    //   LOG_ERROR("start str to date");
-    //   Value *right_value = new Value;
-    //   memcpy(right_value, &(condition.right_value), sizeof(*right_value));
-    //   int ret = value_init_date(right_value, (char*)right_value->data);
-    //   right = new ValueExpr(*right_value);
-    // } else {
-      right = new ValueExpr(condition.right_value);
-    // }
-  } else {
-    std::vector<Table*> tables_vector;
-    for(std::unordered_map<std::string, Table*>::iterator it = tables->begin(); it != tables->end(); ++it){
-        tables_vector.push_back(it->second);
-    }
-    right = new ExprExpr(condition.right_expr, tables_vector);
+RC FilterStmt::create_filter_unit(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
+				  const Condition &condition, FilterUnit *&filter_unit)
+{
+  RC rc = RC::SUCCESS;
+  
+  CompOp comp = condition.comp;
+  if (comp < EQUAL_TO || comp >= NO_OP || condition.sub_select != nullptr) {
+    LOG_WARN("invalid compare operator or subquery is not supported here: %d", comp);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  Expression *left = nullptr;
+  Expression *right = nullptr;
+  rc = create_expression(db, default_table, tables, condition.left_is_attr, condition.left_is_value,
+                         condition.left_attr, condition.left_value, condition.left_expr, left);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  rc = create_expression(db, default_table, tables, condition.right_is_attr, condition.right_is_value,
+                         condition.right_attr, condition.right_value, condition.right_expr, right);
+  if (rc != RC::SUCCESS) {
+    delete left;
+    return rc;
   }
 
   filter_unit = new FilterUnit;
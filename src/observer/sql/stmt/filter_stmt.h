@@ -93,6 +93,13 @@ public:
   static RC create_filter_unit(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
 			      const Condition &condition, FilterUnit *&filter_unit);
 
+  /**
+   * 条件一侧的表达式：字段、常量或者算术表达式
+   */
+  static RC create_expression(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
+                              int is_attr, int is_value, const RelAttr &attr, const Value &value,
+                              const ExpressionNode &expr_node, Expression *&expr);
+
 private:
   std::vector<FilterUnit *>  filter_units_; // 默认当前都是AND关系
 };
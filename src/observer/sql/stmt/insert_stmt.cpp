@@ -21,6 +21,12 @@ InsertStmt::InsertStmt(Table *table, const Value *values, int value_amount)
   : table_ (table), values_(values), value_amount_(value_amount)
 {}
 
+InsertStmt::~InsertStmt()
+{
+  delete[] values_;
+  values_ = nullptr;
+}
+
 RC InsertStmt::create(Db *db, const Inserts &inserts, Stmt *&stmt)
 {
   const char *table_name = inserts.relation_name;
@@ -26,6 +26,7 @@ public:
 
   InsertStmt() = default;
   InsertStmt(Table *table, const Value *values, int value_amount);
+  ~InsertStmt() override;
 
   StmtType type() const override {
     return StmtType::INSERT;
@@ -12,12 +12,15 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2022/6/6.
 //
 
+#include <algorithm>
+
 #include "sql/stmt/select_stmt.h"
 #include "sql/stmt/filter_stmt.h"
 #include "common/log/log.h"
 #include "common/lang/string.h"
 #include "storage/common/db.h"
 #include "storage/common/table.h"
+#include "util/util.h"
 
 SelectStmt::~SelectStmt()
 {
@@ -25,6 +28,22 @@ SelectStmt::~SelectStmt()
     delete filter_stmt_;
     filter_stmt_ = nullptr;
   }
+  for (SubqueryUnit *unit : subquery_units_) {
+    delete unit;
+  }
+  subquery_units_.clear();
+}
+
+SubqueryUnit::~SubqueryUnit()
+{
+  delete left_;
+  left_ = nullptr;
+  for (Expression *expr : outer_keys_) {
+    delete expr;
+  }
+  outer_keys_.clear();
+  delete select_stmt_;
+  select_stmt_ = nullptr;
 }
 
 static void wildcard_fields(Table *table, std::vector<Field> &field_metas)
@@ -36,6 +55,160 @@ static void wildcard_fields(Table *table, std::vector<Field> &field_metas)
   }
 }
 
+static bool contains_field(const std::vector<Field> &fields, const Field &field)
+{
+  for (const Field &other : fields) {
+    if (other.table() == field.table() && other.meta() == field.meta()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * 有聚合或者GROUP BY时只支持单表，输出的普通字段必须是分组字段，不能同时有表达式和排序
+ */
+static RC check_grouping(const std::vector<Table *> &tables, const std::vector<Field> &query_fields,
+                         const std::vector<Aggregation> &aggregations, const std::vector<Field> &group_by_fields,
+                         const std::vector<ExpressionNode> &exprs, size_t order_num)
+{
+  if (aggregations.empty() && group_by_fields.empty()) {
+    return RC::SUCCESS;
+  }
+  if (tables.size() != 1) {
+    LOG_WARN("aggregation on multiple tables is not supported");
+    return RC::INVALID_ARGUMENT;
+  }
+  if (!exprs.empty() || order_num > 0) {
+    LOG_WARN("expressions or order by with aggregation is not supported");
+    return RC::INVALID_ARGUMENT;
+  }
+  for (const Field &field : query_fields) {
+    if (!contains_field(group_by_fields, field)) {
+      LOG_WARN("field is neither grouped nor aggregated. field=%s", field.field_name());
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+/**
+ * 子查询中引用的表是否是外层的表，子查询FROM中的表优先
+ */
+static bool is_outer_relation(const char *relation_name, const Selects &sub_sql,
+                              const std::unordered_map<std::string, Table *> &outer_tables)
+{
+  if (common::is_blank(relation_name)) {
+    return false;
+  }
+  for (size_t i = 0; i < sub_sql.relation_num; i++) {
+    if (0 == strcmp(sub_sql.relations[i], relation_name)) {
+      return false;
+    }
+  }
+  return outer_tables.count(relation_name) > 0;
+}
+
+static bool references_outer(const ExpressionNode *expr, const Selects &sub_sql,
+                             const std::unordered_map<std::string, Table *> &outer_tables)
+{
+  if (expr == nullptr) {
+    return false;
+  }
+  if (expr->is_attr && is_outer_relation(expr->attr.relation_name, sub_sql, outer_tables)) {
+    return true;
+  }
+  return references_outer(expr->left, sub_sql, outer_tables) || references_outer(expr->right, sub_sql, outer_tables);
+}
+
+RC SelectStmt::create_subquery_unit(Db *db, std::unordered_map<std::string, Table *> &outer_tables,
+                                    Table *default_table, const Condition &condition, SubqueryUnit *&unit)
+{
+  // 引用外层字段的条件只能是字段之间的等值比较，把它们提取出来作为连接字段，剩下的条件只涉及子查询中的表
+  const Selects &sub_sql = *condition.sub_select;
+  Selects inner_sql = sub_sql;
+  inner_sql.condition_num = 0;
+  std::vector<RelAttr> outer_attrs;
+  std::vector<RelAttr> inner_attrs;
+  for (size_t i = 0; i < sub_sql.condition_num; i++) {
+    const Condition &sub_condition = sub_sql.conditions[i];
+    const bool left_outer = references_outer(&sub_condition.left_expr, sub_sql, outer_tables);
+    const bool right_outer =
+        sub_condition.sub_select == nullptr && references_outer(&sub_condition.right_expr, sub_sql, outer_tables);
+    if (!left_outer && !right_outer) {
+      inner_sql.conditions[inner_sql.condition_num++] = sub_condition;
+      continue;
+    }
+    if (sub_condition.comp != EQUAL_TO || sub_condition.sub_select != nullptr || !sub_condition.left_is_attr ||
+        !sub_condition.right_is_attr || (left_outer && right_outer)) {
+      LOG_WARN("only equality between an outer field and an inner field is supported in correlated subquery");
+      return RC::INVALID_ARGUMENT;
+    }
+    outer_attrs.push_back(left_outer ? sub_condition.left_attr : sub_condition.right_attr);
+    inner_attrs.push_back(left_outer ? sub_condition.right_attr : sub_condition.left_attr);
+  }
+
+  Stmt *stmt = nullptr;
+  RC rc = SelectStmt::create(db, inner_sql, stmt);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to create subquery. rc=%s", strrc(rc));
+    return rc;
+  }
+  SubqueryUnit *tmp_unit = new SubqueryUnit;
+  tmp_unit->comp_ = condition.comp;
+  tmp_unit->select_stmt_ = static_cast<SelectStmt *>(stmt);
+  SelectStmt *inner_stmt = tmp_unit->select_stmt_;
+
+  std::vector<Table *> outer_table_list;
+  for (auto &iter : outer_tables) {
+    outer_table_list.push_back(iter.second);
+  }
+  for (size_t i = 0; i < outer_attrs.size(); i++) {
+    Field outer_field;
+    Field inner_field;
+    if (get_field(outer_table_list, outer_attrs[i], outer_field) != RC::SUCCESS ||
+        get_field(inner_stmt->tables(), inner_attrs[i], inner_field) != RC::SUCCESS) {
+      LOG_WARN("no such correlated field. field=%s", outer_attrs[i].attribute_name);
+      delete tmp_unit;
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    tmp_unit->outer_keys_.push_back(new FieldExpr(outer_field.table(), outer_field.meta()));
+    tmp_unit->inner_keys_.push_back(inner_field);
+    inner_stmt->correlated_fields_.push_back(inner_field);
+  }
+
+  // IN的子查询只能输出一个字段，标量子查询输出一个字段或者一个聚合
+  const bool single_field = inner_stmt->query_fields().size() == 1 && inner_stmt->exprs().empty() &&
+                            inner_stmt->aggregations().empty();
+  const bool single_aggregation = inner_stmt->query_fields().empty() && inner_stmt->exprs().empty() &&
+                                  inner_stmt->aggregations().size() == 1;
+  bool valid = false;
+  switch (condition.comp) {
+    case IN_OP:
+    case NOT_IN_OP: valid = single_field; break;
+    case EXISTS_OP:
+    case NOT_EXISTS_OP: valid = inner_stmt->aggregations().empty(); break;
+    default: valid = single_field || single_aggregation; break;
+  }
+  if (!valid || !inner_stmt->group_by_fields().empty()) {
+    LOG_WARN("unsupported subquery output. comp=%d", condition.comp);
+    delete tmp_unit;
+    return RC::INVALID_ARGUMENT;
+  }
+
+  if (condition.comp != EXISTS_OP && condition.comp != NOT_EXISTS_OP) {
+    rc = FilterStmt::create_expression(db, default_table, &outer_tables, condition.left_is_attr,
+                                       condition.left_is_value, condition.left_attr, condition.left_value,
+                                       condition.left_expr, tmp_unit->left_);
+    if (rc != RC::SUCCESS) {
+      delete tmp_unit;
+      return rc;
+    }
+  }
+  unit = tmp_unit;
+  return RC::SUCCESS;
+}
+
 RC SelectStmt::create(Db *db, const Selects &select_sql, Stmt *&stmt)
 {
   if (nullptr == db) {
@@ -144,13 +317,80 @@ RC SelectStmt::create(Db *db, const Selects &select_sql, Stmt *&stmt)
     ExpressionNode expr = select_sql.expr[i];
     exprs.push_back(expr);
   }
+  // 表达式在这里绑定字段并编译，执行时不再解析
+  std::vector<CompiledExpr> compiled_exprs(exprs.size());
+  for (size_t i = 0; i < exprs.size(); i++) {
+    RC rc = compiled_exprs[i].compile(exprs[i], tables);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to compile expression %d. rc=%d:%s", (int)i, rc, strrc(rc));
+      return rc;
+    }
+  }
+
+  std::vector<Field> group_by_fields;
+  for (size_t i = 0; i < select_sql.group_by_num; i++) {
+    Field field;
+    RC rc = get_field(tables, select_sql.group_by[i], field);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("no such group by field. field=%s", select_sql.group_by[i].attribute_name);
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    group_by_fields.push_back(field);
+  }
+
+  RC rc = check_grouping(tables, query_fields, aggregations, group_by_fields, exprs, select_sql.order_num);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  std::vector<OrderByUnit> order_by_units;
+  for (size_t i = 0; i < select_sql.order_num; i++) {
+    const OrderBy &order = select_sql.orders[i];
+    OrderByUnit order_by_unit;
+    RC rc = get_field(tables, order.attr, order_by_unit.field);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("no such order by field. field=%s.%s", order.attr.relation_name, order.attr.attribute_name);
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    order_by_unit.asc = order.asc != 0;
+    order_by_units.push_back(order_by_unit);
+  }
+
+  if (select_sql.has_limit && (select_sql.limit < 0 || select_sql.offset < 0)) {
+    LOG_WARN("invalid limit. limit=%d, offset=%d", select_sql.limit, select_sql.offset);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 带子查询的条件单独处理，其它条件组成FilterStmt
+  Condition conditions[MAX_NUM];
+  int condition_num = 0;
+  std::vector<SubqueryUnit *> subquery_units;
+  auto destroy_subquery_units = [&subquery_units]() {
+    for (SubqueryUnit *unit : subquery_units) {
+      delete unit;
+    }
+  };
+  for (size_t i = 0; i < select_sql.condition_num; i++) {
+    const Condition &condition = select_sql.conditions[i];
+    if (condition.sub_select == nullptr) {
+      conditions[condition_num++] = condition;
+      continue;
+    }
+    SubqueryUnit *unit = nullptr;
+    rc = create_subquery_unit(db, table_map, default_table, condition, unit);
+    if (rc != RC::SUCCESS) {
+      destroy_subquery_units();
+      return rc;
+    }
+    subquery_units.push_back(unit);
+  }
 
   // create filter statement in `where` statement
   FilterStmt *filter_stmt = nullptr;
-  RC rc = FilterStmt::create(db, default_table, &table_map,
-           select_sql.conditions, select_sql.condition_num, filter_stmt);
+  rc = FilterStmt::create(db, default_table, &table_map, conditions, condition_num, filter_stmt);
   if (rc != RC::SUCCESS) {
     LOG_WARN("cannot construct filter stmt");
+    destroy_subquery_units();
     return rc;
   }
 
@@ -159,8 +399,16 @@ RC SelectStmt::create(Db *db, const Selects &select_sql, Stmt *&stmt)
   select_stmt->tables_.swap(tables);
   select_stmt->query_fields_.swap(query_fields);
   select_stmt->aggregations_.swap(aggregations);
+  select_stmt->group_by_fields_.swap(group_by_fields);
   select_stmt->exprs_.swap(exprs);
+  select_stmt->compiled_exprs_.swap(compiled_exprs);
+  select_stmt->order_by_units_.swap(order_by_units);
+  if (select_sql.has_limit) {
+    select_stmt->limit_ = select_sql.limit;
+    select_stmt->offset_ = select_sql.offset;
+  }
   select_stmt->filter_stmt_ = filter_stmt;
+  select_stmt->subquery_units_.swap(subquery_units);
   stmt = select_stmt;
   return RC::SUCCESS;
 }
@@ -14,16 +14,59 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "rc.h"
 #include "sql/stmt/stmt.h"
 #include "storage/common/field.h"
+#include "sql/expr/compiled_expr.h"
 
 class FieldMeta;
 class FilterStmt;
+class FilterUnit;
 class Db;
 class Table;
+class Index;
+class Expression;
+class SubqueryUnit;
+
+/**
+ * ORDER BY中的一项
+ */
+struct OrderByUnit
+{
+  Field field;
+  bool asc = true;
+};
+
+enum class JoinMethod
+{
+  NESTED_LOOP,
+  HASH,
+  INDEX_NESTED_LOOP,
+  SORT_MERGE,
+};
+
+/**
+ * 左深连接树中的一步，把table连接到前面已经连接的结果上，由优化器决定连接的顺序和方式
+ * 第一步只扫描table，method和连接字段没有意义
+ */
+struct JoinStep
+{
+  Table *table = nullptr;
+  JoinMethod method = JoinMethod::NESTED_LOOP;
+  std::vector<Field> joined_keys;  // 已经连接的一侧的等值连接字段
+  std::vector<Field> table_keys;   // table上与joined_keys一一对应的字段
+  bool build_table = false;        // 哈希连接时是否用table建立哈希表
+  Index *index = nullptr;          // 索引嵌套循环连接时查找的索引，排序归并连接时table按照这个索引有序
+  Index *joined_index = nullptr;   // 排序归并连接时第一个表按照这个索引有序
+
+  std::vector<const FilterUnit *> table_filters;  // 扫描table时就可以计算的条件
+  std::vector<const FilterUnit *> join_filters;   // 连接之后计算的条件，不包括连接算子已经保证的等值条件
+  double rows = 0;                                // 估算的这一步之后的行数
+};
 
 class SelectStmt : public Stmt
 {
@@ -40,14 +83,77 @@ public:
   const std::vector<Table *> &tables() const { return tables_; }
   const std::vector<Field> &query_fields() const { return query_fields_; }
   const std::vector<Aggregation> &aggregations() const {return aggregations_; }
+  const std::vector<Field> &group_by_fields() const { return group_by_fields_; }
   const std::vector<ExpressionNode> &exprs() const {return exprs_; }
+  const std::vector<CompiledExpr> &compiled_exprs() const { return compiled_exprs_; }
+  const std::vector<OrderByUnit> &order_by_units() const { return order_by_units_; }
+  /**
+   * LIMIT的行数，没有LIMIT时返回-1
+   */
+  int limit() const { return limit_; }
+  int offset() const { return offset_; }
   FilterStmt *filter_stmt() const { return filter_stmt_; }
+  /**
+   * WHERE中带子查询的条件，在其它条件之后计算
+   */
+  const std::vector<SubqueryUnit *> &subquery_units() const { return subquery_units_; }
+  /**
+   * 作为相关子查询时与外层连接的字段，执行时需要从本查询的结果中读取
+   */
+  const std::vector<Field> &correlated_fields() const { return correlated_fields_; }
+  const std::vector<JoinStep> &join_steps() const { return join_steps_; }
+  void set_join_steps(const std::vector<JoinStep> &join_steps) { join_steps_ = join_steps; }
+
+private:
+  static RC create_subquery_unit(Db *db, std::unordered_map<std::string, Table *> &outer_tables,
+                                 Table *default_table, const Condition &condition, SubqueryUnit *&unit);
 
 private:
   std::vector<Field> query_fields_;
   std::vector<Table *> tables_;
   FilterStmt *filter_stmt_ = nullptr;
   std::vector<Aggregation> aggregations_;
+  std::vector<Field> group_by_fields_;
   std::vector<ExpressionNode> exprs_;
+  std::vector<CompiledExpr> compiled_exprs_;  // 与exprs_一一对应
+  std::vector<OrderByUnit> order_by_units_;
+  int limit_ = -1;
+  int offset_ = 0;
+  std::vector<JoinStep> join_steps_;
+  std::vector<SubqueryUnit *> subquery_units_;
+  std::vector<Field> correlated_fields_;
+};
+
+/**
+ * WHERE中的子查询条件：[NOT] IN、[NOT] EXISTS以及与标量子查询的比较
+ * 子查询中与外层字段的等值条件被提取出来作为连接字段，执行时子查询只计算一次，
+ * 再与外层做半连接或反连接，不会对外层的每一行重新执行
+ */
+class SubqueryUnit
+{
+public:
+  SubqueryUnit() = default;
+  ~SubqueryUnit();
+
+  /**
+   * IN_OP、NOT_IN_OP、EXISTS_OP、NOT_EXISTS_OP，或者与标量子查询比较的比较符
+   */
+  CompOp comp() const { return comp_; }
+  /**
+   * 外层的表达式，EXISTS时为空
+   */
+  Expression *left() const { return left_; }
+  SelectStmt *select_stmt() const { return select_stmt_; }
+  const std::vector<Expression *> &outer_keys() const { return outer_keys_; }
+  const std::vector<Field> &inner_keys() const { return inner_keys_; }
+
+private:
+  friend class SelectStmt;
+
+  CompOp comp_ = NO_OP;
+  Expression *left_ = nullptr;
+  SelectStmt *select_stmt_ = nullptr;
+  std::vector<Expression *> outer_keys_;  // 外层的连接字段
+  std::vector<Field> inner_keys_;  // 子查询中与outer_keys_一一对应的字段
 };
 
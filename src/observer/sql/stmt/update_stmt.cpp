@@ -22,6 +22,14 @@ UpdateStmt::UpdateStmt(Table *table, const char *attribute_name, const Value *va
   : table_ (table), attribute_name_(attribute_name), value_(value), filter_stmt_(filter_stmt)
 {}
 
+UpdateStmt::~UpdateStmt()
+{
+  if (nullptr != filter_stmt_) {
+    delete filter_stmt_;
+    filter_stmt_ = nullptr;
+  }
+}
+
 RC UpdateStmt::create(Db *db, const Updates &update_sql, Stmt *&stmt)
 {
   const char *table_name = update_sql.relation_name;
@@ -50,7 +58,7 @@ RC UpdateStmt::create(Db *db, const Updates &update_sql, Stmt *&stmt)
   }
 
   // check the fields number
-  const Value value = update_sql.value;
+  const Value &value = update_sql.value;
   const char *attribute_name = update_sql.attribute_name;
   
 
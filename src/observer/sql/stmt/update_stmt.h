@@ -25,7 +25,7 @@ class UpdateStmt : public Stmt
 public:
   UpdateStmt() = default;
   UpdateStmt(Table *table, const char *attribute_name, const Value *value, FilterStmt *filter_stmt);
-  virtual ~UpdateStmt() = default;
+  ~UpdateStmt() override;
 
 public:
   static RC create(Db *db, const Updates &update_sql, Stmt *&stmt);
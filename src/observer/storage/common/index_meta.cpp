@@ -22,8 +22,35 @@ See the Mulan PSL v2 for more details. */
 
 const static Json::StaticString FIELD_NAME("name");
 const static Json::StaticString FIELD_FIELD_NAME("field_name");
+const static Json::StaticString FIELD_UNIQUE("unique");
+const static Json::StaticString FIELD_INCLUDE_FIELDS("include_fields");
+const static Json::StaticString FIELD_TYPE("type");
 
-RC IndexMeta::init(const char *name, const FieldMeta &field)
+static const char *INDEX_TYPE_NAMES[] = {
+  "btree",
+  "hash"
+};
+
+static const char *index_type_to_string(IndexType type)
+{
+  if (type >= BPLUS_TREE_INDEX && type <= HASH_INDEX) {
+    return INDEX_TYPE_NAMES[type];
+  }
+  return "unknown";
+}
+
+static IndexType index_type_from_string(const char *s)
+{
+  for (unsigned int i = 0; i < sizeof(INDEX_TYPE_NAMES) / sizeof(INDEX_TYPE_NAMES[0]); i++) {
+    if (0 == strcmp(INDEX_TYPE_NAMES[i], s)) {
+      return (IndexType)i;
+    }
+  }
+  return BPLUS_TREE_INDEX;
+}
+
+RC IndexMeta::init(const char *name, const FieldMeta &field, bool unique /* = false */,
+    const std::vector<std::string> &include_fields /* = empty */, IndexType type /* = BPLUS_TREE_INDEX */)
 {
   if (common::is_blank(name)) {
     LOG_ERROR("Failed to init index, name is empty.");
@@ -32,6 +59,9 @@ RC IndexMeta::init(const char *name, const FieldMeta &field)
 
   name_ = name;
   field_ = field.name();
+  unique_ = unique;
+  include_fields_ = include_fields;
+  type_ = type;
   return RC::SUCCESS;
 }
 
@@ -39,6 +69,15 @@ void IndexMeta::to_json(Json::Value &json_value) const
 {
   json_value[FIELD_NAME] = name_;
   json_value[FIELD_FIELD_NAME] = field_;
+  json_value[FIELD_UNIQUE] = unique_;
+  json_value[FIELD_TYPE] = index_type_to_string(type_);
+  if (!include_fields_.empty()) {
+    Json::Value include_value(Json::arrayValue);
+    for (const std::string &include_field : include_fields_) {
+      include_value.append(include_field);
+    }
+    json_value[FIELD_INCLUDE_FIELDS] = std::move(include_value);
+  }
 }
 
 RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, IndexMeta &index)
@@ -63,7 +102,27 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
     return RC::SCHEMA_FIELD_MISSING;
   }
 
-  return index.init(name_value.asCString(), *field);
+  // 旧版本的元数据没有unique字段，当作普通索引处理
+  const Json::Value &unique_value = json_value[FIELD_UNIQUE];
+  bool unique = unique_value.isBool() && unique_value.asBool();
+
+  std::vector<std::string> include_fields;
+  const Json::Value &include_value = json_value[FIELD_INCLUDE_FIELDS];
+  if (include_value.isArray()) {
+    for (int i = 0; i < (int)include_value.size(); i++) {
+      const Json::Value &include_field_value = include_value[i];
+      if (!include_field_value.isString() || nullptr == table.field(include_field_value.asCString())) {
+        LOG_ERROR("Deserialize index [%s]: invalid include field: %s",
+            name_value.asCString(), include_field_value.toStyledString().c_str());
+        return RC::SCHEMA_FIELD_MISSING;
+      }
+      include_fields.push_back(include_field_value.asString());
+    }
+  }
+  // 没有type字段的都是B+树索引
+  const Json::Value &type_value = json_value[FIELD_TYPE];
+  IndexType type = type_value.isString() ? index_type_from_string(type_value.asCString()) : BPLUS_TREE_INDEX;
+  return index.init(name_value.asCString(), *field, unique, include_fields, type);
 }
 
 const char *IndexMeta::name() const
@@ -76,7 +135,39 @@ const char *IndexMeta::field() const
   return field_.c_str();
 }
 
+bool IndexMeta::unique() const
+{
+  return unique_;
+}
+
+IndexType IndexMeta::type() const
+{
+  return type_;
+}
+
+const std::vector<std::string> &IndexMeta::include_fields() const
+{
+  return include_fields_;
+}
+
+bool IndexMeta::covers(const char *field_name) const
+{
+  if (field_ == field_name) {
+    return true;
+  }
+  for (const std::string &include_field : include_fields_) {
+    if (include_field == field_name) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void IndexMeta::desc(std::ostream &os) const
 {
-  os << "index name=" << name_ << ", field=" << field_;
+  os << "index name=" << name_ << ", field=" << field_ << ", unique=" << (unique_ ? "true" : "false")
+     << ", type=" << index_type_to_string(type_);
+  for (const std::string &include_field : include_fields_) {
+    os << ", include=" << include_field;
+  }
 }
\ No newline at end of file
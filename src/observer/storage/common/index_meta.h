@@ -16,7 +16,9 @@ See the Mulan PSL v2 for more details. */
 #define __OBSERVER_STORAGE_COMMON_INDEX_META_H__
 
 #include <string>
+#include <vector>
 #include "rc.h"
+#include "sql/parser/parse_defs.h"
 
 class TableMeta;
 class FieldMeta;
@@ -29,11 +31,21 @@ class IndexMeta {
 public:
   IndexMeta() = default;
 
-  RC init(const char *name, const FieldMeta &field);
+  RC init(const char *name, const FieldMeta &field, bool unique = false,
+      const std::vector<std::string> &include_fields = std::vector<std::string>(),
+      IndexType type = BPLUS_TREE_INDEX);
 
 public:
   const char *name() const;
   const char *field() const;
+  bool unique() const;
+  IndexType type() const;
+  const std::vector<std::string> &include_fields() const;
+
+  /**
+   * 索引字段或者include字段中是否有这个字段
+   */
+  bool covers(const char *field_name) const;
 
   void desc(std::ostream &os) const;
 
@@ -44,5 +56,8 @@ public:
 protected:
   std::string name_;   // index's name
   std::string field_;  // field's name
+  bool unique_ = false;
+  std::vector<std::string> include_fields_;  // 叶子节点中额外保存的字段
+  IndexType type_ = BPLUS_TREE_INDEX;
 };
 #endif  // __OBSERVER_STORAGE_COMMON_INDEX_META_H__
\ No newline at end of file
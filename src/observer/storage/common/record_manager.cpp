@@ -11,6 +11,8 @@ See the Mulan PSL v2 for more details. */
 //
 // Created by Meiyi & Longda on 2021/4/13.
 //
+#include <algorithm>
+
 #include "storage/common/record_manager.h"
 #include "rc.h"
 #include "common/log/log.h"
@@ -461,3 +463,51 @@ RC RecordFileScanner::next(Record &record)
   }
   return rc;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+RC ParallelRecordScan::open(DiskBufferPool &buffer_pool)
+{
+  disk_buffer_pool_ = &buffer_pool;
+  pages_.clear();
+  next_page_ = 0;
+
+  BufferPoolIterator bp_iterator;
+  RC rc = bp_iterator.init(buffer_pool);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to init bp iterator. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+  while (bp_iterator.has_next()) {
+    pages_.push_back(bp_iterator.next());
+  }
+  return RC::SUCCESS;
+}
+
+bool ParallelRecordScan::next_morsel(int &begin, int &end)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (next_page_ >= (int)pages_.size()) {
+    return false;
+  }
+  begin = next_page_;
+  end = std::min(next_page_ + MORSEL_PAGES, (int)pages_.size());
+  next_page_ = end;
+  return true;
+}
+
+RC ParallelRecordScan::fetch_page(int index, RecordPageHandler &page_handler)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  RC rc = page_handler.init(*disk_buffer_pool_, pages_[index]);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to init record page handler. page_num=%d, rc=%d:%s", pages_[index], rc, strrc(rc));
+  }
+  return rc;
+}
+
+void ParallelRecordScan::release_page(RecordPageHandler &page_handler)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  page_handler.cleanup();
+}
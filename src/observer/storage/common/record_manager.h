@@ -16,6 +16,8 @@ See the Mulan PSL v2 for more details. */
 
 #include <sstream>
 #include <limits>
+#include <mutex>
+#include <vector>
 #include "storage/default/disk_buffer_pool.h"
 #include "storage/common/record.h"
 #include "common/lang/bitmap.h"
@@ -184,4 +186,36 @@ private:
   Record next_record_;
 };
 
+/**
+ * 多个线程共同扫描一个文件：每次领取连续的几个页面（morsel），领完为止。
+ * DiskBufferPool没有加锁，读取和释放页面都通过这里串行化，页面内的记录可以并发读取。
+ * 扫描期间不能有其它线程修改这个文件
+ */
+class ParallelRecordScan {
+public:
+  static const int MORSEL_PAGES = 8;
+
+  RC open(DiskBufferPool &buffer_pool);
+
+  int page_count() const
+  {
+    return (int)pages_.size();
+  }
+
+  /**
+   * 领取下一段页面，下标范围是[begin, end)
+   * @return 页面已经领完时返回false
+   */
+  bool next_morsel(int &begin, int &end);
+
+  RC fetch_page(int index, RecordPageHandler &page_handler);
+  void release_page(RecordPageHandler &page_handler);
+
+private:
+  DiskBufferPool *disk_buffer_pool_ = nullptr;
+  std::vector<PageNum> pages_;
+  int next_page_ = 0;
+  std::mutex mutex_;
+};
+
 #endif  //__OBSERVER_STORAGE_COMMON_RECORD_MANAGER_H_
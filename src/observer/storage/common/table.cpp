@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #include <limits.h>
 #include <string.h>
 #include <algorithm>
+#include <random>
 #include <vector>
 
 #include "common/defs.h"
@@ -28,6 +29,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/meta_util.h"
 #include "storage/index/index.h"
 #include "storage/index/bplus_tree_index.h"
+#include "storage/index/hash_index.h"
 #include "storage/trx/trx.h"
 
 Table::~Table()
@@ -181,11 +183,10 @@ RC Table::open(const char *meta_file, const char *base_dir)
       return RC::GENERIC_ERROR;
     }
 
-    BplusTreeIndex *index = new BplusTreeIndex();
+    Index *index = nullptr;
     std::string index_file = table_index_file(base_dir, name(), index_meta->name());
-    rc = index->open(index_file.c_str(), *index_meta, *field_meta);
+    rc = open_index(index_file.c_str(), *index_meta, *field_meta, false/*create*/, index);
     if (rc != RC::SUCCESS) {
-      delete index;
       LOG_ERROR("Failed to open index. table=%s, index=%s, file=%s, rc=%d:%s",
           name(),
           index_meta->name(),
@@ -210,7 +211,9 @@ RC Table::commit_insert(Trx *trx, const RID &rid)
     return rc;
   }
 
-  return trx->commit_insert(this, record);
+  rc = trx->commit_insert(this, record);
+  on_modified();
+  return rc;
 }
 
 RC Table::rollback_insert(Trx *trx, const RID &rid)
@@ -235,6 +238,11 @@ RC Table::rollback_insert(Trx *trx, const RID &rid)
   }
 
   rc = record_handler_->delete_record(&rid);
+  if (rc == RC::SUCCESS) {
+    table_meta_.stats().on_delete();
+    stats_dirty_ = true;
+  }
+  on_modified();
   return rc;
 }
 
@@ -285,6 +293,10 @@ RC Table::insert_record(Trx *trx, Record *record)
     }
     return rc;
   }
+
+  table_meta_.stats().on_insert(record->data());
+  stats_dirty_ = true;
+  on_modified();
   return rc;
 }
 RC Table::insert_record(Trx *trx, int value_num, const Value *values)
@@ -319,6 +331,26 @@ const TableMeta &Table::table_meta() const
   return table_meta_;
 }
 
+int Table::data_page_count() const
+{
+  int page_count = 0;
+  data_buffer_pool_->get_page_count(&page_count);
+  return page_count;
+}
+
+int64_t Table::estimated_row_count() const
+{
+  const TableStats &stats = table_meta_.stats();
+  if (stats.valid()) {
+    return stats.row_count();
+  }
+
+  // 第0页是文件头
+  const int data_pages = std::max(data_page_count() - 1, 0);
+  const int records_per_page = std::max((int)(BP_PAGE_DATA_SIZE / table_meta_.record_size()), 1);
+  return (int64_t)data_pages * records_per_page;
+}
+
 RC Table::make_record(int value_num, const Value *values, char *&record_out)
 {
   // 检查字段类型是否一致
@@ -394,6 +426,15 @@ RC Table::get_record_scanner(RecordFileScanner &scanner)
   return rc;
 }
 
+RC Table::get_parallel_scan(ParallelRecordScan &scan)
+{
+  RC rc = scan.open(*data_buffer_pool_);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("failed to open parallel scan. rc=%d:%s", rc, strrc(rc));
+  }
+  return rc;
+}
+
 /**
  * 为了不把Record暴露出去，封装一下
  */
@@ -481,22 +522,68 @@ RC Table::scan_record_by_index(Trx *trx, IndexScanner *scanner, ConditionFilter
                                int limit, void *context,
                                RC (*record_reader)(Record *, void *))
 {
+  // 先从索引中批量取出rid，按照页面排序后再读取记录，避免在数据页之间来回跳
+  static const int INDEX_SCAN_BATCH_SIZE = 1024;
+
   RC rc = RC::SUCCESS;
   RID rid;
-  Record record;
   int record_count = 0;
-  while (record_count < limit) {
-    rc = scanner->next_entry(&rid);
-    if (rc != RC::SUCCESS) {
-      if (RC::RECORD_EOF == rc) {
-        rc = RC::SUCCESS;
+  bool eof = false;
+  std::vector<RID> rids;
+  rids.reserve(INDEX_SCAN_BATCH_SIZE);
+  while (!eof && record_count < limit) {
+    rids.clear();
+    while (static_cast<int>(rids.size()) < INDEX_SCAN_BATCH_SIZE &&
+           record_count + static_cast<int>(rids.size()) < limit) {
+      rc = scanner->next_entry(&rid);
+      if (rc != RC::SUCCESS) {
         break;
       }
+      rids.push_back(rid);
+    }
+
+    if (rc == RC::RECORD_EOF) {
+      rc = RC::SUCCESS;
+      eof = true;
+    } else if (rc != RC::SUCCESS) {
       LOG_ERROR("Failed to scan table by index. rc=%d:%s", rc, strrc(rc));
       break;
     }
 
-    rc = record_handler_->get_record(&rid, &record);
+    record_count += static_cast<int>(rids.size());
+    rc = read_records_by_rids(trx, rids, filter, context, record_reader);
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+  }
+
+  scanner->destroy();
+  return rc;
+}
+
+RC Table::read_records_by_rids(Trx *trx, std::vector<RID> &rids, ConditionFilter *filter, void *context,
+                               RC (*record_reader)(Record *, void *))
+{
+  std::sort(rids.begin(), rids.end(), [](const RID &rid1, const RID &rid2) {
+    return RID::compare(&rid1, &rid2) < 0;
+  });
+
+  RC rc = RC::SUCCESS;
+  Record record;
+  RecordPageHandler page_handler;
+  PageNum current_page_num = BP_INVALID_PAGE_NUM;
+  for (const RID &rid : rids) {
+    if (rid.page_num != current_page_num) {
+      page_handler.cleanup();
+      rc = page_handler.init(*data_buffer_pool_, rid.page_num);
+      if (rc != RC::SUCCESS) {
+        LOG_ERROR("Failed to init record page handler. page num=%d, rc=%d:%s", rid.page_num, rc, strrc(rc));
+        break;
+      }
+      current_page_num = rid.page_num;
+    }
+
+    rc = page_handler.get_record(&rid, &record);
     if (rc != RC::SUCCESS) {
       LOG_ERROR("Failed to fetch record of rid=%d:%d, rc=%d:%s", rid.page_num, rid.slot_num, rc, strrc(rc));
       break;
@@ -509,11 +596,8 @@ RC Table::scan_record_by_index(Trx *trx, IndexScanner *scanner, ConditionFilter
         break;
       }
     }
-
-    record_count++;
   }
-
-  scanner->destroy();
+  page_handler.cleanup();
   return rc;
 }
 
@@ -537,7 +621,191 @@ static RC insert_index_record_reader_adapter(Record *record, void *context)
   return inserter.insert_index(record);
 }
 
-RC Table::create_index(Trx *trx, const char *index_name, const char *attribute_name)
+RC Table::include_field_metas(const IndexMeta &index_meta, std::vector<FieldMeta> &field_metas) const
+{
+  for (const std::string &include_field : index_meta.include_fields()) {
+    const FieldMeta *field_meta = table_meta_.field(include_field.c_str());
+    if (nullptr == field_meta) {
+      LOG_WARN("no such include field. table=%s, index=%s, field=%s",
+               name(), index_meta.name(), include_field.c_str());
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    field_metas.push_back(*field_meta);
+  }
+  return RC::SUCCESS;
+}
+
+RC Table::open_index(const char *index_file, const IndexMeta &index_meta, const FieldMeta &field_meta, bool create,
+                     Index *&index)
+{
+  RC rc = RC::SUCCESS;
+  if (index_meta.type() == HASH_INDEX) {
+    HashIndex *hash_index = new HashIndex();
+    rc = create ? hash_index->create(index_file, index_meta, field_meta)
+                : hash_index->open(index_file, index_meta, field_meta);
+    index = hash_index;
+  } else {
+    std::vector<FieldMeta> include_metas;
+    rc = include_field_metas(index_meta, include_metas);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    BplusTreeIndex *bplus_tree_index = new BplusTreeIndex();
+    rc = create ? bplus_tree_index->create(index_file, index_meta, field_meta, include_metas)
+                : bplus_tree_index->open(index_file, index_meta, field_meta, include_metas);
+    index = bplus_tree_index;
+  }
+
+  if (rc != RC::SUCCESS) {
+    delete index;
+    index = nullptr;
+  }
+  return rc;
+}
+
+// ANALYZE时最多抽样的行数，以及直方图中桶的个数
+static const size_t ANALYZE_SAMPLE_ROWS = 10000;
+static const size_t HISTOGRAM_BUCKETS = 32;
+static const int ANALYZE_RANDOM_SEED = 1;
+
+/**
+ * ANALYZE时遍历所有记录。行数和不同值的个数是完整统计的，直方图用蓄水池抽样的结果生成
+ */
+class StatsCollector {
+public:
+  explicit StatsCollector(const TableMeta &table_meta) : table_meta_(table_meta), random_(ANALYZE_RANDOM_SEED)
+  {
+    for (int i = table_meta.sys_field_num(); i < table_meta.field_num(); i++) {
+      ColumnStats column;
+      column.init(*table_meta.field(i));
+      columns_.push_back(std::move(column));
+      fields_.push_back(table_meta.field(i));
+    }
+  }
+
+  RC collect(const Record *record)
+  {
+    for (size_t i = 0; i < columns_.size(); i++) {
+      columns_[i].add(record->data() + fields_[i]->offset());
+    }
+
+    row_count_++;
+    if (samples_.size() < ANALYZE_SAMPLE_ROWS) {
+      samples_.emplace_back(record->data(), table_meta_.record_size());
+    } else {
+      const int64_t pos = std::uniform_int_distribution<int64_t>(0, row_count_ - 1)(random_);
+      if (pos < (int64_t)ANALYZE_SAMPLE_ROWS) {
+        samples_[pos].assign(record->data(), table_meta_.record_size());
+      }
+    }
+    return RC::SUCCESS;
+  }
+
+  void finish(TableStats &stats)
+  {
+    for (size_t i = 0; i < columns_.size(); i++) {
+      ColumnStats &column = columns_[i];
+      const FieldMeta *field = fields_[i];
+      std::vector<const char *> values;
+      for (const std::string &sample : samples_) {
+        values.push_back(sample.data() + field->offset());
+      }
+      std::sort(values.begin(), values.end(),
+                [&column](const char *v1, const char *v2) { return column.compare(v1, v2) < 0; });
+
+      std::vector<std::string> bounds;
+      if (!values.empty()) {
+        const size_t bucket_num = std::min(HISTOGRAM_BUCKETS, std::max<size_t>(values.size() - 1, 1));
+        for (size_t j = 0; j <= bucket_num; j++) {
+          const char *value = values[j * (values.size() - 1) / bucket_num];
+          std::string bound(value, field->len());
+          if (field->type() == CHARS || field->type() == DATES) {
+            // 结束符后面的内容是无效的
+            const size_t len = strnlen(value, field->len());
+            std::fill(bound.begin() + len, bound.end(), '\0');
+          }
+          bounds.push_back(std::move(bound));
+        }
+      }
+      column.set_bounds(std::move(bounds));
+    }
+    stats.reset(row_count_, std::move(columns_));
+  }
+
+private:
+  const TableMeta &table_meta_;
+  std::mt19937_64 random_;
+  std::vector<ColumnStats> columns_;
+  std::vector<const FieldMeta *> fields_;
+  std::vector<std::string> samples_;
+  int64_t row_count_ = 0;
+};
+
+static RC collect_stats_record_reader_adapter(Record *record, void *context)
+{
+  StatsCollector &collector = *(StatsCollector *)context;
+  return collector.collect(record);
+}
+
+RC Table::analyze(Trx *trx)
+{
+  StatsCollector collector(table_meta_);
+  RC rc = scan_record(trx, nullptr, -1, &collector, collect_stats_record_reader_adapter);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to scan records while analyzing table %s. rc=%d:%s", name(), rc, strrc(rc));
+    return rc;
+  }
+
+  TableMeta new_table_meta(table_meta_);
+  collector.finish(new_table_meta.stats());
+  rc = write_meta(new_table_meta);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to save table stats of %s. rc=%d:%s", name(), rc, strrc(rc));
+    return rc;
+  }
+
+  table_meta_.swap(new_table_meta);
+  stats_dirty_ = false;
+  on_modified();
+  LOG_INFO("Analyzed table %s. row count=%ld", name(), table_meta_.stats().row_count());
+  return rc;
+}
+
+RC Table::write_meta(const TableMeta &table_meta)
+{
+  // 创建元数据临时文件
+  std::string tmp_file = table_meta_file(base_dir_.c_str(), name()) + ".tmp";
+  std::fstream fs;
+  fs.open(tmp_file, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if (!fs.is_open()) {
+    LOG_ERROR("Failed to open file for write. file name=%s, errmsg=%s", tmp_file.c_str(), strerror(errno));
+    return RC::IOERR;
+  }
+  if (table_meta.serialize(fs) < 0) {
+    LOG_ERROR("Failed to dump new table meta to file: %s. sys err=%d:%s", tmp_file.c_str(), errno, strerror(errno));
+    return RC::IOERR;
+  }
+  fs.close();
+
+  // 覆盖原始元数据文件
+  std::string meta_file = table_meta_file(base_dir_.c_str(), name());
+  int ret = rename(tmp_file.c_str(), meta_file.c_str());
+  if (ret != 0) {
+    LOG_ERROR("Failed to rename tmp meta file (%s) to normal meta file (%s) of table (%s). system error=%d:%s",
+        tmp_file.c_str(),
+        meta_file.c_str(),
+        name(),
+        errno,
+        strerror(errno));
+    return RC::IOERR;
+  }
+  return RC::SUCCESS;
+}
+
+RC Table::create_index(Trx *trx, const char *index_name, const char *attribute_name, bool unique /* = false */,
+                       const std::vector<std::string> &include_fields /* = empty */,
+                       IndexType index_type /* = BPLUS_TREE_INDEX */)
 {
   if (common::is_blank(index_name) || common::is_blank(attribute_name)) {
     LOG_INFO("Invalid input arguments, table name is %s, index_name is blank or attribute_name is blank", name());
@@ -556,7 +824,7 @@ RC Table::create_index(Trx *trx, const char *index_name, const char *attribute_n
   }
 
   IndexMeta new_index_meta;
-  RC rc = new_index_meta.init(index_name, *field_meta);
+  RC rc = new_index_meta.init(index_name, *field_meta, unique, include_fields, index_type);
   if (rc != RC::SUCCESS) {
     LOG_INFO("Failed to init IndexMeta in table:%s, index_name:%s, field_name:%s",
              name(), index_name, attribute_name);
@@ -564,12 +832,11 @@ RC Table::create_index(Trx *trx, const char *index_name, const char *attribute_n
   }
 
   // 创建索引相关数据
-  BplusTreeIndex *index = new BplusTreeIndex();
+  Index *index = nullptr;
   std::string index_file = table_index_file(base_dir_.c_str(), name(), index_name);
-  rc = index->create(index_file.c_str(), new_index_meta, *field_meta);
+  rc = open_index(index_file.c_str(), new_index_meta, *field_meta, true/*create*/, index);
   if (rc != RC::SUCCESS) {
-    delete index;
-    LOG_ERROR("Failed to create bplus tree index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
+    LOG_ERROR("Failed to create index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
     return rc;
   }
 
@@ -577,7 +844,8 @@ RC Table::create_index(Trx *trx, const char *index_name, const char *attribute_n
   IndexInserter index_inserter(index);
   rc = scan_record(trx, nullptr, -1, &index_inserter, insert_index_record_reader_adapter);
   if (rc != RC::SUCCESS) {
-    // rollback
+    // rollback. 唯一索引遇到重复数据时也会走到这里，需要把索引文件删掉
+    index->drop();
     delete index;
     LOG_ERROR("Failed to insert index to all records. table=%s, rc=%d:%s", name(), rc, strrc(rc));
     return rc;
@@ -590,36 +858,16 @@ RC Table::create_index(Trx *trx, const char *index_name, const char *attribute_n
     LOG_ERROR("Failed to add index (%s) on table (%s). error=%d:%s", index_name, name(), rc, strrc(rc));
     return rc;
   }
-  // 创建元数据临时文件
-  std::string tmp_file = table_meta_file(base_dir_.c_str(), name()) + ".tmp";
-  std::fstream fs;
-  fs.open(tmp_file, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
-  if (!fs.is_open()) {
-    LOG_ERROR("Failed to open file for write. file name=%s, errmsg=%s", tmp_file.c_str(), strerror(errno));
-    return RC::IOERR;  // 创建索引中途出错，要做还原操作
-  }
-  if (new_table_meta.serialize(fs) < 0) {
-    LOG_ERROR("Failed to dump new table meta to file: %s. sys err=%d:%s", tmp_file.c_str(), errno, strerror(errno));
-    return RC::IOERR;
-  }
-  fs.close();
-
-  // 覆盖原始元数据文件
-  std::string meta_file = table_meta_file(base_dir_.c_str(), name());
-  int ret = rename(tmp_file.c_str(), meta_file.c_str());
-  if (ret != 0) {
-    LOG_ERROR("Failed to rename tmp meta file (%s) to normal meta file (%s) while creating index (%s) on table (%s). "
-              "system error=%d:%s",
-        tmp_file.c_str(),
-        meta_file.c_str(),
-        index_name,
-        name(),
-        errno,
-        strerror(errno));
-    return RC::IOERR;
+  rc = write_meta(new_table_meta);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to write table meta while creating index (%s) on table (%s). rc=%d:%s",
+              index_name, name(), rc, strrc(rc));
+    return rc;  // 创建索引中途出错，要做还原操作
   }
 
   table_meta_.swap(new_table_meta);
+  stats_dirty_ = false;
+  on_modified();
 
   LOG_INFO("Successfully added a new index (%s) on the table (%s)", index_name, name());
 
@@ -662,24 +910,72 @@ RC Table::update_record(Trx *trx, Record *record, const char *attribute_name, co
         }
       }
 
-      memcpy(record->data() + field->offset(), value->data, copy_len);
-      rc = record_handler_->update_record(record);
+      // 索引项中保存了索引字段以及include字段的值，需要用旧值删除，更新后再用新值插入
+      std::vector<Index *> covering_indexes;
+      for (Index *index : indexes_) {
+        if (!index->index_meta().covers(attribute_name)) {
+          continue;
+        }
+        rc = index->delete_entry(record->data(), &record->rid());
+        if (rc != RC::SUCCESS) {
+          LOG_ERROR("Failed to delete index entry. index=%s, table=%s, rc=%d:%s",
+                    index->index_meta().name(), name(), rc, strrc(rc));
+          break;
+        }
+        covering_indexes.push_back(index);
+      }
+
+      std::string old_value(record->data() + field->offset(), field->len());
+      bool record_updated = false;
+      if (rc == RC::SUCCESS) {
+        memcpy(record->data() + field->offset(), value->data, copy_len);
+        rc = record_handler_->update_record(record);
+        if (rc != RC::SUCCESS) {
+          LOG_ERROR("Failed to update record. table=%s, rc=%d:%s", name(), rc, strrc(rc));
+        } else {
+          record_updated = true;
+        }
+      }
 
       //update index
-      if(isIndex(attribute_name)){
-        rc = update_entry_of_indexes(record->data(),record->rid());
-        if(rc != RC::SUCCESS){
-          LOG_ERROR("Failed to update index");
+      size_t inserted = 0;
+      while (rc == RC::SUCCESS && inserted < covering_indexes.size()) {
+        rc = covering_indexes[inserted]->insert_entry(record->data(), &record->rid());
+        if (rc != RC::SUCCESS) {
+          LOG_WARN("Failed to update index %s, table %s. rc=%d:%s",
+                   covering_indexes[inserted]->index_meta().name(), name(), rc, strrc(rc));
+          break;
+        }
+        inserted++;
+      }
+
+      if (rc != RC::SUCCESS) {
+        // 比如唯一索引冲突，把记录和已经删掉旧值的索引都恢复回去
+        for (size_t i = 0; i < inserted; i++) {
+          covering_indexes[i]->delete_entry(record->data(), &record->rid());
         }
-        return rc;
+        memcpy(record->data() + field->offset(), old_value.data(), old_value.size());
+        if (record_updated) {
+          record_handler_->update_record(record);
+        }
+        for (Index *index : covering_indexes) {
+          index->insert_entry(record->data(), &record->rid());
+        }
+      }
+      if (rc == RC::SUCCESS) {
+        table_meta_.stats().on_update(attribute_name, record->data() + field->offset());
+        stats_dirty_ = true;
       }
   }
+  if (rc == RC::SUCCESS) {
+    on_modified();
+  }
   return rc;
 }
 
 bool Table::isIndex(const char *attribute_name){
   for(auto index: indexes_){
-    if(strcmp(index->index_meta().field(), attribute_name) == 0){
+    if(index->index_meta().covers(attribute_name)){
       return true;
     }
   }
@@ -742,6 +1038,13 @@ RC Table::delete_record(Trx *trx, Record *record)
     } else {
       rc = record_handler_->delete_record(&record->rid());
     }
+    if (rc == RC::SUCCESS) {
+      table_meta_.stats().on_delete();
+      stats_dirty_ = true;
+    }
+  }
+  if (rc == RC::SUCCESS) {
+    on_modified();
   }
   return rc;
 }
@@ -765,6 +1068,9 @@ RC Table::commit_delete(Trx *trx, const RID &rid)
     return rc;
   }
 
+  table_meta_.stats().on_delete();
+  stats_dirty_ = true;
+  on_modified();
   return rc;
 }
 
@@ -777,7 +1083,9 @@ RC Table::rollback_delete(Trx *trx, const RID &rid)
     return rc;
   }
 
-  return trx->rollback_delete(this, record);  // update record in place
+  rc = trx->rollback_delete(this, record);  // update record in place
+  on_modified();
+  return rc;
 }
 
 RC Table::insert_entry_of_indexes(const char *record, const RID &rid)
@@ -806,19 +1114,6 @@ RC Table::delete_entry_of_indexes(const char *record, const RID &rid, bool error
   return rc;
 }
 
-RC Table::update_entry_of_indexes(const char *record, const RID &rid){
-  RC rc = RC::SUCCESS;
-  for (Index *index: indexes_) {
-    rc = index->update_entry(record, &rid);
-    if(rc != RC::SUCCESS){
-      LOG_ERROR("Failed to update index %s, table %s", index->index_meta().name(), name());
-    }
-    return rc;
-  }
-  return rc;
-
-}
-
 Index *Table::find_index(const char *index_name) const
 {
   for (Index *index : indexes_) {
@@ -868,6 +1163,9 @@ IndexScanner *Table::find_index_for_scan(const DefaultConditionFilter &filter)
   if (nullptr == index) {
     return nullptr;
   }
+  if (index_meta->type() == HASH_INDEX && filter.comp_op() != EQUAL_TO) {
+    return nullptr;
+  }
 
   const char *left_key = nullptr;
   const char *right_key = nullptr;
@@ -956,6 +1254,25 @@ RC Table::sync()
       return rc;
     }
   }
+  if (stats_dirty_) {
+    rc = write_meta(table_meta_);
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to save table stats. table=%s, rc=%d:%s", name(), rc, strrc(rc));
+      return rc;
+    }
+    stats_dirty_ = false;
+  }
   LOG_INFO("Sync table over. table=%s", name());
   return rc;
 }
+
+uint64_t Table::next_modify_version()
+{
+  static std::atomic<uint64_t> version{0};
+  return ++version;
+}
+
+void Table::on_modified()
+{
+  modify_version_.store(next_modify_version());
+}
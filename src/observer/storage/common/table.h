@@ -15,6 +15,8 @@ See the Mulan PSL v2 for more details. */
 #ifndef __OBSERVER_STORAGE_COMMON_TABLE_H__
 #define __OBSERVER_STORAGE_COMMON_TABLE_H__
 
+#include <atomic>
+
 #include "storage/common/table_meta.h"
 
 struct RID;
@@ -22,6 +24,7 @@ class Record;
 class DiskBufferPool;
 class RecordFileHandler;
 class RecordFileScanner;
+class ParallelRecordScan;
 class ConditionFilter;
 class DefaultConditionFilter;
 class Index;
@@ -64,9 +67,20 @@ public:
   RC scan_record(Trx *trx, ConditionFilter *filter, int limit, void *context,
       void (*record_reader)(const char *data, void *context));
 
-  RC create_index(Trx *trx, const char *index_name, const char *attribute_name);
+  RC create_index(Trx *trx, const char *index_name, const char *attribute_name, bool unique = false,
+      const std::vector<std::string> &include_fields = std::vector<std::string>(),
+      IndexType index_type = BPLUS_TREE_INDEX);
 
   RC get_record_scanner(RecordFileScanner &scanner);
+  /**
+   * 多个线程按页面分段并行扫描表，见ParallelRecordScan
+   */
+  RC get_parallel_scan(ParallelRecordScan &scan);
+
+  /**
+   * ANALYZE TABLE: 扫描整个表，重新统计行数、每个字段不同值的个数和直方图，并保存到元数据中
+   */
+  RC analyze(Trx *trx);
 
   bool isIndex(const char *attribute_name);
 
@@ -80,8 +94,27 @@ public:
 
   const TableMeta &table_meta() const;
 
+  /**
+   * 数据文件中已经分配的页面数，可以用来粗略地比较表的大小
+   */
+  int data_page_count() const;
+  /**
+   * 有统计信息时返回统计的行数，否则假设数据页面都写满，按照页面数估算
+   */
+  int64_t estimated_row_count() const;
+
   RC sync();
 
+  /**
+   * 表中的数据每次修改之后变化，所有表的版本都不相同，删除之后重建的表也不会与原来的表重复。
+   * 创建索引和更新统计信息之后也变化，执行计划可能不同，结果中行的顺序也就可能不同。
+   * 查询结果缓存用它判断结果是否过期
+   */
+  uint64_t modify_version() const
+  {
+    return modify_version_.load();
+  }
+
 public:
   RC commit_insert(Trx *trx, const RID &rid);
   RC commit_delete(Trx *trx, const RID &rid);
@@ -93,6 +126,8 @@ private:
       Trx *trx, ConditionFilter *filter, int limit, void *context, RC (*record_reader)(Record *record, void *context));
   RC scan_record_by_index(Trx *trx, IndexScanner *scanner, ConditionFilter *filter, int limit, void *context,
       RC (*record_reader)(Record *record, void *context));
+  RC read_records_by_rids(Trx *trx, std::vector<RID> &rids, ConditionFilter *filter, void *context,
+      RC (*record_reader)(Record *record, void *context));
   IndexScanner *find_index_for_scan(const ConditionFilter *filter);
   IndexScanner *find_index_for_scan(const DefaultConditionFilter &filter);
 
@@ -104,11 +139,24 @@ private:
 
   RC insert_entry_of_indexes(const char *record, const RID &rid);
   RC delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists);
-  RC update_entry_of_indexes(const char *record, const RID &rid);
 
 private:
   RC init_record_handler(const char *base_dir);
+  RC include_field_metas(const IndexMeta &index_meta, std::vector<FieldMeta> &field_metas) const;
+  /**
+   * 按照索引类型创建或者打开索引文件
+   */
+  RC open_index(const char *index_file, const IndexMeta &index_meta, const FieldMeta &field_meta, bool create,
+      Index *&index);
   RC make_record(int value_num, const Value *values, char *&record_out);
+  /**
+   * 先写临时文件再改名，替换元数据文件
+   */
+  RC write_meta(const TableMeta &table_meta);
+  /**
+   * 修改完数据之后调用。先修改再换版本，拿到新版本的查询一定能看到修改
+   */
+  void on_modified();
 
 public:
   Index *find_index(const char *index_name) const;
@@ -120,6 +168,10 @@ private:
   DiskBufferPool *data_buffer_pool_ = nullptr;  /// 数据文件关联的buffer pool
   RecordFileHandler *record_handler_ = nullptr;  /// 记录操作
   std::vector<Index *> indexes_;
+  bool stats_dirty_ = false;  /// 统计信息修改之后还没有保存到元数据文件中
+  std::atomic<uint64_t> modify_version_{next_modify_version()};
+
+  static uint64_t next_modify_version();
 };
 
 #endif  // __OBSERVER_STORAGE_COMMON_TABLE_H__
@@ -23,11 +23,13 @@ See the Mulan PSL v2 for more details. */
 static const Json::StaticString FIELD_TABLE_NAME("table_name");
 static const Json::StaticString FIELD_FIELDS("fields");
 static const Json::StaticString FIELD_INDEXES("indexes");
+static const Json::StaticString FIELD_STATS("stats");
 
 std::vector<FieldMeta> TableMeta::sys_fields_;
 
 TableMeta::TableMeta(const TableMeta &other)
-    : name_(other.name_), fields_(other.fields_), indexes_(other.indexes_), record_size_(other.record_size_)
+    : name_(other.name_), fields_(other.fields_), indexes_(other.indexes_), record_size_(other.record_size_),
+      stats_(other.stats_)
 {}
 
 void TableMeta::swap(TableMeta &other) noexcept
@@ -36,6 +38,7 @@ void TableMeta::swap(TableMeta &other) noexcept
   fields_.swap(other.fields_);
   indexes_.swap(other.indexes_);
   std::swap(record_size_, other.record_size_);
+  std::swap(stats_, other.stats_);
 }
 
 RC TableMeta::init_sys_fields()
@@ -92,6 +95,7 @@ RC TableMeta::init(const char *name, int field_num, const AttrInfo attributes[])
   }
 
   record_size_ = field_offset;
+  stats_.init(fields_, sys_fields_.size());
 
   name_ = name;
   LOG_INFO("Sussessfully initialized table meta. table name=%s", name);
@@ -208,6 +212,10 @@ int TableMeta::serialize(std::ostream &ss) const
   }
   table_value[FIELD_INDEXES] = std::move(indexes_value);
 
+  Json::Value stats_value;
+  stats_.to_json(stats_value);
+  table_value[FIELD_STATS] = std::move(stats_value);
+
   Json::StreamWriterBuilder builder;
   Json::StreamWriter *writer = builder.newStreamWriter();
 
@@ -291,6 +299,16 @@ int TableMeta::deserialize(std::istream &is)
     indexes_.swap(indexes);
   }
 
+  // 旧版本的元数据中没有统计信息，行数未知，需要ANALYZE之后才能使用
+  const Json::Value &stats_value = table_value[FIELD_STATS];
+  if (!stats_value.isNull()) {
+    rc = TableStats::from_json(stats_value, fields_, sys_fields_.size(), stats_);
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to deserialize table stats. table name=%s", name_.c_str());
+      return -1;
+    }
+  }
+
   return (int)(is.tellg() - old_pos);
 }
 
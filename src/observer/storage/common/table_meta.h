@@ -21,6 +21,7 @@ See the Mulan PSL v2 for more details. */
 #include "rc.h"
 #include "storage/common/field_meta.h"
 #include "storage/common/index_meta.h"
+#include "storage/common/table_stats.h"
 #include "common/lang/serializable.h"
 
 class TableMeta : public common::Serializable {
@@ -53,6 +54,15 @@ public:
 
   int record_size() const;
 
+  const TableStats &stats() const
+  {
+    return stats_;
+  }
+  TableStats &stats()
+  {
+    return stats_;
+  }
+
 public:
   int serialize(std::ostream &os) const override;
   int deserialize(std::istream &is) override;
@@ -69,6 +79,7 @@ protected:
   std::vector<IndexMeta> indexes_;
 
   int record_size_ = 0;
+  TableStats stats_;
 
   //@@@ TODO why used static variable?
   static std::vector<FieldMeta> sys_fields_;
@@ -0,0 +1,386 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "storage/common/table_stats.h"
+#include "common/log/log.h"
+#include "util/comparator.h"
+#include "json/json.h"
+
+static const Json::StaticString FIELD_ROW_COUNT("row_count");
+static const Json::StaticString FIELD_MODIFIED_ROWS("modified_rows");
+static const Json::StaticString FIELD_ANALYZED("analyzed");
+static const Json::StaticString FIELD_COLUMNS("columns");
+static const Json::StaticString FIELD_NAME("name");
+static const Json::StaticString FIELD_DISTINCT("distinct");
+static const Json::StaticString FIELD_BOUNDS("bounds");
+
+/**
+ * FNV-1a之后再用murmur3的finalizer打散，保证高位和低位都足够随机
+ */
+static uint64_t hash_bytes(const char *data, int len)
+{
+  uint64_t h = 14695981039346656037ULL;
+  for (int i = 0; i < len; i++) {
+    h ^= (uint8_t)data[i];
+    h *= 1099511628211ULL;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+HyperLogLog::HyperLogLog() : registers_(REGISTER_NUM, 0)
+{}
+
+void HyperLogLog::add(const char *data, int len)
+{
+  const uint64_t hash = hash_bytes(data, len);
+  const int index = (int)(hash >> (64 - REGISTER_BITS));
+  const uint64_t rest = hash << REGISTER_BITS;
+  // 剩余的位中第一个1的位置
+  uint8_t rank = 1;
+  while (rank <= 64 - REGISTER_BITS && (rest & (1ULL << (64 - rank))) == 0) {
+    rank++;
+  }
+  if (registers_[index] < rank) {
+    registers_[index] = rank;
+  }
+}
+
+int64_t HyperLogLog::estimate() const
+{
+  double sum = 0;
+  int zeros = 0;
+  for (uint8_t reg : registers_) {
+    sum += ldexp(1.0, -reg);
+    if (reg == 0) {
+      zeros++;
+    }
+  }
+
+  const double m = REGISTER_NUM;
+  const double alpha = 0.7213 / (1 + 1.079 / m);
+  double estimate = alpha * m * m / sum;
+  if (estimate <= 2.5 * m && zeros > 0) {
+    // 基数较小时用线性计数修正
+    estimate = m * log(m / zeros);
+  }
+  return (int64_t)(estimate + 0.5);
+}
+
+void HyperLogLog::clear()
+{
+  std::fill(registers_.begin(), registers_.end(), 0);
+}
+
+std::string HyperLogLog::to_string() const
+{
+  static const char HEX[] = "0123456789abcdef";
+  std::string s;
+  s.reserve(registers_.size() * 2);
+  for (uint8_t reg : registers_) {
+    s.push_back(HEX[reg >> 4]);
+    s.push_back(HEX[reg & 0xf]);
+  }
+  return s;
+}
+
+static int hex_value(char c)
+{
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+RC HyperLogLog::from_string(const std::string &s)
+{
+  if (s.size() != registers_.size() * 2) {
+    return RC::INVALID_ARGUMENT;
+  }
+  for (size_t i = 0; i < registers_.size(); i++) {
+    const int high = hex_value(s[i * 2]);
+    const int low = hex_value(s[i * 2 + 1]);
+    if (high < 0 || low < 0) {
+      return RC::INVALID_ARGUMENT;
+    }
+    registers_[i] = (uint8_t)(high << 4 | low);
+  }
+  return RC::SUCCESS;
+}
+
+void ColumnStats::init(const FieldMeta &field)
+{
+  field_name_ = field.name();
+  type_ = field.type();
+  len_ = field.len();
+  offset_ = field.offset();
+  distinct_.clear();
+  bounds_.clear();
+}
+
+void ColumnStats::add(const char *data)
+{
+  int len = len_;
+  if (type_ == CHARS || type_ == DATES) {
+    // 结束符后面的内容是无效的
+    len = strnlen(data, len_);
+  }
+  distinct_.add(data, len);
+}
+
+int ColumnStats::compare(const char *v1, const char *v2) const
+{
+  switch (type_) {
+    case INTS: return compare_int((void *)v1, (void *)v2);
+    case FLOATS: return compare_float((void *)v1, (void *)v2);
+    default: return compare_string((void *)v1, len_, (void *)v2, len_);
+  }
+}
+
+static double numeric_value(AttrType type, const char *data)
+{
+  return type == INTS ? *(const int *)data : *(const float *)data;
+}
+
+double ColumnStats::fraction_below(const char *value, bool inclusive) const
+{
+  const int bucket_num = (int)bounds_.size() - 1;
+  // 第一个大于value(不包含时为大于等于)的边界
+  int pos = 0;
+  while (pos <= bucket_num) {
+    const int result = compare(bounds_[pos].data(), value);
+    if (result > 0 || (!inclusive && result == 0)) {
+      break;
+    }
+    pos++;
+  }
+  if (pos == 0) {
+    return 0;
+  }
+  if (pos > bucket_num) {
+    return 1;
+  }
+
+  // value落在第pos个桶中，数值类型按照线性分布插值，其它类型认为在桶的中间
+  double ratio = 0.5;
+  if (type_ == INTS || type_ == FLOATS) {
+    const double low = numeric_value(type_, bounds_[pos - 1].data());
+    const double high = numeric_value(type_, bounds_[pos].data());
+    if (high > low) {
+      ratio = std::min(std::max((numeric_value(type_, value) - low) / (high - low), 0.0), 1.0);
+    }
+  }
+  return (pos - 1 + ratio) / bucket_num;
+}
+
+double ColumnStats::selectivity(CompOp comp, const char *value, int64_t row_count) const
+{
+  if (bounds_.size() < 2) {
+    return -1;
+  }
+
+  const double min_selectivity = 1.0 / std::max<int64_t>(row_count, 1);
+  double equal = 1.0 / std::max<int64_t>(distinct_count(), 1);
+  if (compare(value, bounds_.front().data()) < 0 || compare(value, bounds_.back().data()) > 0) {
+    equal = 0;
+  }
+
+  double result = 0;
+  switch (comp) {
+    case EQUAL_TO: result = equal; break;
+    case NOT_EQUAL: result = 1 - equal; break;
+    case LESS_THAN: result = fraction_below(value, false); break;
+    case LESS_EQUAL: result = fraction_below(value, true); break;
+    case GREAT_THAN: result = 1 - fraction_below(value, true); break;
+    case GREAT_EQUAL: result = 1 - fraction_below(value, false); break;
+    default: return -1;
+  }
+  return std::min(std::max(result, min_selectivity), 1.0);
+}
+
+void ColumnStats::to_json(Json::Value &json_value) const
+{
+  json_value[FIELD_NAME] = field_name_;
+  json_value[FIELD_DISTINCT] = distinct_.to_string();
+
+  Json::Value bounds_value(Json::arrayValue);
+  for (const std::string &bound : bounds_) {
+    switch (type_) {
+      case INTS: bounds_value.append(*(const int *)bound.data()); break;
+      case FLOATS: bounds_value.append(*(const float *)bound.data()); break;
+      default: bounds_value.append(std::string(bound.data(), strnlen(bound.data(), len_))); break;
+    }
+  }
+  json_value[FIELD_BOUNDS] = std::move(bounds_value);
+}
+
+RC ColumnStats::from_json(const Json::Value &json_value, const FieldMeta &field, ColumnStats &column)
+{
+  column.init(field);
+  const Json::Value &distinct_value = json_value[FIELD_DISTINCT];
+  if (!distinct_value.isString() || column.distinct_.from_string(distinct_value.asString()) != RC::SUCCESS) {
+    LOG_ERROR("Invalid distinct sketch of field %s. json value=%s",
+              field.name(), distinct_value.toStyledString().c_str());
+    return RC::GENERIC_ERROR;
+  }
+
+  const Json::Value &bounds_value = json_value[FIELD_BOUNDS];
+  if (!bounds_value.isArray()) {
+    LOG_ERROR("Invalid histogram of field %s. json value=%s", field.name(), bounds_value.toStyledString().c_str());
+    return RC::GENERIC_ERROR;
+  }
+  for (Json::ArrayIndex i = 0; i < bounds_value.size(); i++) {
+    const Json::Value &bound_value = bounds_value[i];
+    std::string bound(column.len_, '\0');
+    if (column.type_ == INTS && bound_value.isInt()) {
+      const int v = bound_value.asInt();
+      memcpy(&bound[0], &v, sizeof(v));
+    } else if (column.type_ == FLOATS && bound_value.isNumeric()) {
+      const float v = bound_value.asFloat();
+      memcpy(&bound[0], &v, sizeof(v));
+    } else if ((column.type_ == CHARS || column.type_ == DATES) && bound_value.isString()) {
+      const std::string v = bound_value.asString();
+      memcpy(&bound[0], v.data(), std::min<size_t>(v.size(), column.len_));
+    } else {
+      LOG_ERROR("Invalid histogram bound of field %s. json value=%s",
+                field.name(), bound_value.toStyledString().c_str());
+      return RC::GENERIC_ERROR;
+    }
+    column.bounds_.push_back(std::move(bound));
+  }
+  return RC::SUCCESS;
+}
+
+void TableStats::init(const std::vector<FieldMeta> &fields, int sys_field_num)
+{
+  row_count_ = 0;
+  modified_rows_ = 0;
+  analyzed_ = false;
+  columns_.clear();
+  for (size_t i = sys_field_num; i < fields.size(); i++) {
+    ColumnStats column;
+    column.init(fields[i]);
+    columns_.push_back(std::move(column));
+  }
+}
+
+const ColumnStats *TableStats::column(const char *field_name) const
+{
+  for (const ColumnStats &column : columns_) {
+    if (0 == strcmp(column.field_name(), field_name)) {
+      return &column;
+    }
+  }
+  return nullptr;
+}
+
+void TableStats::on_insert(const char *record)
+{
+  modified_rows_++;
+  if (!valid()) {
+    return;
+  }
+  row_count_++;
+  for (ColumnStats &column : columns_) {
+    column.add(record + column.offset_);
+  }
+}
+
+void TableStats::on_delete()
+{
+  modified_rows_++;
+  if (valid() && row_count_ > 0) {
+    row_count_--;
+  }
+}
+
+void TableStats::on_update(const char *field_name, const char *data)
+{
+  modified_rows_++;
+  if (!valid()) {
+    return;
+  }
+  for (ColumnStats &column : columns_) {
+    if (0 == strcmp(column.field_name(), field_name)) {
+      column.add(data);
+    }
+  }
+}
+
+void TableStats::reset(int64_t row_count, std::vector<ColumnStats> &&columns)
+{
+  row_count_ = row_count;
+  modified_rows_ = 0;
+  analyzed_ = true;
+  columns_ = std::move(columns);
+}
+
+void TableStats::to_json(Json::Value &json_value) const
+{
+  json_value[FIELD_ROW_COUNT] = (Json::Int64)row_count_;
+  json_value[FIELD_MODIFIED_ROWS] = (Json::Int64)modified_rows_;
+  json_value[FIELD_ANALYZED] = analyzed_;
+
+  Json::Value columns_value(Json::arrayValue);
+  for (const ColumnStats &column : columns_) {
+    Json::Value column_value;
+    column.to_json(column_value);
+    columns_value.append(std::move(column_value));
+  }
+  json_value[FIELD_COLUMNS] = std::move(columns_value);
+}
+
+RC TableStats::from_json(const Json::Value &json_value, const std::vector<FieldMeta> &fields, int sys_field_num,
+                         TableStats &stats)
+{
+  const Json::Value &row_count_value = json_value[FIELD_ROW_COUNT];
+  const Json::Value &modified_rows_value = json_value[FIELD_MODIFIED_ROWS];
+  const Json::Value &analyzed_value = json_value[FIELD_ANALYZED];
+  const Json::Value &columns_value = json_value[FIELD_COLUMNS];
+  if (!row_count_value.isInt64() || !modified_rows_value.isInt64() || !analyzed_value.isBool() ||
+      !columns_value.isArray()) {
+    LOG_ERROR("Invalid table stats. json value=%s", json_value.toStyledString().c_str());
+    return RC::GENERIC_ERROR;
+  }
+
+  std::vector<ColumnStats> columns;
+  for (size_t i = sys_field_num; i < fields.size(); i++) {
+    ColumnStats column;
+    column.init(fields[i]);
+    for (Json::ArrayIndex j = 0; j < columns_value.size(); j++) {
+      const Json::Value &name_value = columns_value[j][FIELD_NAME];
+      if (name_value.isString() && name_value.asString() == fields[i].name()) {
+        RC rc = ColumnStats::from_json(columns_value[j], fields[i], column);
+        if (rc != RC::SUCCESS) {
+          return rc;
+        }
+        break;
+      }
+    }
+    columns.push_back(std::move(column));
+  }
+
+  stats.row_count_ = row_count_value.asInt64();
+  stats.modified_rows_ = modified_rows_value.asInt64();
+  stats.analyzed_ = analyzed_value.asBool();
+  stats.columns_.swap(columns);
+  return RC::SUCCESS;
+}
@@ -0,0 +1,170 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "rc.h"
+#include "sql/parser/parse_defs.h"
+#include "storage/common/field_meta.h"
+
+namespace Json {
+class Value;
+}  // namespace Json
+
+/**
+ * 用HyperLogLog估算不同值的个数。2^8个寄存器，标准误差大约6.5%，只能增加不能删除
+ */
+class HyperLogLog {
+public:
+  static const int REGISTER_BITS = 8;
+  static const int REGISTER_NUM = 1 << REGISTER_BITS;
+
+  HyperLogLog();
+
+  void add(const char *data, int len);
+  int64_t estimate() const;
+  void clear();
+
+  /**
+   * 寄存器按照十六进制保存
+   */
+  std::string to_string() const;
+  RC from_string(const std::string &s);
+
+private:
+  std::vector<uint8_t> registers_;
+};
+
+/**
+ * 一个字段的统计信息：不同值的个数和ANALYZE时生成的等深直方图
+ */
+class ColumnStats {
+public:
+  void init(const FieldMeta &field);
+
+  const char *field_name() const
+  {
+    return field_name_.c_str();
+  }
+
+  void add(const char *data);
+  int64_t distinct_count() const
+  {
+    return distinct_.estimate();
+  }
+
+  /**
+   * 直方图的边界，第一个是最小值，最后一个是最大值，相邻两个边界之间的行数相同
+   */
+  const std::vector<std::string> &bounds() const
+  {
+    return bounds_;
+  }
+  void set_bounds(std::vector<std::string> &&bounds)
+  {
+    bounds_ = std::move(bounds);
+  }
+  HyperLogLog &hll()
+  {
+    return distinct_;
+  }
+
+  int compare(const char *v1, const char *v2) const;
+
+  /**
+   * 估算满足 field comp value 的行所占的比例
+   * @param value 与字段类型相同的值
+   * @return 没有直方图时返回负数
+   */
+  double selectivity(CompOp comp, const char *value, int64_t row_count) const;
+
+  void to_json(Json::Value &json_value) const;
+  static RC from_json(const Json::Value &json_value, const FieldMeta &field, ColumnStats &column);
+
+private:
+  /**
+   * 小于value(inclusive时为小于等于)的行所占的比例
+   */
+  double fraction_below(const char *value, bool inclusive) const;
+
+private:
+  std::string field_name_;
+  AttrType type_ = UNDEFINED;
+  int len_ = 0;
+  int offset_ = 0;
+  HyperLogLog distinct_;
+  std::vector<std::string> bounds_;
+
+  friend class TableStats;
+};
+
+/**
+ * 表的统计信息，随表的元数据一起保存
+ * 行数和不同值的个数在增删改时增量维护，直方图只在ANALYZE TABLE时重新生成
+ */
+class TableStats {
+public:
+  /**
+   * 新建的表是空的，所有统计信息都是准确的
+   */
+  void init(const std::vector<FieldMeta> &fields, int sys_field_num);
+
+  /**
+   * 行数未知，例如从没有统计信息的元数据加载时
+   */
+  bool valid() const
+  {
+    return row_count_ >= 0;
+  }
+  int64_t row_count() const
+  {
+    return row_count_;
+  }
+  /**
+   * 上次ANALYZE之后修改过的行数，可以用来判断直方图是否过时
+   */
+  int64_t modified_rows() const
+  {
+    return modified_rows_;
+  }
+  bool analyzed() const
+  {
+    return analyzed_;
+  }
+
+  const ColumnStats *column(const char *field_name) const;
+
+  void on_insert(const char *record);
+  void on_delete();
+  void on_update(const char *field_name, const char *data);
+
+  /**
+   * 用ANALYZE的结果替换当前的统计信息
+   */
+  void reset(int64_t row_count, std::vector<ColumnStats> &&columns);
+  const std::vector<ColumnStats> &columns() const
+  {
+    return columns_;
+  }
+
+  void to_json(Json::Value &json_value) const;
+  static RC from_json(const Json::Value &json_value, const std::vector<FieldMeta> &fields, int sys_field_num,
+                      TableStats &stats);
+
+private:
+  int64_t row_count_ = -1;
+  int64_t modified_rows_ = 0;
+  bool analyzed_ = false;
+  std::vector<ColumnStats> columns_;  // 不包含系统字段
+};
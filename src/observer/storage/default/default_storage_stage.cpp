@@ -29,6 +29,8 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/table.h"
 #include "storage/common/table_meta.h"
 #include "storage/trx/trx.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/default/spill_file.h"
 #include "event/session_event.h"
 #include "event/sql_event.h"
 #include "event/storage_event.h"
@@ -39,6 +41,8 @@ using namespace common;
 const std::string DefaultStorageStage::QUERY_METRIC_TAG = "DefaultStorageStage.query";
 const char *CONF_BASE_DIR = "BaseDir";
 const char *CONF_SYSTEM_DB = "SystemDb";
+const char *CONF_BPLUS_TREE_MERGE_THRESHOLD = "BplusTreeMergeThreshold";
+const char *CONF_BPLUS_TREE_COMPACT_PENDING = "BplusTreeCompactPending";
 
 const char *DEFAULT_SYSTEM_DB = "sys";
 
@@ -87,11 +91,31 @@ bool DefaultStorageStage::set_properties()
     LOG_INFO("Use %s as system db", sys_db);
   }
 
+  iter = section.find(CONF_BPLUS_TREE_MERGE_THRESHOLD);
+  if (iter != section.end()) {
+    int merge_threshold = 0;
+    if (str_to_val(iter->second, merge_threshold)) {
+      BplusTreeHandler::set_default_merge_threshold(merge_threshold);
+      LOG_INFO("Use %d%% as bplus tree merge threshold", merge_threshold);
+    }
+  }
+
+  iter = section.find(CONF_BPLUS_TREE_COMPACT_PENDING);
+  if (iter != section.end()) {
+    int compact_pending = 0;
+    if (str_to_val(iter->second, compact_pending)) {
+      BplusTreeHandler::set_default_compact_pending(compact_pending);
+      LOG_INFO("Use %d as bplus tree compact pending pages", compact_pending);
+    }
+  }
+
   handler_ = &DefaultHandler::get_default();
   if (RC::SUCCESS != handler_->init(base_dir)) {
     LOG_ERROR("Failed to init default handler");
     return false;
   }
+  // 算子内存不够时使用的临时文件也放在数据目录下
+  SpillFile::set_directory(base_dir);
 
   RC ret = handler_->create_db(sys_db);
   if (ret != RC::SUCCESS && ret != RC::SCHEMA_DB_EXIST) {
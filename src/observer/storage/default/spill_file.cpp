@@ -0,0 +1,194 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+
+#include "common/log/log.h"
+#include "storage/default/spill_file.h"
+
+std::string SpillFile::directory_ = ".";
+
+static std::atomic<int> spill_file_sequence(0);
+
+static const int SPILL_PAGE_HEADER_SIZE = sizeof(int32_t);
+
+void SpillFile::set_directory(const std::string &directory)
+{
+  directory_ = directory;
+}
+
+bool SpillFile::can_spill(int row_size)
+{
+  return row_size > 0 && row_size <= (int)BP_PAGE_DATA_SIZE - SPILL_PAGE_HEADER_SIZE;
+}
+
+SpillFile::SpillFile(int row_size) : row_size_(row_size)
+{
+  if (can_spill(row_size)) {
+    rows_per_page_ = (BP_PAGE_DATA_SIZE - SPILL_PAGE_HEADER_SIZE) / row_size;
+  }
+}
+
+SpillFile::~SpillFile()
+{
+  destroy();
+}
+
+RC SpillFile::create()
+{
+  if (rows_per_page_ <= 0) {
+    LOG_WARN("row is too large to spill. row size=%d", row_size_);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  file_name_ = directory_ + "/spill_" + std::to_string(getpid()) + "_" +
+               std::to_string(spill_file_sequence++) + ".tmp";
+  BufferPoolManager &bpm = BufferPoolManager::instance();
+  RC rc = bpm.create_file(file_name_.c_str());
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to create spill file %s. rc=%s", file_name_.c_str(), strrc(rc));
+    file_name_.clear();
+    return rc;
+  }
+
+  rc = bpm.open_file(file_name_.c_str(), buffer_pool_);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open spill file %s. rc=%s", file_name_.c_str(), strrc(rc));
+    ::remove(file_name_.c_str());
+    file_name_.clear();
+    buffer_pool_ = nullptr;
+    return rc;
+  }
+  return RC::SUCCESS;
+}
+
+RC SpillFile::release_frame()
+{
+  if (frame_ == nullptr) {
+    return RC::SUCCESS;
+  }
+
+  const PageNum page_num = frame_->page_num();
+  RC rc = buffer_pool_->unpin_page(frame_);
+  frame_ = nullptr;
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  // 临时文件的页面不会马上再被访问，直接写回磁盘，把内存还给缓冲池
+  return buffer_pool_->purge_page(page_num);
+}
+
+RC SpillFile::append(const char *row)
+{
+  RC rc = RC::SUCCESS;
+  if (buffer_pool_ == nullptr) {
+    rc = create();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  int32_t *page_rows = frame_ == nullptr ? nullptr : (int32_t *)frame_->data();
+  if (page_rows == nullptr || *page_rows >= rows_per_page_) {
+    rc = release_frame();
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to release spill page. file=%s, rc=%s", file_name_.c_str(), strrc(rc));
+      return rc;
+    }
+    // 第0页是文件头
+    if ((int)pages_.size() + 1 >= BPFileHeader::MAX_PAGE_NUM) {
+      LOG_WARN("spill file is full. file=%s", file_name_.c_str());
+      return RC::NOMEM;
+    }
+    rc = buffer_pool_->allocate_page(&frame_);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to allocate spill page. file=%s, rc=%s", file_name_.c_str(), strrc(rc));
+      return rc;
+    }
+    pages_.push_back(frame_->page_num());
+    page_rows = (int32_t *)frame_->data();
+    *page_rows = 0;
+  }
+
+  char *dest = frame_->data() + SPILL_PAGE_HEADER_SIZE + (size_t)(*page_rows) * row_size_;
+  memcpy(dest, row, row_size_);
+  (*page_rows)++;
+  frame_->mark_dirty();
+  row_count_++;
+  return RC::SUCCESS;
+}
+
+RC SpillFile::rewind()
+{
+  RC rc = release_frame();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to release spill page. file=%s, rc=%s", file_name_.c_str(), strrc(rc));
+    return rc;
+  }
+  page_index_ = 0;
+  row_index_ = 0;
+  return RC::SUCCESS;
+}
+
+RC SpillFile::next(const char *&row)
+{
+  RC rc = RC::SUCCESS;
+  while (true) {
+    if (frame_ != nullptr) {
+      const int32_t page_rows = *(const int32_t *)frame_->data();
+      if (row_index_ < page_rows) {
+        row = frame_->data() + SPILL_PAGE_HEADER_SIZE + (size_t)row_index_ * row_size_;
+        row_index_++;
+        return RC::SUCCESS;
+      }
+
+      rc = release_frame();
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      page_index_++;
+    }
+
+    if (page_index_ >= pages_.size()) {
+      return RC::RECORD_EOF;
+    }
+
+    rc = buffer_pool_->get_this_page(pages_[page_index_], &frame_);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to read spill page. file=%s, page=%d, rc=%s",
+               file_name_.c_str(), pages_[page_index_], strrc(rc));
+      frame_ = nullptr;
+      return rc;
+    }
+    row_index_ = 0;
+  }
+}
+
+void SpillFile::destroy()
+{
+  if (buffer_pool_ == nullptr) {
+    return;
+  }
+
+  if (frame_ != nullptr) {
+    buffer_pool_->unpin_page(frame_);
+    frame_ = nullptr;
+  }
+  RC rc = BufferPoolManager::instance().remove_file(file_name_.c_str());
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to remove spill file %s. rc=%s", file_name_.c_str(), strrc(rc));
+  }
+  buffer_pool_ = nullptr;
+  pages_.clear();
+  row_count_ = 0;
+}
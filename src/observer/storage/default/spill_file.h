@@ -0,0 +1,86 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "storage/default/disk_buffer_pool.h"
+#include "rc.h"
+
+/**
+ * 算子内存不够时用来临时保存定长行数据的文件，通过DiskBufferPool读写
+ * 每个页面开头是页面内的行数，后面依次是每一行。写完的页面立即从缓冲池中淘汰，
+ * 读写时都只有当前页面留在内存中。对象析构时删除文件
+ */
+class SpillFile
+{
+public:
+  explicit SpillFile(int row_size);
+  ~SpillFile();
+
+  SpillFile(const SpillFile &) = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+
+  /**
+   * 临时文件所在的目录，默认是当前目录
+   */
+  static void set_directory(const std::string &directory);
+
+  /**
+   * 一行数据超过一个页面时不能写到临时文件中
+   */
+  static bool can_spill(int row_size);
+
+  /**
+   * 第一次写入时才创建文件
+   */
+  RC append(const char *row);
+
+  /**
+   * 从第一行开始读，之后不能再写入
+   */
+  RC rewind();
+
+  /**
+   * @param row 指向页面中的数据，下一次调用next之前有效
+   * @return 没有更多数据时返回RECORD_EOF
+   */
+  RC next(const char *&row);
+
+  int row_size() const
+  {
+    return row_size_;
+  }
+  int row_count() const
+  {
+    return row_count_;
+  }
+
+private:
+  RC create();
+  RC release_frame();
+  void destroy();
+
+private:
+  static std::string directory_;
+
+  int row_size_ = 0;
+  int rows_per_page_ = 0;
+  int row_count_ = 0;
+
+  std::string file_name_;
+  DiskBufferPool *buffer_pool_ = nullptr;
+  std::vector<PageNum> pages_;
+
+  Frame *frame_ = nullptr;   // 正在读或者写的页面
+  size_t page_index_ = 0;    // 读取时frame_在pages_中的位置
+  int row_index_ = 0;        // 读取时下一行在页面中的位置
+};
@@ -12,14 +12,60 @@ See the Mulan PSL v2 for more details. */
 // Created by Xie Meiyi
 // Rewritten by Longda & Wangyunlai
 //
+#include <algorithm>
+
 #include "storage/index/bplus_tree.h"
 #include "storage/default/disk_buffer_pool.h"
 #include "rc.h"
 #include "common/log/log.h"
+#include "common/metrics/metrics.h"
+#include "common/metrics/metrics_registry.h"
 #include "sql/parser/parse_defs.h"
 
 #define FIRST_INDEX_PAGE 1
 
+using namespace common;
+
+namespace {
+/**
+ * 所有B+树共用的结构调整计数，MetricsStage会定期把它们换算成每秒的次数
+ */
+struct BplusTreeMetrics {
+  BplusTreeMetrics()
+  {
+    MetricsRegistry &metrics_registry = get_metrics_registry();
+    metrics_registry.register_metric("bplus_tree.split", split);
+    metrics_registry.register_metric("bplus_tree.merge", merge);
+    metrics_registry.register_metric("bplus_tree.redistribute", redistribute);
+    metrics_registry.register_metric("bplus_tree.lazy_delete", lazy_delete);
+  }
+
+  Meter *split = new Meter();
+  Meter *merge = new Meter();
+  Meter *redistribute = new Meter();
+  Meter *lazy_delete = new Meter();
+};
+
+BplusTreeMetrics &bplus_tree_metrics()
+{
+  static BplusTreeMetrics metrics;
+  return metrics;
+}
+}  // namespace
+
+int BplusTreeHandler::default_merge_threshold_ = 25;
+int BplusTreeHandler::default_compact_pending_ = 64;
+
+void BplusTreeHandler::set_default_merge_threshold(int percent)
+{
+  default_merge_threshold_ = percent;
+}
+
+void BplusTreeHandler::set_default_compact_pending(int pages)
+{
+  default_compact_pending_ = pages;
+}
+
 int calc_internal_page_capacity(int attr_length)
 {
   int item_size = attr_length + sizeof(RID) + sizeof(PageNum);
@@ -29,9 +75,9 @@ int calc_internal_page_capacity(int attr_length)
   return capacity;
 }
 
-int calc_leaf_page_capacity(int attr_length)
+int calc_leaf_page_capacity(int attr_length, int include_length)
 {
-  int item_size = attr_length + sizeof(RID) + sizeof(RID);
+  int item_size = attr_length + sizeof(RID) + sizeof(RID) + include_length;
   int capacity =
     ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / item_size;
   return capacity;
@@ -64,8 +110,8 @@ int IndexNodeHandler::key_size() const
 
 int IndexNodeHandler::value_size() const
 {
-  // return header_.value_size;
-  return sizeof(RID);
+  // 叶子节点的value是rid以及include字段，内部节点会覆盖这个函数
+  return sizeof(RID) + header_.include_length;
 }
 
 int IndexNodeHandler::item_size() const
@@ -751,11 +797,17 @@ bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBuf
 
 RC BplusTreeHandler::sync()
 {
+  RC rc = compact();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to compact tree before sync. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
   return disk_buffer_pool_->flush_all_pages();
 }
 
 RC BplusTreeHandler::create(const char *file_name, AttrType attr_type, int attr_length,
-			    int internal_max_size /* = -1*/, int leaf_max_size /* = -1 */)
+			    int internal_max_size /* = -1*/, int leaf_max_size /* = -1 */, bool unique /* = false */,
+			    int include_length /* = 0 */)
 {
   BufferPoolManager &bpm = BufferPoolManager::instance();
   RC rc = bpm.create_file(file_name);
@@ -792,7 +844,7 @@ RC BplusTreeHandler::create(const char *file_name, AttrType attr_type, int attr_
     internal_max_size = calc_internal_page_capacity(attr_length);
   }
   if (leaf_max_size < 0) {
-    leaf_max_size = calc_leaf_page_capacity(attr_length);
+    leaf_max_size = calc_leaf_page_capacity(attr_length, include_length);
   }
 
   char *pdata = header_frame->data();
@@ -803,6 +855,8 @@ RC BplusTreeHandler::create(const char *file_name, AttrType attr_type, int attr_
   file_header->internal_max_size = internal_max_size;
   file_header->leaf_max_size = leaf_max_size;
   file_header->root_page = BP_INVALID_PAGE_NUM;
+  file_header->unique = unique ? 1 : 0;
+  file_header->include_length = include_length;
 
   header_frame->mark_dirty();
 
@@ -813,7 +867,7 @@ RC BplusTreeHandler::create(const char *file_name, AttrType attr_type, int attr_
   bp->unpin_page(header_frame);
 
   mem_pool_item_ = new common::MemPoolItem(file_name);
-  if (mem_pool_item_->init(file_header->key_length) < 0) {
+  if (mem_pool_item_->init(file_header->key_length + sizeof(RID) + file_header->include_length) < 0) {
     LOG_WARN("Failed to init memory pool for index %s", file_name);
     close();
     return RC::NOMEM;
@@ -854,7 +908,7 @@ RC BplusTreeHandler::open(const char *file_name)
   disk_buffer_pool_ = disk_buffer_pool;
 
   mem_pool_item_ = new common::MemPoolItem(file_name);
-  if (mem_pool_item_->init(file_header_.key_length) < 0) {
+  if (mem_pool_item_->init(file_header_.key_length + sizeof(RID) + file_header_.include_length) < 0) {
     LOG_WARN("Failed to init memory pool for index %s", file_name);
     close();
     return RC::NOMEM;
@@ -872,6 +926,9 @@ RC BplusTreeHandler::open(const char *file_name)
 RC BplusTreeHandler::close()
 {
   if (disk_buffer_pool_ != nullptr) {
+    compact();
+    LOG_INFO("close bplus tree. splits=%ld, merges=%ld, redistributes=%ld, lazy deletes=%ld, compactions=%ld",
+             stat_.splits, stat_.merges, stat_.redistributes, stat_.lazy_deletes, stat_.compactions);
 
     disk_buffer_pool_->close_file(); // TODO
 
@@ -879,6 +936,7 @@ RC BplusTreeHandler::close()
     mem_pool_item_ = nullptr;
   }
 
+  underflow_pages_.clear();
   disk_buffer_pool_ = nullptr;
   return RC::SUCCESS;
 }
@@ -887,12 +945,15 @@ RC BplusTreeHandler::drop(){
   RC rc = RC::SUCCESS;
   if (disk_buffer_pool_ != nullptr) {
     BufferPoolManager &bpm = BufferPoolManager::instance();
-    rc = bpm.remove_file(disk_buffer_pool_->file_name().c_str());
+    // remove_file 会先关闭并释放buffer pool，这里需要先把文件名拷贝出来
+    std::string file_name = disk_buffer_pool_->file_name();
+    rc = bpm.remove_file(file_name.c_str());
 
     delete mem_pool_item_;
     mem_pool_item_ = nullptr;
   }
 
+  underflow_pages_.clear();
   disk_buffer_pool_ = nullptr;
   return RC::SUCCESS;
 }
@@ -1117,6 +1178,11 @@ bool BplusTreeHandler::is_empty() const
   return file_header_.root_page == BP_INVALID_PAGE_NUM;
 }
 
+bool BplusTreeHandler::is_unique() const
+{
+  return file_header_.unique != 0;
+}
+
 RC BplusTreeHandler::find_leaf(const char *key, Frame *&frame)
 {
   return find_leaf_internal(
@@ -1176,7 +1242,7 @@ RC BplusTreeHandler::find_leaf_internal(const std::function<PageNum(InternalInde
   return RC::SUCCESS;
 }
 
-RC BplusTreeHandler::insert_entry_into_leaf_node(Frame *frame, const char *key, const RID *rid)
+RC BplusTreeHandler::insert_entry_into_leaf_node(Frame *frame, const char *key, const char *value)
 {
   LeafIndexNodeHandler leaf_node(file_header_, frame);
   bool exists = false;
@@ -1186,8 +1252,15 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(Frame *frame, const char *key,
     return RC::RECORD_DUPLICATE_KEY;
   }
 
+  if (is_unique()) {
+    RC rc = check_unique(leaf_node, insert_position, key);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
   if (leaf_node.size() < leaf_node.max_size()) {
-    leaf_node.insert(insert_position, key, (const char *)rid);
+    leaf_node.insert(insert_position, key, value);
     frame->mark_dirty();
     disk_buffer_pool_->unpin_page(frame);
     return RC::SUCCESS;
@@ -1221,14 +1294,59 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(Frame *frame, const char *key,
   }
 
   if (insert_position < leaf_node.size()) {
-    leaf_node.insert(insert_position, key, (const char *)rid);
+    leaf_node.insert(insert_position, key, value);
   } else {
-    new_index_node.insert(insert_position - leaf_node.size(), key, (const char *)rid);
+    new_index_node.insert(insert_position - leaf_node.size(), key, value);
   }
 
   return insert_entry_into_parent(frame, new_frame, new_index_node.key_at(0));
 }
 
+/**
+ * key按照(user key, rid)排序，与待插入key的user key相同的项只可能紧挨着插入位置，
+ * 所以只需要检查插入位置左右两项，插入位置在叶子边界时再看一眼兄弟节点，不需要再做一次查找
+ */
+RC BplusTreeHandler::check_unique(LeafIndexNodeHandler &leaf_node, int insert_position, const char *key)
+{
+  const AttrComparator &attr_comparator = key_comparator_.attr_comparator();
+  if (insert_position > 0 && attr_comparator(key, leaf_node.key_at(insert_position - 1)) == 0) {
+    LOG_TRACE("user key exists in unique index");
+    return RC::RECORD_DUPLICATE_KEY;
+  }
+  if (insert_position < leaf_node.size() && attr_comparator(key, leaf_node.key_at(insert_position)) == 0) {
+    LOG_TRACE("user key exists in unique index");
+    return RC::RECORD_DUPLICATE_KEY;
+  }
+
+  PageNum brother_page_num = BP_INVALID_PAGE_NUM;
+  if (insert_position == 0) {
+    brother_page_num = leaf_node.prev_page();
+  } else if (insert_position == leaf_node.size()) {
+    brother_page_num = leaf_node.next_page();
+  }
+  if (brother_page_num == BP_INVALID_PAGE_NUM) {
+    return RC::SUCCESS;
+  }
+
+  Frame *brother_frame = nullptr;
+  RC rc = disk_buffer_pool_->get_this_page(brother_page_num, &brother_frame);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to fetch brother page. page num=%d, rc=%d:%s", brother_page_num, rc, strrc(rc));
+    return rc;
+  }
+
+  LeafIndexNodeHandler brother_node(file_header_, brother_frame);
+  if (brother_node.size() > 0) {
+    int index = insert_position == 0 ? brother_node.size() - 1 : 0;
+    if (attr_comparator(key, brother_node.key_at(index)) == 0) {
+      LOG_TRACE("user key exists in unique index");
+      rc = RC::RECORD_DUPLICATE_KEY;
+    }
+  }
+  disk_buffer_pool_->unpin_page(brother_frame);
+  return rc;
+}
+
 RC BplusTreeHandler::insert_entry_into_parent(Frame *frame, Frame *new_frame, const char *key)
 {
   RC rc = RC::SUCCESS;
@@ -1352,6 +1470,8 @@ RC BplusTreeHandler::split(Frame *frame, Frame *&new_frame)
 
   frame->mark_dirty();
   new_frame->mark_dirty();
+  stat_.splits++;
+  bplus_tree_metrics().split->inc();
   return RC::SUCCESS;
 }
 
@@ -1372,7 +1492,7 @@ RC BplusTreeHandler::update_root_page_num()
 }
 
 
-RC BplusTreeHandler::create_new_tree(const char *key, const RID *rid)
+RC BplusTreeHandler::create_new_tree(const char *key, const char *value)
 {
   RC rc = RC::SUCCESS;
   if (file_header_.root_page != BP_INVALID_PAGE_NUM) {
@@ -1390,7 +1510,7 @@ RC BplusTreeHandler::create_new_tree(const char *key, const RID *rid)
 
   LeafIndexNodeHandler leaf_node(file_header_, frame);
   leaf_node.init_empty();
-  leaf_node.insert(0, key, (const char *)rid);
+  leaf_node.insert(0, key, value);
   file_header_.root_page = frame->page_num();
   frame->mark_dirty();
   disk_buffer_pool_->unpin_page(frame);
@@ -1417,7 +1537,7 @@ void BplusTreeHandler::free_key(char *key)
   mem_pool_item_->free(key);
 }
 
-RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
+RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid, const char *include_data /* = nullptr */)
 {
   if (user_key == nullptr || rid == nullptr) {
     LOG_WARN("Invalid arguments, key is empty or rid is empty");
@@ -1430,8 +1550,21 @@ RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
     return RC::NOMEM;
   }
 
+  // key后面紧跟着叶子节点的value: rid + include字段
+  char *value = key + file_header_.key_length;
+  memcpy(value, rid, sizeof(*rid));
+  if (file_header_.include_length > 0) {
+    if (include_data != nullptr) {
+      memcpy(value + sizeof(*rid), include_data, file_header_.include_length);
+    } else {
+      memset(value + sizeof(*rid), 0, file_header_.include_length);
+    }
+  }
+
   if (is_empty()) {
-    return create_new_tree(key, rid);
+    RC rc = create_new_tree(key, value);
+    mem_pool_item_->free(key);
+    return rc;
   }
 
   Frame *frame;
@@ -1442,7 +1575,7 @@ RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
     return rc;
   }
 
-  rc = insert_entry_into_leaf_node(frame, key, rid);
+  rc = insert_entry_into_leaf_node(frame, key, value);
   if (rc != RC::SUCCESS) {
     LOG_TRACE("Failed to insert into leaf of index, rid:%s", rid->to_string().c_str());
     disk_buffer_pool_->unpin_page(frame);
@@ -1480,6 +1613,117 @@ RC BplusTreeHandler::get_entry(const char *user_key, int key_len, std::list<RID>
   return rc;
 }
 
+RC BplusTreeHandler::get_entries(const std::vector<const char *> &user_keys, std::vector<RID> &rids)
+{
+  if (user_keys.empty() || is_empty()) {
+    return RC::SUCCESS;
+  }
+
+  const AttrComparator &attr_comparator = key_comparator_.attr_comparator();
+  std::vector<const char *> keys(user_keys);
+  std::sort(keys.begin(), keys.end(), [&attr_comparator](const char *k1, const char *k2) {
+    return attr_comparator(k1, k2) < 0;
+  });
+  keys.erase(std::unique(keys.begin(), keys.end(), [&attr_comparator](const char *k1, const char *k2) {
+    return attr_comparator(k1, k2) == 0;
+  }), keys.end());
+
+  RC rc = RC::SUCCESS;
+  Frame *frame = nullptr;
+  int index = 0;
+  for (const char *user_key : keys) {
+    if (frame != nullptr) {
+      // 上一个key已经把位置停在了当前叶子节点，先尝试在当前节点以及下一个兄弟节点中继续向后找
+      LeafIndexNodeHandler leaf_node(file_header_, frame);
+      while (index < leaf_node.size() && attr_comparator(leaf_node.key_at(index), user_key) < 0) {
+        index++;
+      }
+
+      if (index >= leaf_node.size()) {
+        PageNum next_page_num = leaf_node.next_page();
+        disk_buffer_pool_->unpin_page(frame);
+        frame = nullptr;
+        if (next_page_num == BP_INVALID_PAGE_NUM) {
+          break;
+        }
+
+        rc = disk_buffer_pool_->get_this_page(next_page_num, &frame);
+        if (rc != RC::SUCCESS) {
+          LOG_WARN("failed to fetch next page. page num=%d, rc=%d:%s", next_page_num, rc, strrc(rc));
+          frame = nullptr;
+          break;
+        }
+
+        LeafIndexNodeHandler next_node(file_header_, frame);
+        if (next_node.size() > 0 && attr_comparator(next_node.key_at(next_node.size() - 1), user_key) < 0) {
+          disk_buffer_pool_->unpin_page(frame);
+          frame = nullptr;
+        } else {
+          index = 0;
+          while (index < next_node.size() && attr_comparator(next_node.key_at(index), user_key) < 0) {
+            index++;
+          }
+        }
+      }
+    }
+
+    if (frame == nullptr) {
+      char *key = make_key(user_key, *RID::min());
+      if (key == nullptr) {
+        rc = RC::NOMEM;
+        break;
+      }
+      rc = find_leaf(key, frame);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to find leaf page. rc=%d:%s", rc, strrc(rc));
+        free_key(key);
+        frame = nullptr;
+        break;
+      }
+      LeafIndexNodeHandler leaf_node(file_header_, frame);
+      index = leaf_node.lookup(key_comparator_, key);
+      free_key(key);
+    }
+
+    // 相同的user key可能跨越多个叶子节点
+    while (true) {
+      LeafIndexNodeHandler leaf_node(file_header_, frame);
+      while (index < leaf_node.size() && attr_comparator(leaf_node.key_at(index), user_key) == 0) {
+        rids.push_back(*(const RID *)leaf_node.value_at(index));
+        index++;
+      }
+      if (index < leaf_node.size() || leaf_node.next_page() == BP_INVALID_PAGE_NUM) {
+        break;
+      }
+
+      PageNum next_page_num = leaf_node.next_page();
+      disk_buffer_pool_->unpin_page(frame);
+      rc = disk_buffer_pool_->get_this_page(next_page_num, &frame);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to fetch next page. page num=%d, rc=%d:%s", next_page_num, rc, strrc(rc));
+        frame = nullptr;
+        break;
+      }
+      index = 0;
+    }
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+  }
+
+  if (frame != nullptr) {
+    disk_buffer_pool_->unpin_page(frame);
+  }
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  std::sort(rids.begin(), rids.end(), [](const RID &rid1, const RID &rid2) {
+    return RID::compare(&rid1, &rid2) < 0;
+  });
+  return RC::SUCCESS;
+}
+
 RC BplusTreeHandler::adjust_root(Frame *root_frame)
 {
   IndexNodeHandler root_node(file_header_, root_frame);
@@ -1515,9 +1759,15 @@ RC BplusTreeHandler::adjust_root(Frame *root_frame)
 
   PageNum old_root_page_num = root_frame->page_num();
   disk_buffer_pool_->unpin_page(root_frame);
-  disk_buffer_pool_->dispose_page(old_root_page_num);
+  dispose_page(old_root_page_num);
   return RC::SUCCESS;
 }
+
+void BplusTreeHandler::dispose_page(PageNum page_num)
+{
+  underflow_pages_.erase(page_num);
+  disk_buffer_pool_->dispose_page(page_num);
+}
 template <typename IndexNodeHandlerType>
 RC BplusTreeHandler::coalesce_or_redistribute(Frame *frame)
 {
@@ -1639,7 +1889,9 @@ RC BplusTreeHandler::coalesce(Frame *neighbor_frame, Frame *frame, Frame *parent
   PageNum right_page_num = right_frame->page_num();
   disk_buffer_pool_->unpin_page(left_frame);
   disk_buffer_pool_->unpin_page(right_frame);
-  disk_buffer_pool_->dispose_page(right_page_num);
+  dispose_page(right_page_num);
+  stat_.merges++;
+  bplus_tree_metrics().merge->inc();
   return coalesce_or_redistribute<InternalIndexNodeHandler>(parent_frame);
 }
 
@@ -1672,6 +1924,8 @@ RC BplusTreeHandler::redistribute(Frame *neighbor_frame, Frame *frame, Frame *pa
   neighbor_frame->mark_dirty();
   frame->mark_dirty();
   parent_frame->mark_dirty();
+  stat_.redistributes++;
+  bplus_tree_metrics().redistribute->inc();
   disk_buffer_pool_->unpin_page(parent_frame);
   disk_buffer_pool_->unpin_page(neighbor_frame);
   disk_buffer_pool_->unpin_page(frame);
@@ -1697,9 +1951,65 @@ RC BplusTreeHandler::delete_entry_internal(Frame *leaf_frame, const char *key)
     return RC::SUCCESS;
   }
 
+  if (leaf_index_node.parent_page_num() != BP_INVALID_PAGE_NUM &&
+      leaf_index_node.size() >= merge_threshold_size(leaf_index_node)) {
+    underflow_pages_.insert(leaf_frame->page_num());
+    stat_.lazy_deletes++;
+    bplus_tree_metrics().lazy_delete->inc();
+    disk_buffer_pool_->unpin_page(leaf_frame);
+    if (compact_pending_ > 0 && (int)underflow_pages_.size() >= compact_pending_) {
+      return compact();
+    }
+    return RC::SUCCESS;
+  }
+
   return coalesce_or_redistribute<LeafIndexNodeHandler>(leaf_frame);
 }
 
+int BplusTreeHandler::merge_threshold_size(const LeafIndexNodeHandler &node) const
+{
+  if (merge_threshold_ >= 50) {
+    return node.min_size();
+  }
+  // 叶子节点不能变空：扫描时不能遇到空节点，合并时也需要用节点中的key在父节点中定位
+  return std::min(node.min_size(), std::max(2, node.max_size() * merge_threshold_ / 100));
+}
+
+RC BplusTreeHandler::compact()
+{
+  if (disk_buffer_pool_ == nullptr) {
+    return RC::SUCCESS;
+  }
+
+  // 合并的过程中可能会释放其它待处理的页面，所以每次只取一个
+  while (!underflow_pages_.empty()) {
+    const PageNum page_num = *underflow_pages_.begin();
+    underflow_pages_.erase(underflow_pages_.begin());
+
+    Frame *frame = nullptr;
+    RC rc = disk_buffer_pool_->get_this_page(page_num, &frame);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to fetch underflow page. page num=%d, rc=%d:%s", page_num, rc, strrc(rc));
+      return rc;
+    }
+
+    LeafIndexNodeHandler node(file_header_, frame);
+    if (node.size() >= node.min_size()) {
+      // 之后又插入了数据
+      disk_buffer_pool_->unpin_page(frame);
+      continue;
+    }
+
+    stat_.compactions++;
+    rc = coalesce_or_redistribute<LeafIndexNodeHandler>(frame);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to compact page. page num=%d, rc=%d:%s", page_num, rc, strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
 RC BplusTreeHandler::delete_entry(const char *user_key, const RID *rid)
 {
   char *key = (char *)mem_pool_item_->alloc();
@@ -1727,12 +2037,12 @@ RC BplusTreeHandler::delete_entry(const char *user_key, const RID *rid)
   return RC::SUCCESS;
 }
 
-RC BplusTreeHandler::update_entry(const char *user_key, const RID *rid){
+RC BplusTreeHandler::update_entry(const char *user_key, const RID *rid, const char *include_data /* = nullptr */){
   RC rc = delete_entry(user_key, rid);
   if (rc != RC::SUCCESS){
     return rc;
   }
-  rc = insert_entry(user_key, rid);
+  rc = insert_entry(user_key, rid, include_data);
   return rc;
 }
 
@@ -1745,7 +2055,7 @@ BplusTreeScanner::~BplusTreeScanner()
 }
 
 RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inclusive,
-                          const char *right_user_key, int right_len, bool right_inclusive)
+                          const char *right_user_key, int right_len, bool right_inclusive, bool reverse /* = false */)
 {
   RC rc = RC::SUCCESS;
   if (inited_) {
@@ -1754,14 +2064,18 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
   }
 
   inited_ = true;
+  reverse_ = reverse;
+
+  // 空树没有叶子节点，直接返回空的扫描结果
+  if (tree_handler_.is_empty()) {
+    end_index_ = -1;
+    return RC::SUCCESS;
+  }
   
   // 校验输入的键值是否是合法范围
   if (left_user_key && right_user_key) {
     const auto &attr_comparator = tree_handler_.key_comparator_.attr_comparator();
-    LOG_ERROR("compare start");
-    LOG_ERROR("left_user_key: %s. right_user_key: %s", left_user_key, right_user_key);
     const int result = attr_comparator(left_user_key, right_user_key);
-    LOG_ERROR("compare end");
     if (result > 0 || // left < right
          // left == right but is (left,right)/[left,right) or (left,right]
 	(result == 0 && (left_inclusive == false || right_inclusive == false))) { 
@@ -1923,13 +2237,75 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
 }
 
 RC BplusTreeScanner::next_entry(RID *rid)
+{
+  return next_entry(rid, nullptr, nullptr);
+}
+
+void BplusTreeScanner::copy_entry(Frame *frame, int index, RID *rid, char *user_key, char *include_data)
+{
+  LeafIndexNodeHandler node(tree_handler_.file_header_, frame);
+  memcpy(rid, node.value_at(index), sizeof(*rid));
+  if (user_key != nullptr) {
+    memcpy(user_key, node.key_at(index), tree_handler_.file_header_.attr_length);
+  }
+  if (include_data != nullptr) {
+    memcpy(include_data, node.value_at(index) + sizeof(*rid), tree_handler_.file_header_.include_length);
+  }
+}
+
+RC BplusTreeScanner::prev_entry(RID *rid, char *user_key, char *include_data)
+{
+  copy_entry(right_frame_, end_index_, rid, user_key, include_data);
+
+  if (left_frame_->page_num() == right_frame_->page_num() &&
+      iter_index_ == end_index_) {
+    end_index_ = -1;
+    return RC::SUCCESS;
+  }
+
+  if (end_index_ > 0) {
+    --end_index_;
+    return RC::SUCCESS;
+  }
+
+  if (left_frame_->page_num() == right_frame_->page_num()) {
+    LOG_WARN("should have more entries but not. page=%d, begin index=%d", left_frame_->page_num(), iter_index_);
+    return RC::INTERNAL;
+  }
+
+  LeafIndexNodeHandler node(tree_handler_.file_header_, right_frame_);
+  PageNum page_num = node.prev_page();
+  tree_handler_.disk_buffer_pool_->unpin_page(right_frame_);
+  right_frame_ = nullptr;
+  if (page_num == BP_INVALID_PAGE_NUM) {
+    LOG_WARN("got invalid prev page. page num=%d", page_num);
+    return RC::INTERNAL;
+  }
+
+  RC rc = tree_handler_.disk_buffer_pool_->get_this_page(page_num, &right_frame_);
+  if (rc != RC::SUCCESS) {
+    right_frame_ = nullptr;
+    LOG_WARN("failed to fetch prev page. page num=%d, rc=%d:%s", page_num, rc, strrc(rc));
+    return rc;
+  }
+
+  LeafIndexNodeHandler prev_node(tree_handler_.file_header_, right_frame_);
+  end_index_ = prev_node.size() - 1;
+  return RC::SUCCESS;
+}
+
+RC BplusTreeScanner::next_entry(RID *rid, char *user_key, char *include_data)
 {
   if (-1 == end_index_) {
     return RC::RECORD_EOF;
   }
 
+  if (reverse_) {
+    return prev_entry(rid, user_key, include_data);
+  }
+
   LeafIndexNodeHandler node(tree_handler_.file_header_, left_frame_);
-  memcpy(rid, node.value_at(iter_index_), sizeof(*rid));
+  copy_entry(left_frame_, iter_index_, rid, user_key, include_data);
 
   if (left_frame_->page_num() == right_frame_->page_num() &&
       iter_index_ == end_index_) {
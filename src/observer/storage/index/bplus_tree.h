@@ -20,6 +20,8 @@ See the Mulan PSL v2 for more details. */
 #include <string.h>
 #include <sstream>
 #include <functional>
+#include <set>
+#include <vector>
 
 #include "storage/common/record_manager.h"
 #include "storage/default/disk_buffer_pool.h"
@@ -190,6 +192,8 @@ struct IndexFileHeader {
   int32_t  attr_length;
   int32_t  key_length; // attr length + sizeof(RID)
   AttrType attr_type;
+  int32_t  unique;     // 唯一索引不允许出现相同的user key
+  int32_t  include_length; // 叶子节点中跟在rid后面的include字段长度
 
   const std::string to_string()
   {
@@ -200,7 +204,9 @@ struct IndexFileHeader {
        << "attr_type:" << attr_type << ","
        << "root_page:" << root_page << ","
        << "internal_max_size:" << internal_max_size << ","
-       << "leaf_max_size:" << leaf_max_size << ";";
+       << "leaf_max_size:" << leaf_max_size << ","
+       << "unique:" << unique << ","
+       << "include_length:" << include_length << ";";
 
     return ss.str();
   }
@@ -392,14 +398,27 @@ private:
   InternalIndexNode *internal_node_;
 };
 
+/**
+ * B+树结构调整的次数，每秒的次数通过全局的metrics输出
+ */
+struct BplusTreeStat {
+  long splits = 0;
+  long merges = 0;
+  long redistributes = 0;
+  long lazy_deletes = 0;  // 节点不足半满，但是没有马上合并的删除次数
+  long compactions = 0;   // compact时处理的节点数
+};
+
 class BplusTreeHandler {
 public:
   /**
    * 此函数创建一个名为fileName的索引。
    * attrType描述被索引属性的类型，attrLength描述被索引属性的长度
+   * unique 为true时创建唯一索引，插入相同的user key会返回RECORD_DUPLICATE_KEY
+   * include_length 是叶子节点中额外保存的include字段的长度，用于覆盖索引
    */
   RC create(const char *file_name, AttrType attr_type, int attr_length,
-	    int internal_max_size = -1, int leaf_max_size = -1);
+	    int internal_max_size = -1, int leaf_max_size = -1, bool unique = false, int include_length = 0);
 
   /**
    * 打开名为fileName的索引文件。
@@ -418,8 +437,9 @@ public:
    * 参数user_key指向要插入的属性值，参数rid标识该索引项对应的元组，
    * 即向索引中插入一个值为（user_key，rid）的键值对
    * @note 这里假设user_key的内存大小与attr_length 一致
+   * @param include_data include字段的数据，长度为include_length，没有include字段时可以为空
    */
-  RC insert_entry(const char *user_key, const RID *rid);
+  RC insert_entry(const char *user_key, const RID *rid, const char *include_data = nullptr);
 
   /**
    * 从IndexHandle句柄对应的索引中删除一个值为（*pData，rid）的索引项
@@ -428,9 +448,10 @@ public:
    */
   RC delete_entry(const char *user_key, const RID *rid);
 
-  RC update_entry(const char *user_key, const RID *rid);
+  RC update_entry(const char *user_key, const RID *rid, const char *include_data = nullptr);
 
   bool is_empty() const;
+  bool is_unique() const;
 
   /**
    * 获取指定值的record
@@ -439,8 +460,46 @@ public:
    */
   RC get_entry(const char *user_key, int key_len, std::list<RID> &rids);
 
+  /**
+   * 批量获取多个值对应的record
+   * 先对user_keys排序，然后沿着叶子节点的链表向后查找，只有下一个叶子节点也放不下时才重新从根节点查找。
+   * 返回的rid按照页面排序，方便调用方每个数据页只访问一次
+   * @note 这里假设每个user_key的内存大小与attr_length 一致
+   */
+  RC get_entries(const std::vector<const char *> &user_keys, std::vector<RID> &rids);
+
+  /**
+   * 同步之前会先整理删除时延迟合并的节点
+   */
   RC sync();
 
+  /**
+   * 删除数据后，叶子节点低于容量的merge_threshold%才马上合并或者从相邻节点借数据，
+   * 介于阈值和半满之间的节点先记录下来，由compact统一处理，
+   * 这样删除之后在附近重新插入数据时就不会反复地合并和分裂。
+   * 50及以上与删除时马上调整的行为一致
+   */
+  static void set_default_merge_threshold(int percent);
+  /**
+   * 延迟合并的节点个数达到pages时，删除操作会顺便执行一次compact
+   */
+  static void set_default_compact_pending(int pages);
+
+  void set_merge_threshold(int percent)
+  {
+    merge_threshold_ = percent;
+  }
+
+  /**
+   * 合并或者重新分布之前延迟处理的节点
+   */
+  RC compact();
+
+  const BplusTreeStat &stat() const
+  {
+    return stat_;
+  }
+
   /**
    * Check whether current B+ tree is invalid or not.
    * return true means current tree is valid, return false means current tree is invalid.
@@ -484,12 +543,19 @@ protected:
   RC redistribute(Frame *neighbor_frame, Frame *frame, Frame *parent_frame, int index);
 
   RC insert_entry_into_parent(Frame *frame, Frame *new_frame, const char *key);
-  RC insert_entry_into_leaf_node(Frame *frame, const char *pkey, const RID *rid);
+  RC insert_entry_into_leaf_node(Frame *frame, const char *pkey, const char *value);
+  RC check_unique(LeafIndexNodeHandler &leaf_node, int insert_position, const char *key);
   RC update_root_page_num();
-  RC create_new_tree(const char *key, const RID *rid);
+  RC create_new_tree(const char *key, const char *value);
 
   RC adjust_root(Frame *root_frame);
 
+  /**
+   * 叶子节点低于这个大小时，删除后需要马上调整
+   */
+  int merge_threshold_size(const LeafIndexNodeHandler &node) const;
+  void dispose_page(PageNum page_num);
+
 private:
   char *make_key(const char *user_key, const RID &rid);
   void  free_key(char *key);
@@ -503,6 +569,13 @@ protected:
 
   common::MemPoolItem *mem_pool_item_ = nullptr;
 
+  static int default_merge_threshold_;
+  static int default_compact_pending_;
+  int merge_threshold_ = default_merge_threshold_;
+  int compact_pending_ = default_compact_pending_;
+  std::set<PageNum> underflow_pages_;  // 延迟合并的叶子节点
+  BplusTreeStat stat_;
+
 private:
   friend class BplusTreeScanner;
   friend class BplusTreeTester;
@@ -521,12 +594,20 @@ public:
    * @param right_user_key 扫描范围的右边界。如果是null，则没有右边界
    * @param right_len right_user_key 的内存大小(只有在变长字段中才会关注)
    * @param right_inclusive 右边界的值是否包含在内
+   * @param reverse 是否从右边界开始向左遍历
    */
   RC open(const char *left_user_key, int left_len, bool left_inclusive,
-	  const char *right_user_key, int right_len, bool right_inclusive);
+	  const char *right_user_key, int right_len, bool right_inclusive, bool reverse = false);
 
   RC next_entry(RID *rid);
 
+  /**
+   * 与next_entry(RID*)相同，同时把当前项的user key和include字段拷贝出来
+   * @param user_key 长度至少为attr_length，可以为空
+   * @param include_data 长度至少为include_length，可以为空
+   */
+  RC next_entry(RID *rid, char *user_key, char *include_data);
+
   RC close();
 
 private:
@@ -535,6 +616,12 @@ private:
    */
   RC fix_user_key(const char *user_key, int key_len, bool want_greater,
 		  char **fixed_key, bool *should_inclusive);
+
+  void copy_entry(Frame *frame, int index, RID *rid, char *user_key, char *include_data);
+  /**
+   * 反向遍历时使用right_frame_和end_index_记录当前位置，left_frame_和iter_index_是终止位置
+   */
+  RC prev_entry(RID *rid, char *user_key, char *include_data);
 private:
   bool inited_ = false;
   BplusTreeHandler &tree_handler_;
@@ -545,6 +632,7 @@ private:
   Frame *      right_frame_ = nullptr;
   int          iter_index_  = -1;
   int          end_index_   = -1; // use -1 for end of scan
+  bool         reverse_     = false;
 };
 
 #endif  //__OBSERVER_STORAGE_COMMON_INDEX_MANAGER_H_
@@ -20,7 +20,8 @@ BplusTreeIndex::~BplusTreeIndex() noexcept
   close();
 }
 
-RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta,
+                          const std::vector<FieldMeta> &include_field_metas)
 {
   if (inited_) {
     LOG_WARN("Failed to create index due to the index has been created before. file_name:%s, index:%s, field:%s",
@@ -30,9 +31,11 @@ RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, co
     return RC::RECORD_OPENNED;
   }
 
-  Index::init(index_meta, field_meta);
+  Index::init(index_meta, field_meta, include_field_metas);
 
-  RC rc = index_handler_.create(file_name, field_meta.type(), field_meta.len());
+  RC rc = index_handler_.create(file_name, field_meta.type(), field_meta.len(),
+                                -1/*internal_max_size*/, -1/*leaf_max_size*/, index_meta.unique(),
+                                include_length());
   if (RC::SUCCESS != rc) {
     LOG_WARN("Failed to create index_handler, file_name:%s, index:%s, field:%s, rc:%s",
         file_name,
@@ -48,7 +51,8 @@ RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, co
   return RC::SUCCESS;
 }
 
-RC BplusTreeIndex::open(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+RC BplusTreeIndex::open(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta,
+                        const std::vector<FieldMeta> &include_field_metas)
 {
   if (inited_) {
     LOG_WARN("Failed to open index due to the index has been initedd before. file_name:%s, index:%s, field:%s",
@@ -58,7 +62,7 @@ RC BplusTreeIndex::open(const char *file_name, const IndexMeta &index_meta, cons
     return RC::RECORD_OPENNED;
   }
 
-  Index::init(index_meta, field_meta);
+  Index::init(index_meta, field_meta, include_field_metas);
 
   RC rc = index_handler_.open(file_name);
   if (RC::SUCCESS != rc) {
@@ -96,7 +100,13 @@ RC BplusTreeIndex::drop(){
 
 RC BplusTreeIndex::insert_entry(const char *record, const RID *rid)
 {
-  return index_handler_.insert_entry(record + field_meta_.offset(), rid);
+  if (include_field_metas_.empty()) {
+    return index_handler_.insert_entry(record + field_meta_.offset(), rid);
+  }
+
+  std::vector<char> include_data(include_length());
+  make_include_data(record, include_data.data());
+  return index_handler_.insert_entry(record + field_meta_.offset(), rid, include_data.data());
 }
 
 RC BplusTreeIndex::delete_entry(const char *record, const RID *rid)
@@ -104,15 +114,12 @@ RC BplusTreeIndex::delete_entry(const char *record, const RID *rid)
   return index_handler_.delete_entry(record + field_meta_.offset(), rid);
 }
 
-RC BplusTreeIndex::update_entry(const char *record, const RID *rid){
-  return index_handler_.update_entry(record + field_meta_.offset(), rid);
-}
-
 IndexScanner *BplusTreeIndex::create_scanner(const char *left_key, int left_len, bool left_inclusive,
-					     const char *right_key, int right_len, bool right_inclusive)
+					     const char *right_key, int right_len, bool right_inclusive,
+					     bool reverse /* = false */)
 {
-  BplusTreeIndexScanner *index_scanner = new BplusTreeIndexScanner(index_handler_);
-  RC rc = index_scanner->open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
+  BplusTreeIndexScanner *index_scanner = new BplusTreeIndexScanner(index_handler_, field_meta_, include_field_metas_);
+  RC rc = index_scanner->open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive, reverse);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to open index scanner. rc=%d:%s", rc, strrc(rc));
     delete index_scanner;
@@ -121,14 +128,27 @@ IndexScanner *BplusTreeIndex::create_scanner(const char *left_key, int left_len,
   return index_scanner;
 }
 
+RC BplusTreeIndex::get_entries(const std::vector<const char *> &user_keys, std::vector<RID> &rids)
+{
+  return index_handler_.get_entries(user_keys, rids);
+}
+
 RC BplusTreeIndex::sync()
 {
   return index_handler_.sync();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-BplusTreeIndexScanner::BplusTreeIndexScanner(BplusTreeHandler &tree_handler) : tree_scanner_(tree_handler)
-{}
+BplusTreeIndexScanner::BplusTreeIndexScanner(BplusTreeHandler &tree_handler, const FieldMeta &field_meta,
+                                             const std::vector<FieldMeta> &include_field_metas)
+  : tree_scanner_(tree_handler), field_meta_(field_meta), include_field_metas_(include_field_metas)
+{
+  int include_length = 0;
+  for (const FieldMeta &include_field_meta : include_field_metas_) {
+    include_length += include_field_meta.len();
+  }
+  include_data_.resize(include_length);
+}
 
 BplusTreeIndexScanner::~BplusTreeIndexScanner() noexcept
 {
@@ -136,9 +156,9 @@ BplusTreeIndexScanner::~BplusTreeIndexScanner() noexcept
 }
 
 RC BplusTreeIndexScanner::open(const char *left_key, int left_len, bool left_inclusive,
-                               const char *right_key, int right_len, bool right_inclusive)
+                               const char *right_key, int right_len, bool right_inclusive, bool reverse)
 {
-  return tree_scanner_.open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
+  return tree_scanner_.open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive, reverse);
 }
 
 RC BplusTreeIndexScanner::next_entry(RID *rid)
@@ -146,6 +166,21 @@ RC BplusTreeIndexScanner::next_entry(RID *rid)
   return tree_scanner_.next_entry(rid);
 }
 
+RC BplusTreeIndexScanner::next_entry(RID *rid, char *record)
+{
+  RC rc = tree_scanner_.next_entry(rid, record + field_meta_.offset(), include_data_.data());
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  const char *include_data = include_data_.data();
+  for (const FieldMeta &include_field_meta : include_field_metas_) {
+    memcpy(record + include_field_meta.offset(), include_data, include_field_meta.len());
+    include_data += include_field_meta.len();
+  }
+  return RC::SUCCESS;
+}
+
 RC BplusTreeIndexScanner::destroy()
 {
   delete this;
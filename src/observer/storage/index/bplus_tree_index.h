@@ -23,20 +23,24 @@ public:
   BplusTreeIndex() = default;
   virtual ~BplusTreeIndex() noexcept;
 
-  RC create(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta);
-  RC open(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta);
+  RC create(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta,
+      const std::vector<FieldMeta> &include_field_metas = std::vector<FieldMeta>());
+  RC open(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta,
+      const std::vector<FieldMeta> &include_field_metas = std::vector<FieldMeta>());
   RC close();
   RC drop() override;
 
   RC insert_entry(const char *record, const RID *rid) override;
   RC delete_entry(const char *record, const RID *rid) override;
-  RC update_entry(const char *record, const RID *rid) override;
 
   /**
    * 扫描指定范围的数据
    */
   IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive,
-			       const char *right_key, int right_len, bool right_inclusive) override;
+			       const char *right_key, int right_len, bool right_inclusive,
+			       bool reverse = false) override;
+
+  RC get_entries(const std::vector<const char *> &user_keys, std::vector<RID> &rids) override;
 
   RC sync() override;
 
@@ -47,16 +51,21 @@ private:
 
 class BplusTreeIndexScanner : public IndexScanner {
 public:
-  BplusTreeIndexScanner(BplusTreeHandler &tree_handle);
+  BplusTreeIndexScanner(BplusTreeHandler &tree_handle, const FieldMeta &field_meta,
+                        const std::vector<FieldMeta> &include_field_metas);
   ~BplusTreeIndexScanner() noexcept override;
 
   RC next_entry(RID *rid) override;
+  RC next_entry(RID *rid, char *record) override;
   RC destroy() override;
 
   RC open(const char *left_key, int left_len, bool left_inclusive,
-          const char *right_key, int right_len, bool right_inclusive);
+          const char *right_key, int right_len, bool right_inclusive, bool reverse);
 private:
   BplusTreeScanner tree_scanner_;
+  const FieldMeta &field_meta_;
+  const std::vector<FieldMeta> &include_field_metas_;
+  std::vector<char> include_data_;
 };
 
 #endif  //__OBSERVER_STORAGE_COMMON_BPLUS_TREE_INDEX_H_
@@ -0,0 +1,788 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <sstream>
+
+#include "storage/index/extendible_hash.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "rc.h"
+#include "common/log/log.h"
+
+#define FIRST_HASH_INDEX_PAGE 1
+
+/**
+ * FNV-1a，再用murmur3的fmix32打散低位，可扩展哈希使用的是哈希值的低位
+ */
+static uint32_t hash_bytes(const void *data, int length)
+{
+  const unsigned char *p = (const unsigned char *)data;
+  uint32_t h = 2166136261u;
+  for (int i = 0; i < length; i++) {
+    h ^= p[i];
+    h *= 16777619u;
+  }
+
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+uint32_t AttrHasher::operator()(const char *v) const
+{
+  switch (attr_type_) {
+    case INTS: {
+      return hash_bytes(v, sizeof(int));
+    }
+    case FLOATS: {
+      float f = *(const float *)v;
+      if (f == 0) {
+        f = 0;  // -0.0 与 0.0 相等
+      }
+      return hash_bytes(&f, sizeof(f));
+    }
+    case CHARS: {
+      return hash_bytes(v, strnlen(v, attr_length_));
+    }
+    case DATES: {
+      // 与compare_date一致，按照格式化之后的日期计算
+      char date[11];
+      format_date(v, date);
+      return hash_bytes(date, strnlen(date, sizeof(date)));
+    }
+    default: {
+      LOG_ERROR("unknown attr type. %d", attr_type_);
+      abort();
+    }
+  }
+}
+
+const std::string HashIndexFileHeader::to_string() const
+{
+  std::stringstream ss;
+  ss << "attr_length:" << attr_length << ","
+     << "entry_length:" << entry_length << ","
+     << "attr_type:" << attr_type << ","
+     << "bucket_capacity:" << bucket_capacity << ","
+     << "global_depth:" << global_depth << ","
+     << "unique:" << unique << ","
+     << "directory_page_num:" << directory_page_num << ";";
+  return ss.str();
+}
+
+static HashBucketPageHeader *bucket_header(Frame *frame)
+{
+  return (HashBucketPageHeader *)frame->data();
+}
+
+static char *bucket_entries(Frame *frame)
+{
+  return frame->data() + sizeof(HashBucketPageHeader);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+RC ExtendibleHashHandler::create(const char *file_name, AttrType attr_type, int attr_length, bool unique /* = false */,
+                                 int bucket_capacity /* = -1 */)
+{
+  BufferPoolManager &bpm = BufferPoolManager::instance();
+  RC rc = bpm.create_file(file_name);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("Failed to create file. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    return rc;
+  }
+
+  DiskBufferPool *bp = nullptr;
+  rc = bpm.open_file(file_name, bp);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("Failed to open file. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    return rc;
+  }
+
+  Frame *header_frame = nullptr;
+  rc = bp->allocate_page(&header_frame);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to allocate header page for hash index. rc=%d:%s", rc, strrc(rc));
+    bpm.close_file(file_name);
+    return rc;
+  }
+
+  if (header_frame->page_num() != FIRST_HASH_INDEX_PAGE) {
+    LOG_WARN("header page num should be %d but got %d. is it a new file : %s",
+        FIRST_HASH_INDEX_PAGE, header_frame->page_num(), file_name);
+    bp->unpin_page(header_frame);
+    bpm.close_file(file_name);
+    return RC::INTERNAL;
+  }
+  bp->unpin_page(header_frame);
+
+  const int entry_length = attr_length + sizeof(RID);
+  if (bucket_capacity <= 0) {
+    bucket_capacity = (BP_PAGE_DATA_SIZE - sizeof(HashBucketPageHeader)) / entry_length;
+  }
+
+  memset(&file_header_, 0, sizeof(file_header_));
+  file_header_.attr_length = attr_length;
+  file_header_.entry_length = entry_length;
+  file_header_.attr_type = attr_type;
+  file_header_.bucket_capacity = bucket_capacity;
+  file_header_.global_depth = 0;
+  file_header_.unique = unique ? 1 : 0;
+  file_header_.directory_page_num = 0;
+  disk_buffer_pool_ = bp;
+
+  attr_comparator_.init(attr_type, attr_length);
+  hasher_.init(attr_type, attr_length);
+
+  // 初始时只有一个bucket
+  Frame *directory_frame = nullptr;
+  rc = bp->allocate_page(&directory_frame);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to allocate directory page for hash index. rc=%d:%s", rc, strrc(rc));
+    close();
+    return rc;
+  }
+  file_header_.directory_pages[file_header_.directory_page_num++] = directory_frame->page_num();
+  bp->unpin_page(directory_frame);
+
+  PageNum bucket_page_num = BP_INVALID_PAGE_NUM;
+  rc = allocate_bucket_page(0, bucket_page_num);
+  if (rc != RC::SUCCESS) {
+    close();
+    return rc;
+  }
+  directory_.assign(1, bucket_page_num);
+
+  rc = write_directory(0, 1);
+  if (rc == RC::SUCCESS) {
+    rc = write_file_header();
+  }
+  if (rc != RC::SUCCESS) {
+    close();
+    return rc;
+  }
+
+  LOG_INFO("Successfully create hash index %s. %s", file_name, file_header_.to_string().c_str());
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::open(const char *file_name)
+{
+  if (disk_buffer_pool_ != nullptr) {
+    LOG_WARN("%s has been opened before index.open.", file_name);
+    return RC::RECORD_OPENNED;
+  }
+
+  BufferPoolManager &bpm = BufferPoolManager::instance();
+  DiskBufferPool *bp = nullptr;
+  RC rc = bpm.open_file(file_name, bp);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("Failed to open file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    return rc;
+  }
+
+  Frame *frame = nullptr;
+  rc = bp->get_this_page(FIRST_HASH_INDEX_PAGE, &frame);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("Failed to get first page file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    bpm.close_file(file_name);
+    return rc;
+  }
+  memcpy(&file_header_, frame->data(), sizeof(file_header_));
+  bp->unpin_page(frame);
+  disk_buffer_pool_ = bp;
+
+  const int directory_size = 1 << file_header_.global_depth;
+  directory_.resize(directory_size);
+  for (int i = 0; i < file_header_.directory_page_num; i++) {
+    rc = bp->get_this_page(file_header_.directory_pages[i], &frame);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("Failed to get directory page. file name=%s, page num=%d, rc=%d:%s",
+          file_name, file_header_.directory_pages[i], rc, strrc(rc));
+      close();
+      return rc;
+    }
+
+    const int begin = i * HASH_DIRECTORY_ENTRIES_PER_PAGE;
+    const int end = std::min(begin + HASH_DIRECTORY_ENTRIES_PER_PAGE, directory_size);
+    memcpy(directory_.data() + begin, frame->data(), (end - begin) * sizeof(PageNum));
+    bp->unpin_page(frame);
+  }
+
+  attr_comparator_.init(file_header_.attr_type, file_header_.attr_length);
+  hasher_.init(file_header_.attr_type, file_header_.attr_length);
+  LOG_INFO("Successfully open hash index %s. %s", file_name, file_header_.to_string().c_str());
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::close()
+{
+  if (disk_buffer_pool_ != nullptr) {
+    disk_buffer_pool_->close_file();
+  }
+
+  disk_buffer_pool_ = nullptr;
+  directory_.clear();
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::drop()
+{
+  RC rc = RC::SUCCESS;
+  if (disk_buffer_pool_ != nullptr) {
+    BufferPoolManager &bpm = BufferPoolManager::instance();
+    std::string file_name = disk_buffer_pool_->file_name();
+    rc = bpm.remove_file(file_name.c_str());
+  }
+
+  disk_buffer_pool_ = nullptr;
+  directory_.clear();
+  return rc;
+}
+
+RC ExtendibleHashHandler::sync()
+{
+  return disk_buffer_pool_->flush_all_pages();
+}
+
+bool ExtendibleHashHandler::is_unique() const
+{
+  return file_header_.unique != 0;
+}
+
+int ExtendibleHashHandler::attr_length() const
+{
+  return file_header_.attr_length;
+}
+
+AttrType ExtendibleHashHandler::attr_type() const
+{
+  return file_header_.attr_type;
+}
+
+int ExtendibleHashHandler::global_depth() const
+{
+  return file_header_.global_depth;
+}
+
+PageNum ExtendibleHashHandler::bucket_page(uint32_t hash) const
+{
+  return directory_[hash & ((1u << file_header_.global_depth) - 1)];
+}
+
+RC ExtendibleHashHandler::init_bucket_page(Frame *frame, int local_depth)
+{
+  // 回收的页面中可能有旧数据
+  memset(frame->data(), 0, sizeof(HashBucketPageHeader));
+  HashBucketPageHeader *header = bucket_header(frame);
+  header->local_depth = local_depth;
+  header->size = 0;
+  header->next_page = BP_INVALID_PAGE_NUM;
+  frame->mark_dirty();
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::allocate_bucket_page(int local_depth, PageNum &page_num)
+{
+  Frame *frame = nullptr;
+  RC rc = disk_buffer_pool_->allocate_page(&frame);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to allocate bucket page. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+
+  init_bucket_page(frame, local_depth);
+  page_num = frame->page_num();
+  disk_buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::write_file_header()
+{
+  Frame *frame = nullptr;
+  RC rc = disk_buffer_pool_->get_this_page(FIRST_HASH_INDEX_PAGE, &frame);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to fetch header page. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+
+  memcpy(frame->data(), &file_header_, sizeof(file_header_));
+  frame->mark_dirty();
+  disk_buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::write_directory(int begin, int end)
+{
+  RC rc = RC::SUCCESS;
+  while (begin < end) {
+    const int page_index = begin / HASH_DIRECTORY_ENTRIES_PER_PAGE;
+    const int page_end = std::min((page_index + 1) * HASH_DIRECTORY_ENTRIES_PER_PAGE, end);
+
+    Frame *frame = nullptr;
+    rc = disk_buffer_pool_->get_this_page(file_header_.directory_pages[page_index], &frame);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to fetch directory page. page index=%d, rc=%d:%s", page_index, rc, strrc(rc));
+      return rc;
+    }
+
+    const int offset = begin - page_index * HASH_DIRECTORY_ENTRIES_PER_PAGE;
+    memcpy(frame->data() + offset * sizeof(PageNum), directory_.data() + begin, (page_end - begin) * sizeof(PageNum));
+    frame->mark_dirty();
+    disk_buffer_pool_->unpin_page(frame);
+    begin = page_end;
+  }
+  return rc;
+}
+
+RC ExtendibleHashHandler::double_directory()
+{
+  const int old_size = directory_.size();
+  const int new_size = old_size * 2;
+  const int page_num_needed = (new_size + HASH_DIRECTORY_ENTRIES_PER_PAGE - 1) / HASH_DIRECTORY_ENTRIES_PER_PAGE;
+  while (file_header_.directory_page_num < page_num_needed) {
+    Frame *frame = nullptr;
+    RC rc = disk_buffer_pool_->allocate_page(&frame);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to allocate directory page. rc=%d:%s", rc, strrc(rc));
+      return rc;
+    }
+    file_header_.directory_pages[file_header_.directory_page_num++] = frame->page_num();
+    disk_buffer_pool_->unpin_page(frame);
+  }
+
+  directory_.resize(new_size);
+  std::copy(directory_.begin(), directory_.begin() + old_size, directory_.begin() + old_size);
+  file_header_.global_depth++;
+
+  RC rc = write_directory(old_size, new_size);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  return write_file_header();
+}
+
+RC ExtendibleHashHandler::read_bucket(PageNum page_num, int &local_depth, std::vector<char> &entries, int &entry_num)
+{
+  const int entry_length = file_header_.entry_length;
+  entry_num = 0;
+  entries.clear();
+
+  bool first = true;
+  while (page_num != BP_INVALID_PAGE_NUM) {
+    Frame *frame = nullptr;
+    RC rc = disk_buffer_pool_->get_this_page(page_num, &frame);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to fetch bucket page. page num=%d, rc=%d:%s", page_num, rc, strrc(rc));
+      return rc;
+    }
+
+    HashBucketPageHeader *header = bucket_header(frame);
+    if (first) {
+      local_depth = header->local_depth;
+      first = false;
+    }
+    entries.insert(entries.end(), bucket_entries(frame), bucket_entries(frame) + header->size * entry_length);
+    entry_num += header->size;
+    page_num = header->next_page;
+    disk_buffer_pool_->unpin_page(frame);
+  }
+  return RC::SUCCESS;
+}
+
+/**
+ * 用entries重写从page_num开始的整个bucket，页面不够时分配溢出页面，多余的溢出页面释放掉
+ */
+RC ExtendibleHashHandler::write_bucket(PageNum page_num, int local_depth, const char *entries, int entry_num)
+{
+  const int entry_length = file_header_.entry_length;
+  const int capacity = file_header_.bucket_capacity;
+
+  RC rc = RC::SUCCESS;
+  std::vector<PageNum> disposed_pages;
+  Frame *frame = nullptr;
+  rc = disk_buffer_pool_->get_this_page(page_num, &frame);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to fetch bucket page. page num=%d, rc=%d:%s", page_num, rc, strrc(rc));
+    return rc;
+  }
+  bucket_header(frame)->local_depth = local_depth;
+
+  int written = 0;
+  while (true) {
+    HashBucketPageHeader *header = bucket_header(frame);
+    const int count = std::min(capacity, entry_num - written);
+    memcpy(bucket_entries(frame), entries + written * entry_length, count * entry_length);
+    header->size = count;
+    written += count;
+    frame->mark_dirty();
+
+    if (written >= entry_num) {
+      PageNum next_page = header->next_page;
+      header->next_page = BP_INVALID_PAGE_NUM;
+      disk_buffer_pool_->unpin_page(frame);
+
+      // 剩下的溢出页面不再需要了
+      while (next_page != BP_INVALID_PAGE_NUM) {
+        disposed_pages.push_back(next_page);
+        rc = disk_buffer_pool_->get_this_page(next_page, &frame);
+        if (rc != RC::SUCCESS) {
+          LOG_WARN("failed to fetch bucket page. page num=%d, rc=%d:%s", next_page, rc, strrc(rc));
+          return rc;
+        }
+        next_page = bucket_header(frame)->next_page;
+        disk_buffer_pool_->unpin_page(frame);
+      }
+      break;
+    }
+
+    if (header->next_page == BP_INVALID_PAGE_NUM) {
+      PageNum new_page_num = BP_INVALID_PAGE_NUM;
+      rc = allocate_bucket_page(0, new_page_num);
+      if (rc != RC::SUCCESS) {
+        disk_buffer_pool_->unpin_page(frame);
+        return rc;
+      }
+      header->next_page = new_page_num;
+    }
+
+    PageNum next_page = header->next_page;
+    disk_buffer_pool_->unpin_page(frame);
+    rc = disk_buffer_pool_->get_this_page(next_page, &frame);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to fetch bucket page. page num=%d, rc=%d:%s", next_page, rc, strrc(rc));
+      return rc;
+    }
+  }
+
+  for (PageNum disposed_page : disposed_pages) {
+    disk_buffer_pool_->dispose_page(disposed_page);
+  }
+  return RC::SUCCESS;
+}
+
+/**
+ * 把一个满的bucket按照第local_depth位分裂成两个
+ * 如果bucket中的数据(包括将要插入的数据)哈希值完全相同，分裂没有意义，splitted返回false
+ */
+RC ExtendibleHashHandler::split_bucket(PageNum page_num, uint32_t insert_hash, bool &splitted)
+{
+  splitted = false;
+
+  int local_depth = 0;
+  int entry_num = 0;
+  std::vector<char> entries;
+  RC rc = read_bucket(page_num, local_depth, entries, entry_num);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  if (local_depth >= HASH_MAX_GLOBAL_DEPTH) {
+    return RC::SUCCESS;
+  }
+
+  const int entry_length = file_header_.entry_length;
+  const uint32_t max_mask = (1u << HASH_MAX_GLOBAL_DEPTH) - 1;
+  std::vector<uint32_t> hashes(entry_num);
+  bool all_same = true;
+  for (int i = 0; i < entry_num; i++) {
+    hashes[i] = hasher_(entries.data() + i * entry_length);
+    if ((hashes[i] & max_mask) != (insert_hash & max_mask)) {
+      all_same = false;
+    }
+  }
+  if (all_same) {
+    return RC::SUCCESS;
+  }
+
+  if (local_depth == file_header_.global_depth) {
+    rc = double_directory();
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to double hash directory. rc=%d:%s", rc, strrc(rc));
+      return rc;
+    }
+  }
+
+  PageNum new_page_num = BP_INVALID_PAGE_NUM;
+  rc = allocate_bucket_page(local_depth + 1, new_page_num);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  const uint32_t split_bit = 1u << local_depth;
+  std::vector<char> stay_entries;
+  std::vector<char> move_entries;
+  stay_entries.reserve(entries.size());
+  move_entries.reserve(entries.size());
+  for (int i = 0; i < entry_num; i++) {
+    const char *entry = entries.data() + i * entry_length;
+    std::vector<char> &target = (hashes[i] & split_bit) ? move_entries : stay_entries;
+    target.insert(target.end(), entry, entry + entry_length);
+  }
+
+  rc = write_bucket(page_num, local_depth + 1, stay_entries.data(), stay_entries.size() / entry_length);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  rc = write_bucket(new_page_num, local_depth + 1, move_entries.data(), move_entries.size() / entry_length);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  // 指向旧bucket的目录项，下标在local_depth位上是1的改为指向新bucket
+  const uint32_t low_bits = insert_hash & (split_bit - 1);
+  const int directory_size = directory_.size();
+  for (int i = low_bits; i < directory_size; i += split_bit) {
+    if (i & split_bit) {
+      directory_[i] = new_page_num;
+      rc = write_directory(i, i + 1);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+  }
+
+  splitted = true;
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::append_overflow_page(PageNum page_num, const char *entry)
+{
+  PageNum new_page_num = BP_INVALID_PAGE_NUM;
+  RC rc = allocate_bucket_page(0, new_page_num);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  Frame *frame = nullptr;
+  rc = disk_buffer_pool_->get_this_page(new_page_num, &frame);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to fetch bucket page. page num=%d, rc=%d:%s", new_page_num, rc, strrc(rc));
+    return rc;
+  }
+  memcpy(bucket_entries(frame), entry, file_header_.entry_length);
+  bucket_header(frame)->size = 1;
+  frame->mark_dirty();
+  disk_buffer_pool_->unpin_page(frame);
+
+  rc = disk_buffer_pool_->get_this_page(page_num, &frame);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to fetch bucket page. page num=%d, rc=%d:%s", page_num, rc, strrc(rc));
+    return rc;
+  }
+  bucket_header(frame)->next_page = new_page_num;
+  frame->mark_dirty();
+  disk_buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::insert_entry(const char *user_key, const RID *rid)
+{
+  if (disk_buffer_pool_ == nullptr) {
+    return RC::RECORD_CLOSED;
+  }
+
+  if (is_unique()) {
+    std::vector<RID> rids;
+    RC rc = get_entry(user_key, rids);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (!rids.empty()) {
+      return RC::RECORD_DUPLICATE_KEY;
+    }
+  }
+
+  const int attr_length = file_header_.attr_length;
+  const int entry_length = file_header_.entry_length;
+  std::vector<char> entry(entry_length);
+  memcpy(entry.data(), user_key, attr_length);
+  memcpy(entry.data() + attr_length, rid, sizeof(RID));
+
+  const uint32_t hash = hasher_(user_key);
+  while (true) {
+    const PageNum first_page = bucket_page(hash);
+    PageNum page_num = first_page;
+    PageNum last_page = BP_INVALID_PAGE_NUM;
+    while (page_num != BP_INVALID_PAGE_NUM) {
+      Frame *frame = nullptr;
+      RC rc = disk_buffer_pool_->get_this_page(page_num, &frame);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to fetch bucket page. page num=%d, rc=%d:%s", page_num, rc, strrc(rc));
+        return rc;
+      }
+
+      HashBucketPageHeader *header = bucket_header(frame);
+      if (header->size < file_header_.bucket_capacity) {
+        memcpy(bucket_entries(frame) + header->size * entry_length, entry.data(), entry_length);
+        header->size++;
+        frame->mark_dirty();
+        disk_buffer_pool_->unpin_page(frame);
+        return RC::SUCCESS;
+      }
+
+      last_page = page_num;
+      page_num = header->next_page;
+      disk_buffer_pool_->unpin_page(frame);
+    }
+
+    // bucket已经满了，优先分裂，分裂之后重新定位bucket
+    bool splitted = false;
+    RC rc = split_bucket(first_page, hash, splitted);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to split bucket. page num=%d, rc=%d:%s", first_page, rc, strrc(rc));
+      return rc;
+    }
+    if (!splitted) {
+      return append_overflow_page(last_page, entry.data());
+    }
+  }
+}
+
+RC ExtendibleHashHandler::delete_entry(const char *user_key, const RID *rid)
+{
+  if (disk_buffer_pool_ == nullptr) {
+    return RC::RECORD_CLOSED;
+  }
+
+  const int attr_length = file_header_.attr_length;
+  const int entry_length = file_header_.entry_length;
+  PageNum page_num = bucket_page(hasher_(user_key));
+  while (page_num != BP_INVALID_PAGE_NUM) {
+    Frame *frame = nullptr;
+    RC rc = disk_buffer_pool_->get_this_page(page_num, &frame);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to fetch bucket page. page num=%d, rc=%d:%s", page_num, rc, strrc(rc));
+      return rc;
+    }
+
+    HashBucketPageHeader *header = bucket_header(frame);
+    char *entries = bucket_entries(frame);
+    for (int i = 0; i < header->size; i++) {
+      char *entry = entries + i * entry_length;
+      if (attr_comparator_(entry, user_key) == 0 && RID::compare((const RID *)(entry + attr_length), rid) == 0) {
+        // bucket内部是无序的，用最后一个entry填补空位
+        header->size--;
+        if (i != header->size) {
+          memcpy(entry, entries + header->size * entry_length, entry_length);
+        }
+        frame->mark_dirty();
+        disk_buffer_pool_->unpin_page(frame);
+        return RC::SUCCESS;
+      }
+    }
+
+    page_num = header->next_page;
+    disk_buffer_pool_->unpin_page(frame);
+  }
+  return RC::RECORD_RECORD_NOT_EXIST;
+}
+
+RC ExtendibleHashHandler::get_entry(const char *user_key, std::vector<RID> &rids)
+{
+  if (disk_buffer_pool_ == nullptr) {
+    return RC::RECORD_CLOSED;
+  }
+
+  const int attr_length = file_header_.attr_length;
+  const int entry_length = file_header_.entry_length;
+  PageNum page_num = bucket_page(hasher_(user_key));
+  while (page_num != BP_INVALID_PAGE_NUM) {
+    Frame *frame = nullptr;
+    RC rc = disk_buffer_pool_->get_this_page(page_num, &frame);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to fetch bucket page. page num=%d, rc=%d:%s", page_num, rc, strrc(rc));
+      return rc;
+    }
+
+    HashBucketPageHeader *header = bucket_header(frame);
+    const char *entries = bucket_entries(frame);
+    for (int i = 0; i < header->size; i++) {
+      const char *entry = entries + i * entry_length;
+      if (attr_comparator_(entry, user_key) == 0) {
+        rids.push_back(*(const RID *)(entry + attr_length));
+      }
+    }
+
+    page_num = header->next_page;
+    disk_buffer_pool_->unpin_page(frame);
+  }
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::get_entries(const std::vector<const char *> &user_keys, std::vector<RID> &rids)
+{
+  std::vector<const char *> keys(user_keys);
+  const AttrComparator &comparator = attr_comparator_;
+  std::sort(keys.begin(), keys.end(), [&comparator](const char *k1, const char *k2) {
+    return comparator(k1, k2) < 0;
+  });
+  keys.erase(std::unique(keys.begin(), keys.end(), [&comparator](const char *k1, const char *k2) {
+    return comparator(k1, k2) == 0;
+  }), keys.end());
+
+  for (const char *key : keys) {
+    RC rc = get_entry(key, rids);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  std::sort(rids.begin(), rids.end(), [](const RID &r1, const RID &r2) {
+    return RID::compare(&r1, &r2) < 0;
+  });
+  return RC::SUCCESS;
+}
+
+bool ExtendibleHashHandler::validate()
+{
+  const int directory_size = directory_.size();
+  if (directory_size != (1 << file_header_.global_depth)) {
+    LOG_WARN("invalid directory size. size=%d, global depth=%d", directory_size, file_header_.global_depth);
+    return false;
+  }
+
+  const int entry_length = file_header_.entry_length;
+  for (int i = 0; i < directory_size; i++) {
+    int local_depth = 0;
+    int entry_num = 0;
+    std::vector<char> entries;
+    RC rc = read_bucket(directory_[i], local_depth, entries, entry_num);
+    if (rc != RC::SUCCESS) {
+      return false;
+    }
+
+    if (local_depth > file_header_.global_depth) {
+      LOG_WARN("local depth is larger than global depth. page=%d, local depth=%d, global depth=%d",
+          directory_[i], local_depth, file_header_.global_depth);
+      return false;
+    }
+
+    // 低local_depth位相同的目录项都指向同一个bucket
+    const uint32_t mask = (1u << local_depth) - 1;
+    for (int j = i & mask; j < directory_size; j += (1 << local_depth)) {
+      if (directory_[j] != directory_[i]) {
+        LOG_WARN("directory entry %d and %d should point to the same bucket", i, j);
+        return false;
+      }
+    }
+
+    for (int j = 0; j < entry_num; j++) {
+      if ((hasher_(entries.data() + j * entry_length) & mask) != ((uint32_t)i & mask)) {
+        LOG_WARN("entry is in wrong bucket. directory entry=%d, page=%d", i, directory_[i]);
+        return false;
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,136 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_INDEX_EXTENDIBLE_HASH_H_
+#define __OBSERVER_STORAGE_INDEX_EXTENDIBLE_HASH_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "storage/common/record_manager.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "storage/index/bplus_tree.h"
+#include "sql/parser/parse_defs.h"
+
+#define HASH_MAX_GLOBAL_DEPTH 16
+#define HASH_DIRECTORY_ENTRIES_PER_PAGE 1024
+#define HASH_MAX_DIRECTORY_PAGES ((1 << HASH_MAX_GLOBAL_DEPTH) / HASH_DIRECTORY_ENTRIES_PER_PAGE)
+
+/**
+ * 计算user key的哈希值，与AttrComparator的相等语义保持一致
+ * 结果会持久化在目录结构中，所以不能使用std::hash
+ */
+class AttrHasher
+{
+public:
+  void init(AttrType type, int length)
+  {
+    attr_type_ = type;
+    attr_length_ = length;
+  }
+
+  uint32_t operator()(const char *v) const;
+
+private:
+  AttrType attr_type_;
+  int attr_length_;
+};
+
+/**
+ * 哈希索引文件的第一个页面
+ * 目录保存在单独的页面中，每个页面保存HASH_DIRECTORY_ENTRIES_PER_PAGE个bucket页面号
+ */
+struct HashIndexFileHeader {
+  int32_t  attr_length;
+  int32_t  entry_length;      // attr length + sizeof(RID)
+  AttrType attr_type;
+  int32_t  bucket_capacity;   // 每个bucket页面最多保存的entry个数
+  int32_t  global_depth;
+  int32_t  unique;
+  int32_t  directory_page_num;
+  PageNum  directory_pages[HASH_MAX_DIRECTORY_PAGES];
+
+  const std::string to_string() const;
+};
+
+/**
+ * bucket页面的页头，后面紧跟着entry数组，entry = user key + RID
+ * 一个bucket由一个主页面和溢出页面链组成，只有主页面的local_depth有意义。
+ * 当哈希值无法再区分bucket中的数据时(比如大量重复的key)，就使用溢出页面
+ */
+struct HashBucketPageHeader {
+  int32_t local_depth;
+  int32_t size;
+  PageNum next_page;
+};
+
+/**
+ * 可扩展哈希，只支持等值查找
+ * 目录在打开文件时全部加载到内存中，修改时同步写回目录页面
+ */
+class ExtendibleHashHandler {
+public:
+  /**
+   * @param bucket_capacity 每个bucket页面保存的entry数，小于0时按页面大小计算，测试时可以指定一个较小的值
+   */
+  RC create(const char *file_name, AttrType attr_type, int attr_length, bool unique = false,
+            int bucket_capacity = -1);
+  RC open(const char *file_name);
+  RC close();
+  RC drop();
+  RC sync();
+
+  /**
+   * 唯一索引中已经存在相同的user key时，返回RECORD_DUPLICATE_KEY
+   */
+  RC insert_entry(const char *user_key, const RID *rid);
+  RC delete_entry(const char *user_key, const RID *rid);
+
+  RC get_entry(const char *user_key, std::vector<RID> &rids);
+  /**
+   * 批量等值查找，重复的user key只查找一次，返回的rid按照页面排序
+   */
+  RC get_entries(const std::vector<const char *> &user_keys, std::vector<RID> &rids);
+
+  bool is_unique() const;
+  int attr_length() const;
+  AttrType attr_type() const;
+  int global_depth() const;
+
+  /**
+   * 校验目录与每个bucket中的数据是否一致
+   */
+  bool validate();
+
+private:
+  PageNum bucket_page(uint32_t hash) const;
+  RC init_bucket_page(Frame *frame, int local_depth);
+  RC allocate_bucket_page(int local_depth, PageNum &page_num);
+
+  RC read_bucket(PageNum page_num, int &local_depth, std::vector<char> &entries, int &entry_num);
+  RC write_bucket(PageNum page_num, int local_depth, const char *entries, int entry_num);
+  RC split_bucket(PageNum page_num, uint32_t insert_hash, bool &splitted);
+  RC append_overflow_page(PageNum page_num, const char *entry);
+
+  RC double_directory();
+  RC write_directory(int begin, int end);
+  RC write_file_header();
+
+private:
+  DiskBufferPool *disk_buffer_pool_ = nullptr;
+  HashIndexFileHeader file_header_;
+  std::vector<PageNum> directory_;
+
+  AttrComparator attr_comparator_;
+  AttrHasher hasher_;
+};
+
+#endif  // __OBSERVER_STORAGE_INDEX_EXTENDIBLE_HASH_H_
@@ -0,0 +1,211 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+
+#include "storage/index/hash_index.h"
+#include "common/log/log.h"
+
+/**
+ * 把查询条件中的值转换成与索引字段等长的key
+ * 只有字符串的长度是有效的，其它类型的值与字段长度相同
+ * 字符串比字段还长时不可能与任何数据相等，返回false
+ */
+static bool make_fixed_key(const ExtendibleHashHandler &handler, const char *key, int key_len,
+                           std::vector<char> &fixed_key)
+{
+  const int attr_length = handler.attr_length();
+  fixed_key.assign(attr_length, 0);
+  if (handler.attr_type() != CHARS) {
+    memcpy(fixed_key.data(), key, attr_length);
+    return true;
+  }
+
+  const int str_len = key_len >= 0 ? strnlen(key, key_len) : strlen(key);
+  if (str_len > attr_length) {
+    return false;
+  }
+  memcpy(fixed_key.data(), key, str_len);
+  return true;
+}
+
+HashIndex::~HashIndex() noexcept
+{
+  close();
+}
+
+RC HashIndex::create(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+{
+  if (inited_) {
+    LOG_WARN("Failed to create index due to the index has been created before. file_name:%s, index:%s, field:%s",
+        file_name,
+        index_meta.name(),
+        index_meta.field());
+    return RC::RECORD_OPENNED;
+  }
+
+  // 浮点数的相等比较带有误差，无法与哈希值保持一致
+  if (field_meta.type() == FLOATS) {
+    LOG_WARN("Hash index does not support float field. index:%s, field:%s", index_meta.name(), index_meta.field());
+    return RC::SCHEMA_FIELD_TYPE_MISMATCH;
+  }
+  if (!index_meta.include_fields().empty()) {
+    LOG_WARN("Hash index does not support include fields. index:%s", index_meta.name());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  Index::init(index_meta, field_meta, std::vector<FieldMeta>());
+
+  RC rc = index_handler_.create(file_name, field_meta.type(), field_meta.len(), index_meta.unique());
+  if (RC::SUCCESS != rc) {
+    LOG_WARN("Failed to create hash index handler, file_name:%s, index:%s, field:%s, rc:%s",
+        file_name,
+        index_meta.name(),
+        index_meta.field(),
+        strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  LOG_INFO("Successfully create hash index, file_name:%s, index:%s, field:%s",
+      file_name, index_meta.name(), index_meta.field());
+  return RC::SUCCESS;
+}
+
+RC HashIndex::open(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+{
+  if (inited_) {
+    LOG_WARN("Failed to open index due to the index has been initedd before. file_name:%s, index:%s, field:%s",
+        file_name,
+        index_meta.name(),
+        index_meta.field());
+    return RC::RECORD_OPENNED;
+  }
+
+  Index::init(index_meta, field_meta, std::vector<FieldMeta>());
+
+  RC rc = index_handler_.open(file_name);
+  if (RC::SUCCESS != rc) {
+    LOG_WARN("Failed to open hash index handler, file_name:%s, index:%s, field:%s, rc:%s",
+        file_name,
+        index_meta.name(),
+        index_meta.field(),
+        strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  LOG_INFO("Successfully open hash index, file_name:%s, index:%s, field:%s",
+      file_name, index_meta.name(), index_meta.field());
+  return RC::SUCCESS;
+}
+
+RC HashIndex::close()
+{
+  if (inited_) {
+    LOG_INFO("Begin to close hash index, index:%s, field:%s", index_meta_.name(), index_meta_.field());
+    index_handler_.close();
+    inited_ = false;
+  }
+  return RC::SUCCESS;
+}
+
+RC HashIndex::drop()
+{
+  inited_ = false;
+  return index_handler_.drop();
+}
+
+RC HashIndex::insert_entry(const char *record, const RID *rid)
+{
+  return index_handler_.insert_entry(record + field_meta_.offset(), rid);
+}
+
+RC HashIndex::delete_entry(const char *record, const RID *rid)
+{
+  return index_handler_.delete_entry(record + field_meta_.offset(), rid);
+}
+
+IndexScanner *HashIndex::create_scanner(const char *left_key, int left_len, bool left_inclusive,
+					const char *right_key, int right_len, bool right_inclusive,
+					bool reverse /* = false */)
+{
+  std::vector<char> fixed_left_key;
+  std::vector<char> fixed_right_key;
+  if (left_key == nullptr || right_key == nullptr || !left_inclusive || !right_inclusive) {
+    LOG_WARN("hash index only supports equality scan. index:%s", index_meta_.name());
+    return nullptr;
+  }
+
+  const bool left_valid = make_fixed_key(index_handler_, left_key, left_len, fixed_left_key);
+  const bool right_valid = make_fixed_key(index_handler_, right_key, right_len, fixed_right_key);
+  if (left_valid != right_valid || fixed_left_key != fixed_right_key) {
+    LOG_WARN("hash index only supports equality scan. index:%s", index_meta_.name());
+    return nullptr;
+  }
+
+  HashIndexScanner *index_scanner = new HashIndexScanner(index_handler_, field_meta_);
+  RC rc = index_scanner->open(left_valid ? fixed_left_key.data() : nullptr);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open hash index scanner. rc=%d:%s", rc, strrc(rc));
+    delete index_scanner;
+    return nullptr;
+  }
+  return index_scanner;
+}
+
+RC HashIndex::get_entries(const std::vector<const char *> &user_keys, std::vector<RID> &rids)
+{
+  return index_handler_.get_entries(user_keys, rids);
+}
+
+RC HashIndex::sync()
+{
+  return index_handler_.sync();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HashIndexScanner::HashIndexScanner(ExtendibleHashHandler &hash_handler, const FieldMeta &field_meta)
+  : hash_handler_(hash_handler), field_meta_(field_meta)
+{}
+
+RC HashIndexScanner::open(const char *key)
+{
+  if (key == nullptr) {
+    return RC::SUCCESS;
+  }
+  key_.assign(key, key + hash_handler_.attr_length());
+  return hash_handler_.get_entry(key_.data(), rids_);
+}
+
+RC HashIndexScanner::next_entry(RID *rid)
+{
+  if (iter_index_ >= rids_.size()) {
+    return RC::RECORD_EOF;
+  }
+  *rid = rids_[iter_index_++];
+  return RC::SUCCESS;
+}
+
+RC HashIndexScanner::next_entry(RID *rid, char *record)
+{
+  RC rc = next_entry(rid);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  memcpy(record + field_meta_.offset(), key_.data(), field_meta_.len());
+  return RC::SUCCESS;
+}
+
+RC HashIndexScanner::destroy()
+{
+  delete this;
+  return RC::SUCCESS;
+}
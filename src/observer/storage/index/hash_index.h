@@ -0,0 +1,71 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_INDEX_HASH_INDEX_H_
+#define __OBSERVER_STORAGE_INDEX_HASH_INDEX_H_
+
+#include "storage/index/index.h"
+#include "storage/index/extendible_hash.h"
+
+/**
+ * CREATE INDEX ... USING HASH 创建的索引，只能用于等值查询
+ */
+class HashIndex : public Index {
+public:
+  HashIndex() = default;
+  virtual ~HashIndex() noexcept;
+
+  RC create(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta);
+  RC open(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta);
+  RC close();
+  RC drop() override;
+
+  RC insert_entry(const char *record, const RID *rid) override;
+  RC delete_entry(const char *record, const RID *rid) override;
+
+  /**
+   * 只支持左右边界相同并且都是闭区间的扫描，否则返回nullptr。结果没有顺序，reverse没有意义
+   */
+  IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive,
+			       const char *right_key, int right_len, bool right_inclusive,
+			       bool reverse = false) override;
+
+  RC get_entries(const std::vector<const char *> &user_keys, std::vector<RID> &rids) override;
+
+  RC sync() override;
+
+private:
+  bool inited_ = false;
+  ExtendibleHashHandler index_handler_;
+};
+
+class HashIndexScanner : public IndexScanner {
+public:
+  HashIndexScanner(ExtendibleHashHandler &hash_handler, const FieldMeta &field_meta);
+  ~HashIndexScanner() noexcept override = default;
+
+  RC next_entry(RID *rid) override;
+  RC next_entry(RID *rid, char *record) override;
+  RC destroy() override;
+
+  /**
+   * @param key 与索引字段等长的key，nullptr表示不会有任何数据
+   */
+  RC open(const char *key);
+
+private:
+  ExtendibleHashHandler &hash_handler_;
+  const FieldMeta &field_meta_;
+  std::vector<char> key_;
+  std::vector<RID> rids_;
+  size_t iter_index_ = 0;
+};
+
+#endif  // __OBSERVER_STORAGE_INDEX_HASH_INDEX_H_
@@ -12,11 +12,32 @@ See the Mulan PSL v2 for more details. */
 // Created by Meiyi & wangyunlai.wyl on 2021/5/19.
 //
 
+#include <string.h>
+
 #include "storage/index/index.h"
 
-RC Index::init(const IndexMeta &index_meta, const FieldMeta &field_meta)
+RC Index::init(const IndexMeta &index_meta, const FieldMeta &field_meta,
+               const std::vector<FieldMeta> &include_field_metas)
 {
   index_meta_ = index_meta;
   field_meta_ = field_meta;
+  include_field_metas_ = include_field_metas;
   return RC::SUCCESS;
 }
+
+int Index::include_length() const
+{
+  int length = 0;
+  for (const FieldMeta &field_meta : include_field_metas_) {
+    length += field_meta.len();
+  }
+  return length;
+}
+
+void Index::make_include_data(const char *record, char *include_data) const
+{
+  for (const FieldMeta &field_meta : include_field_metas_) {
+    memcpy(include_data, record + field_meta.offset(), field_meta.len());
+    include_data += field_meta.len();
+  }
+}
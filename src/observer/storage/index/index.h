@@ -43,22 +43,44 @@ public:
     return index_meta_;
   }
 
+  const FieldMeta &field_meta() const
+  {
+    return field_meta_;
+  }
+
   virtual RC insert_entry(const char *record, const RID *rid) = 0;
   virtual RC delete_entry(const char *record, const RID *rid) = 0;
-  virtual RC update_entry(const char *record, const RID *rid) = 0;
   virtual RC drop() = 0;
 
+  /**
+   * @param reverse 按照索引顺序从大到小遍历
+   */
   virtual IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive,
-				       const char *right_key, int right_len, bool right_inclusive) = 0;
+				       const char *right_key, int right_len, bool right_inclusive,
+				       bool reverse = false) = 0;
+
+  /**
+   * 批量等值查找，返回的rid按照页面排序
+   * @param user_keys 要查找的值，内存大小与索引字段长度一致
+   */
+  virtual RC get_entries(const std::vector<const char *> &user_keys, std::vector<RID> &rids) = 0;
 
   virtual RC sync() = 0;
 
 protected:
-  RC init(const IndexMeta &index_meta, const FieldMeta &field_meta);
+  RC init(const IndexMeta &index_meta, const FieldMeta &field_meta,
+          const std::vector<FieldMeta> &include_field_metas);
+
+  int include_length() const;
+  /**
+   * 把record中include字段的值依次拷贝到include_data中
+   */
+  void make_include_data(const char *record, char *include_data) const;
 
 protected:
   IndexMeta index_meta_;
   FieldMeta field_meta_;  /// 当前实现仅考虑一个字段的索引
+  std::vector<FieldMeta> include_field_metas_;
 };
 
 class IndexScanner {
@@ -71,6 +93,15 @@ public:
    * 如果没有更多的元素，返回RECORD_EOF
    */
   virtual RC next_entry(RID *rid) = 0;
+
+  /**
+   * 覆盖索引扫描使用，不访问数据文件
+   * 把索引字段和include字段的值按照各自在record中的偏移拷贝到record中，其它字段不做处理
+   */
+  virtual RC next_entry(RID *rid, char *record)
+  {
+    return RC::UNIMPLENMENT;
+  }
   virtual RC destroy() = 0;
 };
 
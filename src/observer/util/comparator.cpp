@@ -51,6 +51,10 @@ int compare_string(void *arg1, int arg1_max_length, void *arg2, int arg2_max_len
   if (0 != result) {
     return result;
   }
+  // 相同的前缀中已经有结束符，结束符后面的内容不参与比较
+  if (memchr(s1, 0, maxlen) != nullptr) {
+    return 0;
+  }
 
   if (arg1_max_length > maxlen) {
     return s1[maxlen] - 0;
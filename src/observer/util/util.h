@@ -14,13 +14,6 @@ std::string relAttr_to_string(const RelAttr &attr);
 
 RC get_field(const std::vector<Table*> tables, const RelAttr &attr, Field &field);
 
-RC cell_to_value(const TupleCell &cell, Value &value);
 
-Value value_plus_value(const Value &v1, const Value &v2);
-Value value_minus_value(const Value &v1, const Value &v2);
-Value value_multi_value(const Value &v1, const Value &v2);
-Value value_divide_value(const Value &v1, const Value &v2);
 
-Value cal_expr_value(const ExpressionNode &expr, const Tuple &tuple, const std::vector<Table*> tables);
 
-void cell_set_value(const Value &value, int length, TupleCell &cell);
\ No newline at end of file
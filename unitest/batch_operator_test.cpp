@@ -0,0 +1,331 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <stdio.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sql/operator/batch_predicate_operator.h"
+#include "sql/operator/batch_project_operator.h"
+#include "sql/operator/batch_table_scan_operator.h"
+#include "sql/operator/batch_aggregation_operator.h"
+#include "sql/operator/aggre_result.h"
+#include "sql/operator/filter_kernel.h"
+#include "util/comparator.h"
+#include "sql/stmt/filter_stmt.h"
+#include "sql/expr/expression.h"
+#include "storage/common/table.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+BufferPoolManager bpm;
+
+void init_bpm()
+{
+  if (&BufferPoolManager::instance() == nullptr) {
+    BufferPoolManager::set_instance(&bpm);
+  }
+}
+
+/**
+ * 返回一个事先填好的批
+ */
+class MockBatchOperator : public BatchOperator
+{
+public:
+  MockBatchOperator(const std::vector<Field> &fields, int rows)
+  {
+    batch_.init(fields);
+    for (int i = 0; i < rows; i++) {
+      *(int *)batch_.column(0).value(i) = i;
+      *(float *)batch_.column(1).value(i) = i * 0.5f;
+      snprintf(batch_.column(2).value(i), batch_.column(2).width(), "n%d", i % 10);
+    }
+    rows_ = rows;
+  }
+
+  RC open() override
+  {
+    returned_ = false;
+    return RC::SUCCESS;
+  }
+  RC next_batch(ColumnBatch *&batch) override
+  {
+    if (returned_) {
+      return RC::RECORD_EOF;
+    }
+    returned_ = true;
+    batch_.reset(rows_);
+    batch = &batch_;
+    return RC::SUCCESS;
+  }
+  RC close() override
+  {
+    return RC::SUCCESS;
+  }
+
+private:
+  ColumnBatch batch_;
+  int rows_ = 0;
+  bool returned_ = false;
+};
+
+class BatchOperatorTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    id_meta_.init("id", INTS, 0, 4, true);
+    score_meta_.init("score", FLOATS, 4, 4, true);
+    name_meta_.init("name", CHARS, 8, 8, true);
+    fields_ = {Field(nullptr, &id_meta_), Field(nullptr, &score_meta_), Field(nullptr, &name_meta_)};
+  }
+
+  void TearDown() override
+  {
+    for (FilterUnit *filter_unit : filter_units_) {
+      delete filter_unit;
+    }
+  }
+
+  void add_filter(const FieldMeta *field_meta, CompOp comp, Value value)
+  {
+    FilterUnit *filter_unit = new FilterUnit;
+    filter_unit->set_left(new FieldExpr(nullptr, field_meta));
+    filter_unit->set_comp(comp);
+    filter_unit->set_right(new ValueExpr(value));
+    filter_units_.push_back(filter_unit);
+  }
+
+  std::vector<const FilterUnit *> filter_units() const
+  {
+    return {filter_units_.begin(), filter_units_.end()};
+  }
+
+protected:
+  FieldMeta id_meta_;
+  FieldMeta score_meta_;
+  FieldMeta name_meta_;
+  std::vector<Field> fields_;
+  std::vector<FilterUnit *> filter_units_;
+};
+
+TEST_F(BatchOperatorTest, test_predicate)
+{
+  int int_value = 1000;
+  float float_value = 600.2;
+  char chars_value[] = "n3";
+  add_filter(&id_meta_, GREAT_EQUAL, Value{INTS, &int_value});
+  add_filter(&score_meta_, LESS_THAN, Value{FLOATS, &float_value});
+  add_filter(&name_meta_, NOT_EQUAL, Value{CHARS, chars_value});
+  ASSERT_TRUE(BatchPredicateOperator::can_filter(filter_units()));
+
+  MockBatchOperator scan_oper(fields_, ColumnBatch::CAPACITY);
+  BatchPredicateOperator pred_oper(filter_units());
+  pred_oper.add_child(&scan_oper);
+  ASSERT_EQ(RC::SUCCESS, pred_oper.open());
+
+  ColumnBatch *batch = nullptr;
+  ASSERT_EQ(RC::SUCCESS, pred_oper.next_batch(batch));
+  // 1000 <= id < 1200.4，并且个位不是3
+  std::vector<int> expected;
+  for (int i = 1000; i < ColumnBatch::CAPACITY; i++) {
+    if (i % 10 != 3) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_EQ((int)expected.size(), batch->selected_count());
+  for (int i = 0; i < batch->selected_count(); i++) {
+    ASSERT_EQ(expected[i], batch->selection()[i]);
+  }
+  ASSERT_EQ(RC::RECORD_EOF, pred_oper.next_batch(batch));
+  ASSERT_EQ(RC::SUCCESS, pred_oper.close());
+}
+
+TEST_F(BatchOperatorTest, test_mixed_numeric_predicate)
+{
+  // 整数字段与浮点常量比较
+  float float_value = 9.5;
+  add_filter(&id_meta_, LESS_EQUAL, Value{FLOATS, &float_value});
+  ASSERT_TRUE(BatchPredicateOperator::can_filter(filter_units()));
+
+  MockBatchOperator scan_oper(fields_, 100);
+  BatchPredicateOperator pred_oper(filter_units());
+  pred_oper.add_child(&scan_oper);
+  ASSERT_EQ(RC::SUCCESS, pred_oper.open());
+
+  ColumnBatch *batch = nullptr;
+  ASSERT_EQ(RC::SUCCESS, pred_oper.next_batch(batch));
+  ASSERT_EQ(10, batch->selected_count());
+  ASSERT_EQ(RC::SUCCESS, pred_oper.close());
+}
+
+TEST_F(BatchOperatorTest, test_unsupported_predicate)
+{
+  int int_value = 3;
+  add_filter(&name_meta_, EQUAL_TO, Value{INTS, &int_value});
+  ASSERT_FALSE(BatchPredicateOperator::can_filter(filter_units()));
+}
+
+TEST_F(BatchOperatorTest, test_project)
+{
+  int int_value = 90;
+  add_filter(&id_meta_, GREAT_THAN, Value{INTS, &int_value});
+
+  MockBatchOperator scan_oper(fields_, 100);
+  BatchPredicateOperator pred_oper(filter_units());
+  pred_oper.add_child(&scan_oper);
+  BatchProjectOperator project_oper({Field(nullptr, &name_meta_), Field(nullptr, &id_meta_)});
+  project_oper.add_child(&pred_oper);
+  ASSERT_EQ(RC::SUCCESS, project_oper.open());
+
+  ColumnBatch *batch = nullptr;
+  ASSERT_EQ(RC::SUCCESS, project_oper.next_batch(batch));
+  ASSERT_EQ(9, batch->size());
+  ASSERT_EQ(9, batch->selected_count());
+  ASSERT_EQ(2, batch->column_num());
+  for (int i = 0; i < batch->size(); i++) {
+    ASSERT_EQ(91 + i, batch->column(1).values<int>()[i]);
+    char name[8];
+    snprintf(name, sizeof(name), "n%d", (91 + i) % 10);
+    ASSERT_STREQ(name, batch->column(0).value(i));
+  }
+  ASSERT_EQ(RC::RECORD_EOF, project_oper.next_batch(batch));
+  ASSERT_EQ(RC::SUCCESS, project_oper.close());
+}
+
+TEST(test_parallel_aggregation, test_merge_partial_results)
+{
+  const char *directory = "batch_operator_test_dir";
+  std::string command = std::string("rm -rf ") + directory + " && mkdir -p " + directory;
+  ASSERT_EQ(0, system(command.c_str()));
+
+  AttrInfo attrs[] = {{(char *)"id", INTS, 4}, {(char *)"v", INTS, 4}, {(char *)"score", FLOATS, 4}};
+  Table table;
+  std::string meta_file = std::string(directory) + "/t.table";
+  ASSERT_EQ(RC::SUCCESS, table.create(meta_file.c_str(), "t", directory, 3, attrs));
+
+  // v的和超过int的范围
+  const int count = 30000;
+  int64_t v_sum = 0;
+  double score_sum = 0;
+  for (int i = 0; i < count; i++) {
+    int id = i;
+    int v = (i % 2 == 0 ? 2000000000 : -1000000000) + i;
+    float score = (i % 100) * 0.25f;
+    Value values[] = {{INTS, &id}, {INTS, &v}, {FLOATS, &score}};
+    ASSERT_EQ(RC::SUCCESS, table.insert_record(nullptr, 3, values));
+    v_sum += v;
+    score_sum += score;
+  }
+
+  RelAttr star = {nullptr, (char *)"*"};
+  RelAttr id_attr = {nullptr, (char *)"id"};
+  RelAttr v_attr = {nullptr, (char *)"v"};
+  RelAttr score_attr = {nullptr, (char *)"score"};
+  std::vector<Aggregation> aggregations = {
+      {COUNT, star}, {SUM, v_attr}, {AVG, v_attr}, {MIN, id_attr}, {MAX, id_attr}, {SUM, score_attr}};
+  std::vector<Field> fields = {Field(&table, table.table_meta().field("id")),
+      Field(&table, table.table_meta().field("v")),
+      Field(&table, table.table_meta().field("score"))};
+
+  // 单线程和多线程的结果相同
+  for (int workers : {1, 4}) {
+    ParallelRecordScan parallel_scan;
+    ASSERT_EQ(RC::SUCCESS, table.get_parallel_scan(parallel_scan));
+    ASSERT_GT(parallel_scan.page_count(), ParallelRecordScan::MORSEL_PAGES * workers);
+
+    std::vector<std::unique_ptr<BatchTableScanOperator>> scan_opers;
+    BatchAggregationOperator aggre_oper(aggregations, &table);
+    for (int i = 0; i < workers; i++) {
+      scan_opers.emplace_back(new BatchTableScanOperator(&table, fields));
+      scan_opers.back()->set_parallel_scan(&parallel_scan);
+      aggre_oper.add_child(scan_opers.back().get());
+    }
+    // 再次open时从头聚合，不会累加上一次的结果
+    for (int round = 0; round < 2; round++) {
+      ASSERT_EQ(RC::SUCCESS, table.get_parallel_scan(parallel_scan));
+      ASSERT_EQ(RC::SUCCESS, aggre_oper.open());
+      ColumnBatch *batch = nullptr;
+      ASSERT_EQ(RC::RECORD_EOF, aggre_oper.next_batch(batch));
+      ASSERT_EQ(RC::SUCCESS, aggre_oper.close());
+
+      const std::vector<AggreResult> &results = aggre_oper.aggre_results();
+      ASSERT_EQ(aggregations.size(), results.size());
+      ASSERT_EQ(count, (int)results[0].count);
+      ASSERT_EQ(v_sum, results[1].int_sum);
+      ASSERT_DOUBLE_EQ(v_sum / double(count), aggre_result_avg(results[2]));
+      ASSERT_EQ(0, *(int *)results[3].result.data);
+      ASSERT_EQ(count - 1, *(int *)results[4].result.data);
+      ASSERT_DOUBLE_EQ(score_sum, results[5].float_sum);
+    }
+  }
+}
+
+TEST(test_filter_kernel, test_numeric_column)
+{
+  // 长度不是16的倍数，同时覆盖SIMD和逐个比较的部分
+  const int count = 1000;
+  std::vector<int> ints(count);
+  std::vector<float> floats(count);
+  for (int i = 0; i < count; i++) {
+    ints[i] = i % 37 - 18;
+    floats[i] = (i % 41 - 20) * 0.25f;
+  }
+  // 与常量的差在epsilon附近
+  floats[7] = 1.0f + 1E-6f;
+  floats[8] = 1.0f - 1E-6f;
+  floats[9] = 1.0f + 2E-6f;
+
+  const CompOp comps[] = {EQUAL_TO, LESS_EQUAL, NOT_EQUAL, LESS_THAN, GREAT_EQUAL, GREAT_THAN};
+  for (CompOp comp : comps) {
+    std::vector<uint8_t> bitmap(count, 1);
+    int int_constant = 3;
+    filter_int_column(comp, ints.data(), count, int_constant, bitmap.data());
+    for (int i = 0; i < count; i++) {
+      ASSERT_EQ(filter_test(comp, compare_int(&ints[i], &int_constant)), bitmap[i] == 1) << "comp=" << comp << ", i=" << i;
+    }
+
+    bitmap.assign(count, 1);
+    float float_constant = 1.0f;
+    filter_float_column(comp, floats.data(), count, float_constant, bitmap.data());
+    for (int i = 0; i < count; i++) {
+      ASSERT_EQ(filter_test(comp, compare_float(&floats[i], &float_constant)), bitmap[i] == 1) << "comp=" << comp << ", i=" << i;
+    }
+
+    bitmap.assign(count, 1);
+    float_constant = 2.5f;
+    filter_int_column(comp, ints.data(), count, float_constant, bitmap.data());
+    for (int i = 0; i < count; i++) {
+      float value = ints[i];
+      ASSERT_EQ(filter_test(comp, compare_float(&value, &float_constant)), bitmap[i] == 1) << "comp=" << comp << ", i=" << i;
+    }
+
+    // 已经被过滤掉的行保持为0
+    bitmap.assign(count, 0);
+    filter_int_column(comp, ints.data(), count, int_constant, bitmap.data());
+    for (int i = 0; i < count; i++) {
+      ASSERT_EQ(0, bitmap[i]);
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("test.log");
+  init_bpm();
+  return RUN_ALL_TESTS();
+}
@@ -737,6 +737,323 @@ TEST(test_bplus_tree, test_bplus_tree_insert)
   handler = nullptr;
 }
 
+TEST(test_bplus_tree, test_unique)
+{
+  LoggerFactory::init_default("test.log");
+
+  const char *index_name = "unique.btree";
+  ::remove(index_name);
+  handler = new BplusTreeHandler();
+  handler->create(index_name, INTS, sizeof(int), ORDER, ORDER, true/*unique*/);
+
+  const int count = 100;
+  RID rid;
+  RC rc = RC::SUCCESS;
+  for (int i = 0; i < count; i++) {
+    rid.page_num = 1;
+    rid.slot_num = i;
+    rc = handler->insert_entry((const char *)&i, &rid);
+    ASSERT_EQ(RC::SUCCESS, rc);
+  }
+  ASSERT_EQ(true, handler->validate_tree());
+
+  // 相同的user key，rid比已有的小或者大，都需要被拒绝，包括落在相邻叶子节点上的情况
+  for (int i = 0; i < count; i++) {
+    rid.page_num = 0;
+    rid.slot_num = i;
+    rc = handler->insert_entry((const char *)&i, &rid);
+    ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, rc);
+
+    rid.page_num = 2;
+    rc = handler->insert_entry((const char *)&i, &rid);
+    ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, rc);
+  }
+  ASSERT_EQ(true, handler->validate_tree());
+
+  int key = 50;
+  rid.page_num = 1;
+  rid.slot_num = key;
+  rc = handler->delete_entry((const char *)&key, &rid);
+  ASSERT_EQ(RC::SUCCESS, rc);
+
+  rid.page_num = 3;
+  rc = handler->insert_entry((const char *)&key, &rid);
+  ASSERT_EQ(RC::SUCCESS, rc);
+
+  std::list<RID> rids;
+  rc = handler->get_entry((const char *)&key, sizeof(key), rids);
+  ASSERT_EQ(RC::SUCCESS, rc);
+  ASSERT_EQ(1, rids.size());
+  ASSERT_EQ(3, rids.front().page_num);
+
+  handler->close();
+  delete handler;
+  handler = nullptr;
+}
+
+TEST(test_bplus_tree, test_get_entries)
+{
+  LoggerFactory::init_default("test.log");
+
+  const char *index_name = "multi_get.btree";
+  ::remove(index_name);
+  handler = new BplusTreeHandler();
+  handler->create(index_name, INTS, sizeof(int), ORDER, ORDER);
+
+  // 每个值插入两次，rid的页面号与值的顺序相反
+  const int count = 200;
+  RID rid;
+  RC rc = RC::SUCCESS;
+  for (int i = 0; i < count; i++) {
+    for (int j = 0; j < 2; j++) {
+      rid.page_num = count - i;
+      rid.slot_num = j;
+      rc = handler->insert_entry((const char *)&i, &rid);
+      ASSERT_EQ(RC::SUCCESS, rc);
+    }
+  }
+
+  int values[] = {150, 3, 77, 3, 4, 199, 1000, -1, 78, 0};
+  std::vector<const char *> keys;
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    keys.push_back((const char *)&values[i]);
+  }
+
+  std::vector<RID> rids;
+  rc = handler->get_entries(keys, rids);
+  ASSERT_EQ(RC::SUCCESS, rc);
+  // 重复的3只算一次，1000与-1不存在
+  ASSERT_EQ(14, rids.size());
+  for (size_t i = 1; i < rids.size(); i++) {
+    ASSERT_LT(RID::compare(&rids[i - 1], &rids[i]), 0);
+  }
+  ASSERT_EQ(count - 199, rids.front().page_num);
+  ASSERT_EQ(count - 0, rids.back().page_num);
+
+  handler->close();
+  delete handler;
+  handler = nullptr;
+}
+
+TEST(test_bplus_tree, test_include)
+{
+  LoggerFactory::init_default("test.log");
+
+  const char *index_name = "include.btree";
+  ::remove(index_name);
+  handler = new BplusTreeHandler();
+  handler->create(index_name, INTS, sizeof(int), ORDER, ORDER, false, 2 * sizeof(int));
+
+  // include字段保存key的两倍和三倍
+  const int count = 500;
+  RID rid;
+  RC rc = RC::SUCCESS;
+  for (int i = 0; i < count; i++) {
+    int include_data[2] = {i * 2, i * 3};
+    rid.page_num = i;
+    rid.slot_num = 0;
+    rc = handler->insert_entry((const char *)&i, &rid, (const char *)include_data);
+    ASSERT_EQ(RC::SUCCESS, rc);
+  }
+  ASSERT_EQ(true, handler->validate_tree());
+
+  int key = 100;
+  int include_data[2] = {-1, -1};
+  rid.page_num = key;
+  rc = handler->update_entry((const char *)&key, &rid, (const char *)include_data);
+  ASSERT_EQ(RC::SUCCESS, rc);
+
+  BplusTreeScanner scanner(*handler);
+  int begin = 50;
+  rc = scanner.open((const char *)&begin, sizeof(begin), true, nullptr, 0, false);
+  ASSERT_EQ(RC::SUCCESS, rc);
+
+  int count_scanned = 0;
+  int user_key = 0;
+  while (RC::SUCCESS == (rc = scanner.next_entry(&rid, (char *)&user_key, (char *)include_data))) {
+    ASSERT_EQ(begin + count_scanned, user_key);
+    ASSERT_EQ(user_key, rid.page_num);
+    if (user_key == key) {
+      ASSERT_EQ(-1, include_data[0]);
+      ASSERT_EQ(-1, include_data[1]);
+    } else {
+      ASSERT_EQ(user_key * 2, include_data[0]);
+      ASSERT_EQ(user_key * 3, include_data[1]);
+    }
+    count_scanned++;
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(count - begin, count_scanned);
+  scanner.close();
+
+  handler->close();
+  delete handler;
+  handler = nullptr;
+}
+
+TEST(test_bplus_tree, test_reverse_scanner)
+{
+  LoggerFactory::init_default("test.log");
+
+  const char *index_name = "reverse.btree";
+  ::remove(index_name);
+  handler = new BplusTreeHandler();
+  handler->create(index_name, INTS, sizeof(int), ORDER, ORDER);
+
+  // 空树上的扫描直接结束
+  BplusTreeScanner scanner(*handler);
+  RID rid;
+  RC rc = scanner.open(nullptr, 0, false, nullptr, 0, false, true/*reverse*/);
+  ASSERT_EQ(RC::SUCCESS, rc);
+  ASSERT_EQ(RC::RECORD_EOF, scanner.next_entry(&rid));
+  scanner.close();
+
+  // 每个key插入两次，覆盖重复key跨页面的情况
+  const int count = 1000;
+  for (int i = 0; i < count; i++) {
+    for (int slot = 0; slot < 2; slot++) {
+      rid.page_num = i;
+      rid.slot_num = slot;
+      rc = handler->insert_entry((const char *)&i, &rid);
+      ASSERT_EQ(RC::SUCCESS, rc);
+    }
+  }
+
+  rc = scanner.open(nullptr, 0, false, nullptr, 0, false, true/*reverse*/);
+  ASSERT_EQ(RC::SUCCESS, rc);
+  int scanned = 0;
+  while (RC::SUCCESS == (rc = scanner.next_entry(&rid))) {
+    const int expect = 2 * count - 1 - scanned;
+    ASSERT_EQ(expect / 2, rid.page_num);
+    ASSERT_EQ(expect % 2, rid.slot_num);
+    scanned++;
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(2 * count, scanned);
+  scanner.close();
+
+  int begin = 100;
+  int end = 300;
+  rc = scanner.open((const char *)&begin, sizeof(begin), false, (const char *)&end, sizeof(end), true, true/*reverse*/);
+  ASSERT_EQ(RC::SUCCESS, rc);
+  int user_key = 0;
+  int last_key = end + 1;
+  scanned = 0;
+  while (RC::SUCCESS == (rc = scanner.next_entry(&rid, (char *)&user_key, nullptr))) {
+    ASSERT_LE(user_key, last_key);
+    ASSERT_GT(user_key, begin);
+    ASSERT_LE(user_key, end);
+    last_key = user_key;
+    scanned++;
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(2 * (end - begin), scanned);
+  scanner.close();
+
+  // 范围内没有数据
+  begin = count + 10;
+  rc = scanner.open((const char *)&begin, sizeof(begin), true, nullptr, 0, false, true/*reverse*/);
+  ASSERT_EQ(RC::SUCCESS, rc);
+  ASSERT_EQ(RC::RECORD_EOF, scanner.next_entry(&rid));
+  scanner.close();
+
+  handler->close();
+  delete handler;
+  handler = nullptr;
+}
+
+// 删除一小段数据之后马上重新插入，返回这个过程中结构调整的次数
+static long delete_and_reinsert(BplusTreeHandler &tree, int count)
+{
+  const long restructures_before = tree.stat().splits + tree.stat().merges + tree.stat().redistributes;
+  RID rid;
+  for (int round = 0; round < count / 20; round++) {
+    for (int pass = 0; pass < 2; pass++) {
+      for (int key = round * 20; key < round * 20 + 3; key++) {
+        rid.page_num = key;
+        rid.slot_num = 0;
+        if (pass == 0) {
+          EXPECT_EQ(RC::SUCCESS, tree.delete_entry((const char *)&key, &rid));
+        } else {
+          EXPECT_EQ(RC::SUCCESS, tree.insert_entry((const char *)&key, &rid));
+        }
+      }
+    }
+  }
+  return tree.stat().splits + tree.stat().merges + tree.stat().redistributes - restructures_before;
+}
+
+TEST(test_bplus_tree, test_lazy_delete)
+{
+  LoggerFactory::init_default("test.log");
+
+  const int leaf_size = 16;
+  const int count = 2000;
+  const char *eager_name = "eager.btree";
+  const char *lazy_name = "lazy.btree";
+  ::remove(eager_name);
+  ::remove(lazy_name);
+
+  BplusTreeHandler::set_default_compact_pending(0);  // 只在显式调用compact时合并
+  BplusTreeHandler eager_tree;
+  BplusTreeHandler lazy_tree;
+  BplusTreeHandler::set_default_compact_pending(64);
+  eager_tree.set_merge_threshold(50);
+  lazy_tree.set_merge_threshold(25);
+  ASSERT_EQ(RC::SUCCESS, eager_tree.create(eager_name, INTS, sizeof(int), leaf_size, leaf_size));
+  ASSERT_EQ(RC::SUCCESS, lazy_tree.create(lazy_name, INTS, sizeof(int), leaf_size, leaf_size));
+
+  RID rid;
+  for (int i = 0; i < count; i++) {
+    rid.page_num = i;
+    rid.slot_num = 0;
+    ASSERT_EQ(RC::SUCCESS, eager_tree.insert_entry((const char *)&i, &rid));
+    ASSERT_EQ(RC::SUCCESS, lazy_tree.insert_entry((const char *)&i, &rid));
+  }
+
+  const long eager_restructures = delete_and_reinsert(eager_tree, count);
+  const long lazy_restructures = delete_and_reinsert(lazy_tree, count);
+  ASSERT_GT(eager_restructures, 0);
+  ASSERT_LT(lazy_restructures, eager_restructures);
+  ASSERT_GT(lazy_tree.stat().lazy_deletes, 0);
+  ASSERT_EQ(0, eager_tree.stat().lazy_deletes);
+  ASSERT_EQ(true, lazy_tree.validate_tree());
+
+  // 删掉大部分数据，空的叶子节点必须马上删除，其它的留给compact
+  for (int i = 0; i < count; i++) {
+    if (i % 10 != 0) {
+      rid.page_num = i;
+      rid.slot_num = 0;
+      ASSERT_EQ(RC::SUCCESS, lazy_tree.delete_entry((const char *)&i, &rid));
+    }
+  }
+  ASSERT_EQ(true, lazy_tree.validate_tree());
+  ASSERT_EQ(RC::SUCCESS, lazy_tree.compact());
+  ASSERT_GT(lazy_tree.stat().compactions, 0);
+  ASSERT_EQ(true, lazy_tree.validate_tree());
+
+  BplusTreeScanner scanner(lazy_tree);
+  ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, false, nullptr, 0, false));
+  int scanned = 0;
+  while (RC::SUCCESS == scanner.next_entry(&rid)) {
+    ASSERT_EQ(scanned * 10, rid.page_num);
+    scanned++;
+  }
+  ASSERT_EQ(count / 10, scanned);
+  scanner.close();
+
+  for (int i = 0; i < count; i += 10) {
+    rid.page_num = i;
+    rid.slot_num = 0;
+    ASSERT_EQ(RC::SUCCESS, lazy_tree.delete_entry((const char *)&i, &rid));
+  }
+  ASSERT_EQ(RC::SUCCESS, lazy_tree.compact());
+  ASSERT_EQ(true, lazy_tree.is_empty());
+
+  eager_tree.close();
+  lazy_tree.close();
+}
+
 int main(int argc, char **argv)
 {
 
@@ -0,0 +1,151 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "sql/expr/compiled_expr.h"
+#include "sql/expr/tuple.h"
+#include "sql/parser/parse.h"
+#include "storage/common/table.h"
+#include "storage/common/record.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+BufferPoolManager bpm;
+
+void init_bpm()
+{
+  if (&BufferPoolManager::instance() == nullptr) {
+    BufferPoolManager::set_instance(&bpm);
+  }
+}
+
+class CompiledExprTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const char *directory = "compiled_expr_test_dir";
+    std::string command = std::string("rm -rf ") + directory + " && mkdir -p " + directory;
+    ASSERT_EQ(0, system(command.c_str()));
+
+    AttrInfo attrs[] = {{(char *)"i", INTS, 4}, {(char *)"f", FLOATS, 4}};
+    std::string meta_file = std::string(directory) + "/t.table";
+    ASSERT_EQ(RC::SUCCESS, table_.create(meta_file.c_str(), "t", directory, 2, attrs));
+
+    // i = 4, f = 0.5
+    const TableMeta &table_meta = table_.table_meta();
+    row_.assign(table_meta.record_size(), 0);
+    const int i = 4;
+    const float f = 0.5;
+    memcpy(row_.data() + table_meta.field("i")->offset(), &i, sizeof(i));
+    memcpy(row_.data() + table_meta.field("f")->offset(), &f, sizeof(f));
+    record_.set_data(row_.data());
+    tuple_.set_schema(&table_, table_meta.field_metas());
+    tuple_.set_record(&record_);
+  }
+
+  /**
+   * 编译select列表中的第一个表达式并计算
+   */
+  AttrType evaluate(const std::string &expr, ExprValue &value)
+  {
+    const std::string sql = "select " + expr + " from t;";
+    Query *query = query_create();
+    EXPECT_EQ(RC::SUCCESS, parse(sql.c_str(), query));
+    EXPECT_EQ(1, (int)query->sstr.selection.expr_size);
+
+    CompiledExpr compiled_expr;
+    const RC rc = compiled_expr.compile(query->sstr.selection.expr[0], {&table_});
+    query_destroy(query);
+    EXPECT_EQ(RC::SUCCESS, rc);
+    return compiled_expr.evaluate(tuple_, value);
+  }
+
+  int evaluate_int(const std::string &expr)
+  {
+    ExprValue value;
+    EXPECT_EQ(INTS, evaluate(expr, value)) << expr;
+    return value.int_value;
+  }
+
+  float evaluate_float(const std::string &expr)
+  {
+    ExprValue value;
+    EXPECT_EQ(FLOATS, evaluate(expr, value)) << expr;
+    return value.float_value;
+  }
+
+protected:
+  Table table_;
+  std::vector<char> row_;
+  Record record_;
+  RowTuple tuple_;
+};
+
+TEST_F(CompiledExprTest, test_int_arithmetic)
+{
+  // 两边都是整数时按整数计算，除法截断
+  ASSERT_EQ(13, evaluate_int("i * 3 + 1"));
+  ASSERT_EQ(2, evaluate_int("(i + 1) / 2"));
+  ASSERT_EQ(-1, evaluate_int("i - 5"));
+}
+
+TEST_F(CompiledExprTest, test_float_promotion)
+{
+  // 任意一边是浮点数时另一边转换成浮点数
+  ASSERT_FLOAT_EQ(4.5, evaluate_float("i + f"));
+  ASSERT_FLOAT_EQ(8, evaluate_float("i / f"));
+  ASSERT_FLOAT_EQ(2.5, evaluate_float("5 / 2.0"));
+  ASSERT_FLOAT_EQ(2.5, evaluate_float("(i + 1) * f"));
+}
+
+TEST_F(CompiledExprTest, test_unary_minus)
+{
+  ASSERT_EQ(-4, evaluate_int("-i"));
+  ASSERT_EQ(-1, evaluate_int("-i + 3"));
+  ASSERT_FLOAT_EQ(-0.5, evaluate_float("-f"));
+  ASSERT_FLOAT_EQ(-4.5, evaluate_float("-(i + f)"));
+}
+
+TEST_F(CompiledExprTest, test_divide_by_zero)
+{
+  ExprValue value;
+  ASSERT_EQ(UNDEFINED, evaluate("i / 0", value));
+  ASSERT_EQ(UNDEFINED, evaluate("f / (i - 4)", value));
+  ASSERT_EQ(UNDEFINED, evaluate("i / (f - 0.5)", value));
+}
+
+TEST_F(CompiledExprTest, test_deep_expression)
+{
+  // 中间结果超过MAX_DEPTH层时在堆上计算
+  for (int depth : {CompiledExpr::MAX_DEPTH - 1, CompiledExpr::MAX_DEPTH + 1, 200}) {
+    // i + (i + (... + (1)))，每个i都要等右边算完才能相加
+    std::string expr = "1";
+    for (int d = 0; d < depth; d++) {
+      expr = "i + (" + expr + ")";
+    }
+    ASSERT_EQ(4 * depth + 1, evaluate_int(expr)) << depth;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("test.log");
+  init_bpm();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,192 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sql/executor/execute_stage.h"
+#include "sql/operator/hash_aggregation_operator.h"
+#include "sql/operator/aggre_result.h"
+#include "sql/parser/parse.h"
+#include "sql/stmt/select_stmt.h"
+#include "storage/common/db.h"
+#include "storage/common/table.h"
+#include "storage/common/record.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "common/log/log.h"
+#include "mock_scan_operator.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+BufferPoolManager bpm;
+
+void init_bpm()
+{
+  if (&BufferPoolManager::instance() == nullptr) {
+    BufferPoolManager::set_instance(&bpm);
+  }
+}
+
+struct Expected {
+  int count = 0;
+  int min_id = 0;
+  int max_id = 0;
+  int id_sum = 0;
+};
+
+TEST(test_hash_aggregation, test_group_by_with_spill)
+{
+  const char *directory = "hash_aggregation_test_dir";
+  std::string command = std::string("rm -rf ") + directory + " && mkdir -p " + directory;
+  ASSERT_EQ(0, system(command.c_str()));
+  SpillFile::set_directory(directory);
+
+  AttrInfo attrs[] = {{(char *)"id", INTS, 4}, {(char *)"name", CHARS, 8}};
+  Table table;
+  std::string meta_file = std::string(directory) + "/t.table";
+  ASSERT_EQ(RC::SUCCESS, table.create(meta_file.c_str(), "t", directory, 2, attrs));
+  const FieldMeta *id_meta = table.table_meta().field("id");
+  const FieldMeta *name_meta = table.table_meta().field("name");
+
+  // 3000个分组，每个分组的行分散在整个输入中
+  const int groups = 3000;
+  const int count = 20000;
+  std::vector<std::vector<char>> rows;
+  std::map<std::string, Expected> expected;
+  for (int i = 0; i < count; i++) {
+    std::vector<char> row(table.table_meta().record_size(), 'x');  // 结束符后面是无关的数据
+    const int id = (i * 7919) % count;
+    char name[8];
+    snprintf(name, sizeof(name), "g%d", id % groups);
+    memcpy(row.data() + id_meta->offset(), &id, sizeof(id));
+    memcpy(row.data() + name_meta->offset(), name, strlen(name) + 1);
+    rows.push_back(row);
+
+    Expected &e = expected[name];
+    e.min_id = e.count == 0 ? id : std::min(e.min_id, id);
+    e.max_id = e.count == 0 ? id : std::max(e.max_id, id);
+    e.count++;
+    e.id_sum += id;
+  }
+
+  RelAttr star = {nullptr, (char *)"*"};
+  RelAttr id_attr = {nullptr, (char *)"id"};
+  std::vector<Aggregation> aggregations = {{COUNT, star}, {MIN, id_attr}, {MAX, id_attr}, {AVG, id_attr}};
+  std::vector<Field> group_fields = {Field(&table, name_meta)};
+
+  // 内存足够时不分区；只能放下几十个分组时需要多层分区
+  for (int64_t budget : {(int64_t)64 << 20, (int64_t)4096}) {
+    MockScanOperator scan_oper(&table, rows);
+    HashAggregationOperator aggre_oper(group_fields, aggregations, &table);
+    aggre_oper.set_memory_budget(budget);
+    aggre_oper.add_child(&scan_oper);
+    ASSERT_EQ(RC::SUCCESS, aggre_oper.open());
+
+    std::map<std::string, bool> seen;
+    RC rc = RC::SUCCESS;
+    while (RC::SUCCESS == (rc = aggre_oper.next())) {
+      TupleCell cell;
+      ASSERT_EQ(RC::SUCCESS, aggre_oper.current_tuple()->find_cell(group_fields[0], cell));
+      const std::string name(cell.data());
+      ASSERT_FALSE(seen[name]) << name;
+      seen[name] = true;
+
+      const Expected &e = expected[name];
+      const std::vector<AggreResult> &results = aggre_oper.aggre_results();
+      ASSERT_EQ(e.count, (int)results[0].count);
+      ASSERT_EQ(e.min_id, *(int *)results[1].result.data);
+      ASSERT_EQ(e.max_id, *(int *)results[2].result.data);
+      ASSERT_DOUBLE_EQ(e.id_sum / double(e.count), aggre_result_avg(results[3]));
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    ASSERT_EQ(groups, (int)seen.size());
+    if (budget < 1 << 20) {
+      ASSERT_GT(aggre_oper.spilled_partitions(), 16);
+    } else {
+      ASSERT_EQ(0, aggre_oper.spilled_partitions());
+    }
+    ASSERT_EQ(RC::SUCCESS, aggre_oper.close());
+  }
+}
+
+/**
+ * 执行分组查询，返回表头和排好序的各行
+ */
+static std::vector<std::string> group_select(Db &db, const char *sql)
+{
+  std::vector<std::string> lines;
+  Query *query = query_create();
+  EXPECT_EQ(RC::SUCCESS, parse(sql, query));
+  Stmt *stmt = nullptr;
+  EXPECT_EQ(RC::SUCCESS, Stmt::create_stmt(&db, *query, stmt));
+  std::stringstream ss;
+  if (stmt != nullptr) {
+    EXPECT_EQ(RC::SUCCESS, do_group_select(static_cast<SelectStmt *>(stmt), ss));
+  }
+  delete stmt;
+  query_destroy(query);
+
+  std::string line;
+  while (std::getline(ss, line)) {
+    lines.push_back(line);
+  }
+  if (!lines.empty()) {
+    std::sort(lines.begin() + 1, lines.end());  // 分组输出的顺序不确定
+  }
+  return lines;
+}
+
+TEST(test_hash_aggregation, test_select_list_order)
+{
+  const char *directory = "hash_aggregation_order_test_dir";
+  std::string command = std::string("rm -rf ") + directory + " && mkdir -p " + directory;
+  ASSERT_EQ(0, system(command.c_str()));
+  SpillFile::set_directory(directory);
+  Db db;
+  ASSERT_EQ(RC::SUCCESS, db.init("hash_aggregation_order_test", directory));
+
+  AttrInfo attrs[] = {{(char *)"id", INTS, 4}, {(char *)"g", INTS, 4}, {(char *)"k", INTS, 4}};
+  ASSERT_EQ(RC::SUCCESS, db.create_table("t", 3, attrs));
+  const int rows[][3] = {{1, 1, 10}, {2, 1, 10}, {3, 2, 20}};
+  for (const int *row : rows) {
+    Value values[3];
+    for (int i = 0; i < 3; i++) {
+      value_init_integer(&values[i], row[i]);
+    }
+    ASSERT_EQ(RC::SUCCESS, db.find_table("t")->insert_record(nullptr, 3, values));
+    for (Value &value : values) {
+      value_destroy(&value);
+    }
+  }
+
+  // 聚合函数在分组字段前面时也按照select列表的顺序输出
+  ASSERT_EQ(std::vector<std::string>({"COUNT(*) | g", "1 | 2", "2 | 1"}),
+            group_select(db, "select count(*), g from t group by g;"));
+  ASSERT_EQ(std::vector<std::string>({"g | COUNT(*)", "1 | 2", "2 | 1"}),
+            group_select(db, "select g, count(*) from t group by g;"));
+  ASSERT_EQ(std::vector<std::string>({"MAX(ID) | g | MIN(ID) | k | COUNT(*)", "2 | 1 | 1 | 10 | 2", "3 | 2 | 3 | 20 | 1"}),
+            group_select(db, "select max(id), g, min(id), k, count(*) from t group by g, k;"));
+  ASSERT_EQ(std::vector<std::string>({"g | k", "1 | 10", "2 | 20"}),
+            group_select(db, "select g, k from t group by g, k;"));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("test.log");
+  init_bpm();
+  return RUN_ALL_TESTS();
+}
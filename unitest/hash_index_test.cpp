@@ -0,0 +1,162 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdio.h>
+#include <vector>
+
+#include "storage/index/extendible_hash.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "rc.h"
+#include "common/log/log.h"
+#include "sql/parser/parse_defs.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+// bucket容量比较小，才能覆盖分裂和溢出页面的逻辑
+#define BUCKET_CAPACITY 8
+
+BufferPoolManager bpm;
+
+void init_bpm()
+{
+  if (&BufferPoolManager::instance() == nullptr) {
+    BufferPoolManager::set_instance(&bpm);
+  }
+}
+
+TEST(test_hash_index, test_insert_delete)
+{
+  LoggerFactory::init_default("test.log");
+
+  const char *index_name = "test.hash";
+  ::remove(index_name);
+  ExtendibleHashHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int), false, BUCKET_CAPACITY));
+
+  const int count = 2000;
+  RID rid;
+  for (int i = 0; i < count; i++) {
+    rid.page_num = i;
+    rid.slot_num = 0;
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&i, &rid));
+  }
+  ASSERT_TRUE(handler.validate());
+  ASSERT_GT(handler.global_depth(), 0);
+
+  for (int i = 0; i < count; i++) {
+    std::vector<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entry((const char *)&i, rids));
+    ASSERT_EQ(1, rids.size());
+    ASSERT_EQ(i, rids[0].page_num);
+  }
+
+  for (int i = 0; i < count; i += 2) {
+    rid.page_num = i;
+    rid.slot_num = 0;
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&i, &rid));
+  }
+  int key = 0;
+  ASSERT_EQ(RC::RECORD_RECORD_NOT_EXIST, handler.delete_entry((const char *)&key, &rid));
+  ASSERT_TRUE(handler.validate());
+
+  // 重新打开之后目录和数据都还在
+  handler.close();
+  ASSERT_EQ(RC::SUCCESS, handler.open(index_name));
+  ASSERT_TRUE(handler.validate());
+  for (int i = 0; i < count; i++) {
+    std::vector<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entry((const char *)&i, rids));
+    ASSERT_EQ(i % 2 == 0 ? 0 : 1, rids.size());
+  }
+  handler.close();
+}
+
+TEST(test_hash_index, test_duplicate_keys)
+{
+  LoggerFactory::init_default("test.log");
+
+  const char *index_name = "test_dup.hash";
+  ::remove(index_name);
+  ExtendibleHashHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int), false, BUCKET_CAPACITY));
+
+  // 大量重复的key无法通过分裂区分，需要使用溢出页面
+  const int dup_count = BUCKET_CAPACITY * 10;
+  RID rid;
+  int keys[] = {7, 13};
+  for (int key : keys) {
+    for (int i = 0; i < dup_count; i++) {
+      rid.page_num = dup_count - i;
+      rid.slot_num = key;
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&key, &rid));
+    }
+  }
+  ASSERT_TRUE(handler.validate());
+
+  std::vector<const char *> user_keys = {(const char *)&keys[1], (const char *)&keys[0], (const char *)&keys[1]};
+  std::vector<RID> rids;
+  ASSERT_EQ(RC::SUCCESS, handler.get_entries(user_keys, rids));
+  ASSERT_EQ(2 * dup_count, rids.size());
+  for (size_t i = 1; i < rids.size(); i++) {
+    ASSERT_LE(RID::compare(&rids[i - 1], &rids[i]), 0);
+  }
+
+  for (int i = 0; i < dup_count; i++) {
+    rid.page_num = dup_count - i;
+    rid.slot_num = keys[0];
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&keys[0], &rid));
+  }
+  rids.clear();
+  ASSERT_EQ(RC::SUCCESS, handler.get_entry((const char *)&keys[0], rids));
+  ASSERT_EQ(0, rids.size());
+  handler.close();
+}
+
+TEST(test_hash_index, test_unique_chars)
+{
+  LoggerFactory::init_default("test.log");
+
+  const char *index_name = "test_unique.hash";
+  ::remove(index_name);
+  ExtendibleHashHandler handler;
+  const int attr_length = 8;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, CHARS, attr_length, true, BUCKET_CAPACITY));
+
+  RID rid;
+  char key[attr_length];
+  for (int i = 0; i < 200; i++) {
+    memset(key, 0, sizeof(key));
+    snprintf(key, sizeof(key), "k%d", i);
+    rid.page_num = i;
+    rid.slot_num = 0;
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key, &rid));
+  }
+  ASSERT_TRUE(handler.validate());
+
+  // 字符串结束符后面的内容不参与比较
+  memset(key, 'x', sizeof(key));
+  snprintf(key, 4, "k42");
+  rid.page_num = 1000;
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler.insert_entry(key, &rid));
+
+  std::vector<RID> rids;
+  ASSERT_EQ(RC::SUCCESS, handler.get_entry(key, rids));
+  ASSERT_EQ(1, rids.size());
+  ASSERT_EQ(42, rids[0].page_num);
+  handler.close();
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  init_bpm();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,328 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sql/operator/join_operator.h"
+#include "storage/common/table.h"
+#include "storage/common/record.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "storage/default/spill_file.h"
+#include "common/log/log.h"
+#include "mock_scan_operator.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+BufferPoolManager bpm;
+
+void init_bpm()
+{
+  if (&BufferPoolManager::instance() == nullptr) {
+    BufferPoolManager::set_instance(&bpm);
+  }
+}
+
+typedef std::vector<std::pair<int, int>> JoinResult;  // 连接结果中左边和右边的id
+
+class JoinOperatorTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const char *directory = "join_operator_test_dir";
+    std::string command = std::string("rm -rf ") + directory + " && mkdir -p " + directory;
+    ASSERT_EQ(0, system(command.c_str()));
+    SpillFile::set_directory(directory);
+
+    // 两边的字符串字段长度不同，索引查找时要截断或者补0
+    AttrInfo left_attrs[] = {{(char *)"id", INTS, 4}, {(char *)"k", INTS, 4}, {(char *)"s", CHARS, 8}};
+    AttrInfo right_attrs[] = {{(char *)"id", INTS, 4}, {(char *)"k", INTS, 4}, {(char *)"s", CHARS, 4}};
+    for (Table *table : {&left_, &right_}) {
+      const char *name = table == &left_ ? "l" : "r";
+      std::string meta_file = std::string(directory) + "/" + name + ".table";
+      ASSERT_EQ(RC::SUCCESS,
+          table->create(meta_file.c_str(), name, directory, 3, table == &left_ ? left_attrs : right_attrs));
+    }
+  }
+
+  void add_row(Table &table, std::vector<std::vector<char>> &rows, int id, int k, const char *s = "")
+  {
+    const TableMeta &table_meta = table.table_meta();
+    std::vector<char> row(table_meta.record_size(), 0);
+    memcpy(row.data() + table_meta.field("id")->offset(), &id, sizeof(id));
+    memcpy(row.data() + table_meta.field("k")->offset(), &k, sizeof(k));
+    const FieldMeta *s_meta = table_meta.field("s");
+    memcpy(row.data() + s_meta->offset(), s, std::min<size_t>(strlen(s), s_meta->len()));
+    rows.push_back(row);
+  }
+
+  /**
+   * 右边的行同时插入到表中，索引嵌套循环连接从表中读取
+   */
+  void insert_right(int id, int k, const char *s = "")
+  {
+    Value values[3];
+    value_init_integer(&values[0], id);
+    value_init_integer(&values[1], k);
+    value_init_string(&values[2], s);
+    ASSERT_EQ(RC::SUCCESS, right_.insert_record(nullptr, 3, values));
+    for (Value &value : values) {
+      value_destroy(&value);
+    }
+    add_row(right_, right_rows_, id, k, s);
+  }
+
+  int value_of(const Tuple &tuple, Table &table, const char *field_name)
+  {
+    TupleCell cell;
+    EXPECT_EQ(RC::SUCCESS, tuple.find_cell(Field(&table, table.table_meta().field(field_name)), cell));
+    return *(const int *)cell.data();
+  }
+
+  Field key_of(Table &table, const char *field_name = "k")
+  {
+    return Field(&table, table.table_meta().field(field_name));
+  }
+
+  /**
+   * 读出连接算子的全部结果，key不为空时只保留两边key字段相等的行
+   */
+  JoinResult collect(Operator &oper, const char *key)
+  {
+    JoinResult result;
+    EXPECT_EQ(RC::SUCCESS, oper.open());
+    RC rc = RC::SUCCESS;
+    while (RC::SUCCESS == (rc = oper.next())) {
+      const Tuple &tuple = *oper.current_tuple();
+      if (key != nullptr) {
+        TupleCell left_cell;
+        TupleCell right_cell;
+        EXPECT_EQ(RC::SUCCESS, tuple.find_cell(key_of(left_, key), left_cell));
+        EXPECT_EQ(RC::SUCCESS, tuple.find_cell(key_of(right_, key), right_cell));
+        if (0 != left_cell.compare(right_cell)) {
+          continue;
+        }
+      }
+      result.emplace_back(value_of(tuple, left_, "id"), value_of(tuple, right_, "id"));
+    }
+    EXPECT_EQ(RC::RECORD_EOF, rc);
+    oper.close();
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  JoinResult nested_loop_join(const char *key = "k")
+  {
+    MockScanOperator left_oper(&left_, left_rows_);
+    MockScanOperator right_oper(&right_, right_rows_);
+    NestedLoopJoinOperator join_oper(&left_oper, {&left_}, &right_oper, {&right_});
+    return collect(join_oper, key);
+  }
+
+  JoinResult hash_join(int64_t memory_budget, int &spilled_partitions)
+  {
+    // 右边作为build一侧
+    MockScanOperator right_oper(&right_, right_rows_);
+    MockScanOperator left_oper(&left_, left_rows_);
+    HashJoinOperator join_oper(&right_oper, {&right_}, &left_oper, {&left_}, {key_of(right_)}, {key_of(left_)});
+    join_oper.set_memory_budget(memory_budget);
+    JoinResult result = collect(join_oper, nullptr);
+    spilled_partitions = join_oper.spilled_partitions();
+    return result;
+  }
+
+  JoinResult index_join(const char *key)
+  {
+    MockScanOperator left_oper(&left_, left_rows_);
+    IndexNestedLoopJoinOperator join_oper(
+        &left_oper, {&left_}, &right_, right_.find_index_by_field(key), key_of(left_, key), key_of(right_, key));
+    return collect(join_oper, nullptr);
+  }
+
+  void create_index(const char *field_name, IndexType index_type)
+  {
+    const std::string index_name = std::string("r_") + field_name;
+    ASSERT_EQ(RC::SUCCESS,
+        right_.create_index(nullptr, index_name.c_str(), field_name, false, std::vector<std::string>(), index_type));
+  }
+
+  void check_index_join(IndexType index_type)
+  {
+    // 左边超过一批的行数，两边都有重复的值
+    for (int i = 0; i < 500; i++) {
+      add_row(left_, left_rows_, i, i % 150);
+    }
+    for (int i = 0; i < 300; i++) {
+      insert_right(i, i % 100);
+    }
+    create_index("k", index_type);
+
+    const JoinResult expected = nested_loop_join();
+    ASSERT_EQ((size_t)50 * 4 * 3 + 50 * 3 * 3, expected.size());
+    ASSERT_EQ(expected, index_join("k"));
+  }
+
+  void check_index_join_key_length(IndexType index_type)
+  {
+    // 左边的字符串比索引字段长时截断之后查找，查到的记录还要用原始值比较
+    const char *left_values[] = {"ab", "abcd", "abcdefg", "b", ""};
+    for (int i = 0; i < 5; i++) {
+      add_row(left_, left_rows_, i, 0, left_values[i]);
+    }
+    const char *right_values[] = {"ab", "abc", "abcd", "abcd", "b"};
+    for (int i = 0; i < 5; i++) {
+      insert_right(i, 0, right_values[i]);
+    }
+    create_index("s", index_type);
+
+    const JoinResult expected = nested_loop_join("s");
+    const JoinResult matches = {{0, 0}, {1, 2}, {1, 3}, {3, 4}};
+    ASSERT_EQ(matches, expected);
+    ASSERT_EQ(expected, index_join("s"));
+  }
+
+  JoinResult sort_merge_join(bool sorted)
+  {
+    MockScanOperator left_oper(&left_, left_rows_);
+    MockScanOperator right_oper(&right_, right_rows_);
+    SortMergeJoinOperator join_oper(&left_oper, {&left_}, &right_oper, {&right_}, {key_of(left_)}, {key_of(right_)});
+    join_oper.set_sorted(sorted, sorted);
+    return collect(join_oper, nullptr);
+  }
+
+protected:
+  Table left_;
+  Table right_;
+  std::vector<std::vector<char>> left_rows_;
+  std::vector<std::vector<char>> right_rows_;
+};
+
+TEST_F(JoinOperatorTest, test_hash_join_duplicate_keys)
+{
+  // 两边都有重复的连接字段，也都有对方没有的值
+  for (int i = 0; i < 300; i++) {
+    add_row(left_, left_rows_, i, i % 50);
+  }
+  for (int i = 0; i < 120; i++) {
+    add_row(right_, right_rows_, i, i % 40 + 20);
+  }
+
+  const JoinResult expected = nested_loop_join();
+  ASSERT_EQ((size_t)30 * 6 * 3, expected.size());
+
+  int spilled_partitions = 0;
+  ASSERT_EQ(expected, hash_join(64 * 1024 * 1024, spilled_partitions));
+  ASSERT_EQ(0, spilled_partitions);
+}
+
+TEST_F(JoinOperatorTest, test_hash_join_empty_build)
+{
+  for (int i = 0; i < 100; i++) {
+    add_row(left_, left_rows_, i, i);
+  }
+
+  int spilled_partitions = 0;
+  ASSERT_TRUE(hash_join(64 * 1024 * 1024, spilled_partitions).empty());
+  ASSERT_TRUE(nested_loop_join().empty());
+}
+
+TEST_F(JoinOperatorTest, test_hash_join_spill_uniform)
+{
+  for (int i = 0; i < 8000; i++) {
+    add_row(left_, left_rows_, i, i % 4000);
+  }
+  for (int i = 0; i < 4000; i++) {
+    add_row(right_, right_rows_, i, i);
+  }
+
+  int spilled_partitions = 0;
+  const JoinResult expected = hash_join(64 * 1024 * 1024, spilled_partitions);
+  ASSERT_EQ((size_t)8000, expected.size());
+  ASSERT_EQ(0, spilled_partitions);
+
+  // 每个第0层分区都放不下，需要用下一层的哈希位再分区
+  ASSERT_EQ(expected, hash_join(2048, spilled_partitions));
+  ASSERT_GT(spilled_partitions, 16);
+}
+
+TEST_F(JoinOperatorTest, test_hash_join_spill_single_key)
+{
+  // build一侧全是同一个值，再分区也分不开，只能把整个分区读到内存中
+  for (int i = 0; i < 50; i++) {
+    add_row(left_, left_rows_, i, i % 10);
+  }
+  for (int i = 0; i < 2000; i++) {
+    add_row(right_, right_rows_, i, 7);
+  }
+
+  int spilled_partitions = 0;
+  const JoinResult expected = hash_join(64 * 1024 * 1024, spilled_partitions);
+  ASSERT_EQ((size_t)5 * 2000, expected.size());
+  ASSERT_EQ(0, spilled_partitions);
+
+  ASSERT_EQ(expected, hash_join(2048, spilled_partitions));
+  ASSERT_EQ(1, spilled_partitions);
+}
+
+TEST_F(JoinOperatorTest, test_index_join)
+{
+  check_index_join(BPLUS_TREE_INDEX);
+}
+
+TEST_F(JoinOperatorTest, test_index_join_hash_index)
+{
+  check_index_join(HASH_INDEX);
+}
+
+TEST_F(JoinOperatorTest, test_index_join_key_length)
+{
+  check_index_join_key_length(BPLUS_TREE_INDEX);
+}
+
+TEST_F(JoinOperatorTest, test_index_join_key_length_hash_index)
+{
+  check_index_join_key_length(HASH_INDEX);
+}
+
+TEST_F(JoinOperatorTest, test_sort_merge_join)
+{
+  for (int i = 0; i < 300; i++) {
+    add_row(left_, left_rows_, i, (i * 7) % 50);
+  }
+  for (int i = 0; i < 120; i++) {
+    add_row(right_, right_rows_, i, (i * 11) % 40 + 20);
+  }
+
+  const JoinResult expected = nested_loop_join();
+  ASSERT_EQ((size_t)30 * 6 * 3, expected.size());
+  ASSERT_EQ(expected, sort_merge_join(false));
+
+  // 输入已经有序时逐行读取，每次只保存右边的一组
+  auto by_key = [this](const std::vector<char> &left, const std::vector<char> &right) {
+    const int offset = left_.table_meta().field("k")->offset();
+    return *(const int *)(left.data() + offset) < *(const int *)(right.data() + offset);
+  };
+  std::stable_sort(left_rows_.begin(), left_rows_.end(), by_key);
+  std::stable_sort(right_rows_.begin(), right_rows_.end(), by_key);
+  ASSERT_EQ(expected, sort_merge_join(true));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("test.log");
+  init_bpm();
+  return RUN_ALL_TESTS();
+}
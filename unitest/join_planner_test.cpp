@@ -0,0 +1,239 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "sql/executor/execute_stage.h"
+#include "sql/operator/index_scan_operator.h"
+#include "sql/optimizer/join_planner.h"
+#include "sql/parser/parse.h"
+#include "sql/stmt/filter_stmt.h"
+#include "sql/stmt/select_stmt.h"
+#include "storage/common/db.h"
+#include "storage/common/table.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "storage/index/index.h"
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+BufferPoolManager bpm;
+
+void init_bpm()
+{
+  if (&BufferPoolManager::instance() == nullptr) {
+    BufferPoolManager::set_instance(&bpm);
+  }
+}
+
+class JoinPlannerTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const char *directory = "join_planner_test_dir";
+    std::string command = std::string("rm -rf ") + directory + " && mkdir -p " + directory;
+    ASSERT_EQ(0, system(command.c_str()));
+    ASSERT_EQ(RC::SUCCESS, db_.init("join_planner_test", directory));
+
+    // small很小；a、b、h一样大，a和b的k上有B+树索引，h的k上有哈希索引
+    create_table("small", 10, nullptr, BPLUS_TREE_INDEX);
+    create_table("a", 1000, "k", BPLUS_TREE_INDEX);
+    create_table("b", 1000, "k", BPLUS_TREE_INDEX);
+    create_table("h", 1000, "k", HASH_INDEX);
+  }
+
+  void TearDown() override
+  {
+    delete stmt_;
+    stmt_ = nullptr;
+    if (query_ != nullptr) {
+      query_destroy(query_);
+      query_ = nullptr;
+    }
+  }
+
+  void create_table(const char *name, int rows, const char *index_field, IndexType index_type)
+  {
+    AttrInfo attrs[] = {{(char *)"id", INTS, 4}, {(char *)"k", INTS, 4}};
+    ASSERT_EQ(RC::SUCCESS, db_.create_table(name, 2, attrs));
+    Table *table = db_.find_table(name);
+    for (int i = 0; i < rows; i++) {
+      Value values[2];
+      value_init_integer(&values[0], i);
+      value_init_integer(&values[1], i);
+      ASSERT_EQ(RC::SUCCESS, table->insert_record(nullptr, 2, values));
+      value_destroy(&values[0]);
+      value_destroy(&values[1]);
+    }
+    if (index_field != nullptr) {
+      const std::string index_name = std::string(name) + "_" + index_field;
+      ASSERT_EQ(RC::SUCCESS,
+          table->create_index(nullptr, index_name.c_str(), index_field, false, std::vector<std::string>(), index_type));
+    }
+    ASSERT_EQ(RC::SUCCESS, table->analyze(nullptr));
+  }
+
+  const std::vector<JoinStep> &plan(const char *sql)
+  {
+    TearDown();
+    query_ = query_create();
+    EXPECT_EQ(RC::SUCCESS, parse(sql, query_));
+    Stmt *stmt = nullptr;
+    EXPECT_EQ(RC::SUCCESS, Stmt::create_stmt(&db_, *query_, stmt));
+    stmt_ = static_cast<SelectStmt *>(stmt);
+    JoinPlanner::plan(stmt_);
+    return stmt_->join_steps();
+  }
+
+  /**
+   * 用索引扫描a，返回读到的k值
+   */
+  std::vector<int> index_scan(const char *sql)
+  {
+    plan(sql);
+    std::vector<int> values;
+    IndexScanOperator *oper = try_to_create_index_scan_operator(stmt_->filter_stmt());
+    EXPECT_NE(nullptr, oper);
+    if (oper == nullptr) {
+      return values;
+    }
+
+    Table *table = db_.find_table("a");
+    const Field field(table, table->table_meta().field("k"));
+    EXPECT_EQ(RC::SUCCESS, oper->open());
+    while (RC::SUCCESS == oper->next()) {
+      TupleCell cell;
+      EXPECT_EQ(RC::SUCCESS, oper->current_tuple()->find_cell(field, cell));
+      values.push_back(*(const int *)cell.data());
+    }
+    oper->close();
+    delete oper;
+    return values;
+  }
+
+protected:
+  Db db_;
+  Query *query_ = nullptr;
+  SelectStmt *stmt_ = nullptr;
+};
+
+TEST_F(JoinPlannerTest, test_index_nested_loop)
+{
+  // 已经连接的行数乘以4不超过新表的行数时逐行查索引，哈希索引也可以
+  for (const char *table_name : {"a", "h"}) {
+    const std::string sql = std::string("select * from small, ") + table_name + " where small.k = " + table_name + ".k;";
+    const std::vector<JoinStep> &steps = plan(sql.c_str());
+    ASSERT_EQ(2, (int)steps.size());
+    ASSERT_STREQ("small", steps[0].table->name());
+    ASSERT_STREQ(table_name, steps[1].table->name());
+    ASSERT_EQ(JoinMethod::INDEX_NESTED_LOOP, steps[1].method);
+    ASSERT_EQ(db_.find_table(table_name)->find_index_by_field("k"), steps[1].index);
+    ASSERT_TRUE(steps[1].join_filters.empty());
+  }
+}
+
+TEST_F(JoinPlannerTest, test_sort_merge)
+{
+  // 两边差不多大，都有B+树索引并且没有其它条件时按照索引顺序归并
+  const std::vector<JoinStep> &steps = plan("select * from a, b where a.k = b.k;");
+  ASSERT_EQ(2, (int)steps.size());
+  ASSERT_EQ(JoinMethod::SORT_MERGE, steps[1].method);
+  ASSERT_EQ(steps[1].table->find_index_by_field("k"), steps[1].index);
+  ASSERT_EQ(steps[0].table->find_index_by_field("k"), steps[1].joined_index);
+  ASSERT_TRUE(steps[1].join_filters.empty());
+}
+
+TEST_F(JoinPlannerTest, test_hash)
+{
+  // 有过滤条件时不再完整地按照索引顺序读
+  const std::vector<JoinStep> *steps = &plan("select * from a, b where a.k = b.k and a.id > 5;");
+  ASSERT_EQ(JoinMethod::HASH, (*steps)[1].method);
+
+  // 只有一边有B+树索引
+  steps = &plan("select * from a, h where a.k = h.k;");
+  ASSERT_EQ(JoinMethod::HASH, (*steps)[1].method);
+
+  // 没有索引时小表作为build一侧
+  steps = &plan("select * from small, a where small.id = a.id;");
+  ASSERT_STREQ("small", (*steps)[0].table->name());
+  ASSERT_EQ(JoinMethod::HASH, (*steps)[1].method);
+  ASSERT_FALSE((*steps)[1].build_table);
+  ASSERT_EQ(1, (int)(*steps)[1].table_keys.size());
+  ASSERT_TRUE((*steps)[1].join_filters.empty());
+}
+
+TEST_F(JoinPlannerTest, test_nested_loop)
+{
+  const std::vector<JoinStep> &steps = plan("select * from small, a where small.k < a.k;");
+  ASSERT_EQ(JoinMethod::NESTED_LOOP, steps[1].method);
+  ASSERT_EQ(1, (int)steps[1].join_filters.size());
+}
+
+TEST_F(JoinPlannerTest, test_filter_split)
+{
+  // 常量条件放在第一个表上，单表条件在扫描时计算，等值连接条件由连接算子处理，其它连接条件在连接之后计算
+  const std::vector<JoinStep> *steps =
+      &plan("select * from small, a where small.id = a.id and small.k > 2 and 1 = 1 and a.k < 500 and small.k < a.k;");
+  ASSERT_EQ(2, (int)steps->size());
+  const JoinStep &first = (*steps)[0];
+  const JoinStep &second = (*steps)[1];
+  ASSERT_STREQ("small", first.table->name());
+  ASSERT_EQ(2, (int)first.table_filters.size());
+  ASSERT_TRUE(first.join_filters.empty());
+  ASSERT_EQ(JoinMethod::HASH, second.method);
+  ASSERT_EQ(1, (int)second.table_filters.size());
+  ASSERT_EQ(1, (int)second.join_filters.size());
+  ASSERT_EQ(LESS_THAN, second.join_filters[0]->comp());
+
+  // 索引嵌套循环连接不扫描新表，单表条件也要在连接之后计算
+  steps = &plan("select * from small, a where small.k = a.k and a.id < 500;");
+  ASSERT_EQ(JoinMethod::INDEX_NESTED_LOOP, (*steps)[1].method);
+  ASSERT_TRUE((*steps)[1].table_filters.empty());
+  ASSERT_EQ(1, (int)(*steps)[1].join_filters.size());
+}
+
+TEST_F(JoinPlannerTest, test_join_order)
+{
+  // 从行数最少的表开始，每次优先选择与已经连接的表有连接条件的表
+  const std::vector<JoinStep> *steps = &plan("select * from b, a, small where b.k = a.k and a.k = small.k;");
+  ASSERT_EQ(3, (int)steps->size());
+  ASSERT_STREQ("small", (*steps)[0].table->name());
+  ASSERT_STREQ("a", (*steps)[1].table->name());
+  ASSERT_STREQ("b", (*steps)[2].table->name());
+
+  // a与small没有连接条件，虽然与b一样大也要放到最后
+  steps = &plan("select * from a, b, small where small.k = b.k;");
+  ASSERT_STREQ("small", (*steps)[0].table->name());
+  ASSERT_STREQ("b", (*steps)[1].table->name());
+  ASSERT_STREQ("a", (*steps)[2].table->name());
+  ASSERT_EQ(JoinMethod::NESTED_LOOP, (*steps)[2].method);
+}
+
+TEST_F(JoinPlannerTest, test_index_scan_mirrored_comparison)
+{
+  // "值 op 字段"要换成对称的比较，995 <= k 就是 k >= 995
+  ASSERT_EQ(std::vector<int>({995, 996, 997, 998, 999}), index_scan("select * from a where 995 <= a.k;"));
+  ASSERT_EQ(std::vector<int>({996, 997, 998, 999}), index_scan("select * from a where 995 < a.k;"));
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 4, 5}), index_scan("select * from a where 5 >= a.k;"));
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 4}), index_scan("select * from a where 5 > a.k;"));
+  ASSERT_EQ(std::vector<int>({5}), index_scan("select * from a where 5 = a.k;"));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("test.log");
+  init_bpm();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,58 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <vector>
+
+#include "sql/operator/operator.h"
+#include "storage/common/table.h"
+#include "storage/common/record.h"
+
+/**
+ * 算子测试用的输入，按顺序输出事先生成好的记录，可以多次open从头输出
+ */
+class MockScanOperator : public Operator
+{
+public:
+  MockScanOperator(Table *table, std::vector<std::vector<char>> &rows) : rows_(rows)
+  {
+    tuple_.set_schema(table, table->table_meta().field_metas());
+  }
+
+  RC open() override
+  {
+    index_ = 0;
+    return RC::SUCCESS;
+  }
+  RC next() override
+  {
+    if (index_ >= rows_.size()) {
+      return RC::RECORD_EOF;
+    }
+    record_.set_data(rows_[index_++].data());
+    tuple_.set_record(&record_);
+    return RC::SUCCESS;
+  }
+  RC close() override
+  {
+    return RC::SUCCESS;
+  }
+  Tuple *current_tuple() override
+  {
+    return &tuple_;
+  }
+
+private:
+  std::vector<std::vector<char>> &rows_;
+  size_t index_ = 0;
+  Record record_;
+  RowTuple tuple_;
+};
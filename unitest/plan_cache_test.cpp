@@ -0,0 +1,168 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/parser/parse.h"
+#include "sql/stmt/stmt.h"
+#include "storage/common/db.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+BufferPoolManager bpm;
+
+void init_bpm()
+{
+  if (&BufferPoolManager::instance() == nullptr) {
+    BufferPoolManager::set_instance(&bpm);
+  }
+}
+
+class PlanCacheTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const char *directory = "plan_cache_test_dir";
+    std::string command = std::string("rm -rf ") + directory + " && mkdir -p " + directory;
+    ASSERT_EQ(0, system(command.c_str()));
+    ASSERT_EQ(RC::SUCCESS, db_.init("plan_cache_test", directory));
+
+    AttrInfo attrs[] = {{(char *)"id", INTS, 4}, {(char *)"name", CHARS, 8}};
+    ASSERT_EQ(RC::SUCCESS, db_.create_table("t", 2, attrs));
+  }
+
+protected:
+  Db db_;
+};
+
+TEST_F(PlanCacheTest, test_normalize)
+{
+  Value values[4];
+  int value_num = 0;
+  char *normalized = nullptr;
+  ASSERT_EQ(0, sql_normalize("select * from t where id = 1 and name = 'abc' limit 5 offset 2;",
+                   &normalized, values, 4, &value_num));
+  ASSERT_STREQ("SELECT * FROM t WHERE id = ? AND name = ? LIMIT 5 OFFSET 2 ;", normalized);
+  ASSERT_EQ(2, value_num);
+  ASSERT_EQ(INTS, values[0].type);
+  ASSERT_EQ(1, *(int *)values[0].data);
+  ASSERT_EQ(CHARS, values[1].type);
+  ASSERT_STREQ("abc", (char *)values[1].data);
+  free(normalized);
+  value_destroy(&values[0]);
+  value_destroy(&values[1]);
+
+  // 只缓存增删改查；已经有参数的语句和常量太多的语句也不处理
+  ASSERT_EQ(-1, sql_normalize("create table t2(id int);", &normalized, values, 4, &value_num));
+  ASSERT_EQ(-1, sql_normalize("select * from t where id = ?;", &normalized, values, 4, &value_num));
+  ASSERT_EQ(-1, sql_normalize("insert into t values(1, 'a', 2, 'b', 3);", &normalized, values, 4, &value_num));
+}
+
+TEST_F(PlanCacheTest, test_hit_and_invalidate)
+{
+  PlanCache &plan_cache = PlanCache::instance();
+  const long hits = plan_cache.hit_count();
+  const long misses = plan_cache.miss_count();
+
+  CachedPlan *plan = plan_cache.acquire(&db_, "select * from t where id = 1;");
+  ASSERT_NE(nullptr, plan);
+  ASSERT_EQ(misses + 1, plan_cache.miss_count());
+  Stmt *stmt = plan->stmt();
+  ASSERT_NE(nullptr, stmt);
+  plan_cache.release(plan);
+
+  // 常量也相同，直接用原来的Stmt，关键字的大小写不影响
+  plan = plan_cache.acquire(&db_, "SELECT * from t where id = 1;");
+  ASSERT_EQ(hits + 1, plan_cache.hit_count());
+  ASSERT_EQ(stmt, plan->stmt());
+  plan_cache.release(plan);
+
+  // 常量不同，只重新resolve
+  plan = plan_cache.acquire(&db_, "select * from t   where id=2;");
+  ASSERT_EQ(hits + 2, plan_cache.hit_count());
+  ASSERT_NE(nullptr, plan->stmt());
+  const Condition &condition = plan->query()->sstr.selection.conditions[0];
+  ASSERT_EQ(INTS, condition.right_value.type);
+  ASSERT_EQ(2, *(int *)condition.right_value.data);
+  plan_cache.release(plan);
+
+  // 表结构变化之后计划失效
+  const size_t size = plan_cache.size();
+  plan_cache.invalidate(db_.name(), "t");
+  ASSERT_EQ(size - 1, plan_cache.size());
+  plan = plan_cache.acquire(&db_, "select * from t where id = 1;");
+  ASSERT_EQ(misses + 2, plan_cache.miss_count());
+  plan_cache.release(plan);
+
+  // resolve失败的语句不缓存
+  ASSERT_EQ(nullptr, plan_cache.acquire(&db_, "select * from t2 where id = 1;"));
+  ASSERT_EQ(nullptr, plan_cache.acquire(&db_, "insert into t values(1);"));
+}
+
+TEST_F(PlanCacheTest, test_prepared_statement)
+{
+  PreparedCommand command;
+  ASSERT_EQ(0, sql_parse_prepared_command("  prepare p AS select * from t where id = ? and name = ?;", &command));
+  ASSERT_EQ(PREPARED_PREPARE, command.type);
+  ASSERT_STREQ("p", command.name);
+  ASSERT_STREQ(" select * from t where id = ? and name = ?;", command.sql);
+
+  Query *query = query_create();
+  ASSERT_EQ(RC::SUCCESS, parse(command.sql, query));
+  ASSERT_EQ(2, (int)query->param_num);
+  prepared_command_destroy(&command);
+  CachedPlan plan("plan_cache_test:p", query);
+
+  // 执行时只做词法分析读出参数，参数与上一次相同时不用重新resolve
+  Stmt *stmt = nullptr;
+  for (int i = 0; i < 3; i++) {
+    const char *sql = i < 2 ? "execute p(1, 'a');" : "EXECUTE p (-2, 'b')";
+    ASSERT_EQ(0, sql_parse_prepared_command(sql, &command));
+    ASSERT_EQ(PREPARED_EXECUTE, command.type);
+    ASSERT_EQ(2, (int)command.value_num);
+    std::vector<Value> values(command.values, command.values + command.value_num);
+    command.value_num = 0;
+    prepared_command_destroy(&command);
+
+    bool reused = false;
+    ASSERT_EQ(RC::SUCCESS, PlanCache::instance().bind(&db_, &plan, values, reused));
+    ASSERT_EQ(i == 1, reused);
+    ASSERT_NE(nullptr, plan.stmt());
+    ASSERT_TRUE(i != 1 || stmt == plan.stmt());
+    stmt = plan.stmt();
+  }
+  const Condition &condition = plan.query()->sstr.selection.conditions[0];
+  ASSERT_EQ(-2, *(int *)condition.right_value.data);
+
+  ASSERT_EQ(0, sql_parse_prepared_command("deallocate p;", &command));
+  ASSERT_EQ(PREPARED_DEALLOCATE, command.type);
+  prepared_command_destroy(&command);
+  ASSERT_EQ(0, sql_parse_prepared_command("select * from t;", &command));
+  ASSERT_EQ(PREPARED_NONE, command.type);
+  for (const char *bad : {"execute p(1,);", "execute p 1;", "prepare p select * from t;", "deallocate;"}) {
+    ASSERT_EQ(-1, sql_parse_prepared_command(bad, &command)) << bad;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("test.log");
+  init_bpm();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,159 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "sql/query_cache/query_cache.h"
+#include "sql/parser/parse.h"
+#include "storage/common/db.h"
+#include "storage/common/table.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+BufferPoolManager bpm;
+
+void init_bpm()
+{
+  if (&BufferPoolManager::instance() == nullptr) {
+    BufferPoolManager::set_instance(&bpm);
+  }
+}
+
+class QueryCacheTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const char *directory = "query_cache_test_dir";
+    std::string command = std::string("rm -rf ") + directory + " && mkdir -p " + directory;
+    ASSERT_EQ(0, system(command.c_str()));
+    ASSERT_EQ(RC::SUCCESS, db_.init("query_cache_test", directory));
+
+    AttrInfo attrs[] = {{(char *)"id", INTS, 4}};
+    ASSERT_EQ(RC::SUCCESS, db_.create_table("t", 1, attrs));
+    ASSERT_EQ(RC::SUCCESS, db_.create_table("s", 1, attrs));
+    QueryCache::instance().set_memory_limit(64 * 1024);
+  }
+
+  void TearDown() override
+  {
+    QueryCache::instance().set_memory_limit(0);
+  }
+
+  void insert(const char *table_name, int id)
+  {
+    Value value;
+    value_init_integer(&value, id);
+    ASSERT_EQ(RC::SUCCESS, db_.find_table(table_name)->insert_record(nullptr, 1, &value));
+    value_destroy(&value);
+  }
+
+  void put(const std::string &key, const std::string &result, const std::vector<std::string> &tables)
+  {
+    std::vector<uint64_t> versions;
+    ASSERT_TRUE(QueryCache::table_versions(&db_, tables, versions));
+    std::string copy = result;
+    QueryCache::instance().put(key, std::move(copy), tables, versions);
+  }
+
+protected:
+  Db db_;
+};
+
+TEST_F(QueryCacheTest, test_make_key)
+{
+  std::vector<Value> values(2);
+  value_init_integer(&values[0], 1);
+  value_init_string(&values[1], "a");
+  const std::string key = QueryCache::make_key("db:SELECT * FROM t WHERE id = ? AND name = ?", values);
+
+  // 常量不同或者类型不同都是不同的key
+  std::vector<Value> others(2);
+  value_init_integer(&others[0], 1);
+  value_init_string(&others[1], "b");
+  ASSERT_NE(key, QueryCache::make_key("db:SELECT * FROM t WHERE id = ? AND name = ?", others));
+  value_destroy(&others[0]);
+  value_init_float(&others[0], 1);
+  value_destroy(&others[1]);
+  value_init_string(&others[1], "a");
+  ASSERT_NE(key, QueryCache::make_key("db:SELECT * FROM t WHERE id = ? AND name = ?", others));
+  value_destroy(&others[0]);
+  value_init_integer(&others[0], 1);
+  ASSERT_EQ(key, QueryCache::make_key("db:SELECT * FROM t WHERE id = ? AND name = ?", others));
+
+  for (std::vector<Value> *list : {&values, &others}) {
+    for (Value &value : *list) {
+      value_destroy(&value);
+    }
+  }
+}
+
+TEST_F(QueryCacheTest, test_invalidate_on_modify)
+{
+  QueryCache &query_cache = QueryCache::instance();
+  insert("t", 1);
+  put("q1", "id\n1\n", {"t"});
+  put("q2", "id\n", {"t", "s"});
+
+  std::string result;
+  ASSERT_TRUE(query_cache.get(&db_, "q1", result));
+  ASSERT_EQ("id\n1\n", result);
+  ASSERT_TRUE(query_cache.get(&db_, "q2", result));
+
+  // 修改s之后只有读过s的结果失效
+  const uint64_t version = db_.find_table("s")->modify_version();
+  insert("s", 1);
+  ASSERT_NE(version, db_.find_table("s")->modify_version());
+  ASSERT_TRUE(query_cache.get(&db_, "q1", result));
+  ASSERT_FALSE(query_cache.get(&db_, "q2", result));
+  ASSERT_EQ(1, (int)query_cache.size());
+
+  // 删除之后重建的表版本也不同
+  ASSERT_EQ(RC::SUCCESS, db_.drop_table("t"));
+  AttrInfo attrs[] = {{(char *)"id", INTS, 4}};
+  ASSERT_EQ(RC::SUCCESS, db_.create_table("t", 1, attrs));
+  ASSERT_FALSE(query_cache.get(&db_, "q1", result));
+  ASSERT_EQ(0, (int)query_cache.size());
+}
+
+TEST_F(QueryCacheTest, test_lru_eviction)
+{
+  QueryCache &query_cache = QueryCache::instance();
+  const std::string result(4 * 1024, 'x');
+  for (int i = 0; i < 32; i++) {
+    put("q" + std::to_string(i), result, {"t"});
+    std::string output;
+    ASSERT_TRUE(query_cache.get(&db_, "q0", output));  // q0一直在用，不会被淘汰
+  }
+  ASSERT_LE(query_cache.memory_usage(), (size_t)64 * 1024);
+  ASSERT_LT((int)query_cache.size(), 32);
+
+  std::string output;
+  ASSERT_TRUE(query_cache.get(&db_, "q0", output));
+  ASSERT_TRUE(query_cache.get(&db_, "q31", output));
+  ASSERT_FALSE(query_cache.get(&db_, "q1", output));
+
+  // 超过上限1/8的结果不缓存
+  put("big", std::string(9 * 1024, 'x'), {"t"});
+  ASSERT_FALSE(query_cache.get(&db_, "big", output));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("test.log");
+  init_bpm();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,161 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <stdio.h>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "sql/operator/semi_join_operator.h"
+#include "sql/expr/expression.h"
+#include "storage/common/table.h"
+#include "storage/common/record.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "common/log/log.h"
+#include "mock_scan_operator.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+BufferPoolManager bpm;
+
+void init_bpm()
+{
+  if (&BufferPoolManager::instance() == nullptr) {
+    BufferPoolManager::set_instance(&bpm);
+  }
+}
+
+class SemiJoinOperatorTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const char *directory = "semi_join_operator_test_dir";
+    std::string command = std::string("rm -rf ") + directory + " && mkdir -p " + directory;
+    ASSERT_EQ(0, system(command.c_str()));
+
+    // outer(id int, name char(8))，inner(id int, outer_id int, name char(8))
+    AttrInfo outer_attrs[] = {{(char *)"id", INTS, 4}, {(char *)"name", CHARS, 8}};
+    std::string meta_file = std::string(directory) + "/outer.table";
+    ASSERT_EQ(RC::SUCCESS, outer_.create(meta_file.c_str(), "outer", directory, 2, outer_attrs));
+    AttrInfo inner_attrs[] = {{(char *)"id", INTS, 4}, {(char *)"outer_id", INTS, 4}, {(char *)"name", CHARS, 8}};
+    meta_file = std::string(directory) + "/inner.table";
+    ASSERT_EQ(RC::SUCCESS, inner_.create(meta_file.c_str(), "inner", directory, 3, inner_attrs));
+
+    for (int i = 0; i < OUTER_COUNT; i++) {
+      add_row(outer_, outer_rows_, {i}, i % 7);
+    }
+    // 每个偶数的outer_id有两行，name与outer中对应的行相同的只有一行
+    for (int i = 0; i < OUTER_COUNT; i += 2) {
+      add_row(inner_, inner_rows_, {i, i}, i % 7);
+      add_row(inner_, inner_rows_, {i + 1, i}, i % 7 + 1);
+    }
+  }
+
+  void add_row(Table &table, std::vector<std::vector<char>> &rows, const std::vector<int> &ints, int name_index)
+  {
+    const TableMeta &table_meta = table.table_meta();
+    std::vector<char> row(table_meta.record_size(), 'x');  // 结束符后面是无关的数据
+    for (size_t i = 0; i < ints.size(); i++) {
+      memcpy(row.data() + table_meta.field(table_meta.sys_field_num() + i)->offset(), &ints[i], sizeof(int));
+    }
+    char name[8];
+    snprintf(name, sizeof(name), "n%d", name_index);
+    const FieldMeta *name_meta = table_meta.field("name");
+    memcpy(row.data() + name_meta->offset(), name, strlen(name) + 1);
+    rows.push_back(row);
+  }
+
+  Field field(Table &table, const char *name)
+  {
+    return Field(&table, table.table_meta().field(name));
+  }
+
+  /**
+   * 输出的outer.id
+   */
+  std::set<int> output_ids(SemiJoinOperator &semi_oper)
+  {
+    std::set<int> ids;
+    EXPECT_EQ(RC::SUCCESS, semi_oper.open());
+    RC rc = RC::SUCCESS;
+    while (RC::SUCCESS == (rc = semi_oper.next())) {
+      TupleCell cell;
+      EXPECT_EQ(RC::SUCCESS, semi_oper.current_tuple()->find_cell(field(outer_, "id"), cell));
+      ids.insert(*(const int *)cell.data());
+    }
+    EXPECT_EQ(RC::RECORD_EOF, rc);
+    semi_oper.close();
+    return ids;
+  }
+
+protected:
+  static const int OUTER_COUNT = 1000;
+
+  Table outer_;
+  Table inner_;
+  std::vector<std::vector<char>> outer_rows_;
+  std::vector<std::vector<char>> inner_rows_;
+};
+
+TEST_F(SemiJoinOperatorTest, test_semi_and_anti_join)
+{
+  // outer.id IN (SELECT outer_id FROM inner WHERE inner.name = outer.name)
+  FieldExpr outer_id(&outer_, outer_.table_meta().field("id"));
+  FieldExpr outer_name(&outer_, outer_.table_meta().field("name"));
+  for (bool anti : {false, true}) {
+    MockScanOperator outer_oper(&outer_, outer_rows_);
+    MockScanOperator inner_oper(&inner_, inner_rows_);
+    SemiJoinOperator semi_oper(&outer_oper, &inner_oper, anti);
+    semi_oper.add_key(&outer_id, field(inner_, "outer_id"));
+    semi_oper.add_key(&outer_name, field(inner_, "name"));
+
+    std::set<int> ids = output_ids(semi_oper);
+    ASSERT_EQ(OUTER_COUNT / 2, (int)ids.size());
+    for (int id : ids) {
+      ASSERT_EQ(anti ? 1 : 0, id % 2) << id;
+    }
+  }
+}
+
+TEST_F(SemiJoinOperatorTest, test_scalar_compare)
+{
+  // outer.id < (SELECT id FROM inner WHERE inner.outer_id = outer.id AND inner.name = outer.name)
+  FieldExpr outer_id(&outer_, outer_.table_meta().field("id"));
+  FieldExpr outer_name(&outer_, outer_.table_meta().field("name"));
+  {
+    MockScanOperator outer_oper(&outer_, outer_rows_);
+    MockScanOperator inner_oper(&inner_, inner_rows_);
+    SemiJoinOperator semi_oper(&outer_oper, &inner_oper, false);
+    semi_oper.add_key(&outer_id, field(inner_, "outer_id"));
+    semi_oper.add_key(&outer_name, field(inner_, "name"));
+    semi_oper.set_compare(LESS_EQUAL, &outer_id, field(inner_, "id"));
+    ASSERT_EQ(OUTER_COUNT / 2, (int)output_ids(semi_oper).size());
+  }
+
+  // 只按outer_id关联时每个outer.id有两个值，不是标量子查询
+  MockScanOperator outer_oper(&outer_, outer_rows_);
+  MockScanOperator inner_oper(&inner_, inner_rows_);
+  SemiJoinOperator semi_oper(&outer_oper, &inner_oper, false);
+  semi_oper.add_key(&outer_id, field(inner_, "outer_id"));
+  semi_oper.set_compare(LESS_EQUAL, &outer_id, field(inner_, "id"));
+  ASSERT_EQ(RC::INVALID_ARGUMENT, semi_oper.open());
+  semi_oper.close();
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("test.log");
+  init_bpm();
+  return RUN_ALL_TESTS();
+}
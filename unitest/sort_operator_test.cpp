@@ -0,0 +1,156 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "sql/operator/sort_operator.h"
+#include "storage/common/table.h"
+#include "storage/common/record.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "storage/default/spill_file.h"
+#include "common/log/log.h"
+#include "mock_scan_operator.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+BufferPoolManager bpm;
+
+void init_bpm()
+{
+  if (&BufferPoolManager::instance() == nullptr) {
+    BufferPoolManager::set_instance(&bpm);
+  }
+}
+
+struct Row {
+  int id;
+  float score;
+  std::string name;
+};
+
+class SortOperatorTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const char *directory = "sort_operator_test_dir";
+    std::string command = std::string("rm -rf ") + directory + " && mkdir -p " + directory;
+    ASSERT_EQ(0, system(command.c_str()));
+    SpillFile::set_directory(directory);
+
+    AttrInfo attrs[] = {{(char *)"id", INTS, 4}, {(char *)"score", FLOATS, 4}, {(char *)"name", CHARS, 8}};
+    std::string meta_file = std::string(directory) + "/t.table";
+    ASSERT_EQ(RC::SUCCESS, table_.create(meta_file.c_str(), "t", directory, 3, attrs));
+    id_meta_ = table_.table_meta().field("id");
+    const FieldMeta *score_meta = table_.table_meta().field("score");
+    const FieldMeta *name_meta = table_.table_meta().field("name");
+
+    // 很多行的name和score都相同，用id检查排序是稳定的
+    for (int i = 0; i < ROW_COUNT; i++) {
+      std::vector<char> row(table_.table_meta().record_size(), 'x');  // 结束符后面是无关的数据
+      const int key = (i * 7919) % ROW_COUNT;
+      float score = (key % 13 - 6) * 0.25f;
+      if (score == 0 && key % 2 == 0) {
+        score = -0.0f;
+      }
+      char name[8];
+      snprintf(name, sizeof(name), key % 5 == 0 ? "a%d" : "a%d0", key % 31);
+      memcpy(row.data() + id_meta_->offset(), &i, sizeof(i));
+      memcpy(row.data() + score_meta->offset(), &score, sizeof(score));
+      memcpy(row.data() + name_meta->offset(), name, strlen(name) + 1);
+      rows_.push_back(row);
+      expected_.push_back({i, score, name});
+    }
+    // ORDER BY name, score DESC
+    std::stable_sort(expected_.begin(), expected_.end(), [](const Row &left, const Row &right) {
+      if (left.name != right.name) {
+        return left.name < right.name;
+      }
+      return left.score > right.score;
+    });
+
+    OrderByUnit name_unit;
+    name_unit.field = Field(&table_, name_meta);
+    OrderByUnit score_unit;
+    score_unit.field = Field(&table_, score_meta);
+    score_unit.asc = false;
+    order_by_units_ = {name_unit, score_unit};
+  }
+
+  /**
+   * 在给定的内存预算下排序，检查输出的前rows行和排好序的数据一致
+   * @return 写到临时文件的有序段个数
+   */
+  int sort_and_check(int64_t memory_budget, int limit, int rows)
+  {
+    MockScanOperator scan_oper(&table_, rows_);
+    SortOperator sort_oper({&table_}, order_by_units_);
+    sort_oper.set_memory_budget(memory_budget);
+    sort_oper.set_limit(limit);
+    sort_oper.add_child(&scan_oper);
+    EXPECT_EQ(RC::SUCCESS, sort_oper.open());
+
+    int index = 0;
+    RC rc = RC::SUCCESS;
+    while (RC::SUCCESS == (rc = sort_oper.next()) && index < rows) {
+      TupleCell cell;
+      EXPECT_EQ(RC::SUCCESS, sort_oper.current_tuple()->find_cell(Field(&table_, id_meta_), cell));
+      EXPECT_EQ(expected_[index].id, *(const int *)cell.data()) << "index=" << index;
+      index++;
+    }
+    EXPECT_EQ(RC::RECORD_EOF, rc);
+    EXPECT_EQ(rows, index);
+    const int runs = sort_oper.spilled_runs();
+    EXPECT_EQ(RC::SUCCESS, sort_oper.close());
+    return runs;
+  }
+
+protected:
+  static const int ROW_COUNT = 20000;
+
+  Table table_;
+  const FieldMeta *id_meta_ = nullptr;
+  std::vector<std::vector<char>> rows_;
+  std::vector<Row> expected_;
+  std::vector<OrderByUnit> order_by_units_;
+};
+
+TEST_F(SortOperatorTest, test_in_memory_sort)
+{
+  ASSERT_EQ(0, sort_and_check((int64_t)64 << 20, -1, ROW_COUNT));
+}
+
+TEST_F(SortOperatorTest, test_external_merge_sort)
+{
+  // 只能放下几十行，有序段很多，需要多趟归并
+  ASSERT_GT(sort_and_check(4096, -1, ROW_COUNT), 16);
+}
+
+TEST_F(SortOperatorTest, test_top_n)
+{
+  // limit行放得下时只保留limit行，放不下时退化成完整的外部排序
+  ASSERT_EQ(0, sort_and_check(4096, 0, 0));
+  ASSERT_EQ(0, sort_and_check(4096, 1, 1));
+  ASSERT_EQ(0, sort_and_check(4096, 25, 25));
+  ASSERT_GT(sort_and_check(4096, 5000, ROW_COUNT), 0);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("test.log");
+  init_bpm();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,112 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <dirent.h>
+#include <string.h>
+#include <string>
+
+#include "storage/default/spill_file.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "rc.h"
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+BufferPoolManager bpm;
+
+void init_bpm()
+{
+  if (&BufferPoolManager::instance() == nullptr) {
+    BufferPoolManager::set_instance(&bpm);
+  }
+}
+
+static int count_spill_files(const char *directory)
+{
+  int count = 0;
+  DIR *dir = opendir(directory);
+  if (dir == nullptr) {
+    return -1;
+  }
+  struct dirent *entry = nullptr;
+  while ((entry = readdir(dir)) != nullptr) {
+    if (strncmp(entry->d_name, "spill_", 6) == 0) {
+      count++;
+    }
+  }
+  closedir(dir);
+  return count;
+}
+
+TEST(test_spill_file, test_write_read)
+{
+  LoggerFactory::init_default("test.log");
+
+  const char *directory = "spill_test_dir";
+  std::string command = std::string("mkdir -p ") + directory;
+  ASSERT_EQ(0, system(command.c_str()));
+  SpillFile::set_directory(directory);
+
+  const int row_size = 100;
+  const int count = 10000;  // 跨越很多个页面
+  {
+    SpillFile file(row_size);
+    char row[row_size];
+    for (int i = 0; i < count; i++) {
+      memset(row, i % 128, sizeof(row));
+      memcpy(row, &i, sizeof(i));
+      ASSERT_EQ(RC::SUCCESS, file.append(row));
+    }
+    ASSERT_EQ(count, file.row_count());
+    ASSERT_EQ(1, count_spill_files(directory));
+
+    // 可以重复读取
+    for (int round = 0; round < 2; round++) {
+      ASSERT_EQ(RC::SUCCESS, file.rewind());
+      const char *data = nullptr;
+      for (int i = 0; i < count; i++) {
+        ASSERT_EQ(RC::SUCCESS, file.next(data));
+        int value = 0;
+        memcpy(&value, data, sizeof(value));
+        ASSERT_EQ(i, value);
+        ASSERT_EQ(i % 128, data[row_size - 1]);
+      }
+      ASSERT_EQ(RC::RECORD_EOF, file.next(data));
+    }
+  }
+  ASSERT_EQ(0, count_spill_files(directory));
+
+  SpillFile::set_directory(".");
+}
+
+TEST(test_spill_file, test_empty_and_large_row)
+{
+  SpillFile empty(16);
+  const char *data = nullptr;
+  ASSERT_EQ(RC::SUCCESS, empty.rewind());
+  ASSERT_EQ(RC::RECORD_EOF, empty.next(data));
+
+  ASSERT_TRUE(SpillFile::can_spill(1000));
+  ASSERT_FALSE(SpillFile::can_spill(BP_PAGE_SIZE));
+
+  char row[BP_PAGE_SIZE] = {0};
+  SpillFile large(BP_PAGE_SIZE);
+  ASSERT_NE(RC::SUCCESS, large.append(row));
+}
+
+int main(int argc, char **argv)
+{
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  init_bpm();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,134 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "storage/common/table_stats.h"
+#include "common/log/log.h"
+#include "json/json.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+static std::string int_bound(int v)
+{
+  return std::string((const char *)&v, sizeof(v));
+}
+
+TEST(test_table_stats, test_hyper_log_log)
+{
+  LoggerFactory::init_default("test.log");
+
+  for (int count : {10, 1000, 100000}) {
+    HyperLogLog hll;
+    for (int round = 0; round < 2; round++) {  // 重复的值不影响结果
+      for (int i = 0; i < count; i++) {
+        hll.add((const char *)&i, sizeof(i));
+      }
+    }
+    const int64_t estimate = hll.estimate();
+    ASSERT_GT(estimate, count * 0.8);
+    ASSERT_LT(estimate, count * 1.2);
+
+    HyperLogLog copy;
+    ASSERT_EQ(RC::SUCCESS, copy.from_string(hll.to_string()));
+    ASSERT_EQ(estimate, copy.estimate());
+  }
+
+  HyperLogLog hll;
+  ASSERT_EQ(0, hll.estimate());
+  ASSERT_NE(RC::SUCCESS, hll.from_string("xyz"));
+}
+
+TEST(test_table_stats, test_histogram_selectivity)
+{
+  FieldMeta field;
+  ASSERT_EQ(RC::SUCCESS, field.init("v", INTS, 4, 4, true));
+  ColumnStats column;
+  column.init(field);
+  for (int i = 0; i < 100; i++) {
+    column.add((const char *)&i);
+  }
+  // 0到100，均匀分成4个桶
+  column.set_bounds({int_bound(0), int_bound(25), int_bound(50), int_bound(75), int_bound(100)});
+
+  const int row_count = 100;
+  int value = 50;
+  ASSERT_NEAR(0.5, column.selectivity(LESS_THAN, (const char *)&value, row_count), 0.02);
+  ASSERT_NEAR(0.5, column.selectivity(GREAT_EQUAL, (const char *)&value, row_count), 0.02);
+  value = 10;
+  ASSERT_NEAR(0.1, column.selectivity(LESS_EQUAL, (const char *)&value, row_count), 0.02);
+  ASSERT_NEAR(0.9, column.selectivity(GREAT_THAN, (const char *)&value, row_count), 0.02);
+  ASSERT_NEAR(0.01, column.selectivity(EQUAL_TO, (const char *)&value, row_count), 0.005);
+
+  // 超出范围的值
+  value = 200;
+  ASSERT_NEAR(0.01, column.selectivity(EQUAL_TO, (const char *)&value, row_count), 0.001);
+  ASSERT_NEAR(1, column.selectivity(LESS_THAN, (const char *)&value, row_count), 0.001);
+  value = -5;
+  ASSERT_NEAR(1, column.selectivity(GREAT_THAN, (const char *)&value, row_count), 0.001);
+
+  ColumnStats empty;
+  empty.init(field);
+  ASSERT_LT(empty.selectivity(EQUAL_TO, (const char *)&value, row_count), 0);
+}
+
+TEST(test_table_stats, test_serialize)
+{
+  std::vector<FieldMeta> fields(3);
+  ASSERT_EQ(RC::SUCCESS, fields[0].init("__trx", INTS, 0, 4, false));
+  ASSERT_EQ(RC::SUCCESS, fields[1].init("id", INTS, 4, 4, true));
+  ASSERT_EQ(RC::SUCCESS, fields[2].init("name", CHARS, 8, 8, true));
+
+  TableStats stats;
+  stats.init(fields, 1);
+  ASSERT_TRUE(stats.valid());
+  ASSERT_EQ(nullptr, stats.column("__trx"));
+
+  char record[16] = {0};
+  for (int i = 0; i < 50; i++) {
+    memcpy(record + 4, &i, sizeof(i));
+    snprintf(record + 8, 8, "n%d", i % 5);
+    stats.on_insert(record);
+  }
+  stats.on_delete();
+  ASSERT_EQ(49, stats.row_count());
+  ASSERT_EQ(51, stats.modified_rows());
+  ASSERT_NEAR(50, stats.column("id")->distinct_count(), 5);
+  ASSERT_NEAR(5, stats.column("name")->distinct_count(), 1);
+
+  std::vector<ColumnStats> columns = stats.columns();
+  char a[8] = "aa";
+  char z[8] = "zz";
+  columns[1].set_bounds({std::string(a, sizeof(a)), std::string(z, sizeof(z))});
+  stats.reset(49, std::move(columns));
+
+  Json::Value json_value;
+  stats.to_json(json_value);
+  TableStats copy;
+  ASSERT_FALSE(copy.valid());
+  ASSERT_EQ(RC::SUCCESS, TableStats::from_json(json_value, fields, 1, copy));
+  ASSERT_TRUE(copy.analyzed());
+  ASSERT_EQ(49, copy.row_count());
+  ASSERT_EQ(0, copy.modified_rows());
+  ASSERT_EQ(stats.column("id")->distinct_count(), copy.column("id")->distinct_count());
+  ASSERT_EQ(2, copy.column("name")->bounds().size());
+  ASSERT_EQ(0, copy.column("name")->compare(copy.column("name")->bounds()[1].data(), "zz"));
+}
+
+int main(int argc, char **argv)
+{
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,144 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "sql/operator/temp_relation.h"
+#include "sql/operator/join_operator.h"
+#include "storage/common/table.h"
+#include "storage/common/record.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "storage/default/spill_file.h"
+#include "common/log/log.h"
+#include "mock_scan_operator.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+BufferPoolManager bpm;
+
+void init_bpm()
+{
+  if (&BufferPoolManager::instance() == nullptr) {
+    BufferPoolManager::set_instance(&bpm);
+  }
+}
+
+class TempRelationTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const char *directory = "temp_relation_test_dir";
+    std::string command = std::string("rm -rf ") + directory + " && mkdir -p " + directory;
+    ASSERT_EQ(0, system(command.c_str()));
+    SpillFile::set_directory(directory);
+
+    AttrInfo attrs[] = {{(char *)"id", INTS, 4}};
+    for (Table *table : {&left_, &right_}) {
+      const char *name = table == &left_ ? "l" : "r";
+      std::string meta_file = std::string(directory) + "/" + name + ".table";
+      ASSERT_EQ(RC::SUCCESS, table->create(meta_file.c_str(), name, directory, 1, attrs));
+    }
+    for (int i = 0; i < 300; i++) {
+      add_row(left_, left_rows_, i);
+    }
+    for (int i = 0; i < 200; i++) {
+      add_row(right_, right_rows_, i);
+    }
+  }
+
+  void add_row(Table &table, std::vector<std::vector<char>> &rows, int id)
+  {
+    std::vector<char> row(table.table_meta().record_size(), 0);
+    memcpy(row.data() + table.table_meta().field("id")->offset(), &id, sizeof(id));
+    rows.push_back(row);
+  }
+
+  int id_of(const Tuple &tuple, Table &table)
+  {
+    TupleCell cell;
+    EXPECT_EQ(RC::SUCCESS, tuple.find_cell(Field(&table, table.table_meta().field("id")), cell));
+    return *(const int *)cell.data();
+  }
+
+protected:
+  Table left_;
+  Table right_;
+  std::vector<std::vector<char>> left_rows_;
+  std::vector<std::vector<char>> right_rows_;
+};
+
+TEST_F(TempRelationTest, test_spill_and_rescan)
+{
+  MockScanOperator scan_oper(&right_, right_rows_);
+  TempRelation relation({&right_});
+  const int row_size = relation.resident_rows().row_size();
+  relation.set_memory_budget(row_size * 50);
+  ASSERT_EQ(RC::SUCCESS, scan_oper.open());
+  while (RC::SUCCESS == scan_oper.next()) {
+    ASSERT_EQ(RC::SUCCESS, relation.append(*scan_oper.current_tuple()));
+  }
+  ASSERT_TRUE(relation.spilled());
+  ASSERT_EQ(50, relation.resident_rows().size());
+  ASSERT_EQ((int)right_rows_.size(), relation.size());
+
+  // 先读内存中的行再读文件中的行，可以反复从头读
+  RowSetTuple tuple(relation.resident_rows());
+  for (int round = 0; round < 2; round++) {
+    ASSERT_EQ(RC::SUCCESS, relation.rewind());
+    const char *row = nullptr;
+    for (int i = 0; i < (int)right_rows_.size(); i++) {
+      ASSERT_EQ(RC::SUCCESS, relation.next(row));
+      tuple.set_row(row);
+      ASSERT_EQ(i, id_of(tuple, right_));
+    }
+    ASSERT_EQ(RC::RECORD_EOF, relation.next(row));
+  }
+  relation.clear();
+  ASSERT_EQ(0, relation.size());
+}
+
+TEST_F(TempRelationTest, test_block_nested_loop_join)
+{
+  // 右边放不下时按块连接，每一块都要和左边的所有行连接一次，输出的仍然恰好是笛卡尔积
+  MockScanOperator left_oper(&left_, left_rows_);
+  MockScanOperator right_oper(&right_, right_rows_);
+  NestedLoopJoinOperator join_oper(&left_oper, {&left_}, &right_oper, {&right_});
+  join_oper.set_memory_budget(1024);
+  ASSERT_EQ(RC::SUCCESS, join_oper.open());
+
+  const int left_count = left_rows_.size();
+  const int right_count = right_rows_.size();
+  std::vector<int> matches(left_count * right_count, 0);
+  RC rc = RC::SUCCESS;
+  while (RC::SUCCESS == (rc = join_oper.next())) {
+    const int left_id = id_of(*join_oper.current_tuple(), left_);
+    const int right_id = id_of(*join_oper.current_tuple(), right_);
+    ASSERT_TRUE(left_id >= 0 && left_id < left_count && right_id >= 0 && right_id < right_count);
+    matches[left_id * right_count + right_id]++;
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_TRUE(join_oper.spilled());
+  for (int i = 0; i < left_count * right_count; i++) {
+    ASSERT_EQ(1, matches[i]) << "left=" << i / right_count << ", right=" << i % right_count;
+  }
+  ASSERT_EQ(RC::SUCCESS, join_oper.close());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("test.log");
+  init_bpm();
+  return RUN_ALL_TESTS();
+}